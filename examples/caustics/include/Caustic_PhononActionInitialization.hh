@@ -4,6 +4,7 @@
 \***********************************************************************/
 
 // 20241024 Israel Hernandez -- IIT, QSC and Fermilab
+// 20261019 Add run action on master and workers to merge hit images
 
 #ifndef Caustic_PhononActionInitialization_hh
 #define Caustic_PhononActionInitialization_hh 1
@@ -15,6 +16,7 @@ public:
   Caustic_PhononActionInitialization() {;}
   virtual ~Caustic_PhononActionInitialization() {;}
   virtual void Build() const;
+  virtual void BuildForMaster() const;
 };
 
 #endif
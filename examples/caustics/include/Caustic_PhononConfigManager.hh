@@ -4,15 +4,18 @@
 \***********************************************************************/
 
 // 20241024 Israel Hernandez -- IIT, QSC and Fermilab
+// 20261019 Add configuration of in-memory hit image (G4CMPHitImage)
 
 #ifndef Caustic_PhononConfigManager_hh
 #define Caustic_PhononConfigManager_hh 1
 
 #include "G4Types.hh"
 #include "G4String.hh"
+#include <vector>
 
 
 class Caustic_PhononConfigMessenger;
+class G4CMPHitImage;
 
 
 class Caustic_PhononConfigManager {
@@ -23,11 +26,33 @@ public:
   // Access current values
   static const G4String& GetHitOutput()  { return Instance()->Hit_file; }
 
+  // Hit image is written only if filename is set
+  static const G4String& GetImageOutput() { return Instance()->Image_file; }
+
+  // Apply image settings (binning, modes, slices) to accumulator
+  static void ConfigureImage(G4CMPHitImage& image);
 
   // Change values (e.g., via Messenger)
   static void SetHitOutput(const G4String& name)
     { Instance()->Hit_file=name; UpdateGeometry(); }
 
+  static void SetImageOutput(const G4String& name)
+    { Instance()->Image_file=name; }
+  static void SetImageBins(G4int nu, G4int nv)
+    { Instance()->Image_nu=nu; Instance()->Image_nv=nv; }
+  static void SetImageRange(G4double umin, G4double umax,
+			    G4double vmin, G4double vmax) {
+    Instance()->Image_umin=umin; Instance()->Image_umax=umax;
+    Instance()->Image_vmin=vmin; Instance()->Image_vmax=vmax;
+  }
+  static void SetImageModes(const std::vector<G4int>& types)
+    { Instance()->Image_modes=types; }
+  static void SetImageTimeSlices(const std::vector<G4double>& edges)
+    { Instance()->Image_times=edges; }
+  static void SetImageEnergySlices(const std::vector<G4double>& edges)
+    { Instance()->Image_energies=edges; }
+  static void SetImageEnergyWeight(G4bool value)
+    { Instance()->Image_energyWeight=value; }
 
   static void UpdateGeometry();
 
@@ -43,6 +68,13 @@ private:
 private:
   G4String Hit_file;	// Output file
 
+  G4String Image_file;	// Hit image output file; empty for none
+  G4int Image_nu, Image_nv;			// Image bins on sensor face
+  G4double Image_umin, Image_umax, Image_vmin, Image_vmax;
+  std::vector<G4int> Image_modes;		// G4CMPHitWriter::ParticleType
+  std::vector<G4double> Image_times;		// Time slice edges
+  std::vector<G4double> Image_energies;		// Energy slice edges
+  G4bool Image_energyWeight;			// Fill with energy, not count
 
   Caustic_PhononConfigMessenger* messenger;
 };
@@ -4,6 +4,7 @@
 \***********************************************************************/
 
 // 20241024 Israel Hernandez -- IIT, QSC and Fermilab
+// 20261019 Add commands to configure in-memory hit image
 
 
 #ifndef Caustic_PhononConfigMessenger_hh
@@ -11,6 +12,7 @@
 
 #include "G4UImessenger.hh"
 #include "G4UIcmdWithADouble.hh"
+#include <vector>
 
 class Caustic_PhononConfigManager;
 class G4UIcmdWithAString;
@@ -27,6 +29,17 @@ public:
 private:
   Caustic_PhononConfigManager* theManager;
   G4UIcmdWithAString* hitsCmd;
+  G4UIcmdWithAString* imageCmd;
+  G4UIcommand* imageBinsCmd;
+  G4UIcommand* imageRangeCmd;
+  G4UIcmdWithAString* imageModesCmd;
+  G4UIcmdWithAString* imageTimeCmd;
+  G4UIcmdWithAString* imageEnergyCmd;
+  G4UIcmdWithAString* imageWeightCmd;
+
+  // Parse list of values, with optional unit at end
+  std::vector<G4double> ParseSlices(const G4String& value,
+				    const char* defaultUnit) const;
 
 
 private:
@@ -0,0 +1,35 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Merges per-thread hit images from Caustic_PhononSensitivity at the end
+// of each run, and writes the combined image from the master thread.
+//
+// 20261019 New run action for in-memory hit images
+
+#ifndef Caustic_PhononRunAction_hh
+#define Caustic_PhononRunAction_hh 1
+
+#include "G4UserRunAction.hh"
+
+class Caustic_PhononSensitivity;
+class G4CMPHitImage;
+class G4Run;
+
+class Caustic_PhononRunAction : public G4UserRunAction {
+public:
+  Caustic_PhononRunAction() {;}
+  virtual ~Caustic_PhononRunAction() {;}
+
+  virtual void BeginOfRunAction(const G4Run*);
+  virtual void EndOfRunAction(const G4Run*);
+
+private:
+  // Sensitive detector in this thread (none on master in MT mode)
+  Caustic_PhononSensitivity* GetSensitivity() const;
+
+  static G4CMPHitImage* totalImage;	// Merged from all threads
+};
+
+#endif
@@ -4,12 +4,16 @@
 \***********************************************************************/
 
 // 20241024 Israel Hernandez -- IIT, QSC and Fermilab
+// 20261019 Add optional per-thread image of hits (G4CMPHitImage)
 
 #ifndef Caustic_PhononSensitivity_h
 #define Caustic_PhononSensitivity_h 1
 
 #include "G4CMPElectrodeSensitivity.hh"
 
+class G4CMPHitImage;
+class G4CMPHitWriter;
+
 class Caustic_PhononSensitivity final : public G4CMPElectrodeSensitivity {
 public:
   Caustic_PhononSensitivity(G4String name);
@@ -25,11 +29,17 @@ public:
 
   void SetOutputFile(const G4String& fn);
 
+  // Image of hits in this thread, created on first request
+  G4CMPHitImage* GetImage(G4bool create=false);
+  void DeleteImage();
+
 protected:
   virtual G4bool IsHit(const G4Step*, const G4TouchableHistory*) const;
 
 private:
   std::ofstream output;
+  G4CMPHitWriter* binaryOutput;		// Used for files ending in ".bin"
+  G4CMPHitImage* image;			// Filled in addition to output file
   G4String fileName;
 };
 
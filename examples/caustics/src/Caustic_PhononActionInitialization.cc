@@ -4,12 +4,19 @@
 \***********************************************************************/
 
 // 20241024 Israel Hernandez -- IIT, QSC and Fermilab
+// 20261019 Add run action on master and workers to merge hit images
 
 #include "Caustic_PhononActionInitialization.hh"
 #include "Caustic_PhononPrimaryGeneratorAction.hh"
+#include "Caustic_PhononRunAction.hh"
 #include "G4CMPStackingAction.hh"
 
 void Caustic_PhononActionInitialization::Build() const {
   SetUserAction(new Caustic_PhononPrimaryGeneratorAction);
   SetUserAction(new G4CMPStackingAction);
+  SetUserAction(new Caustic_PhononRunAction);
+}
+
+void Caustic_PhononActionInitialization::BuildForMaster() const {
+  SetUserAction(new Caustic_PhononRunAction);
 }
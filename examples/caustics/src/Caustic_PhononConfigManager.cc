@@ -4,11 +4,15 @@
 \***********************************************************************/
 
 // 20241024 Israel Hernandez -- IIT, QSC and Fermilab
+// 20261019 Add configuration of in-memory hit image (G4CMPHitImage)
 
 
 #include "Caustic_PhononConfigManager.hh"
 #include "Caustic_PhononConfigMessenger.hh"
+#include "G4CMPHitImage.hh"
+#include "G4CMPHitWriter.hh"
 #include "G4RunManager.hh"
+#include "G4SystemOfUnits.hh"
 #include <stdlib.h>
 
 
@@ -23,6 +27,12 @@ Caustic_PhononConfigManager* Caustic_PhononConfigManager::Instance() {
 
 Caustic_PhononConfigManager::Caustic_PhononConfigManager()
   : Hit_file(getenv("G4CMP_HIT_FILE")?getenv("G4CMP_HIT_FILE"):"phonon_hits.txt"),
+    Image_file(getenv("G4CMP_IMAGE_FILE")?getenv("G4CMP_IMAGE_FILE"):""),
+    Image_nu(400), Image_nv(400), Image_umin(-0.2*cm), Image_umax(0.2*cm),
+    Image_vmin(-0.2*cm), Image_vmax(0.2*cm),
+    Image_modes({G4CMPHitWriter::kPhononL, G4CMPHitWriter::kPhononTS,
+		 G4CMPHitWriter::kPhononTF}),
+    Image_energyWeight(false),
     messenger(new Caustic_PhononConfigMessenger(this))
 {;}
 
@@ -31,6 +41,23 @@ Caustic_PhononConfigManager::~Caustic_PhononConfigManager() {
 }
 
 
+// Image is of sensor (bolometer) face, in X-Y plane of substrate
+
+void Caustic_PhononConfigManager::ConfigureImage(G4CMPHitImage& image) {
+  const Caustic_PhononConfigManager* mgr = Instance();
+
+  image.SetFace(G4ThreeVector(), G4ThreeVector(1.,0.,0.),
+		G4ThreeVector(0.,1.,0.));
+  image.SetBinning(mgr->Image_nu, mgr->Image_umin, mgr->Image_umax,
+		   mgr->Image_nv, mgr->Image_vmin, mgr->Image_vmax);
+  image.SetModes(mgr->Image_modes);
+  image.SetTimeSlices(mgr->Image_times);
+  image.SetEnergySlices(mgr->Image_energies);
+  image.SetWeighting(mgr->Image_energyWeight ? G4CMPHitImage::kEnergy
+		     : G4CMPHitImage::kCount);
+}
+
+
 // Trigger rebuild of geometry if parameters change
 
 void Caustic_PhononConfigManager::UpdateGeometry() {
@@ -5,25 +5,94 @@
 
 
 // 20241024 Israel Hernandez -- IIT, QSC and Fermilab
+// 20261019 Add commands to configure in-memory hit image
 
 #include "Caustic_PhononConfigMessenger.hh"
 #include "Caustic_PhononConfigManager.hh"
+#include "G4CMPHitWriter.hh"
 #include "G4UIcmdWithAString.hh"
+#include "G4UIparameter.hh"
+#include <sstream>
+#include <stdlib.h>
 
 
 // Constructor and destructor
 
 Caustic_PhononConfigMessenger::Caustic_PhononConfigMessenger(Caustic_PhononConfigManager* mgr)
   : G4UImessenger("/g4cmp/", "User configuration for G4CMP phonon example"),
-    theManager(mgr), hitsCmd(0) {
+    theManager(mgr), hitsCmd(0), imageCmd(0), imageBinsCmd(0),
+    imageRangeCmd(0), imageModesCmd(0), imageTimeCmd(0), imageEnergyCmd(0),
+    imageWeightCmd(0) {
   hitsCmd = CreateCommand<G4UIcmdWithAString>("HitsFile",
 			      "Set filename for output of phonon hit locations");
+  hitsCmd->SetGuidance("Empty name turns off hit output.");
+  hitsCmd->SetParameterName("file",true);
+  hitsCmd->SetDefaultValue("");
+
+  imageCmd = CreateCommand<G4UIcmdWithAString>("ImageFile",
+			      "Set filename for image of phonon hits on sensor");
+  imageCmd->SetGuidance("Image is merged from all threads, and written at");
+  imageCmd->SetGuidance("end of each run.  Empty name turns off image.");
+  imageCmd->SetParameterName("file",true);
+  imageCmd->SetDefaultValue("");
+
+  imageBinsCmd = new G4UIcommand("/g4cmp/ImageBins", this);
+  imageBinsCmd->SetGuidance("Set number of image bins in X and Y");
+  G4UIparameter* param = new G4UIparameter("nx", 'i', false);
+  param->SetParameterRange("nx>0");
+  imageBinsCmd->SetParameter(param);
+  param = new G4UIparameter("ny", 'i', false);
+  param->SetParameterRange("ny>0");
+  imageBinsCmd->SetParameter(param);
+
+  imageRangeCmd = new G4UIcommand("/g4cmp/ImageRange", this);
+  imageRangeCmd->SetGuidance("Set image range in X and Y on sensor face");
+  param = new G4UIparameter("xmin", 'd', false);
+  imageRangeCmd->SetParameter(param);
+  param = new G4UIparameter("xmax", 'd', false);
+  imageRangeCmd->SetParameter(param);
+  param = new G4UIparameter("ymin", 'd', false);
+  imageRangeCmd->SetParameter(param);
+  param = new G4UIparameter("ymax", 'd', false);
+  imageRangeCmd->SetParameter(param);
+  param = new G4UIparameter("unit", 's', true);
+  param->SetDefaultUnit("mm");
+  imageRangeCmd->SetParameter(param);
+
+  imageModesCmd = CreateCommand<G4UIcmdWithAString>("ImageModes",
+			      "Set phonon modes to image, each separately");
+  imageModesCmd->SetGuidance("List of phononL, phononTS, phononTF");
+
+  imageTimeCmd = CreateCommand<G4UIcmdWithAString>("ImageTimeSlices",
+			      "Set edges of hit time slices for image");
+  imageTimeCmd->SetGuidance("List of increasing times, optional unit (ns)");
+  imageTimeCmd->SetGuidance("Empty list turns off time slices.");
+  imageTimeCmd->SetParameterName("edges",true);
+  imageTimeCmd->SetDefaultValue("");
+
+  imageEnergyCmd = CreateCommand<G4UIcmdWithAString>("ImageEnergySlices",
+			      "Set edges of hit energy slices for image");
+  imageEnergyCmd->SetGuidance("List of increasing energies, optional unit (meV)");
+  imageEnergyCmd->SetGuidance("Empty list turns off energy slices.");
+  imageEnergyCmd->SetParameterName("edges",true);
+  imageEnergyCmd->SetDefaultValue("");
+
+  imageWeightCmd = CreateCommand<G4UIcmdWithAString>("ImageWeight",
+			      "Fill image with hit count or energy (eV)");
+  imageWeightCmd->SetCandidates("count energy");
 
 }
 
 
 Caustic_PhononConfigMessenger::~Caustic_PhononConfigMessenger() {
   delete hitsCmd; hitsCmd=0;
+  delete imageCmd; imageCmd=0;
+  delete imageBinsCmd; imageBinsCmd=0;
+  delete imageRangeCmd; imageRangeCmd=0;
+  delete imageModesCmd; imageModesCmd=0;
+  delete imageTimeCmd; imageTimeCmd=0;
+  delete imageEnergyCmd; imageEnergyCmd=0;
+  delete imageWeightCmd; imageWeightCmd=0;
 
 }
 
@@ -33,4 +102,64 @@ Caustic_PhononConfigMessenger::~Caustic_PhononConfigMessenger() {
 void Caustic_PhononConfigMessenger::SetNewValue(G4UIcommand* cmd, G4String value) {
   if (cmd == hitsCmd) theManager->SetHitOutput(value);
 
+  if (cmd == imageCmd) theManager->SetImageOutput(value);
+
+  if (cmd == imageBinsCmd) {
+    G4int nx=0, ny=0;
+    std::istringstream args(value);
+    args >> nx >> ny;
+    theManager->SetImageBins(nx, ny);
+  }
+
+  if (cmd == imageRangeCmd) {
+    G4double xmin=0., xmax=0., ymin=0., ymax=0.;
+    G4String unit;
+    std::istringstream args(value);
+    args >> xmin >> xmax >> ymin >> ymax >> unit;
+    G4double scale = G4UIcommand::ValueOf(unit);
+    theManager->SetImageRange(xmin*scale, xmax*scale, ymin*scale, ymax*scale);
+  }
+
+  if (cmd == imageModesCmd) {
+    std::vector<G4int> types;
+    std::istringstream args(value);
+    G4String name;
+    while (args >> name) {
+      G4int type = G4CMPHitWriter::GetParticleType(name);
+      if (type != G4CMPHitWriter::kUnknown) types.push_back(type);
+      else G4cerr << "ImageModes: ignoring unknown mode " << name << G4endl;
+    }
+    theManager->SetImageModes(types);
+  }
+
+  if (cmd == imageTimeCmd)
+    theManager->SetImageTimeSlices(ParseSlices(value, "ns"));
+
+  if (cmd == imageEnergyCmd)
+    theManager->SetImageEnergySlices(ParseSlices(value, "meV"));
+
+  if (cmd == imageWeightCmd)
+    theManager->SetImageEnergyWeight(value == "energy");
+}
+
+
+// Values are followed by optional unit name
+
+std::vector<G4double>
+Caustic_PhononConfigMessenger::ParseSlices(const G4String& value,
+					   const char* defaultUnit) const {
+  std::vector<G4double> edges;
+  G4double scale = G4UIcommand::ValueOf(defaultUnit);
+
+  std::istringstream args(value);
+  G4String word;
+  while (args >> word) {
+    char* end = 0;
+    G4double edge = strtod(word.c_str(), &end);
+    if (end && *end == '\0') edges.push_back(edge);
+    else scale = G4UIcommand::ValueOf(word);
+  }
+
+  for (G4double& edge: edges) edge *= scale;
+  return edges;
 }
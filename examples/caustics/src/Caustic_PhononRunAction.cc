@@ -0,0 +1,79 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// 20261019 New run action for in-memory hit images
+
+#include "Caustic_PhononRunAction.hh"
+#include "Caustic_PhononConfigManager.hh"
+#include "Caustic_PhononSensitivity.hh"
+#include "G4AutoLock.hh"
+#include "G4CMPHitImage.hh"
+#include "G4Run.hh"
+#include "G4SDManager.hh"
+#include "G4Threading.hh"
+
+namespace {
+  G4Mutex imageMutex = G4MUTEX_INITIALIZER;
+}
+
+G4CMPHitImage* Caustic_PhononRunAction::totalImage = 0;
+
+
+// Master thread starts before workers, so combined image is ready for them
+
+void Caustic_PhononRunAction::BeginOfRunAction(const G4Run*) {
+  G4bool useImage = !Caustic_PhononConfigManager::GetImageOutput().empty();
+
+  if (G4Threading::IsMasterThread()) {
+    G4AutoLock l(&imageMutex);
+    if (useImage) {
+      if (!totalImage) totalImage = new G4CMPHitImage;
+      Caustic_PhononConfigManager::ConfigureImage(*totalImage);
+    } else {
+      delete totalImage; totalImage = 0;
+    }
+  }
+
+  Caustic_PhononSensitivity* sd = GetSensitivity();
+  if (!sd) return;
+
+  if (useImage)
+    Caustic_PhononConfigManager::ConfigureImage(*sd->GetImage(true));
+  else
+    sd->DeleteImage();
+}
+
+
+// Workers finish before master, which writes the combined image
+
+void Caustic_PhononRunAction::EndOfRunAction(const G4Run* run) {
+  Caustic_PhononSensitivity* sd = GetSensitivity();
+  G4CMPHitImage* image = sd ? sd->GetImage() : 0;
+
+  G4AutoLock l(&imageMutex);
+  if (!totalImage) return;
+
+  if (image) {
+    totalImage->Merge(*image);
+    image->Reset();
+  }
+
+  if (G4Threading::IsMasterThread()) {
+    const G4String& fileName = Caustic_PhononConfigManager::GetImageOutput();
+    if (totalImage->Write(fileName)) {
+      G4cout << "Run " << run->GetRunID() << ": image of "
+	     << totalImage->GetEntries() << " hits ("
+	     << totalImage->GetOutside() << " outside) written to "
+	     << fileName << G4endl;
+    }
+  }
+}
+
+
+Caustic_PhononSensitivity* Caustic_PhononRunAction::GetSensitivity() const {
+  return dynamic_cast<Caustic_PhononSensitivity*>(
+	   G4SDManager::GetSDMpointer()->FindSensitiveDetector("PhononElectrode",
+							       false));
+}
@@ -5,9 +5,13 @@
 
 // 20241024 Israel Hernandez -- IIT, QSC and Fermilab
 // 20250101 M. Kelsey -- G4CMP-434: Make output file thread-safe
+// 20261019 Use G4CMPHitWriter binary output for files ending in ".bin"
+// 20261019 Add optional per-thread image of hits (G4CMPHitImage)
 
 #include "Caustic_PhononSensitivity.hh"
 #include "G4CMPElectrodeHit.hh"
+#include "G4CMPHitImage.hh"
+#include "G4CMPHitWriter.hh"
 #include "G4CMPUtils.hh"
 #include "G4Event.hh"
 #include "G4HCofThisEvent.hh"
@@ -22,13 +26,18 @@
 
 
 Caustic_PhononSensitivity::Caustic_PhononSensitivity(G4String name) :
-  G4CMPElectrodeSensitivity(name), fileName("") {
-  SetOutputFile(G4CMP::DebuggingFileThread(Caustic_PhononConfigManager::GetHitOutput()));
+  G4CMPElectrodeSensitivity(name), binaryOutput(0), image(0), fileName("") {
+  // Empty filename turns off hit output (e.g., when only image is wanted)
+  const G4String& hitFile = Caustic_PhononConfigManager::GetHitOutput();
+  if (!hitFile.empty()) SetOutputFile(G4CMP::DebuggingFileThread(hitFile));
 }
 
 
 
 Caustic_PhononSensitivity::~Caustic_PhononSensitivity() {
+  delete binaryOutput; binaryOutput=0;		// Flushes buffered hits
+  DeleteImage();
+
   if (output.is_open()) output.close();
   if (!output.good()) {
     G4cerr << "Error closing output file, " << fileName << ".\n"
@@ -43,7 +52,15 @@ void Caustic_PhononSensitivity::EndOfEvent(G4HCofThisEvent* HCE) {
 
   G4RunManager* runMan = G4RunManager::GetRunManager();
 
-  if (output.good()) {
+  if (image) image->Fill(hitCol);
+
+  if (binaryOutput) {
+    binaryOutput->Write(runMan->GetCurrentRun()->GetRunID(),
+			runMan->GetCurrentEvent()->GetEventID(), hitCol);
+    return;
+  }
+
+  if (output.is_open() && output.good()) {
     // Saving in a txt file the Final Phonon Position.
     for (G4CMPElectrodeHit* hit : *hitVec) {
       output << runMan->GetCurrentEvent()->GetEventID() << '\t'
@@ -56,10 +73,34 @@ void Caustic_PhononSensitivity::EndOfEvent(G4HCofThisEvent* HCE) {
   }
 }
 
+G4CMPHitImage* Caustic_PhononSensitivity::GetImage(G4bool create) {
+  if (!image && create) image = new G4CMPHitImage;
+  return image;
+}
+
+void Caustic_PhononSensitivity::DeleteImage() {
+  delete image; image=0;
+}
+
 void Caustic_PhononSensitivity::SetOutputFile(const G4String &fn) {
   if (fileName != fn) {
     if (output.is_open()) output.close();
+    delete binaryOutput; binaryOutput=0;
     fileName = fn;
+    if (fileName.empty()) return;
+
+    // Compact binary format; use tools/g4cmpHitsToCSV to convert
+    if (G4CMPHitWriter::IsBinaryFile(fileName)) {
+      binaryOutput = new G4CMPHitWriter;
+      if (!binaryOutput->Open(fileName)) {
+	G4ExceptionDescription msg;
+	msg << "Error opening output file " << fileName;
+	G4Exception("PhononSensitivity::SetOutputFile", "PhonSense003",
+		    FatalException, msg);
+      }
+      return;
+    }
+
     output.open(fileName, std::ios_base::app);
     if (!output.good()) {
       G4ExceptionDescription msg;
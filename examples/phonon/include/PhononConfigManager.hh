@@ -15,6 +15,7 @@
 //		changed via macro commands (see PhononConfigMessenger).
 //
 // 20170816  M. Kelsey -- Extract hit filename from G4CMPConfigManager.
+// 20261019  Add flag to write binary hits file in event order.
 
 #include "globals.hh"
 
@@ -28,11 +29,15 @@ public:
 
   // Access current values
   static const G4String& GetHitOutput()  { return Instance()->Hit_file; }
+  static G4bool GetHitsOrdered()         { return Instance()->Hits_ordered; }
 
   // Change values (e.g., via Messenger)
   static void SetHitOutput(const G4String& name)
     { Instance()->Hit_file=name; UpdateGeometry(); }
 
+  static void SetHitsOrdered(G4bool value)
+    { Instance()->Hits_ordered=value; UpdateGeometry(); }
+
   static void UpdateGeometry();
 
 private:
@@ -46,6 +51,7 @@ private:
 
 private:
   G4String Hit_file;	// Output file of e/h hits ($G4CMP_HIT_FILE)
+  G4bool Hits_ordered;	// Binary hits in event order ($G4CMP_HITS_ORDERED)
 
   PhononConfigMessenger* messenger;
 };
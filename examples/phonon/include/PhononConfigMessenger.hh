@@ -13,10 +13,12 @@
 //		PhononConfigManager.
 //
 // 20170816  Michael Kelsey
+// 20261019  Add command to write binary hits file in event order.
 
 #include "G4UImessenger.hh"
 
 class PhononConfigManager;
+class G4UIcmdWithABool;
 class G4UIcmdWithAString;
 class G4UIcommand;
 
@@ -31,6 +33,7 @@ public:
 private:
   PhononConfigManager* theManager;
   G4UIcmdWithAString* hitsCmd;
+  G4UIcmdWithABool* orderedCmd;
 
 private:
   PhononConfigMessenger(const PhononConfigMessenger&);	// Copying is forbidden
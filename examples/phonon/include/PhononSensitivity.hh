@@ -8,6 +8,8 @@
 
 #include "G4CMPElectrodeSensitivity.hh"
 
+class G4CMPOutputService;
+
 class PhononSensitivity final : public G4CMPElectrodeSensitivity {
 public:
   PhononSensitivity(G4String name);
@@ -32,6 +34,7 @@ protected:
 
 private:
   std::ofstream output;
+  G4CMPOutputService* binaryOutput;	// Shared; for files ending in ".bin"
   G4String fileName;
 };
 
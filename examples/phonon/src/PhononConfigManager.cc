@@ -12,6 +12,7 @@
 //		changed via macro commands (see PhononConfigMessenger).
 //
 // 20170816  M. Kelsey -- Extract hit filename from G4CMPConfigManager.
+// 20261019  Add flag to write binary hits file in event order.
 
 #include "PhononConfigManager.hh"
 #include "PhononConfigMessenger.hh"
@@ -30,6 +31,7 @@ PhononConfigManager* PhononConfigManager::Instance() {
 
 PhononConfigManager::PhononConfigManager()
   : Hit_file(getenv("G4CMP_HIT_FILE")?getenv("G4CMP_HIT_FILE"):"phonon_hits.txt"),
+    Hits_ordered(getenv("G4CMP_HITS_ORDERED")!=0),
     messenger(new PhononConfigMessenger(this)) {;}
 
 PhononConfigManager::~PhononConfigManager() {
@@ -10,9 +10,11 @@
 //		PhononConfigManager.
 //
 // 20170816  Michael Kelsey
+// 20261019  Add command to write binary hits file in event order.
 
 #include "PhononConfigMessenger.hh"
 #include "PhononConfigManager.hh"
+#include "G4UIcmdWithABool.hh"
 #include "G4UIcmdWithAString.hh"
 
 
@@ -20,14 +22,20 @@
 
 PhononConfigMessenger::PhononConfigMessenger(PhononConfigManager* mgr)
   : G4UImessenger("/g4cmp/", "User configuration for G4CMP phonon example"),
-    theManager(mgr), hitsCmd(0) {
+    theManager(mgr), hitsCmd(0), orderedCmd(0) {
   hitsCmd = CreateCommand<G4UIcmdWithAString>("HitsFile",
 			      "Set filename for output of phonon hit locations");
+
+  orderedCmd = CreateCommand<G4UIcmdWithABool>("HitsOrdered",
+		"Write binary (.bin) hits file in event order");
+  orderedCmd->SetParameterName("ordered",true,false);
+  orderedCmd->SetDefaultValue(true);
 }
 
 
 PhononConfigMessenger::~PhononConfigMessenger() {
   delete hitsCmd; hitsCmd=0;
+  delete orderedCmd; orderedCmd=0;
 }
 
 
@@ -35,4 +43,5 @@ PhononConfigMessenger::~PhononConfigMessenger() {
 
 void PhononConfigMessenger::SetNewValue(G4UIcommand* cmd, G4String value) {
   if (cmd == hitsCmd) theManager->SetHitOutput(value);
+  if (cmd == orderedCmd) theManager->SetHitsOrdered(StoB(value));
 }
@@ -5,6 +5,8 @@
 
 #include "PhononSensitivity.hh"
 #include "G4CMPElectrodeHit.hh"
+#include "G4CMPHitWriter.hh"
+#include "G4CMPOutputService.hh"
 #include "G4Event.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4PhononLong.hh"
@@ -19,7 +21,7 @@
 
 
 PhononSensitivity::PhononSensitivity(G4String name) :
-  G4CMPElectrodeSensitivity(name), fileName("") {
+  G4CMPElectrodeSensitivity(name), binaryOutput(0), fileName("") {
   SetOutputFile(PhononConfigManager::GetHitOutput());
 }
 
@@ -44,6 +46,10 @@ PhononSensitivity& PhononSensitivity::operator=(PhononSensitivity&& in) {
 */
 
 PhononSensitivity::~PhononSensitivity() {
+  // Service is shared, closed at end of job; ordered output must not wait
+  if (binaryOutput) binaryOutput->RemoveProducer();
+  binaryOutput=0;
+
   if (output.is_open()) output.close();
   if (!output.good()) {
     G4cerr << "Error closing output file, " << fileName << ".\n"
@@ -57,11 +63,18 @@ void PhononSensitivity::EndOfEvent(G4HCofThisEvent* HCE) {
   std::vector<G4CMPElectrodeHit*>* hitVec = hitCol->GetVector();
 
   G4RunManager* runMan = G4RunManager::GetRunManager();
+  G4int runID = runMan->GetCurrentRun()->GetRunID();
+  G4int eventID = runMan->GetCurrentEvent()->GetEventID();
+
+  if (binaryOutput) {
+    binaryOutput->Write(runID, eventID, hitCol);
+    return;
+  }
 
   if (output.good()) {
     for (G4CMPElectrodeHit* hit : *hitVec) {
-      output << runMan->GetCurrentRun()->GetRunID() << ','
-             << runMan->GetCurrentEvent()->GetEventID() << ','
+      output << runID << ','
+             << eventID << ','
              << hit->GetTrackID() << ','
              << hit->GetParticleName() << ','
              << hit->GetStartEnergy()/eV << ','
@@ -82,7 +95,25 @@ void PhononSensitivity::EndOfEvent(G4HCofThisEvent* HCE) {
 void PhononSensitivity::SetOutputFile(const G4String &fn) {
   if (fileName != fn) {
     if (output.is_open()) output.close();
+    if (binaryOutput) binaryOutput->RemoveProducer();
+    binaryOutput=0;
     fileName = fn;
+
+    // Compact binary format, one file written by a background thread for
+    // all worker threads; use tools/g4cmpHitsToCSV to convert
+    if (G4CMPHitWriter::IsBinaryFile(fileName)) {
+      binaryOutput = G4CMPOutputService::GetService(fileName);
+      binaryOutput->SetEventOrdered(PhononConfigManager::GetHitsOrdered());
+      binaryOutput->AddProducer();
+      if (!binaryOutput->IsOpen()) {
+        G4ExceptionDescription msg;
+        msg << "Error opening output file " << fileName;
+        G4Exception("PhononSensitivity::SetOutputFile", "PhonSense003",
+                    FatalException, msg);
+      }
+      return;
+    }
+
     output.open(fileName, std::ios_base::app);
     if (!output.good()) {
       G4ExceptionDescription msg;
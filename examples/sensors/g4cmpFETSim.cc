@@ -3,7 +3,16 @@
  * License version 3 or later. See G4CMP/LICENSE for the full license. *
 \***********************************************************************/
 
+// Usage: g4cmpFETSim [hitsFile] [outputFile] [nThreads] [format]
+//
+// Events in hitsFile are digitized on nThreads worker threads (default,
+// or zero, uses all available cores).  Traces are written in the given
+// format, "csv", "float" or "int16"; the default is "float" for output
+// files ending in ".bin", otherwise "csv".  Use g4cmpFETToCSV to convert
+// binary output.
+
 #include "ChargeFETDigitizerModule.hh"
+#include <stdlib.h>
 
 int main(int argc, char** argv) {
   G4String filename;
@@ -21,6 +30,16 @@ int main(int argc, char** argv) {
     fetsim.SetOutputFile("FETOutput");
   }
 
+  if (argc > 3) fetsim.SetNumberOfThreads(atoi(argv[3]));
+
+  if (argc > 4) {
+    fetsim.SetOutputFormat(argv[4]);
+  } else {
+    const G4String& out = fetsim.GetOutputFile();
+    if (out.size() > 4 && out.compare(out.size()-4, 4, ".bin") == 0)
+      fetsim.SetOutputFormat("float");
+  }
+
   fetsim.Build();
   fetsim.PostProcess(filename);
 
@@ -0,0 +1,126 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: g4cmpFETToCSV <traces.bin> [traces.csv]
+//
+// Convert binary FET traces from ChargeFETTraceWriter to the CSV format
+// written by ChargeFETDigitizerModule (one line per channel per event).
+// Output goes to standard output if no CSV file is given.  Integer
+// samples are multiplied by the scale factor in the file header.
+
+#include "ChargeFETTraceWriter.hh"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <stdlib.h>
+using namespace std;
+
+
+// Read one value or array of known type from file
+
+template <class T> bool readValue(istream& in, T& value) {
+  return (bool)in.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+template <class T> bool readArray(istream& in, vector<T>& values, size_t n) {
+  values.resize(n);
+  return n==0 || (bool)in.read(reinterpret_cast<char*>(values.data()),
+                               n*sizeof(T));
+}
+
+
+int main(int argc, const char* argv[]) {
+  if (argc < 2) {
+    cerr << "Usage: " << argv[0] << " <traces.bin> [traces.csv]" << endl;
+    ::exit(1);
+  }
+
+  ifstream input(argv[1], ios::binary);
+  if (!input.good()) {
+    cerr << argv[0] << ": unable to open " << argv[1] << endl;
+    ::exit(1);
+  }
+
+  ofstream outfile;
+  if (argc > 2) {
+    outfile.open(argv[2], ios::trunc);
+    if (!outfile.good()) {
+      cerr << argv[0] << ": unable to open " << argv[2] << endl;
+      ::exit(1);
+    }
+  }
+  ostream& output = (argc > 2) ? outfile : cout;
+
+  // Validate file header
+  char magic[sizeof(ChargeFETTraceWriter::kMagic)];
+  uint32_t version=0, sampleSize=0, nChannels=0, nBins=0;
+  double dt=0., scale=1.;
+  input.read(magic, sizeof(magic));
+  readValue(input, version);
+  readValue(input, sampleSize);
+  readValue(input, nChannels);
+  readValue(input, nBins);
+  readValue(input, dt);
+  readValue(input, scale);
+
+  if (!input.good() ||
+      memcmp(magic, ChargeFETTraceWriter::kMagic, sizeof(magic))) {
+    cerr << argv[1] << " is not a G4CMP FET trace file" << endl;
+    ::exit(2);
+  }
+
+  if (version != ChargeFETTraceWriter::kVersion ||
+      (sampleSize != ChargeFETTraceWriter::kInt16 &&
+       sampleSize != ChargeFETTraceWriter::kFloat32)) {
+    cerr << argv[1] << " has unsupported version " << version
+         << " or sample size " << sampleSize << " (byte-swapped file?)" << endl;
+    ::exit(2);
+  }
+
+  cerr << argv[1] << ": " << nChannels << " channels, " << nBins
+       << " bins of " << dt << " ns" << endl;
+
+  output << "Run ID,Event ID,Channel,Pulse (" << nBins << " bins)\n";
+
+  // Events, each with all channels
+  const size_t nSamples = size_t(nChannels)*nBins;
+  vector<float> fvals;
+  vector<int16_t> ivals;
+  int32_t runID=0, eventID=0;
+  size_t nEvents = 0;
+
+  while (readValue(input, runID)) {
+    bool good = readValue(input, eventID);
+    if (sampleSize == ChargeFETTraceWriter::kFloat32)
+      good = good && readArray(input, fvals, nSamples);
+    else
+      good = good && readArray(input, ivals, nSamples);
+
+    if (!good) {
+      cerr << argv[1] << ": truncated event after " << nEvents << " events"
+           << endl;
+      ::exit(3);
+    }
+
+    for (uint32_t chan=0; chan<nChannels; chan++) {
+      output << runID << ',' << eventID << ',' << chan+1;
+      for (size_t i=chan*nBins; i<(chan+1)*nBins; i++) {
+        output << ',';
+        if (sampleSize == ChargeFETTraceWriter::kFloat32) output << fvals[i];
+        else output << ivals[i]*scale;
+      }
+      output << '\n';
+    }
+
+    nEvents++;
+  }
+
+  cerr << argv[0] << ": converted " << nEvents << " events" << endl;
+
+  return 0;
+}
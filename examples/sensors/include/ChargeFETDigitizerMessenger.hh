@@ -13,6 +13,7 @@ class G4UIdirectory;
 class G4UIcmdWithoutParameter;
 class G4UIcmdWithAString;
 class G4UIcmdWithAnInteger;
+class G4UIcmdWithADouble;
 class G4UIcmdWithADoubleAndUnit;
 class G4UIcmdWithABool;
 
@@ -30,6 +31,10 @@ class ChargeFETDigitizerMessenger : public G4UImessenger
     G4UIcmdWithoutParameter*   GetEnabledStateCmd;
     G4UIcmdWithAString*        SetOutputFileCmd;
     G4UIcmdWithoutParameter*   GetOutputFileCmd;
+    G4UIcmdWithAString*        SetOutputFormatCmd;
+    G4UIcmdWithoutParameter*   GetOutputFormatCmd;
+    G4UIcmdWithADouble*        SetTraceScaleCmd;
+    G4UIcmdWithoutParameter*   GetTraceScaleCmd;
     G4UIcmdWithAString*        SetConfigFileCmd;
     G4UIcmdWithoutParameter*   GetConfigFileCmd;
     G4UIcmdWithAString*        SetTemplateFileCmd;
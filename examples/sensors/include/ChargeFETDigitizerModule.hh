@@ -6,6 +6,7 @@
 #ifndef CHARGEFETDIGITIZERMODULE_HH
 #define CHARGEFETDIGITIZERMODULE_HH
 
+#include "ChargeFETTraceWriter.hh"
 #include "G4VDigitizerModule.hh"
 #include <fstream>
 
@@ -26,6 +27,10 @@ class ChargeFETDigitizerModule : public G4VDigitizerModule
 
     void Build();
     virtual void Digitize();
+
+    // Digitize each event in hits file (CSV, as written by charge example)
+    // Events are read in blocks, and digitized in parallel if numThreads
+    // is not 1; traces are written in file order.
     void PostProcess(const G4String& fileName);
 
     // Methods for Messenger
@@ -36,6 +41,14 @@ class ChargeFETDigitizerModule : public G4VDigitizerModule
     void     SetOutputFile(const G4String& name);
     G4String GetOutputFile() const {return outputFilename;}
 
+    // Trace output as "csv" text, or binary "float" or "int16" samples
+    void     SetOutputFormat(const G4String& name);
+    G4String GetOutputFormat() const;
+
+    // Trace value for each int16 count
+    void     SetTraceScale(G4double value);
+    G4double GetTraceScale() const {return traceWriter.GetScale();}
+
     void     SetConfigFilename(const G4String& name);
     G4String GetConfigFilename() const {return configFilename;}
 
@@ -60,13 +73,31 @@ class ChargeFETDigitizerModule : public G4VDigitizerModule
     void     SetPreTrig(G4double n);
     G4double GetPreTrig() const {return preTrig;}
 
+    // Worker threads for PostProcess(); zero uses all available cores
+    void     SetNumberOfThreads(size_t n) {numThreads = n;}
+    size_t   GetNumberOfThreads() const {return numThreads;}
+
   private:
     void ReadFETConstantsFile();
     void BuildFETTemplates();
-    vector<vector<G4double> > CalculateTraces(const vector<G4double>& scaleFactors);
+    // Templates in file order, [chan][cross][bin]; text file is cached
+    G4bool ReadFETTemplates(vector<G4double>& templates) const;
+    G4bool ReadFETTemplateCache(vector<G4double>& templates) const;
+    void   WriteFETTemplateCache(const vector<G4double>& templates) const;
+    void   SetFETTemplates(const vector<G4double>& templates);
+    // Scale factors are padded with zeros to templateStride
+    void CalculateScaleFactors(const vector<G4double>& charges,
+                               const vector<G4double>& positions,
+                               vector<G4double>& scaleFactors) const;
+    // Fills numChannels*timeBins values, channel by channel
+    void CalculateTraces(const vector<G4double>& scaleFactors,
+                         G4double* FETTraces) const;
     void BuildRamoFields();
-    void WriteFETTraces(const vector<vector<G4double> >& FETTraces,
-                        G4int RunID, G4int EventID);
+    void WriteFETTraces(const G4double* FETTraces, G4int RunID, G4int EventID);
+
+    // Template rows are padded to SIMD width (doubles) and aligned
+    static const size_t kSimdWidth = 4;
+    static const size_t kAlignment = 64;
 
     ChargeFETDigitizerMessenger* messenger;
     // FET constants
@@ -75,6 +106,8 @@ class ChargeFETDigitizerModule : public G4VDigitizerModule
     G4double preTrig;
     size_t numChannels;
     size_t timeBins;
+    // Worker threads for post-processing
+    size_t numThreads;
     // Enable/Disable FETSim during sim
     G4bool enabledForSD;
     // Internal flags to not waste time on unnecessary recalculating
@@ -82,15 +115,22 @@ class ChargeFETDigitizerModule : public G4VDigitizerModule
     G4bool rebuildFETTemplates;
     G4bool rebuildRamoFields;
     // File Stuff
-    std::ofstream outputFile;
+    ChargeFETTraceWriter traceWriter;
     std::ifstream constantsFile;
-    std::ifstream templateFile;
     G4String outputFilename;
     G4String configFilename;
     G4String templateFilename;
     G4String ramoFileDir;
     // FETSim Quantities
-    vector<vector<vector<G4double> > > FETTemplates; //4x4x4096 = 4 channels w/ cross-talk terms
+    // Templates are [chan][bin][cross], each bin's cross-talk terms padded
+    // to templateStride and aligned, so that traces are a small matrix
+    // times vector product per bin.  Templates with no cross-talk (e.g.,
+    // the default) are kept as [chan][bin] diagonal pulses instead.
+    vector<G4double> templateStore;     // Includes space for alignment
+    const G4double* FETTemplates;       // Aligned start in templateStore
+    size_t templateStride;
+    G4bool diagonalTemplates;
+    size_t firstTemplateBin;            // Bins before this are zero
     vector<G4CMPMeshElectricField> RamoFields;
 };
 
@@ -0,0 +1,100 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Writes FET traces from ChargeFETDigitizerModule, either as CSV text
+// (one line per channel) or in a compact binary format:
+//
+//   Header:  char[8]  "G4CMPFET"
+//            uint32   format version (kVersion); also detects byte order
+//            uint32   sample type (2 = int16, 4 = float32)
+//            uint32   number of channels
+//            uint32   number of time bins
+//            float64  time bin width [ns]
+//            float64  scale; trace value is sample * scale
+//
+//   Event:   int32    run ID
+//            int32    event ID
+//            samples  channels * time bins, channel by channel
+//
+// Events are encoded into a reused buffer, which is written to the file
+// when full, or on Flush() or Close().  The file is opened for appending
+// on the first Write(); an existing binary file must have a matching
+// header.  Use g4cmpFETToCSV to convert binary files to CSV.
+
+#ifndef CHARGEFETTRACEWRITER_HH
+#define CHARGEFETTRACEWRITER_HH 1
+
+#include "globals.hh"
+#include <fstream>
+#include <stdint.h>
+#include <vector>
+
+class ChargeFETTraceWriter
+{
+  public:
+    // Binary formats are identified by sample size
+    enum Format { kCSV=0, kInt16=2, kFloat32=4 };
+
+    static const char     kMagic[8];        // "G4CMPFET", no terminator
+    static const uint32_t kVersion = 1;
+
+    // Format names are "csv", "int16", "float"
+    static Format      GetFormat(const G4String& name);
+    static const char* GetFormatName(Format format);
+
+    ChargeFETTraceWriter(size_t bufferBytes=1<<22);
+    virtual ~ChargeFETTraceWriter();
+
+    // Changing any setting closes the file; it is reopened on next Write()
+    void     SetFileName(const G4String& name);
+    const G4String& GetFileName() const {return fileName;}
+
+    void     SetFormat(Format fmt);
+    Format   GetFormat() const {return format;}
+
+    void     SetScale(G4double value);     // Trace value per int16 count
+    G4double GetScale() const {return scale;}
+
+    void     SetShape(size_t channels, size_t bins, G4double binWidth);
+    size_t   GetNumberOfChannels() const {return numChannels;}
+    size_t   GetTimeBins() const {return timeBins;}
+
+    // Traces are channels * time bins values, channel by channel
+    void Write(G4int runID, G4int eventID, const G4double* traces);
+    void Flush();
+    void Close();
+
+    G4bool IsOpen() const {return output.is_open();}
+    G4bool good() const {return !failed;}
+
+  private:
+    G4bool Open();
+    G4bool CheckHeader(std::ifstream& existing) const;
+    void   WriteHeader();
+    void   EncodeCSV(G4int runID, G4int eventID, const G4double* traces);
+    void   EncodeBinary(G4int runID, G4int eventID, const G4double* traces);
+
+    template <class T> void AppendBytes(const T& value) {
+      const char* bytes = reinterpret_cast<const char*>(&value);
+      buffer.insert(buffer.end(), bytes, bytes+sizeof(T));
+    }
+
+    G4String fileName;
+    Format   format;
+    G4double scale;
+    size_t   numChannels;
+    size_t   timeBins;
+    G4double dt;
+    G4bool   failed;                        // Don't retry until changed
+
+    std::ofstream     output;
+    std::vector<char> buffer;               // Encoded events not yet written
+    size_t            bufferSize;
+
+    ChargeFETTraceWriter(const ChargeFETTraceWriter&) = delete;
+    ChargeFETTraceWriter& operator=(const ChargeFETTraceWriter&) = delete;
+};
+
+#endif // CHARGEFETTRACEWRITER_HH
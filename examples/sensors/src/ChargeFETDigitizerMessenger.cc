@@ -9,6 +9,7 @@
 #include "G4UIcmdWithoutParameter.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADouble.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
 #include "G4UIcmdWithABool.hh"
 
@@ -33,6 +34,21 @@ ChargeFETDigitizerMessenger::ChargeFETDigitizerMessenger(
   GetOutputFileCmd = new G4UIcmdWithoutParameter("/g4cmp/FETSim/GetOutputFile",this);
   GetOutputFileCmd->SetGuidance("Current path to FET output file.");
 
+  SetOutputFormatCmd = new G4UIcmdWithAString("/g4cmp/FETSim/SetOutputFormat",this);
+  SetOutputFormatCmd->SetGuidance("Write traces as CSV text, or binary float or int16 samples.");
+  SetOutputFormatCmd->SetCandidates("csv float int16");
+
+  GetOutputFormatCmd = new G4UIcmdWithoutParameter("/g4cmp/FETSim/GetOutputFormat",this);
+  GetOutputFormatCmd->SetGuidance("Current FET output format.");
+
+  SetTraceScaleCmd = new G4UIcmdWithADouble("/g4cmp/FETSim/SetTraceScale",this);
+  SetTraceScaleCmd->SetGuidance("Set trace value for each count in int16 output.");
+  SetTraceScaleCmd->SetParameterName("scale",false);
+  SetTraceScaleCmd->SetRange("scale>0");
+
+  GetTraceScaleCmd = new G4UIcmdWithoutParameter("/g4cmp/FETSim/GetTraceScale",this);
+  GetTraceScaleCmd->SetGuidance("Trace value for each count in int16 output.");
+
   SetConfigFileCmd = new G4UIcmdWithAString("/g4cmp/FETSim/SetConfigFile",this);
   SetConfigFileCmd->SetGuidance("Set path to FET config file.");
 
@@ -93,6 +109,10 @@ ChargeFETDigitizerMessenger::~ChargeFETDigitizerMessenger()
     delete GetEnabledStateCmd;
     delete SetOutputFileCmd;
     delete GetOutputFileCmd;
+    delete SetOutputFormatCmd;
+    delete GetOutputFormatCmd;
+    delete SetTraceScaleCmd;
+    delete GetTraceScaleCmd;
     delete SetConfigFileCmd;
     delete GetConfigFileCmd;
     delete SetTemplateFileCmd;
@@ -122,6 +142,14 @@ void ChargeFETDigitizerMessenger::SetNewValue(G4UIcommand* command, G4String New
     fet->SetOutputFile(NewValue);
   else if (command == GetOutputFileCmd)
     fet->GetOutputFile();
+  else if (command == SetOutputFormatCmd)
+    fet->SetOutputFormat(NewValue);
+  else if (command == GetOutputFormatCmd)
+    fet->GetOutputFormat();
+  else if (command == SetTraceScaleCmd)
+    fet->SetTraceScale(SetTraceScaleCmd->ConvertToDouble(NewValue));
+  else if (command == GetTraceScaleCmd)
+    fet->GetTraceScale();
   else if (command == SetConfigFileCmd)
     fet->SetConfigFilename(NewValue);
   else if (command == GetConfigFileCmd)
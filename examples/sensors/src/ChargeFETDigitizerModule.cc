@@ -7,6 +7,7 @@
 #include "ChargeFETDigitizerMessenger.hh"
 #include "G4CMPElectrodeHit.hh"
 #include "G4CMPMeshElectricField.hh"
+#include "G4CMPVMeshInterpolator.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4VDigitizerModule.hh"
 #include "G4String.hh"
@@ -14,35 +15,164 @@
 #include "G4SDManager.hh"
 #include "G4Run.hh"
 #include "G4Event.hh"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
 #include <sstream>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <thread>
+
+
+namespace {
+  // Hits from one event; only charge carriers are kept
+  struct FETEventHits {
+    FETEventHits() : runID(0), eventID(0) {}
+    void clear() { charge.clear(); position.clear(); }
+
+    G4int runID;
+    G4int eventID;
+    vector<G4double> charge;            // -1 for electrons, +1 for holes
+    vector<G4double> position;          // Final x,y,z of each hit
+  };
+
+  // Reads CSV hits file in large blocks, parsing lines in place
+  class FETHitFileReader {
+  public:
+    FETHitFileReader(const G4String& fileName, size_t blockSize=1<<24);
+
+    G4bool good() const { return input.is_open() && !input.bad(); }
+
+    // Fill all hits from next event in file; false at end of file
+    G4bool NextEvent(FETEventHits& evt);
+
+  private:
+    G4bool ReadRow();
+    G4bool NextLine(const char*& line, const char*& lineEnd);
+    void FillBuffer();
+    void ParseHeader(const char* line, const char* lineEnd);
+    G4bool ParseRow(const char* line, const char* lineEnd);
+
+    std::ifstream input;
+    vector<char> buffer;
+    size_t begin, end;                  // Unparsed data in buffer
+    G4bool atEOF;
+
+    // Column positions, taken from header if present
+    size_t runCol, eventCol, nameCol, xCol;
+
+    struct {                            // Last row read
+      G4int runID, eventID;
+      G4double charge;
+      G4double position[3];
+    } row;
+    G4bool havePending;                 // Row not yet added to an event
+  };
+
+  // Cache is the template values in file order, after a header identifying
+  // the text file (by size and modification time) and table shape
+  const char kTemplateCacheMagic[8] = {'G','4','C','M','P','F','T','C'};
+  const uint32_t kTemplateCacheVersion = 1;
+
+  struct FETTemplateCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t numChannels;
+    uint64_t timeBins;
+    uint64_t fileSize;
+    int64_t fileTime;
+  };
+
+  G4bool FillTemplateCacheHeader(const G4String& fileName, size_t nChan,
+                                 size_t nBins, FETTemplateCacheHeader& hdr) {
+    struct stat info;
+    if (stat(fileName.c_str(), &info) != 0) return false;
+
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, kTemplateCacheMagic, sizeof(hdr.magic));
+    hdr.version = kTemplateCacheVersion;
+    hdr.numChannels = nChan;
+    hdr.timeBins = nBins;
+    hdr.fileSize = info.st_size;
+    hdr.fileTime = info.st_mtime;
+    return true;
+  }
+
+  // Batch of consecutive events, digitized together by one worker
+  struct FETEventBatch {
+    FETEventBatch(size_t seq) : sequence(seq) {}
+
+    size_t sequence;
+    vector<FETEventHits> events;
+    vector<G4double> traces;            // All events, channel by channel
+  };
+
+  // Hands batches to worker threads and back for output in sequence
+  class FETBatchQueue {
+  public:
+    FETBatchQueue() : nSubmitted(0), nReturned(0), finished(false) {}
+
+    size_t InFlight() {
+      std::lock_guard<std::mutex> l(mtx);
+      return nSubmitted - nReturned;
+    }
+
+    // Reader: add next batch (batches must be submitted in sequence)
+    void Submit(FETEventBatch* batch);
+    void Finish();                      // No more batches will be added
+
+    // Worker threads: next batch to digitize, or null when finished
+    FETEventBatch* Take();
+    void Done(FETEventBatch* batch);
+
+    // Reader: next batch in sequence, or null if not done (and no wait)
+    FETEventBatch* NextResult(G4bool wait);
+
+  private:
+    std::mutex mtx;
+    std::condition_variable workReady;
+    std::condition_variable resultReady;
+    std::deque<FETEventBatch*> work;
+    std::map<size_t, FETEventBatch*> results;
+    size_t nSubmitted, nReturned;
+    G4bool finished;
+  };
+}
 
 ChargeFETDigitizerModule::ChargeFETDigitizerModule(G4String modName) :
   G4VDigitizerModule(modName), messenger(new ChargeFETDigitizerMessenger(this)),
   decayTime(40e-6*s), dt(800e-9*s), preTrig(4096e-7*s), numChannels(4),
-  timeBins(4096), enabledForSD(false), rereadConfigFile(true),
-  rebuildFETTemplates(true), rebuildRamoFields(true),
+  timeBins(4096), numThreads(0), enabledForSD(false),
+  rereadConfigFile(true), rebuildFETTemplates(true), rebuildRamoFields(true),
   outputFilename("FETOutput"),
   configFilename("config/G4CMP/FETSim/ConstantsFET"),
   templateFilename("config/G4CMP/FETSim/FETTemplates"),
-  ramoFileDir("config/G4CMP/FETSim")
+  ramoFileDir("config/G4CMP/FETSim"), FETTemplates(0), templateStride(1),
+  diagonalTemplates(true), firstTemplateBin(0)
 {}
 
 ChargeFETDigitizerModule::ChargeFETDigitizerModule() :
   G4VDigitizerModule("NoSim"), messenger(nullptr),
   decayTime(40e-6*s), dt(800e-9*s), preTrig(4096e-7*s), numChannels(4),
-  timeBins(4096), enabledForSD(false), rereadConfigFile(true),
-  rebuildFETTemplates(true), rebuildRamoFields(true),
+  timeBins(4096), numThreads(0), enabledForSD(false),
+  rereadConfigFile(true), rebuildFETTemplates(true), rebuildRamoFields(true),
   outputFilename("FETOutput"),
   configFilename("config/G4CMP/FETSim/ConstantsFET"),
   templateFilename("config/G4CMP/FETSim/FETTemplates"),
-  ramoFileDir("config/G4CMP/FETSim")
+  ramoFileDir("config/G4CMP/FETSim"), FETTemplates(0), templateStride(1),
+  diagonalTemplates(true), firstTemplateBin(0)
 {}
 
 ChargeFETDigitizerModule::~ChargeFETDigitizerModule()
 {
   delete messenger;
-  if (outputFile.is_open()) outputFile.close();
-  if (!outputFile.good()) {
+  traceWriter.Close();
+  if (!traceWriter.good()) {
     G4ExceptionDescription msg;
     msg << "Error closing output file, " << outputFilename << ".\n"
         << "Expect bad things like loss of data.";
@@ -53,13 +183,14 @@ ChargeFETDigitizerModule::~ChargeFETDigitizerModule()
 
 void ChargeFETDigitizerModule::Build()
 {
-  SetOutputFile(outputFilename);
   if (rereadConfigFile)
     ReadFETConstantsFile();
   if (rebuildFETTemplates)
     BuildFETTemplates();
   if (rebuildRamoFields)
     BuildRamoFields();
+  traceWriter.SetFileName(outputFilename);
+  traceWriter.SetShape(numChannels, timeBins, dt);
 }
 
 void ChargeFETDigitizerModule::Digitize()
@@ -73,104 +204,182 @@ void ChargeFETDigitizerModule::Digitize()
     static_cast<G4CMPElectrodeHitsCollection*>(HCE->GetHC(HCID));
   vector<G4CMPElectrodeHit*>* hitVec = hitCol->GetVector();
 
-  vector<G4double> scaleFactors(numChannels,0);
-  G4double position[4] = {0.,0.,0.,0.};
-  G4ThreeVector vecPosition;
-  for(size_t chan = 0; chan < numChannels; ++chan) {
-    for(size_t hitIdx=0; hitIdx < hitVec->size(); ++hitIdx) {
-      if(hitVec->at(hitIdx)->GetParticleName()=="G4CMPDriftElectron" ||
-         hitVec->at(hitIdx)->GetParticleName()=="G4CMPDriftHole") {
-        vecPosition = hitVec->at(hitIdx)->GetFinalPosition();
-        position[0] = vecPosition.getX();
-        position[1] = vecPosition.getY();
-        position[2] = vecPosition.getZ();
-        if(hitVec->at(hitIdx)->GetParticleName()=="G4CMPDriftElectron")
-          scaleFactors[chan] -= -1 * RamoFields[chan].GetPotential(position);
-        else
-          scaleFactors[chan] -= 1 * RamoFields[chan].GetPotential(position);
-      }
+  vector<G4double> charges;
+  vector<G4double> positions;
+  for(size_t hitIdx=0; hitIdx < hitVec->size(); ++hitIdx) {
+    const G4String& name = hitVec->at(hitIdx)->GetParticleName();
+    if(name=="G4CMPDriftElectron" || name=="G4CMPDriftHole") {
+      charges.push_back(name=="G4CMPDriftElectron" ? -1. : 1.);
+      const G4ThreeVector& vecPosition = hitVec->at(hitIdx)->GetFinalPosition();
+      positions.push_back(vecPosition.getX());
+      positions.push_back(vecPosition.getY());
+      positions.push_back(vecPosition.getZ());
     }
   }
 
-  vector<vector<G4double> > FETTraces(CalculateTraces(scaleFactors));
+  vector<G4double> scaleFactors;
+  CalculateScaleFactors(charges, positions, scaleFactors);
+  vector<G4double> FETTraces(numChannels*timeBins);
+  CalculateTraces(scaleFactors, FETTraces.data());
   G4int runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
   G4int eventID = G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
-  WriteFETTraces(FETTraces, runID, eventID);
+  WriteFETTraces(FETTraces.data(), runID, eventID);
 }
 
 void ChargeFETDigitizerModule::PostProcess(const G4String& fileName)
 {
-  std::ifstream input(fileName);
+  FETHitFileReader input(fileName);
   if (!input.good()) {
     G4ExceptionDescription msg;
     msg << "Error reading data input file from " << fileName;
     G4Exception("ChargeFETDigitizerModule::PostProcess", "Charge002",
     FatalException, msg);
   }
-  G4double throw_away;
-  G4String particleName;
-  G4double position[4] = {0.,0.,0.,0.};
-  G4double charge;
-  G4int RunID, EventID;
-  vector<G4double> scaleFactors(numChannels,0);
-
-  G4String line;
-  G4String entry;
-  std::getline(input, line); //Grab column headers first
-  while (!std::getline(input, line).eof()) {
-    std::istringstream ssLine(line);
-
-    std::getline(ssLine,entry,',');
-    std::istringstream(entry) >> RunID;
-
-    std::getline(ssLine,entry,',');
-    std::istringstream(entry) >> EventID;
-
-    std::getline(ssLine,entry,',');
-    std::istringstream(entry) >> throw_away;
-
-    std::getline(ssLine,entry,',');
-    std::istringstream(entry) >> particleName;
-
-    for (size_t i=0; i<6; ++i) {
-      std::getline(ssLine,entry,',');
-      std::istringstream(entry) >> throw_away;
+
+  size_t nThreads = numThreads;
+  if (nThreads == 0) nThreads = std::thread::hardware_concurrency();
+#ifndef G4MULTITHREADED
+  nThreads = 1;   // Mesh search caches are not thread-local in this build
+#endif
+
+  const size_t traceSize = numChannels*timeBins;
+
+  if (nThreads <= 1) {
+    FETEventHits evt;
+    vector<G4double> scaleFactors;
+    vector<G4double> traces(traceSize);
+    while (input.NextEvent(evt)) {
+      CalculateScaleFactors(evt.charge, evt.position, scaleFactors);
+      CalculateTraces(scaleFactors, traces.data());
+      WriteFETTraces(traces.data(), evt.runID, evt.eventID);
     }
+    traceWriter.Flush();
+    return;
+  }
 
-    for (size_t i=0; i<3; ++i) {
-      std::getline(ssLine,entry,',');
-      std::istringstream(entry) >> position[i];
-      position[i] *= m;
+  // Workers share the Ramo fields; each thread has its own search index
+  FETBatchQueue queue;
+  auto worker = [this, &queue, traceSize]() {
+    for (size_t i=0; i<RamoFields.size(); ++i)
+      RamoFields[i].GetInterpolator()->Initialize();
+
+    vector<G4double> scaleFactors;
+    while (FETEventBatch* batch = queue.Take()) {
+      batch->traces.resize(batch->events.size()*traceSize);
+      for (size_t i=0; i<batch->events.size(); ++i) {
+        const FETEventHits& evt = batch->events[i];
+        CalculateScaleFactors(evt.charge, evt.position, scaleFactors);
+        CalculateTraces(scaleFactors, &batch->traces[i*traceSize]);
+      }
+      queue.Done(batch);
     }
+  };
 
-    std::getline(ssLine,entry,',');
-    std::istringstream(entry) >> throw_away;
+  vector<std::thread> workers;
+  for (size_t i=0; i<nThreads; ++i) workers.emplace_back(worker);
 
-    if (particleName == "G4CMPDriftElectron") {
-      charge = -1;
-    } else if (particleName == "G4CMPDriftElectron") {
-      charge = 1;
-    } else {
-      continue;
+  // Written batches are reused, along with their hit and trace storage
+  vector<FETEventBatch*> spares;
+  auto write = [this, &spares, traceSize](FETEventBatch* batch) {
+    for (size_t i=0; i<batch->events.size(); ++i) {
+      WriteFETTraces(&batch->traces[i*traceSize], batch->events[i].runID,
+                     batch->events[i].eventID);
+    }
+    spares.push_back(batch);
+  };
+
+  // Batches are limited by number of hits, to balance very large events
+  const size_t maxEvents = 1024, maxHits = 1<<16;
+  const size_t maxInFlight = 4*nThreads;    // Limits memory use
+
+  for (size_t seq=0; ; ++seq) {
+    FETEventBatch* batch = 0;
+    if (spares.empty()) batch = new FETEventBatch(seq);
+    else {
+      batch = spares.back();
+      spares.pop_back();
+      batch->sequence = seq;
     }
-    for(size_t chan = 0; chan < numChannels; ++chan) {
-      scaleFactors[chan] -= charge*RamoFields[chan].GetPotential(position);
+
+    size_t nEvents = 0, nHits = 0;
+    while (nEvents < maxEvents && nHits < maxHits) {
+      if (batch->events.size() <= nEvents) batch->events.emplace_back();
+      if (!input.NextEvent(batch->events[nEvents])) break;
+      nHits += batch->events[nEvents++].charge.size();
+    }
+    batch->events.resize(nEvents);
+
+    if (nEvents == 0) {
+      delete batch;
+      break;
     }
+
+    while (queue.InFlight() >= maxInFlight) write(queue.NextResult(true));
+    queue.Submit(batch);
+    while ((batch = queue.NextResult(false))) write(batch);
   }
 
-  vector<vector<G4double> > FETTraces(CalculateTraces(scaleFactors));
-  WriteFETTraces(FETTraces, RunID, EventID);
+  queue.Finish();
+  while (queue.InFlight() > 0) write(queue.NextResult(true));
+
+  for (size_t i=0; i<workers.size(); ++i) workers[i].join();
+  for (size_t i=0; i<spares.size(); ++i) delete spares[i];
+
+  traceWriter.Flush();
+}
+
+void ChargeFETDigitizerModule::CalculateScaleFactors(
+                                    const vector<G4double>& charges,
+                                    const vector<G4double>& positions,
+                                    vector<G4double>& scaleFactors) const
+{
+  scaleFactors.assign(std::max(numChannels,templateStride),0.);
+  const size_t nFields = std::min(numChannels, RamoFields.size());
+  for(size_t hit=0; hit < charges.size(); ++hit) {
+    const G4double* position = &positions[3*hit];
+    for(size_t chan=0; chan < nFields; ++chan)
+      scaleFactors[chan] -= charges[hit]*RamoFields[chan].GetPotential(position);
+  }
 }
 
-vector<vector<G4double> > ChargeFETDigitizerModule::CalculateTraces(
-                                    const vector<G4double>& scaleFactors)
+// Each bin is a small matrix (chan x cross) times vector product; the
+// fixed-width inner loop over padded cross terms is vectorized by the
+// compiler, with one partial sum per SIMD lane
+
+void ChargeFETDigitizerModule::CalculateTraces(
+                                    const vector<G4double>& scaleFactors,
+                                    G4double* FETTraces) const
 {
-  vector<vector<G4double> > FETTraces(numChannels,vector<G4double>(timeBins,0.));
+  const size_t first = std::min(firstTemplateBin, timeBins);
   for(size_t chan=0; chan < numChannels; ++chan)
-    for(size_t cross=0; cross < numChannels; ++cross)
-      for(size_t bin=0; bin < timeBins; ++bin)
-        FETTraces[chan][bin] += scaleFactors[cross]*FETTemplates[chan][cross][bin];
-  return FETTraces;
+    std::fill(FETTraces+chan*timeBins, FETTraces+chan*timeBins+first, 0.);
+
+  if (diagonalTemplates) {              // Pulse for each channel only
+    for(size_t chan=0; chan < numChannels; ++chan) {
+      const G4double scale = scaleFactors[chan];
+      const G4double* pulse = FETTemplates + chan*timeBins;
+      G4double* trace = FETTraces + chan*timeBins;
+      for(size_t bin=first; bin < timeBins; ++bin)
+        trace[bin] = scale*pulse[bin];
+    }
+    return;
+  }
+
+  const G4double* scale = scaleFactors.data();
+  for(size_t chan=0; chan < numChannels; ++chan) {
+    const G4double* matrix = FETTemplates + (chan*timeBins+first)*templateStride;
+    G4double* trace = FETTraces + chan*timeBins;
+    for(size_t bin=first; bin < timeBins; ++bin, matrix += templateStride) {
+      G4double sum[kSimdWidth] = {0.};
+      for(size_t cross=0; cross < templateStride; cross += kSimdWidth)
+        for(size_t lane=0; lane < kSimdWidth; ++lane)
+          sum[lane] += matrix[cross+lane]*scale[cross+lane];
+
+      G4double total = 0.;
+      for(size_t lane=0; lane < kSimdWidth; ++lane) total += sum[lane];
+      trace[bin] = total;
+    }
+  }
 }
 
 void ChargeFETDigitizerModule::ReadFETConstantsFile()
@@ -247,32 +456,127 @@ void ChargeFETDigitizerModule::ReadFETConstantsFile()
 
 void ChargeFETDigitizerModule::BuildFETTemplates()
 {
-  FETTemplates = vector<vector<vector<G4double> > >
-    (numChannels, vector<vector<G4double> >
-    (numChannels, vector<G4double>(timeBins, 0) ) );
-  templateFile.open(templateFilename.c_str());
-  if(templateFile.good()) {
-    for(size_t i=0; i<numChannels; ++i)
-      for(size_t j=0; j<numChannels; ++j)
-        for(size_t k=0; k<timeBins; ++k)
-          templateFile >> FETTemplates[i][j][k];
-  } else {
+  vector<G4double> templates;
+  if (!ReadFETTemplates(templates)) {
     G4Exception("ChargeFETDigitizerModule::BuildFETTemplate", "Charge007",
 		JustWarning,
 	"Reading from template file failed. Using default pulse templates.");
 
+    templates.assign(numChannels*numChannels*timeBins, 0.);
     for(size_t i=0; i<numChannels; ++i) {
+      G4double* pulse = &templates[(i*numChannels+i)*timeBins];
       size_t ndt = static_cast<size_t>(preTrig/dt);
-      for(size_t j=0; j<ndt; ++j)
-        FETTemplates[i][i][j] = 0;
       for(size_t k=1; k<timeBins-ndt+1; ++k)
-        FETTemplates[i][i][k+ndt-1] = exp(-k*dt/decayTime);
+        pulse[k+ndt-1] = exp(-k*dt/decayTime);
     }
   }
-  templateFile.close();
+
+  SetFETTemplates(templates);
   rebuildFETTemplates = false;
 }
 
+// Read binary cache if it is up to date, otherwise parse text file
+
+G4bool ChargeFETDigitizerModule::ReadFETTemplates(vector<G4double>& templates) const
+{
+  if (ReadFETTemplateCache(templates)) return true;
+
+  std::ifstream file(templateFilename, std::ios::binary|std::ios::ate);
+  if (!file.good()) return false;
+
+  std::string text(static_cast<size_t>(file.tellg()), '\0');
+  file.seekg(0);
+  file.read(&text[0], text.size());
+  if (!file.good()) return false;
+
+  const size_t nValues = numChannels*numChannels*timeBins;
+  templates.resize(nValues);
+
+  const char* p = text.c_str();
+  char* end = 0;
+  for(size_t i=0; i<nValues; ++i, p=end) {
+    templates[i] = strtod(p, &end);
+    if (end == p) return false;         // File is too short
+  }
+
+  WriteFETTemplateCache(templates);
+  return true;
+}
+
+G4bool ChargeFETDigitizerModule::ReadFETTemplateCache(vector<G4double>& templates) const
+{
+  FETTemplateCacheHeader expected, found;
+  if (!FillTemplateCacheHeader(templateFilename, numChannels, timeBins,
+                               expected)) return false;
+
+  std::ifstream cache(templateFilename+".cache", std::ios::binary);
+  if (!cache.read(reinterpret_cast<char*>(&found), sizeof(found)) ||
+      memcmp(&found, &expected, sizeof(found)) != 0) return false;
+
+  templates.resize(numChannels*numChannels*timeBins);
+  return (G4bool)cache.read(reinterpret_cast<char*>(templates.data()),
+                            templates.size()*sizeof(G4double));
+}
+
+// Cache is only for speed; if it can't be written, text file is used again
+
+void ChargeFETDigitizerModule::WriteFETTemplateCache(const vector<G4double>& templates) const
+{
+  FETTemplateCacheHeader header;
+  if (!FillTemplateCacheHeader(templateFilename, numChannels, timeBins,
+                               header)) return;
+
+  G4String cacheName = templateFilename+".cache";
+  std::ofstream cache(cacheName, std::ios::binary|std::ios::trunc);
+  cache.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  cache.write(reinterpret_cast<const char*>(templates.data()),
+              templates.size()*sizeof(G4double));
+  cache.close();
+
+  if (!cache.good()) remove(cacheName.c_str());
+}
+
+// Rearrange templates from file order to evaluation order; see header
+
+void ChargeFETDigitizerModule::SetFETTemplates(const vector<G4double>& templates)
+{
+  diagonalTemplates = true;
+  firstTemplateBin = timeBins;
+  for(size_t chan=0; chan < numChannels; ++chan) {
+    for(size_t cross=0; cross < numChannels; ++cross) {
+      const G4double* pulse = &templates[(chan*numChannels+cross)*timeBins];
+      for(size_t bin=0; bin < timeBins; ++bin) {
+        if (pulse[bin] == 0.) continue;
+        if (cross != chan) diagonalTemplates = false;
+        firstTemplateBin = std::min(firstTemplateBin, bin);
+      }
+    }
+  }
+
+  templateStride = (diagonalTemplates ? 1 :
+                    kSimdWidth*((numChannels+kSimdWidth-1)/kSimdWidth));
+  const size_t rowSize = diagonalTemplates ? 1 : templateStride;
+
+  // Extra space so that the start can be aligned
+  const size_t padding = kAlignment/sizeof(G4double);
+  templateStore.assign(numChannels*timeBins*rowSize + padding, 0.);
+  size_t offset = reinterpret_cast<uintptr_t>(templateStore.data()) % kAlignment;
+  offset = (offset ? (kAlignment-offset)/sizeof(G4double) : 0);
+  G4double* aligned = templateStore.data() + offset;
+
+  for(size_t chan=0; chan < numChannels; ++chan) {
+    for(size_t cross=0; cross < numChannels; ++cross) {
+      if (diagonalTemplates && cross != chan) continue;
+      const G4double* pulse = &templates[(chan*numChannels+cross)*timeBins];
+      G4double* row = aligned + chan*timeBins*rowSize;
+      for(size_t bin=0; bin < timeBins; ++bin)
+        row[bin*rowSize + (diagonalTemplates ? 0 : cross)] = pulse[bin];
+    }
+  }
+
+  FETTemplates = aligned;
+}
+
 void ChargeFETDigitizerModule::BuildRamoFields()
 {
   if (RamoFields.size()) RamoFields.clear();
@@ -294,15 +598,9 @@ void ChargeFETDigitizerModule::BuildRamoFields()
 }
 
 void ChargeFETDigitizerModule::WriteFETTraces(
-  const vector<vector<G4double> >& traces, G4int RunID, G4int EventID)
+  const G4double* traces, G4int RunID, G4int EventID)
 {
-  for(size_t chan = 0; chan < numChannels; ++chan) {
-    outputFile << RunID << "," << EventID << "," << chan+1 << ",";
-    for(size_t bin = 0; bin < timeBins-1; ++bin) {
-      outputFile << traces[chan][bin] << ",";
-    }
-    outputFile << traces[chan][timeBins-1] << "\n";
-  }
+  traceWriter.Write(RunID, EventID, traces);
 }
 
 void ChargeFETDigitizerModule::EnableFETSim()
@@ -313,23 +611,27 @@ void ChargeFETDigitizerModule::EnableFETSim()
   }
 }
 
+// File is opened, and header written, with first traces
+
 void ChargeFETDigitizerModule::SetOutputFile(const G4String& fn)
 {
-  if (outputFilename != fn) {
-    if (outputFile.is_open()) outputFile.close();
-    outputFilename = fn;
-    outputFile.open(outputFilename, std::ios_base::app);
-    if (!outputFile.good()) {
-      G4ExceptionDescription msg;
-      msg << "Error opening output file, " << outputFilename << ".\n"
-          << "Will continue simulation.";
-      G4Exception("ChargeFETDigitizerModule::SetOutputFile", "Charge006",
-                  JustWarning, msg);
-      outputFile.close();
-    } else {
-      outputFile << "Run ID,Event ID,Channel,Pulse (4096 bins)" << G4endl;
-    }
-  }
+  outputFilename = fn;
+  traceWriter.SetFileName(outputFilename);
+}
+
+void ChargeFETDigitizerModule::SetOutputFormat(const G4String& name)
+{
+  traceWriter.SetFormat(ChargeFETTraceWriter::GetFormat(name));
+}
+
+G4String ChargeFETDigitizerModule::GetOutputFormat() const
+{
+  return ChargeFETTraceWriter::GetFormatName(traceWriter.GetFormat());
+}
+
+void ChargeFETDigitizerModule::SetTraceScale(G4double value)
+{
+  traceWriter.SetScale(value);
 }
 
 void ChargeFETDigitizerModule::SetConfigFilename(const G4String& name)
@@ -388,3 +690,270 @@ void ChargeFETDigitizerModule::SetPreTrig(G4double n)
   preTrig = n;
   rebuildFETTemplates = true;
 }
+
+
+// Post-processing helpers: streaming hits reader and batch queue
+
+namespace {
+  // Powers of ten which are exactly representable as doubles
+  const G4double exactPow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+
+  inline G4bool IsDigit(char c) { return (unsigned)(c-'0') < 10u; }
+
+  G4int ParseInt(const char* p, const char* end) {
+    while (p < end && *p == ' ') ++p;
+    G4bool neg = (p < end && *p == '-');
+    if (p < end && (*p == '-' || *p == '+')) ++p;
+
+    G4int value = 0;
+    for (; p < end && IsDigit(*p); ++p) value = 10*value + (*p-'0');
+    return neg ? -value : value;
+  }
+
+  // Values written by std::ostream have at most 19 significant digits and
+  // small exponents; those are converted exactly without strtod().
+  G4double ParseDouble(const char* p, const char* end) {
+    const char* start = p;
+    while (p < end && *p == ' ') ++p;
+    G4bool neg = (p < end && *p == '-');
+    if (p < end && (*p == '-' || *p == '+')) ++p;
+
+    uint64_t mantissa = 0;
+    G4int nDigits = 0, exponent = 0;
+    G4bool anyDigits = false;
+    for (; p < end && IsDigit(*p); ++p) {
+      anyDigits = true;
+      if (nDigits < 19) {
+        mantissa = 10*mantissa + (*p-'0');
+        if (mantissa) nDigits++;
+      } else exponent++;
+    }
+
+    if (p < end && *p == '.') {
+      for (++p; p < end && IsDigit(*p); ++p) {
+        anyDigits = true;
+        if (nDigits < 19) {
+          mantissa = 10*mantissa + (*p-'0');
+          if (mantissa) nDigits++;
+          exponent--;
+        }
+      }
+    }
+
+    if (anyDigits && p < end && (*p == 'e' || *p == 'E')) {
+      ++p;
+      G4bool negExp = (p < end && *p == '-');
+      if (p < end && (*p == '-' || *p == '+')) ++p;
+      G4int expValue = 0;
+      for (; p < end && IsDigit(*p); ++p) {
+        if (expValue < 10000) expValue = 10*expValue + (*p-'0');
+      }
+      exponent += negExp ? -expValue : expValue;
+    }
+
+    while (p < end && *p == ' ') ++p;
+
+    if (anyDigits && p == end && mantissa <= (uint64_t(1)<<53) &&
+        exponent >= -22 && exponent <= 22) {
+      G4double value = G4double(mantissa);
+      value = (exponent < 0) ? value/exactPow10[-exponent]
+                             : value*exactPow10[exponent];
+      return neg ? -value : value;
+    }
+
+    // Anything else (long mantissa, large exponent, inf, nan)
+    char field[64];
+    size_t len = std::min(size_t(end-start), sizeof(field)-1);
+    memcpy(field, start, len);
+    field[len] = '\0';
+    return strtod(field, 0);
+  }
+
+  // Compare field contents to string
+  inline G4bool FieldIs(const char* p, const char* end, const char* text) {
+    size_t len = strlen(text);
+    return (size_t(end-p) == len && memcmp(p, text, len) == 0);
+  }
+
+  const size_t kMaxColumns = 32;        // Ignore any columns beyond this
+
+
+  FETHitFileReader::FETHitFileReader(const G4String& fileName,
+                                     size_t blockSize)
+    : input(fileName, std::ios::binary), buffer(blockSize), begin(0), end(0),
+      atEOF(false), runCol(0), eventCol(1), nameCol(3), xCol(11),
+      havePending(false) {}
+
+  G4bool FETHitFileReader::NextEvent(FETEventHits& evt) {
+    evt.clear();
+    if (!havePending && !ReadRow()) return false;
+
+    evt.runID = row.runID;
+    evt.eventID = row.eventID;
+    do {
+      if (row.charge != 0.) {
+        evt.charge.push_back(row.charge);
+        evt.position.insert(evt.position.end(), row.position, row.position+3);
+      }
+    } while ((havePending = ReadRow()) &&
+             row.runID == evt.runID && row.eventID == evt.eventID);
+
+    return true;
+  }
+
+  // Parse lines until a data row is found; headers may be repeated
+  G4bool FETHitFileReader::ReadRow() {
+    const char* line = 0;
+    const char* lineEnd = 0;
+    while (NextLine(line, lineEnd)) {
+      while (lineEnd > line && (lineEnd[-1] == '\r' || lineEnd[-1] == ' '))
+        --lineEnd;
+      if (line == lineEnd) continue;
+
+      if (IsDigit(*line) || *line == '-') {
+        if (ParseRow(line, lineEnd)) return true;
+      } else {
+        ParseHeader(line, lineEnd);
+      }
+    }
+
+    return false;
+  }
+
+  // Returns pointers into buffer, valid until next call
+  G4bool FETHitFileReader::NextLine(const char*& line, const char*& lineEnd) {
+    while (true) {
+      const char* start = buffer.data() + begin;
+      const char* nl =
+        static_cast<const char*>(memchr(start, '\n', end-begin));
+      if (nl) {
+        line = start;
+        lineEnd = nl;
+        begin = nl - buffer.data() + 1;
+        return true;
+      }
+
+      if (atEOF) {              // Last line may not have newline
+        if (begin == end) return false;
+        line = start;
+        lineEnd = buffer.data() + end;
+        begin = end;
+        return true;
+      }
+
+      FillBuffer();
+    }
+  }
+
+  // Keep partial line at start of buffer, and read next block after it
+  void FETHitFileReader::FillBuffer() {
+    if (begin > 0) {
+      memmove(buffer.data(), buffer.data()+begin, end-begin);
+      end -= begin;
+      begin = 0;
+    }
+
+    if (end == buffer.size()) buffer.resize(2*buffer.size());
+
+    input.read(buffer.data()+end, buffer.size()-end);
+    end += input.gcount();
+    if (!input) atEOF = true;
+  }
+
+  // Locate columns by name, so that older files can be read
+  void FETHitFileReader::ParseHeader(const char* line, const char* lineEnd) {
+    size_t col = 0;
+    for (const char* p = line; p <= lineEnd; ++col) {
+      const char* q = static_cast<const char*>(memchr(p, ',', lineEnd-p));
+      if (!q) q = lineEnd;
+
+      if (FieldIs(p, q, "Run ID")) runCol = col;
+      else if (FieldIs(p, q, "Event ID")) eventCol = col;
+      else if (FieldIs(p, q, "Particle Name")) nameCol = col;
+      else if (FieldIs(p, q, "End X [m]")) xCol = col;
+
+      p = q+1;
+    }
+  }
+
+  G4bool FETHitFileReader::ParseRow(const char* line, const char* lineEnd) {
+    const char* field[kMaxColumns+1];
+    size_t nFields = 0;
+    const char* p = line;
+    while (p <= lineEnd && nFields < kMaxColumns) {
+      field[nFields++] = p;
+      const char* q = static_cast<const char*>(memchr(p, ',', lineEnd-p));
+      p = (q ? q+1 : lineEnd+1);
+    }
+    field[nFields] = p;                 // Each field ends before next start
+
+    size_t needed = std::max(std::max(runCol, eventCol),
+                             std::max(nameCol, xCol+2)) + 1;
+    if (nFields < needed) return false;
+
+    row.runID = ParseInt(field[runCol], field[runCol+1]-1);
+    row.eventID = ParseInt(field[eventCol], field[eventCol+1]-1);
+
+    const char* name = field[nameCol];
+    const char* nameEnd = field[nameCol+1]-1;
+    if (FieldIs(name, nameEnd, "G4CMPDriftElectron")) row.charge = -1.;
+    else if (FieldIs(name, nameEnd, "G4CMPDriftHole")) row.charge = 1.;
+    else row.charge = 0.;
+
+    if (row.charge != 0.) {
+      for (size_t i=0; i<3; ++i) {
+        row.position[i] = ParseDouble(field[xCol+i], field[xCol+i+1]-1) * m;
+      }
+    }
+
+    return true;
+  }
+
+
+  void FETBatchQueue::Submit(FETEventBatch* batch) {
+    std::lock_guard<std::mutex> l(mtx);
+    work.push_back(batch);
+    nSubmitted++;
+    workReady.notify_one();
+  }
+
+  void FETBatchQueue::Finish() {
+    std::lock_guard<std::mutex> l(mtx);
+    finished = true;
+    workReady.notify_all();
+  }
+
+  FETEventBatch* FETBatchQueue::Take() {
+    std::unique_lock<std::mutex> lock(mtx);
+    workReady.wait(lock, [this]() { return !work.empty() || finished; });
+    if (work.empty()) return 0;
+
+    FETEventBatch* batch = work.front();
+    work.pop_front();
+    return batch;
+  }
+
+  void FETBatchQueue::Done(FETEventBatch* batch) {
+    std::lock_guard<std::mutex> l(mtx);
+    results[batch->sequence] = batch;
+    resultReady.notify_one();
+  }
+
+  FETEventBatch* FETBatchQueue::NextResult(G4bool wait) {
+    std::unique_lock<std::mutex> lock(mtx);
+    if (wait) {
+      resultReady.wait(lock, [this]() { return results.count(nReturned) > 0; });
+    }
+
+    auto next = results.find(nReturned);
+    if (next == results.end()) return 0;
+
+    FETEventBatch* batch = next->second;
+    results.erase(next);
+    nReturned++;
+    return batch;
+  }
+}
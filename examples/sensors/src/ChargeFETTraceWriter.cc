@@ -0,0 +1,243 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#include "ChargeFETTraceWriter.hh"
+#include "G4SystemOfUnits.hh"
+#include <algorithm>
+#include <cmath>
+#include <stdio.h>
+#include <string.h>
+
+const char ChargeFETTraceWriter::kMagic[8] = {'G','4','C','M','P','F','E','T'};
+const uint32_t ChargeFETTraceWriter::kVersion;
+
+ChargeFETTraceWriter::Format
+ChargeFETTraceWriter::GetFormat(const G4String& name)
+{
+  if (name == "int16") return kInt16;
+  if (name == "float") return kFloat32;
+  if (name != "csv") {
+    G4ExceptionDescription msg;
+    msg << "Unknown FET output format " << name << "; using csv.";
+    G4Exception("ChargeFETTraceWriter::GetFormat", "Charge008",
+                JustWarning, msg);
+  }
+  return kCSV;
+}
+
+const char* ChargeFETTraceWriter::GetFormatName(Format fmt)
+{
+  return (fmt == kInt16 ? "int16" : fmt == kFloat32 ? "float" : "csv");
+}
+
+ChargeFETTraceWriter::ChargeFETTraceWriter(size_t bufferBytes) :
+  format(kCSV), scale(1.), numChannels(0), timeBins(0), dt(0.),
+  failed(false), bufferSize(bufferBytes)
+{}
+
+ChargeFETTraceWriter::~ChargeFETTraceWriter()
+{
+  Close();
+}
+
+void ChargeFETTraceWriter::SetFileName(const G4String& name)
+{
+  if (fileName == name) return;
+  Close();
+  fileName = name;
+  failed = false;
+}
+
+void ChargeFETTraceWriter::SetFormat(Format fmt)
+{
+  if (format == fmt) return;
+  Close();
+  format = fmt;
+  failed = false;
+}
+
+void ChargeFETTraceWriter::SetScale(G4double value)
+{
+  if (scale == value) return;
+  Close();
+  scale = value;
+  failed = false;
+}
+
+void ChargeFETTraceWriter::SetShape(size_t channels, size_t bins,
+                                    G4double binWidth)
+{
+  if (numChannels == channels && timeBins == bins && dt == binWidth) return;
+  Close();
+  numChannels = channels;
+  timeBins = bins;
+  dt = binWidth;
+  failed = false;
+}
+
+void ChargeFETTraceWriter::Write(G4int runID, G4int eventID,
+                                 const G4double* traces)
+{
+  if (!output.is_open() && !Open()) return;
+
+  if (format == kCSV) EncodeCSV(runID, eventID, traces);
+  else EncodeBinary(runID, eventID, traces);
+
+  if (buffer.size() >= bufferSize) Flush();
+}
+
+void ChargeFETTraceWriter::Flush()
+{
+  if (buffer.empty() || !output.is_open()) return;
+
+  output.write(buffer.data(), buffer.size());
+  buffer.clear();
+
+  if (!output.good()) {
+    G4ExceptionDescription msg;
+    msg << "Error writing to output file, " << fileName << ".\n"
+        << "Expect bad things like loss of data.";
+    G4Exception("ChargeFETTraceWriter::Flush", "Charge005",
+                JustWarning, msg);
+    failed = true;
+  }
+}
+
+void ChargeFETTraceWriter::Close()
+{
+  if (!output.is_open()) return;
+  Flush();
+  output.close();
+}
+
+// Open for appending; new files get header, existing ones must match
+
+G4bool ChargeFETTraceWriter::Open()
+{
+  if (failed || fileName.empty()) return false;
+
+  std::ios::openmode mode = std::ios::app;
+  if (format != kCSV) mode |= std::ios::binary;
+
+  std::ifstream existing(fileName, std::ios::binary|std::ios::ate);
+  G4bool needHeader = !existing.good() || existing.tellg() <= 0;
+  if (!needHeader && format != kCSV && !CheckHeader(existing)) {
+    G4ExceptionDescription msg;
+    msg << "Output file, " << fileName << ", is not a version " << kVersion
+        << " FET trace file with " << GetFormatName(format) << " samples, "
+        << numChannels << " channels, " << timeBins << " bins of " << dt/ns
+        << " ns, and the same scale.\n"
+        << "Will continue simulation.";
+    G4Exception("ChargeFETTraceWriter::Open", "Charge006", JustWarning, msg);
+    failed = true;
+    return false;
+  }
+  existing.close();
+
+  output.open(fileName, mode);
+  if (!output.good()) {
+    G4ExceptionDescription msg;
+    msg << "Error opening output file, " << fileName << ".\n"
+        << "Will continue simulation.";
+    G4Exception("ChargeFETTraceWriter::Open", "Charge006", JustWarning, msg);
+    output.close();
+    failed = true;
+    return false;
+  }
+
+  buffer.reserve(bufferSize + numChannels*timeBins*(format==kCSV?16:4) + 64);
+  if (needHeader) WriteHeader();
+
+  return true;
+}
+
+G4bool ChargeFETTraceWriter::CheckHeader(std::ifstream& existing) const
+{
+  char magic[sizeof(kMagic)];
+  uint32_t version=0, sampleSize=0, channels=0, bins=0;
+  double binWidth=0., sampleScale=0.;
+
+  existing.seekg(0);
+  existing.read(magic, sizeof(magic));
+  existing.read((char*)&version, sizeof(version));
+  existing.read((char*)&sampleSize, sizeof(sampleSize));
+  existing.read((char*)&channels, sizeof(channels));
+  existing.read((char*)&bins, sizeof(bins));
+  existing.read((char*)&binWidth, sizeof(binWidth));
+  existing.read((char*)&sampleScale, sizeof(sampleScale));
+
+  return (existing.good() && memcmp(magic, kMagic, sizeof(magic)) == 0 &&
+          version == kVersion && sampleSize == uint32_t(format) &&
+          channels == numChannels && bins == timeBins &&
+          binWidth == dt/ns && sampleScale == (format==kInt16 ? scale : 1.));
+}
+
+void ChargeFETTraceWriter::WriteHeader()
+{
+  if (format == kCSV) {
+    char line[64];
+    snprintf(line, sizeof(line), "Run ID,Event ID,Channel,Pulse (%zu bins)\n",
+             timeBins);
+    buffer.insert(buffer.end(), line, line+strlen(line));
+  } else {
+    buffer.insert(buffer.end(), kMagic, kMagic+sizeof(kMagic));
+    AppendBytes<uint32_t>(kVersion);
+    AppendBytes<uint32_t>(format);
+    AppendBytes<uint32_t>(numChannels);
+    AppendBytes<uint32_t>(timeBins);
+    AppendBytes<double>(dt/ns);
+    AppendBytes<double>(format == kInt16 ? scale : 1.);
+  }
+
+  Flush();
+}
+
+// Same text as std::ostream with default precision, without the overhead
+
+void ChargeFETTraceWriter::EncodeCSV(G4int runID, G4int eventID,
+                                     const G4double* traces)
+{
+  char number[32];
+  for (size_t chan = 0; chan < numChannels; ++chan) {
+    G4int len = snprintf(number, sizeof(number), "%d,%d,%zu", runID, eventID,
+                         chan+1);
+    buffer.insert(buffer.end(), number, number+len);
+
+    const G4double* trace = traces + chan*timeBins;
+    for (size_t bin = 0; bin < timeBins; ++bin) {
+      len = snprintf(number, sizeof(number), ",%g", trace[bin]);
+      buffer.insert(buffer.end(), number, number+len);
+    }
+    buffer.push_back('\n');
+  }
+}
+
+// Samples are converted directly into the buffer; int16 values are clipped
+
+void ChargeFETTraceWriter::EncodeBinary(G4int runID, G4int eventID,
+                                        const G4double* traces)
+{
+  AppendBytes<int32_t>(runID);
+  AppendBytes<int32_t>(eventID);
+
+  const size_t nSamples = numChannels*timeBins;
+  const size_t start = buffer.size();
+  buffer.resize(start + nSamples*format);
+
+  char* samples = &buffer[start];
+  if (format == kFloat32) {
+    for (size_t i = 0; i < nSamples; ++i) {
+      float value = traces[i];
+      memcpy(samples + i*sizeof(value), &value, sizeof(value));
+    }
+  } else {
+    const G4double invScale = 1./scale;
+    for (size_t i = 0; i < nSamples; ++i) {
+      G4double count = std::round(traces[i]*invScale);
+      int16_t value = int16_t(std::min(std::max(count, -32767.), 32767.));
+      memcpy(samples + i*sizeof(value), &value, sizeof(value));
+    }
+  }
+}
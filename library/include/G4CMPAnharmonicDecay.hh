@@ -1,6 +1,8 @@
 /* Header File for AnharmonicDecay utility class */
 
 // 20221103  Drop G4CMP_DEBUG protection here, to avoid client rebuilding
+// 20261019  Use lattice's tabulated energy sampling; cache lattice constants
+// 20261019  Add SampleDecay() to generate daughters without tracks
 
 #ifndef G4CMPAnharmonicDecay_h
 #define G4CMPAnharmonicDecay_h
@@ -8,6 +10,8 @@
 #include "G4CMPProcessUtils.hh"
 #include <iosfwd>
 
+class G4CMPAnharmonicTable;
+class G4LatticePhysical;
 class G4ParticleChange;
 class G4Step;
 class G4Track;
@@ -23,13 +27,26 @@ public:
 
   void DoDecay(const G4Track&, const G4Step&, G4ParticleChange&);
 
+  // Sample daughters for decay of L-phonon with energy and wavevector k,
+  // without creating tracks; directions are in the same frame as k
+  void SampleDecay(G4double energy, const G4ThreeVector& k, G4int mode[2],
+		   G4ThreeVector dir[2], G4double Esec[2]);
+
 private:
+  void LoadLatticeConstants();		// Only when lattice changes
+
   G4double GetLTDecayProb(G4double, G4double) const;
   G4double GetTTDecayProb(G4double, G4double) const;
   G4double MakeLDeviation(G4double, G4double) const;
   G4double MakeTTDeviation(G4double, G4double) const;
   G4double MakeTDeviation(G4double, G4double) const;
 
+  // Daughter modes, directions, energies and deviations from k
+  void SampleTT(G4double E, const G4ThreeVector& k, G4int mode[2],
+		G4ThreeVector dir[2], G4double Esec[2], G4double theta[2]) const;
+  void SampleLT(G4double E, const G4ThreeVector& k, G4int mode[2],
+		G4ThreeVector dir[2], G4double Esec[2], G4double theta[2]) const;
+
   void MakeTTSecondaries(const G4Track&, G4ParticleChange&);
   void MakeLTSecondaries(const G4Track&, G4ParticleChange&);
 
@@ -38,6 +55,10 @@ private:
 
   G4double fBeta, fGamma, fLambda, fMu; // Local buffers for decay parameters
   G4double fvLvT; 			// Ratio of sound speeds
+  G4double fTTFrac;			// Fraction of L -> T+T decays
+
+  const G4LatticePhysical* fCachedLattice;	// Source of values above
+  const G4CMPAnharmonicTable* fTable;	// Energy sampling, owned by lattice
 
   std::ofstream output;			// Only used for G4CMP_DEBUG debugging
 };
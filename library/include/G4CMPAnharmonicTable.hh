@@ -0,0 +1,90 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPAnharmonicTable.hh
+/// \brief Definition of the G4CMPAnharmonicTable class, which tabulates
+///   the inverse cumulative distributions of daughter energy fraction for
+///   anharmonic decay (L -> T+T and L -> L'+T) of a given lattice.
+///
+///   The densities (Tamura, PRB31, 1985) depend only on the ratio of sound
+///   speeds and the dimensionless dynamical constants beta, gamma, lambda
+///   and mu, so the table is filled once when the lattice is initialized.
+///   Each sample is then a single uniform random number, with linear
+///   interpolation between equal-probability quantiles.
+///
+///   The tables reproduce the rejection sampling in G4CMPAnharmonicDecay,
+///   including its cutoffs on the densities.  When filled, the largest
+///   difference between the tabulated and integrated CDFs is recorded; the
+///   number of quantiles is doubled (up to 16 times the requested number)
+///   until it is within GetTolerance(), otherwise a warning is issued.
+//
+// $Id$
+//
+// 20261019  New class for tabulated anharmonic decay sampling
+
+#ifndef G4CMPAnharmonicTable_hh
+#define G4CMPAnharmonicTable_hh 1
+
+#include "globals.hh"
+#include <vector>
+
+
+class G4CMPAnharmonicTable {
+public:
+  // Dynamical constants must be dimensionless (units of 1e11 pascal)
+  G4CMPAnharmonicTable(G4double vLvT, G4double beta, G4double gamma,
+		       G4double lambda, G4double mu, G4int nQuantiles=4096);
+  virtual ~G4CMPAnharmonicTable() {;}
+
+  // Energy fraction of first daughter, given uniform random u in [0,1)
+  G4double SampleTT(G4double u) const { return Sample(ttQuantiles, u); }
+  G4double SampleLT(G4double u) const { return Sample(ltQuantiles, u); }
+
+  // Draw using G4UniformRand()
+  G4double ShootTT() const;
+  G4double ShootLT() const;
+
+  // Ratio of longitudinal to transverse sound speeds used for table
+  G4double GetVLVT() const { return vLvT; }
+
+  // Largest difference between tabulated and integrated CDFs
+  G4double GetTTError() const { return ttError; }
+  G4double GetLTError() const { return ltError; }
+  static G4double GetTolerance() { return 1e-4; }
+
+  // Probability densities, as used by rejection sampling
+  // d is ratio of sound speeds, x is energy fraction (scaled for TT)
+  static G4double LTDecayProb(G4double d, G4double x);
+  static G4double TTDecayProb(G4double d, G4double x, G4double beta,
+			      G4double gamma, G4double lambda, G4double mu);
+
+  // Range of energy fraction for each decay
+  static G4double TTLowerBound(G4double d) { return (1.-1./d)/2.; }
+  static G4double TTUpperBound(G4double d) { return (1.+1./d)/2.; }
+  static G4double LTLowerBound(G4double d) { return (d-1.)/(d+1.); }
+  static G4double LTUpperBound(G4double)   { return 1.; }
+
+protected:
+  // Cutoffs applied by rejection sampling in G4CMPAnharmonicDecay
+  G4double TTDensity(G4double x) const;
+  G4double LTDensity(G4double x) const;
+
+  // Fill quantiles of density over range; returns maximum CDF error
+  template <class Density>
+  G4double FillQuantiles(Density density, G4double xmin, G4double xmax,
+			 G4int nQuant, std::vector<G4double>& quantiles) const;
+
+  G4double Sample(const std::vector<G4double>& quantiles, G4double u) const;
+
+private:
+  G4double vLvT;
+  G4double beta, gamma, lambda, mu;
+
+  std::vector<G4double> ttQuantiles;	// Energy fraction at CDF = i/N
+  std::vector<G4double> ltQuantiles;
+  G4double ttError, ltError;		// Maximum CDF difference from fill
+};
+
+#endif	/* G4CMPAnharmonicTable_hh */
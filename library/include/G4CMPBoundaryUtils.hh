@@ -21,6 +21,9 @@
 //	     to validate step trajectory to boundary.
 // 20250927  Add overloadable function to kill track when max-reflections.
 // 20251028  G4CMP-527: Move CheckStepBoundary() here from DriftBoundaryProcess
+// 20261019  Cache resolved surface state per boundary and particle type;
+//	     cache outward normals of planar faces.  Discard cache when a new
+//	     run starts or geometry is rebuilt.
 #ifndef G4CMPBoundaryUtils_hh
 #define G4CMPBoundaryUtils_hh 1
 
@@ -28,12 +31,14 @@
 #include "G4ThreeVector.hh"
 #include <map>
 #include <utility>
+#include <vector>
 
 class G4CMPProcessUtils;
 class G4CMPSurfaceProperty;
 class G4CMPVElectrodePattern;
 class G4MaterialPropertiesTable;
 class G4ParticleChange;
+class G4ParticleDefinition;
 class G4Step;
 class G4Track;
 class G4VPhysicalVolume;
@@ -86,14 +91,59 @@ public:
   virtual void DoTransmission(const G4Track& aTrack, const G4Step& aStep,
 			      G4ParticleChange& aParticleChange);
 
+  // Discard resolved surfaces; must be called if surfaces are modified
+  // after tracking has started
+  void ClearSurfaceCache() { surfaceCache.clear(); surfState = nullptr; }
+
+  // Discard resolved surfaces in all threads when geometry is rebuilt
+  static void InvalidateSurfaceCache();
+
 protected:
   G4bool IsBounaryStep(const G4Step& aStep);
   G4bool GetBoundingVolumes(const G4Step& aStep);
   G4bool GetSurfaceProperty(const G4Step& aStep);
 
+  // Clear cache if run or geometry has changed since it was filled
+  void CheckSurfaceCache();
+
   // Does const-casting of matTable for access
   G4double GetMaterialProperty(const G4String& key) const;
 
+  // Outward normal at surfacePoint, in pre-step volume or global coordinates
+  // Computed by ApplyBoundaryAction() for charge carriers, before surface
+  // actions are chosen
+  const G4ThreeVector& GetLocalSurfaceNormal() const { return localNormal; }
+  const G4ThreeVector& GetSurfaceNormal() const { return surfaceNormal; }
+
+  void ComputeSurfaceNormal(const G4Step& aStep);
+
+  // Surface information for one boundary and particle type, resolved on
+  // first encounter so that later hits need no lookups by name
+  struct PlanarFace {
+    G4ThreeVector normal;		// Outward normal in local coordinates
+    G4double offset;			// Distance of plane from origin
+  };
+
+  struct SurfaceState {
+    G4CMPSurfaceProperty* surfProp = nullptr;
+    G4MaterialPropertiesTable* matTable = nullptr;
+    G4CMPVElectrodePattern* electrode = nullptr;
+    G4bool valid = true;		// False if property is not G4CMP
+    G4double absProb = 0.;		// Values from matTable
+    G4double reflProb = 0.;
+    G4double minKElec = 0.;		// Charge carriers only
+    G4double minKHole = 0.;
+    G4bool planar = false;		// Pre-step solid has only flat faces
+    std::vector<PlanarFace> faces;	// Filled as faces are hit
+  };
+
+  const SurfaceState* GetSurfaceState() const { return surfState; }
+
+  void ResolveSurfaceState(const G4Step& aStep, SurfaceState& state);
+
+  // Particle type for cache: 1 for charge carriers, 2 for phonons, else 0
+  static G4int SurfaceType(const G4ParticleDefinition* pd);
+
 private:
   G4int buVerboseLevel;			// For local use; name avoids collisions
   G4String procName;
@@ -112,7 +162,16 @@ protected:
   typedef std::pair<G4VPhysicalVolume*,G4VPhysicalVolume*> BoundaryPV;
   std::map<BoundaryPV, G4bool> hasSurface;
 
+  // Resolved surfaces, by PV pair and particle type (see SurfaceType())
+  typedef std::pair<BoundaryPV, G4int> SurfaceKey;
+  std::map<SurfaceKey, SurfaceState> surfaceCache;
+  SurfaceState* surfState;		// Entry for current boundary
+  G4int cacheRunID;			// Run in which cache was filled
+  G4int cacheGeometry;			// Geometry version when cache was filled
+
   G4ThreeVector surfacePoint;		// "Adjusted" impact point at surface
+  G4ThreeVector localNormal;		// Outward normal at surfacePoint
+  G4ThreeVector surfaceNormal;
 };
 
 #endif	/* G4CMPBoundaryUtils_hh */
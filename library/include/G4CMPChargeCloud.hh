@@ -8,16 +8,26 @@
 ///   Generates a collection of points distributed in a sphere around a
 ///   given center.  The distribution is uniform in angle, falls off
 ///   linearly with radius.  Size of cloud determined by lattice structure
-///   (eight per unit cell for diamond).  If enclosing volume is specified
-///   sphere will be "folded" inward at bounding surfaces.  If a touchable
-///   is specified, both the enclosing volume and local-global transforms
+///   (eight per unit cell for diamond, or as set with SetLatticeFill()).
+///   If enclosing volume is specified sphere will be "folded" inward at
+///   bounding surfaces; only points farther from the center than the
+///   volume's safety distance (the shells which may cross the surface)
+///   are checked.  If a touchable is
+///   specified, both the enclosing volume and local-global transforms
 ///   will be extracted, and the final distribution returned in global
 ///   coordinates.
 ///
+///   Points are collected in cubic bins of four lattice spacings, with
+///   21 bits per axis packed into a 64-bit bin index.
+///
 // $Id$
 //
 // 20170925  Add direct access to individual positions in cloud, binning
 // 20180831  Fix compiler warning on GetPositionBin()
+// 20261019  Add lattice fill option, check containment only beyond safety
+//		distance, use 64-bit bin indices.
+// 20261019  Split Generate() into Prepare() and GeneratePoints(), so that
+//		blocks of points can be filled concurrently.
 
 #ifndef G4CMPChargeCloud_hh
 #define G4CMPChargeCloud_hh 1
@@ -35,6 +45,9 @@ class G4VTouchable;
 
 class G4CMPChargeCloud {
 public:
+  // Number of charges (atoms) per cubic unit cell, sets cloud density
+  enum LatticeFill { SimpleCubic=1, BCC=2, FCC=4, Diamond=8 };
+
   G4CMPChargeCloud(const G4LatticeLogical* lat=0, const G4VSolid* solid=0);
   G4CMPChargeCloud(const G4LatticePhysical* lat, const G4VSolid* solid);
   explicit G4CMPChargeCloud(const G4VSolid* solid);
@@ -51,6 +64,9 @@ public:
   void SetLattice(const G4LatticePhysical* lat);
   const G4LatticeLogical* GetLattice() const { return theLattice; }
 
+  void SetLatticeFill(LatticeFill fill);
+  LatticeFill GetLatticeFill() const { return latticeFill; }
+
   void SetTouchable(const G4VTouchable* touch);
   const G4VTouchable* GetTouchable() const { return theTouchable; }
 
@@ -62,13 +78,18 @@ public:
   virtual const std::vector<G4ThreeVector>& 
   Generate(G4int npos, const G4ThreeVector& center);
 
+  // Set up cloud of npos points around center, to be filled in blocks;
+  // disjoint blocks may be filled from different threads
+  void Prepare(G4int npos, const G4ThreeVector& center);
+  G4int GeneratePoints(size_t begin, size_t end);	// Returns number checked
+
   // Get constituents and parameters of generated distribution
   const std::vector<G4ThreeVector>& GetCloud() const { return theCloud; }
   const G4ThreeVector& GetPosition(G4int i) const { return theCloud[i]; }
 
-  const std::vector<G4int>& GetCloudBins() const { return theCloudBins; }
-  G4int GetPositionBin(G4int i) const { return theCloudBins[i]; }
-  G4ThreeVector GetBinCenter(G4int ibin) const;
+  const std::vector<G4long>& GetCloudBins() const { return theCloudBins; }
+  G4long GetPositionBin(G4int i) const { return theCloudBins[i]; }
+  G4ThreeVector GetBinCenter(G4long ibin) const;
 
   G4double GetRadius() const { return cloudRadius; }
   const G4ThreeVector& GetCenter() const { return localCenter; }
@@ -76,6 +97,10 @@ public:
   // Compute maximum radius of sphere to contain points
   virtual G4double ComputeRadius(G4int npos) const;
 
+  // Number of points in last Generate() which were checked against volume;
+  // not filled by GeneratePoints()
+  G4int GetNumberChecked() const { return nChecked; }
+
   // Generate point randomly in sphere of given radius
   virtual G4ThreeVector GeneratePoint(G4double rmax) const;
 
@@ -87,18 +112,28 @@ protected:
   const G4LatticeLogical* theLattice;	// For crystal structure
   const G4VSolid* theSolid;		// For bounding surfaces
   const G4VTouchable* theTouchable;	// For local-global coordinates
+  LatticeFill latticeFill;		// Charges per unit cell
   G4double avgLatticeSpacing;		// Cubic approximation from lattice
   G4double radiusScale;			// Cloud radius per e/h pair (cbrt)
   G4double binSpacing;			// Bin size for primary clumping
 
   // Convert local position to bin index (pass-by-value for use as temporary)
-  G4int GetBinIndex(G4ThreeVector localPos) const;
+  G4long GetBinIndex(G4ThreeVector localPos) const;
+
+  // Bits per axis in bin index; bins are clamped to range
+  static constexpr G4int binBits = 21;
+  static constexpr G4long binMask = (G4long(1) << binBits) - 1;
+
+  // Distance from center within which all points are inside volume
+  G4double ComputeSafety() const;
+  G4double safety;			// Computed by Prepare()
 
 private:
   std::vector<G4ThreeVector> theCloud;	// Buffer to carry generated points
   G4double cloudRadius;			// Radius used to generate distribution
   G4ThreeVector localCenter;		// Local center point of distribution
-  std::vector<G4int> theCloudBins;	// Buffer for bin indices at points
+  std::vector<G4long> theCloudBins;	// Buffer for bin indices at points
+  G4int nChecked;			// Points tested against volume
 };
 
 #endif	/* G4CMPChargeCloud_hh */
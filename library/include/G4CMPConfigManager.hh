@@ -49,11 +49,23 @@
 // 20250209  G4CMP-457: Add short names for Lindhard empirical ionization model.
 // 20250325  G4CMP-463:  Add parameter for phonon surface step size & limit.
 // 20250502  G4CMP-358: Limit number of steps for charged tracks in E-field.
+// 20261019  Add flag to enable G4CMPProfiler timing (requires G4CMP_PROFILE).
+// 20261019  Add energy threshold for bulk phonon cascade (G4CMPPhononCascade).
+// 20261019  Add field stepper selection and per-volume field accuracy.
+// 20261019  Add flag to limit charge steps to field mesh tetrahedra.
+// 20261019  Add flag to use tabulated IV scattering rates.
+// 20261019  Add macro-carrier multiplicity and electrode hit splitting.
+// 20261019  Add task size for splitting large partitions across tasks.
+// 20261019  Add thread count for partitioning tasks.
+// 20261019  Add flag to use tabulated NIEL yield (G4CMPNIELTable).
 
 #include "globals.hh"
 #include <iosfwd>
+#include <map>
+#include <utility>
 
 class G4CMPConfigMessenger;
+class G4CMPNIELTable;
 class G4VNIELPartition;
 
 
@@ -78,15 +90,26 @@ public:
   static G4int GetMaxChargeSteps()       { return Instance()->ehMaxSteps; }
   static G4int GetMaxLukePhonons()       { return Instance()->maxLukePhonons; }
   static G4int GetPhononSurfStepLimit()  { return Instance()->pSurfStepLimit; }
+  static G4int GetMacroCharges()         { return Instance()->macroCharges; }
+  static G4int GetMacroSplitHits()       { return Instance()->macroSplitHits; }
+  static G4int GetPartitionTaskSize()    { return Instance()->partitionTaskSize; }
+  static G4int GetPartitionThreads()     { return Instance()->partitionThreads; }
   static G4bool UseKVSolver()            { return Instance()->useKVsolver; }
   static G4bool FanoStatisticsEnabled()  { return Instance()->fanoEnabled; }
   static G4bool KeepKaplanPhonons()      { return Instance()->kaplanKeepPh; }
   static G4bool CreateChargeCloud()      { return Instance()->chargeCloud; }
   static G4bool RecordMinETracks()       { return Instance()->recordMinE; }
+  static G4bool ProfilingEnabled()       { return Instance()->profiling; }
+  static G4bool LimitStepsToMesh()       { return Instance()->meshSteps; }
+  static G4bool UseRateTables()          { return Instance()->rateTables; }
+  static G4bool UseNIELTables()          { return Instance()->nielTables; }
   static G4double GetSurfaceClearance()  { return Instance()->clearance; }
   static G4double GetMinStepScale()      { return Instance()->stepScale; }
   static G4double GetMinPhononEnergy()   { return Instance()->EminPhonons; }
   static G4double GetMinChargeEnergy()   { return Instance()->EminCharges; }
+  static G4double GetPhononCascadeEnergy() { return Instance()->EcascadePhonons; }
+  static G4double GetFieldDeltaOneStep() { return Instance()->fieldDelta; }
+  static G4double GetFieldEpsilon()      { return Instance()->fieldEpsilon; }
   static G4double GetSamplingEnergy()    { return Instance()->sampleEnergy; }
   static G4double GetGenPhonons()        { return Instance()->genPhonons; }
   static G4double GetGenCharges()        { return Instance()->genCharges; }
@@ -111,8 +134,16 @@ public:
   static const G4String& GetLatticeDir() { return Instance()->LatticeDir; }
   static const G4String& GetIVRateModel() { return Instance()->IVRateModel; }
   static const G4String& GetLukeDebugFile() { return Instance()->lukeFilename; }
+  static const G4String& GetFieldStepper() { return Instance()->fieldStepper; }
 
-  static const G4VNIELPartition* GetNIELPartition() { return Instance()->nielPartition; }
+  // Field accuracy for named volume (physical or logical), or global values
+  // Returns true if volume has its own settings
+  static G4bool GetFieldAccuracy(const G4String& volume, G4double& delta,
+				 G4double& epsilon) {
+    return Instance()->getFieldAccuracy(volume, delta, epsilon);
+  }
+
+  static const G4VNIELPartition* GetNIELPartition() { return Instance()->getNIEL(); }
 
   // Change values (e.g., via Messenger) -- pass strings by value for toLower()
   static void SetVerboseLevel(G4int value) { Instance()->verbose = value; }
@@ -122,10 +153,17 @@ public:
   static void SetPhononSurfStepLimit(G4int value) { Instance()->pSurfStepLimit = value; }
   static void SetMaxChargeSteps(G4int value) { Instance()->ehMaxSteps = value; }
   static void SetMaxLukePhonons(G4int value) { Instance()->maxLukePhonons = value; }
+  static void SetMacroCharges(G4int value) { Instance()->macroCharges = value; }
+  static void SetMacroSplitHits(G4int value) { Instance()->macroSplitHits = value; }
+  static void SetPartitionTaskSize(G4int value) { Instance()->partitionTaskSize = value; }
+  static void SetPartitionThreads(G4int value) { Instance()->partitionThreads = value; }
   static void SetSurfaceClearance(G4double value) { Instance()->clearance = value; }
   static void SetMinStepScale(G4double value) { Instance()->stepScale = value; }
   static void SetMinPhononEnergy(G4double value) { Instance()->EminPhonons = value; }
   static void SetMinChargeEnergy(G4double value) { Instance()->EminCharges = value; }
+  static void SetPhononCascadeEnergy(G4double value) { Instance()->EcascadePhonons = value; }
+  static void SetFieldDeltaOneStep(G4double value) { Instance()->fieldDelta = value; }
+  static void SetFieldEpsilon(G4double value) { Instance()->fieldEpsilon = value; }
   static void SetSamplingEnergy(G4double value) { Instance()->sampleEnergy = value; }
   static void SetGenPhonons(G4double value) { Instance()->genPhonons = value; }
   static void SetGenCharges(G4double value) { Instance()->genCharges = value; }
@@ -137,6 +175,10 @@ public:
   static void KeepKaplanPhonons(G4bool value) { Instance()->kaplanKeepPh = value; }
   static void SetIVRateModel(G4String value) { Instance()->IVRateModel = value; }
   static void CreateChargeCloud(G4bool value) { Instance()->chargeCloud = value; }
+  static void EnableProfiling(G4bool value) { Instance()->setProfiling(value); }
+  static void LimitStepsToMesh(G4bool value) { Instance()->meshSteps = value; }
+  static void UseRateTables(G4bool value) { Instance()->rateTables = value; }
+  static void UseNIELTables(G4bool value) { Instance()->nielTables = value; }
 
   static void SetETrappingMFP(G4double value) { Instance()->eTrapMFP = value; }
   static void SetHTrappingMFP(G4double value) { Instance()->hTrapMFP = value; }
@@ -147,6 +189,13 @@ public:
   static void SetTemperature(G4double value)  { Instance()->temperature = value; }
 
   static void SetLukeDebugFile(const G4String& value) { Instance()->lukeFilename = value; }
+  static void SetFieldStepper(const G4String& value) { Instance()->fieldStepper = value; }
+
+  // Accuracy for a single volume; values <= 0 use global setting
+  static void SetFieldAccuracy(const G4String& volume, G4double delta,
+			       G4double epsilon) {
+    Instance()->fieldAccuracy[volume] = std::make_pair(delta, epsilon);
+  }
 
   static void SetNIELPartition(const G4String& value) { Instance()->setNIEL(value); }
   static void SetNIELPartition(G4VNIELPartition* niel) { Instance()->setNIEL(niel); }
@@ -185,6 +234,16 @@ private:
   void setNIEL(G4String value);
   void setNIEL(G4VNIELPartition* niel);
 
+  // Return NIEL function, wrapped in this thread's table if requested
+  const G4VNIELPartition* getNIEL();
+
+  // Pass profiling flag through to G4CMPProfiler
+  void setProfiling(G4bool value);
+
+  // Look up volume-specific field accuracy, with global defaults
+  G4bool getFieldAccuracy(const G4String& volume, G4double& delta,
+			  G4double& epsilon) const;
+
 private:
   G4int verbose;	 // Global verbosity (all processes, lattices)
   G4int fPhysicsModelID; // ID key to get aux. track info.
@@ -193,10 +252,15 @@ private:
   G4int ehMaxSteps;      // Maximum steps for charges ($G$CMP_EH_MAX_STEPS)
   G4int maxLukePhonons;  // Approx. Luke phonon limit ($G4MP_MAX_LUKE)
   G4int pSurfStepLimit;  // Phonon surface displacement step limit ($G4CMP_PHON_SURFLIMIT).
+  G4int macroCharges;    // Carriers per charge track, 1 = off ($G4CMP_MACRO_CHARGES)
+  G4int macroSplitHits;  // Electrode hits per bundle, 0 = all ($G4CMP_MACRO_SPLIT)
+  G4int partitionTaskSize; // Tracks per partition task, 0 = off ($G4CMP_PARTITION_TASKS)
+  G4int partitionThreads;  // Partition task threads, 0 = cores ($G4CMP_PARTITION_THREADS)
   G4String version;	 // Version name string extracted from .g4cmp-version
   G4String LatticeDir;	 // Lattice data directory ($G4LATTICEDATA)
   G4String IVRateModel;	 // Model for IV rate ($G4CMP_IV_RATE_MODEL)
   G4String lukeFilename; // Filename for LukeScattering debugging output
+  G4String fieldStepper; // Integrator for charge transport ($G4CMP_FIELD_STEPPER)
   G4double eTrapMFP;	 // Mean free path for electron trapping
   G4double hTrapMFP;	 // Mean free path for hole trapping
   G4double eDTrapIonMFP; // Mean free path for e- on e-trap ionization ($G4CMP_EETRAPION_MFP)
@@ -213,13 +277,21 @@ private:
   G4double combineSteps; // Maximum length to merge track steps ($G4CMP_COMBINE_STEPLEN)
   G4double EminPhonons;	 // Minimum energy to track phonons ($G4CMP_EMIN_PHONONS)
   G4double EminCharges;	 // Minimum energy to track e/h ($G4CMP_EMIN_CHARGES)
+  G4double EcascadePhonons; // Energy above which phonons cascade in bulk ($G4CMP_PHONON_CASCADE)
+  G4double fieldDelta;	 // Field integration accuracy ($G4CMP_FIELD_DELTA)
+  G4double fieldEpsilon; // Relative field integration error ($G4CMP_FIELD_EPSILON)
   G4double pSurfStepSize;  // Phonon surface displacement step size ($G4CMP_PHON_SURFSTEP).
   G4bool useKVsolver;	 // Use K-Vg eigensolver ($G4CMP_USE_KVSOLVER)
   G4bool fanoEnabled;	 // Apply Fano statistics to ionization energy deposits ($G4CMP_FANO_ENABLED)
   G4bool kaplanKeepPh;   // Emit or iterate over all phonons in KaplanQP ($G4CMP_KAPLAN_KEEP)
   G4bool chargeCloud;    // Produce e/h pairs around position ($G4CMP_CHARGE_CLOUD) 
   G4bool recordMinE;     // Store below-minimum track energy as NIEL when killed
+  G4bool profiling;      // Collect G4CMPProfiler timing data ($G4CMP_PROFILE_ENABLED)
+  G4bool meshSteps;      // Limit charge steps to mesh tetrahedra ($G4CMP_MESH_STEPS)
+  G4bool rateTables;     // Tabulate IV scattering rates ($G4CMP_RATE_TABLES)
+  G4bool nielTables;     // Tabulate NIEL yield function ($G4CMP_NIEL_TABLES)
   G4VNIELPartition* nielPartition; // Function class to compute non-ionizing ($G4CMP_NIEL_FUNCTION)
+  G4CMPNIELTable* nielTable;	 // Table of nielPartition, not shared with master
   // Empirical Lindhard Model Parameters
     // Model fit parameters
   G4double Empklow;  
@@ -231,6 +303,8 @@ private:
   G4bool EmpEDepK; 
     // If k is not energy dependent, provide/use kFixed
   G4double EmpkFixed; 
+  // Field accuracy (delta, epsilon) by volume name
+  std::map<G4String, std::pair<G4double,G4double> > fieldAccuracy;
   //
   G4CMPConfigMessenger* messenger;	// User interface (UI) commands
 };
@@ -47,6 +47,15 @@
 // 20250213  G4CMP-457: Add empirical Lindhard NIEL parameters.
 // 20250325  G4CMP-463:  Add parameter for phonon surface step size & limit.
 // 20250502  G4CMP-358: Add macro command for maximum steps (stuck tracks).
+// 20261019  Add macro commands to enable and print G4CMPProfiler timing.
+// 20261019  Add phononCascadeEnergy command for bulk phonon cascade.
+// 20261019  Add commands for field stepper and per-volume field accuracy.
+// 20261019  Add meshStepLimit command to limit charge steps to tetrahedra.
+// 20261019  Add useRateTables command for tabulated IV scattering rates.
+// 20261019  Add macroCharges and macroSplitHits for macro-carrier transport.
+// 20261019  Add partitionTaskSize to split large partitions across tasks.
+// 20261019  Add partitionThreads for partitioning task pool.
+// 20261019  Add useNIELTables command for tabulated NIEL yield.
 
 
 #include "G4UImessenger.hh"
@@ -73,15 +82,22 @@ private:
 
   G4UIcmdWithoutParameter* versionCmd;
   G4UIcmdWithoutParameter* printCmd;
+  G4UIcmdWithoutParameter* printProfileCmd;
   G4UIcmdWithAnInteger* verboseCmd;
   G4UIcmdWithAnInteger* ehBounceCmd;
   G4UIcmdWithAnInteger* pBounceCmd;
   G4UIcmdWithAnInteger* maxStepsCmd;
   G4UIcmdWithAnInteger* maxLukeCmd;
+  G4UIcmdWithAnInteger* macroCmd;
+  G4UIcmdWithAnInteger* macroSplitCmd;
+  G4UIcmdWithAnInteger* partTaskCmd;
+  G4UIcmdWithAnInteger* partThreadCmd;
   G4UIcmdWithAnInteger* pSurfStepLimitCmd;
   G4UIcmdWithADoubleAndUnit* clearCmd;
   G4UIcmdWithADoubleAndUnit* minEPhononCmd;
   G4UIcmdWithADoubleAndUnit* minEChargeCmd;
+  G4UIcmdWithADoubleAndUnit* cascadeECmd;
+  G4UIcmdWithADoubleAndUnit* fieldDeltaCmd;
   G4UIcmdWithADoubleAndUnit* sampleECmd;
   G4UIcmdWithADoubleAndUnit* comboStepCmd;
   G4UIcmdWithADoubleAndUnit* trapEMFPCmd;
@@ -96,15 +112,22 @@ private:
   G4UIcmdWithADouble* makePhononCmd;
   G4UIcmdWithADouble* makeChargeCmd;
   G4UIcmdWithADouble* lukePhononCmd;
+  G4UIcmdWithADouble* fieldEpsilonCmd;
   G4UIcmdWithAString* dirCmd;
   G4UIcmdWithAString* lukeFileCmd;
   G4UIcmdWithAString* ivRateModelCmd;
   G4UIcmdWithAString* nielPartitionCmd;
+  G4UIcmdWithAString* fieldStepperCmd;
+  G4UIcommand*        fieldAccuracyCmd;
   G4UIcmdWithABool*   kvmapCmd;
   G4UIcmdWithABool*   fanoStatsCmd;
   G4UIcmdWithABool*   kaplanKeepCmd;
   G4UIcmdWithABool*   ehCloudCmd;
   G4UIcmdWithABool*   recordMinECmd;
+  G4UIcmdWithABool*   profileCmd;
+  G4UIcmdWithABool*   meshStepCmd;
+  G4UIcmdWithABool*   rateTableCmd;
+  G4UIcmdWithABool*   nielTableCmd;
 
   // Empirical Lindhard Model Macro Commands
   G4UIcmdWithABool* EmpEDepKCmd;
@@ -9,6 +9,7 @@
 // $Id$
 //
 // 20170815  Move G4CMPProcessUtils inheritance to base class
+// 20261019  Add RateForEnergy() for use without a track
 
 #ifndef G4CMPDownconversionRate_hh
 #define G4CMPDownconversionRate_hh 1
@@ -22,6 +23,9 @@ public:
   virtual ~G4CMPDownconversionRate() {;}
 
   virtual G4double Rate(const G4Track& aTrack) const;
+
+  // Rate for L-phonon of given energy, using current lattice
+  G4double RateForEnergy(G4double energy) const;
 };
 
 #endif	/* G4CMPDownconversionRate_hh */
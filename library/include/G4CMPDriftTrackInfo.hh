@@ -12,11 +12,17 @@
 // $Id$
 //
 // 20161111 Initial commit - R. Agnese
+// 20261019 Add multiplicity and diffusion width for macro-carrier bundles
+// 20261019 Add Luke sampling factor, set by G4CMPEnergyPartition
+// 20261019 Diffusion width uses only displacement transverse to field
 
 #ifndef G4CMPDriftTrackInfo_hh
 #define G4CMPDriftTrackInfo_hh 1
 
 #include "G4CMPVTrackInfo.hh"
+#include "G4ThreeVector.hh"
+
+class G4Track;
 /*
 #include "G4Allocator.hh"
 
@@ -42,10 +48,31 @@ public:
   G4int ValleyIndex() const                                { return valleyIdx; }
   void SetValleyIndex(G4int valIdx);
 
+  // Luke phonon emission rate for this carrier (see /g4cmp/sampleLuke)
+  G4double LukeSampling() const                         { return lukeSampling; }
+  void SetLukeSampling(G4double samp)                   { lukeSampling = samp; }
+
+  // Number of carriers represented by track (see /g4cmp/macroCharges)
+  G4int Multiplicity() const                            { return multiplicity; }
+  void SetMultiplicity(G4int mult);
+
+  // Spread of carriers in bundle, from random walk between scatters
+  G4double DiffusionWidth() const;
+  void AddScattering(const G4Track& track);
+
+  // Path from start to end of segment, with drift field (any coordinates)
+  void AddDiffusion(const G4ThreeVector& start, const G4ThreeVector& end,
+		    const G4ThreeVector& field);
+
   virtual void Print() const override;
 
 private:
   G4int valleyIdx;
+  G4double lukeSampling;	// Luke emission rate, from partition or config
+  G4int multiplicity = 1;	// Carriers in macro-carrier bundle
+  G4double diffusion2 = 0.;	// Variance (per axis) of bundle positions
+  G4bool scattered = false;	// Flag if lastScatter has been filled
+  G4ThreeVector lastScatter;	// Position of previous scattering
 };
 
 #endif
@@ -8,7 +8,10 @@
 
 #include "G4VSensitiveDetector.hh"
 #include "G4CMPElectrodeHit.hh"
+#include "G4ThreeVector.hh"
+#include <vector>
 
+class G4CMPRamoSignal;
 class G4HCofThisEvent;
 
 class G4CMPElectrodeSensitivity : public G4VSensitiveDetector {
@@ -21,13 +24,32 @@ public:
   G4CMPElectrodeSensitivity(G4CMPElectrodeSensitivity&&);
   G4CMPElectrodeSensitivity& operator=(G4CMPElectrodeSensitivity&&);
 
+  virtual ~G4CMPElectrodeSensitivity();
+
   virtual void Initialize(G4HCofThisEvent*) override;
-  
+
+  // Time-resolved Ramo signals from charge steps; takes ownership
+  void SetRamoSignal(G4CMPRamoSignal* signal);
+  const G4CMPRamoSignal* GetRamoSignal() const { return ramoSignal; }
+
+  // Number of hits for macro-carrier bundle (see /g4cmp/macroSplitHits)
+  static G4int NumberOfSplitHits(G4int multiplicity);
+
+  // Divide hit into nsplit equal shares of weight and energy deposit,
+  // spread by sigma in plane normal to surface; input hit is first
+  static void SplitHit(G4CMPElectrodeHit* hit, G4int nsplit, G4double sigma,
+		       const G4ThreeVector& norm,
+		       std::vector<G4CMPElectrodeHit*>& subhits);
+
 protected:
   virtual G4bool ProcessHits(G4Step*, G4TouchableHistory*) override;
   virtual G4bool IsHit(const G4Step*, const G4TouchableHistory*) const;
 
+  // Split hit from macro-carrier bundle, spread by its diffusion width
+  void InsertChargeHits(const G4Step* step, G4CMPElectrodeHit* hit);
+
   G4CMPElectrodeHitsCollection* hitsCollection;
+  G4CMPRamoSignal* ramoSignal;
 };
 
 #endif
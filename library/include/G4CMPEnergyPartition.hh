@@ -30,6 +30,11 @@
 // 20220816  Add generated track counts, for convenience before filling
 // 20220816  G4CMP-308 -- Support generating multiple primary positions.
 // 20240105  Add UpdateSummary() function to set position and track info
+// 20261019  Store macro-carrier multiplicity for each charge in "Data".
+// 20261019  Keep sampling factors in partitioner, not G4CMPConfigManager.
+// 20261019  Fill particle list in place, optionally split across tasks.
+// 20261019  Compute track positions and kinematics in tasks, before creating
+//		tracks on the calling thread; drop FillTrackInfo().
 
 #ifndef G4CMPEnergyPartition_hh
 #define G4CMPEnergyPartition_hh 1
@@ -37,6 +42,7 @@
 #include "globals.hh"
 #include "G4CMPProcessUtils.hh"
 #include "G4ThreeVector.hh"
+#include <functional>
 #include <vector>
 
 class G4CMPChargeCloud;
@@ -51,6 +57,7 @@ class G4PrimaryVertex;
 class G4Track;
 class G4VParticleChange;
 class G4VPhysicalVolume;
+class G4VTouchable;
 
 
 class G4CMPEnergyPartition : public G4CMPProcessUtils {
@@ -135,6 +142,12 @@ public:
   void ComputeChargeSampling(G4double eIon);
   void ComputePhononSampling(G4double eNIEL);
   void ComputeLukeSampling(G4double eIon);
+
+  // Sampling factors used in last DoPartition(); Luke sampling is passed
+  // to generated charges
+  G4double GetChargeSampling() const { return chargeSampling; }
+  G4double GetPhononSampling() const { return phononSampling; }
+  G4double GetLukeSampling() const { return lukeSampling; }
   
   // Fraction of total energy deposit in material which goes to e/h pairs
   G4double LindhardScalingFactor(G4double energy, G4double Z=0,
@@ -145,10 +158,29 @@ public:
 
 protected:
   void GenerateCharges(G4double energy);
-  void AddChargePair(G4double ePair, G4double wt);
+  void FillChargePair(size_t index, G4double ePair, G4double wt, G4int mult=1);
 
   void GeneratePhonons(G4double energy);
-  void AddPhonon(G4double ePhon, G4double wt);
+  void FillPhonon(size_t index, G4double ePhon, G4double wt);
+
+  // Call fill(begin,end) over [0,n), in blocks with separate random streams
+  // for long lists; blocks are grouped into tasks if G4CMP_PARTITION_TASKS
+  // is set, but the results do not depend on the grouping
+  void FillInTasks(size_t n,
+		   const std::function<void(size_t,size_t)>& fill) const;
+
+  // Generate charge cloud around center, in tasks
+  void GenerateCloud(const G4VTouchable* touch,
+		     const G4ThreeVector& center) const;
+
+  // Compute positions and kinematics for secondary tracks, in tasks
+  void FillKinematics(const G4VTouchable* touch,
+		      const G4ThreeVector& center) const;
+  void FillKinematics(size_t index, const G4VTouchable* touch,
+		      const G4ThreeVector& pos) const;
+
+  // Create track from particle and kinematics, on calling thread
+  G4Track* CreateTrack(size_t index, G4double time) const;
 
   G4PrimaryVertex* CreateVertex(G4Event* event, const G4ThreeVector& pos,
 				G4double time) const;
@@ -166,10 +198,14 @@ protected:
   G4int nParticlesMinimum;	// Minimum production when downsampling
   G4bool applyDownsampling;	// Flag whether to do downsampling calcualtions
 
+  G4double chargeSampling;	// Sampling factors for current partition,
+  G4double phononSampling;	// initialized from G4CMPConfigManager
+  G4double lukeSampling;
+
   G4CMPChargeCloud* cloud;	// Distribute e/h around central position
 
   size_t nPairsTrue;		// True number of pairs (no downsampling)
-  size_t nPairsGen;		// Number of pairs after downsampling
+  size_t nPairsGen;		// Number of pair tracks after downsampling
   G4double chargeEnergyLeft;	// Energy to partition into e/h pairs
 
   size_t nPhononsTrue;		// True number of phonons (no downsampling)
@@ -184,13 +220,24 @@ protected:
     G4ThreeVector dir;
     G4double ekin;
     G4double wt;
+    G4int mult;			// Carriers in macro-carrier bundle
 
-    Data() : pd(0), ekin(0.), wt(0.) {;}	// Default ctor for vector::resize()
+    Data() : pd(0), ekin(0.), wt(0.), mult(1) {;}	// Default ctor for vector::resize()
     Data(G4ParticleDefinition* part, const G4ThreeVector& d, G4double E,
-	 G4double w) : pd(part), dir(d), ekin(E), wt(w) {;}
+	 G4double w, G4int m=1) : pd(part), dir(d), ekin(E), wt(w), mult(m) {;}
   };
     
   std::vector<Data> particles;	// Combined phonons and charge carriers
+
+  struct Kinematics {		// Computed by FillKinematics(), global frame
+    G4ThreeVector pos;		// Track position (charge cloud)
+    G4ThreeVector vdir;		// Phonon group velocity direction
+    G4double vel;		// Phonon group velocity
+    G4double mass;		// Charge carrier effective mass
+    G4int valley;		// Electron valley, -1 for others
+  };
+
+  mutable std::vector<Kinematics> kinematics;	// Same order as particles
 };
 
 #endif	/* G4CMPEnergyPartition_hh */
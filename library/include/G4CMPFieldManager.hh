@@ -12,6 +12,7 @@
 // 20170801  Add counter to track instances of null-lattice, for reflections.
 // 20210901  Add local verbosity flag for reporting diagnostics; use instead
 //	     of G4CMP global setting.
+// 20261019  Select stepper by name; apply field accuracy for each volume.
 
 #ifndef G4CMPFieldManager_h
 #define G4CMPFieldManager_h 1
@@ -28,6 +29,7 @@ class G4LatticeLogical;
 class G4LatticePhysical;
 class G4MagInt_Driver;
 class G4MagIntegratorStepper;
+class G4VPhysicalVolume;
 
 
 class G4CMPFieldManager : public G4FieldManager {
@@ -49,6 +51,14 @@ public:
   void ConfigureForTrack(const G4Track* aTrack);
   void SetChargeValleyForTrack(const G4LatticePhysical* lat, G4int valley);
 
+  // Replace integrator: ClassicalRK4, DormandPrince745, Midpoint, UniformField
+  // Default is taken from G4CMPConfigManager::GetFieldStepper()
+  void SetStepperType(const G4String& name);
+  const G4String& GetStepperType() const { return stepperType; }
+
+  // Set DeltaOneStep and epsilon from configuration for volume
+  void ApplyAccuracy(const G4VPhysicalVolume* volume);
+
 private:
   G4int verboseLevel;		// For reporting diagnostic progress
 
@@ -61,8 +71,12 @@ private:
   G4int latticeNulls;		// Count consective cases of no lattice
   const G4int maxLatticeNulls;	// Maximum allowed cases (reflection == 2)
 
+  G4String stepperType;		// Name of integrator in use
+
   // NOTE: All pointers are kept in order to delete in dtor
   void CreateTransport();
+  void DeleteTransport();
+  G4MagIntegratorStepper* CreateStepper() const;
   G4CMPEqEMField* theEqMotion;
   G4MagIntegratorStepper* theStepper;
   G4MagInt_Driver* theDriver;
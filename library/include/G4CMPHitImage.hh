@@ -0,0 +1,140 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPHitImage.hh
+/// \brief Definition of the G4CMPHitImage class, which histograms the
+///   final positions of G4CMPElectrodeHits on a face (e.g., caustic
+///   images), in place of writing every hit to a file.
+///
+///   Face coordinates are u = (pos-origin).uAxis and v = (pos-origin).vAxis,
+///   binned uniformly.  Each selected particle type (mode) has its own
+///   image, which may be further split into slices of hit time and of
+///   energy deposit.  Bins are filled with the hit weight, or with weight
+///   times energy deposit.  Hits outside the binning are counted, but not
+///   stored.
+///
+///   Each thread fills its own image; images with the same configuration
+///   are combined with Merge() (e.g., at the end of a run), and written as
+///   one binary file:
+///
+///   Header:  char[8]  "G4CMPIMG"
+///            uint32   format version (kVersion); also detects byte order
+///            uint32   weighting (0 = weight, 1 = weight*energy [eV])
+///            uint32   number of modes, followed by uint8 particle types
+///                       (see G4CMPHitWriter::ParticleType)
+///            float64  origin, uAxis, vAxis (x,y,z each) [mm]
+///            uint32   nu, float64 umin, umax [mm]
+///            uint32   nv, float64 vmin, vmax [mm]
+///            uint32   number of time slice edges, float64 edges [ns]
+///            uint32   number of energy slice edges, float64 edges [eV]
+///            uint64   hits filled, uint64 hits outside binning
+///   Data:    float64  [mode][time slice][energy slice][v][u]
+///
+///   Use tools/g4cmpImageToCSV to convert the file to text.
+//
+// $Id$
+//
+// 20261019  New class for in-memory images of electrode hits
+
+#ifndef G4CMPHitImage_hh
+#define G4CMPHitImage_hh 1
+
+#include "globals.hh"
+#include "G4CMPElectrodeHit.hh"
+#include "G4ThreeVector.hh"
+#include <stdint.h>
+#include <vector>
+
+
+class G4CMPHitImage {
+public:
+  enum Weighting { kCount=0, kEnergy=1 };
+
+  static const char     kMagic[8];		// "G4CMPIMG", no terminator
+  static const uint32_t kVersion = 1;
+
+  // Default is 100x100 bins over 1 cm square face at z=0, phonon modes
+  G4CMPHitImage();
+  virtual ~G4CMPHitImage() {;}
+
+  // Configuration; changing any of these clears the image
+  void SetFace(const G4ThreeVector& origin, const G4ThreeVector& uAxis,
+	       const G4ThreeVector& vAxis);
+  void SetBinning(size_t nu, G4double umin, G4double umax,
+		  size_t nv, G4double vmin, G4double vmax);
+
+  // Particle types (G4CMPHitWriter::ParticleType), one image for each
+  void SetModes(const std::vector<G4int>& types);
+
+  // Slice edges must be increasing; empty (default) means no slicing
+  void SetTimeSlices(const std::vector<G4double>& edges);
+  void SetEnergySlices(const std::vector<G4double>& edges);
+
+  void SetWeighting(Weighting value);
+
+  // Accumulate hit final positions
+  void Fill(const G4CMPElectrodeHitsCollection* hits);
+  void Fill(const G4CMPElectrodeHit* hit);
+  void Fill(G4int type, const G4ThreeVector& pos, G4double time,
+	    G4double energy, G4double weight=1.);
+
+  // Add contents of image with same configuration; false if different
+  G4bool Merge(const G4CMPHitImage& other);
+
+  // Clear contents, keeping configuration
+  void Reset();
+
+  // Write or read image file; Read() replaces configuration and contents
+  G4bool Write(const G4String& fileName) const;
+  G4bool Read(const G4String& fileName);
+
+  // Access configuration and contents
+  const G4ThreeVector& GetOrigin() const { return origin; }
+  const G4ThreeVector& GetUAxis() const { return uAxis; }
+  const G4ThreeVector& GetVAxis() const { return vAxis; }
+  size_t GetNU() const { return nu; }
+  size_t GetNV() const { return nv; }
+  G4double GetUMin() const { return umin; }
+  G4double GetUMax() const { return umax; }
+  G4double GetVMin() const { return vmin; }
+  G4double GetVMax() const { return vmax; }
+
+  const std::vector<G4int>& GetModes() const { return modes; }
+  const std::vector<G4double>& GetTimeSlices() const { return timeEdges; }
+  const std::vector<G4double>& GetEnergySlices() const { return energyEdges; }
+  size_t GetNTimeSlices() const;
+  size_t GetNEnergySlices() const;
+  Weighting GetWeighting() const { return weighting; }
+
+  uint64_t GetEntries() const { return nEntries; }
+  uint64_t GetOutside() const { return nOutside; }
+
+  // Image for one mode and slice, as nv rows of nu bins
+  const G4double* GetImage(size_t mode, size_t tSlice=0,
+			   size_t eSlice=0) const;
+
+protected:
+  void Resize();				// Allocate and clear contents
+  G4bool SameConfiguration(const G4CMPHitImage& other) const;
+
+  // Slice index for value, or -1 if outside all slices
+  static G4int FindSlice(const std::vector<G4double>& edges, G4double value);
+
+private:
+  G4ThreeVector origin, uAxis, vAxis;
+  size_t nu, nv;
+  G4double umin, umax, vmin, vmax;
+  G4double uScale, vScale;			// Bins per unit length
+
+  std::vector<G4int> modes;
+  std::vector<G4int> modeIndex;			// Image for each particle type
+  std::vector<G4double> timeEdges, energyEdges;
+  Weighting weighting;
+
+  std::vector<G4double> contents;
+  uint64_t nEntries, nOutside;
+};
+
+#endif	/* G4CMPHitImage_hh */
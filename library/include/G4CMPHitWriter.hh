@@ -0,0 +1,127 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPHitWriter.hh
+/// \brief Definition of the G4CMPHitWriter class, which writes collections
+///   of G4CMPElectrodeHit to a compact binary file, in blocks of columns.
+///
+///   The file starts with a header, followed by any number of blocks:
+///
+///   Header:  char[8]  "G4CMPHIT"
+///            uint32   format version (kVersion); also detects byte order
+///            uint32   size of real-valued columns (4 = float, 8 = double)
+///            uint32   number of particle types, followed for each by
+///                       uint16 name length, name characters
+///            uint32   number of columns, followed for each by
+///                       uint8 type code ('i' int32, 'b' uint8, 'r' real),
+///                       uint16 name length, name characters
+///
+///   Block:   uint32   block marker (kBlockMarker)
+///            int32    run ID
+///            uint32   number of rows N
+///            column arrays in header order, each N values
+///
+///   Hits are buffered by column, and written as one block when the buffer
+///   is full, when the run ID changes, or on Flush() or Close().  Multiple
+///   writers (e.g., one per worker thread) may append to the same file;
+///   each block is written as a unit.  Use tools/g4cmpHitsToCSV to convert.
+//
+// $Id$
+//
+// 20261019  New class for binary columnar output of electrode hits
+// 20261019  Separate block encoding from file output, for G4CMPOutputService
+
+#ifndef G4CMPHitWriter_hh
+#define G4CMPHitWriter_hh 1
+
+#include "globals.hh"
+#include "G4CMPElectrodeHit.hh"
+#include <fstream>
+#include <stdint.h>
+#include <vector>
+
+
+class G4CMPHitWriter {
+public:
+  // Particle types are stored as enum, not name
+  enum ParticleType { kUnknown=0, kPhononL, kPhononTS, kPhononTF,
+		      kElectron, kHole, kNumParticleTypes };
+
+  static const char     kMagic[8];		// "G4CMPHIT", no terminator
+  static const uint32_t kVersion = 1;
+  static const uint32_t kBlockMarker = 0x4B4C4248;	// "HBLK" in file
+
+  // Default block size is tuned for large sequential writes
+  G4CMPHitWriter(const G4String& fileName="", size_t blockRows=65536);
+  virtual ~G4CMPHitWriter();
+
+  // Open file for appending; header is written to new or empty files
+  G4bool Open(const G4String& fileName);
+  void Close();
+  G4bool IsOpen() const { return output.is_open(); }
+  const G4String& GetFileName() const { return fileName; }
+
+  // Real-valued columns are float by default; must be set before Open()
+  void SetDoublePrecision(G4bool value) { doublePrecision = value; }
+  G4bool GetDoublePrecision() const { return doublePrecision; }
+
+  void SetBlockSize(size_t rows) { blockRows = (rows>0 ? rows : 1); }
+  size_t GetBlockSize() const { return blockRows; }
+
+  // Buffer hits for output; block is written when buffer fills
+  void Write(G4int runID, G4int eventID, const G4CMPElectrodeHitsCollection* hits);
+  void Write(G4int runID, G4int eventID, const G4CMPElectrodeHit* hit);
+
+  // Write any buffered hits as a (partial) block
+  void Flush();
+
+  // Write a block already encoded by another writer (see G4CMPOutputService)
+  void WriteEncodedBlock(const std::vector<char>& block);
+
+  // Convert between particle names and stored enum
+  static ParticleType GetParticleType(const G4String& name);
+  static const char* GetParticleName(G4int type);
+
+  // Column names, with units, in storage order (matches example CSV)
+  static const std::vector<G4String>& GetColumnNames();
+
+  // Files ending in ".bin" are written with this class by the examples
+  static G4bool IsBinaryFile(const G4String& fileName);
+
+protected:
+  // Subclasses may send encoded blocks elsewhere instead of to file
+  virtual void WriteBlock(const std::vector<char>& block) {
+    WriteEncodedBlock(block);
+  }
+
+  void WriteHeader();
+  void EncodeBlock();				// Fill blockBuffer from columns
+  void ClearColumns();
+
+  template <class T> void AppendBytes(const T& value);
+  template <class T> void AppendColumn(const std::vector<T>& column);
+  void AppendReals(const std::vector<G4double>& column);
+
+private:
+  G4String fileName;
+  std::ofstream output;
+  size_t blockRows;
+  G4bool doublePrecision;
+  G4int currentRun;
+
+  // Column buffers, filled hit by hit and written as a block
+  std::vector<int32_t> eventID;
+  std::vector<int32_t> trackID;
+  std::vector<uint8_t> particle;
+  std::vector<G4double> startE, startX, startY, startZ, startT;
+  std::vector<G4double> eDep, weight, finalX, finalY, finalZ, finalT;
+
+  std::vector<char> blockBuffer;	// Reused for encoding each block
+
+  G4CMPHitWriter(const G4CMPHitWriter&) = delete;
+  G4CMPHitWriter& operator=(const G4CMPHitWriter&) = delete;
+};
+
+#endif	/* G4CMPHitWriter_hh */
@@ -12,20 +12,41 @@
 // 20170815  Move G4CMPProcessUtils inheritance to base class
 // 20240823  Change name to plain "Quadratic", to match UseRateModel()
 // 20250515  Apply IV energy thresholds to reduce zero-voltage scatters
+// 20261019  Add optional tabulated rate vs. field, filled for each lattice
 
 #ifndef G4CMPIVRateQuadratic_hh
 #define G4CMPIVRateQuadratic_hh 1
 
 #include "G4CMPVScatteringRate.hh"
+#include "G4CMPRateTable.hh"
+#include <map>
+
+class G4LatticePhysical;
 
 
 class G4CMPIVRateQuadratic : public G4CMPVScatteringRate {
 public:
-  G4CMPIVRateQuadratic() : G4CMPVScatteringRate("Quadratic") {;}
+  G4CMPIVRateQuadratic()
+    : G4CMPVScatteringRate("Quadratic"), rateTable(0) {;}
   virtual ~G4CMPIVRateQuadratic() {;}
 
   virtual G4double Rate(const G4Track& aTrack) const;
   virtual G4double Threshold(G4double Eabove=0.) const;
+
+  // Initialize rate table for current lattice
+  virtual void LoadDataForTrack(const G4Track* track);
+  void LoadDataForLattice();
+
+  // Analytic rate for specified field magnitude in Herring-Vogt frame
+  G4double FieldRate(G4double fieldHV) const;
+
+  // Table for current lattice, or null if tables are not used
+  const G4CMPRateTable* GetRateTable() const { return rateTable; }
+
+private:
+  // Tabulated rate vs. field magnitude for each lattice, if enabled
+  std::map<const G4LatticePhysical*, G4CMPRateTable> rateTables;
+  const G4CMPRateTable* rateTable;
 };
 
 #endif	/* G4CMPIVRateQuadratic_hh */
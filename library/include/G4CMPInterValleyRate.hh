@@ -9,11 +9,16 @@
 // $Id$
 //
 // 20170919  Add interface for threshold identification
+// 20261019  Add optional tabulated rate vs. energy, filled for each lattice
 
 #ifndef G4CMPInterValleyRate_hh
 #define G4CMPInterValleyRate_hh 1
 
 #include "G4CMPVScatteringRate.hh"
+#include "G4CMPRateTable.hh"
+#include <map>
+
+class G4LatticePhysical;
 
 
 class G4CMPInterValleyRate : public G4CMPVScatteringRate {
@@ -23,7 +28,7 @@ public:
       hbar_sq(CLHEP::hbar_Planck*CLHEP::hbar_Planck), hbar_4th(hbar_sq*hbar_sq),
       m_electron(CLHEP::electron_mass_c2/CLHEP::c_squared),
       eTrk(0.), density(0.), kT(0.), uSound(0.), alpha(0.), nValley(0),
-      m_DOS(0.), m_DOS3half(0.) {;}
+      m_DOS(0.), m_DOS3half(0.), rateTable(0) {;}
 
   virtual ~G4CMPInterValleyRate() {;}
 
@@ -34,6 +39,15 @@ public:
   // Initialize numerical parameters below
   virtual void LoadDataForTrack(const G4Track* track);
 
+  // Initialize parameters and rate table for current lattice
+  void LoadDataForLattice();
+
+  // Analytic rate (optical and neutral impurity) at specified energy
+  G4double EnergyRate(G4double energy) const;
+
+  // Table for current lattice, or null if tables are not used
+  const G4CMPRateTable* GetRateTable() const { return rateTable; }
+
 protected:
   G4double acousticRate() const;	// Acoustic intravalley rate
   G4double opticalRate() const;		// Optical intervalley D0, D1 rate
@@ -59,6 +73,10 @@ private:
   G4int    nValley;		// Number of final-state valleys (2N-1)
   G4double m_DOS;		// Electron "density of states" average mass
   G4double m_DOS3half;		// m_DOS ^ (3/2)
+
+  // Tabulated rate vs. energy for each lattice, if enabled
+  std::map<const G4LatticePhysical*, G4CMPRateTable> rateTables;
+  const G4CMPRateTable* rateTable;
 };
 
 #endif	/* G4CMPInterValleyRate_hh */
@@ -13,6 +13,7 @@
 // 20170805  Remove GetMeanFreePath() function to scattering-rate model
 // 20190816  Add flag to track secondary phonons immediately (c.f. G4Cerenkov)
 // 20201109  Drop G4CMP_DEBUG protection here, to avoid client rebuilding
+// 20261019  Move debugging file output to WriteDebugOutput()
 
 #ifndef G4CMPLukeScattering_h
 #define G4CMPLukeScattering_h 1
@@ -38,6 +39,12 @@ public:
   void SetTrackSecondariesFirst(const G4bool val) { secondariesFirst = val; }
   G4bool GetTrackSecondariesFirst() const { return secondariesFirst; }
 
+protected:
+  // Write kinematics of emission to debugging file, opening if necessary
+  void WriteDebugOutput(const G4Track& aTrack, G4double kmag, G4double theta,
+			G4double Ephonon, G4double phononWt, G4double kRecoil,
+			G4double Erecoil, G4double pRecoil);
+
 private:
   // hide assignment operator as private
   G4CMPLukeScattering(G4CMPLukeScattering&);
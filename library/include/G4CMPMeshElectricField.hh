@@ -20,6 +20,9 @@
 // 20190612  Mesh pointer ctor should set axes to kUndefined
 // 20200520  For thread-safety, move reusable "pos" buffer here
 // 20240921  G4CMP-244: Add non-const access to meshing object.
+// 20261019  Add GetExitTime() for step limits at tetrahedron boundaries.
+// 20261019  Cache verbose level at construction, for use from any thread.
+// 20261019  Drop "pos" buffer; local vectors allow shared use across threads.
 
 #ifndef G4CMPMeshElectricField_h 
 #define G4CMPMeshElectricField_h 1
@@ -72,6 +75,15 @@ public:
   // Call through to interpolator (e.g., for use with FET code)
   virtual G4double GetPotential(const G4double Point[3]) const;
 
+  // Time for trajectory with constant acceleration to leave the mesh
+  // element (3D only) containing Point; DBL_MAX if no limit applies
+  G4double GetExitTime(const G4double Point[3], const G4ThreeVector& vel,
+		       const G4ThreeVector& acc) const;
+
+  // Diagnostic output level, taken from G4CMPConfigManager when created
+  void SetVerboseLevel(G4int vb);
+  G4int GetVerboseLevel() const { return verboseLevel; }
+
   // Get access to mesh interpolator for client access or copying
         G4CMPVMeshInterpolator* GetInterpolator()       { return Interp; }
   const G4CMPVMeshInterpolator* GetInterpolator() const { return Interp; }
@@ -83,6 +95,7 @@ public:
 private:
   G4CMPVMeshInterpolator* Interp;
   EAxis xCoord, yCoord;			// 2D coordinates for projection
+  G4int verboseLevel;			// Not looked up during evaluation
 
   void BuildInterp(const G4String& EPotFileName, G4double Vscale=1.);
 
@@ -99,9 +112,6 @@ private:
   // Convert between 3D and 2D coordinates (Expand needs to know location)
   void Project2D(const G4double Point[3], G4double Project[2]) const;
   void Expand2Dat(const G4double Point[3], G4ThreeVector& Efield) const;
-
-private:
-  mutable G4ThreeVector pos_;		// Reusale buffer for calculations
 };
 
 #endif	/* G4CMPMeshElectricField_h */
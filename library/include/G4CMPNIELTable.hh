@@ -0,0 +1,113 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPNIELTable.hh
+/// \brief Definition of the G4CMPNIELTable class, which wraps another
+///   G4VNIELPartition function with a table for fast lookup.
+///
+///   The yield is tabulated separately for each material and recoiling
+///   species (Zin,Ain), the first time that combination is used, with
+///   points spaced uniformly in log(E).  Evaluation is a single linear
+///   interpolation.  Energies outside the table range are passed to the
+///   wrapped function.
+///
+///   When filled, the yield is compared with the table at the midpoint of
+///   every interval.  The number of points is doubled (up to 16 times the
+///   requested number) until the largest absolute difference is within
+///   GetTolerance(), or the number of intervals outside it stops falling.
+///   Intervals which still differ, such as across a switch between models,
+///   are passed to the wrapped function.
+///
+///   Tables are filled on demand, so an instance must not be shared
+///   between threads; G4CMPConfigManager keeps one for each thread.
+//
+// $Id$
+//
+// 20261019  New class for tabulated NIEL yield functions
+
+#ifndef G4CMPNIELTable_hh
+#define G4CMPNIELTable_hh 1
+
+#include "G4VNIELPartition.hh"
+#include "G4SystemOfUnits.hh"
+#include "globals.hh"
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <vector>
+
+class G4Material;
+
+
+class G4CMPNIELTable : public G4VNIELPartition {
+public:
+  // Wrapped function is not owned by table; nPoints is per decade
+  G4CMPNIELTable(const G4VNIELPartition* niel, G4double emin=10.*eV,
+		 G4double emax=100.*MeV, G4int nPoints=32);
+  virtual ~G4CMPNIELTable() {;}
+
+  virtual G4double
+  PartitionNIEL(G4double energy, const G4Material* material, G4double Zin=0.,
+		G4double Ain=0.) const override;
+
+  // Tabulate yield for material and species in advance, return max error
+  G4double Fill(const G4Material* material, G4double Zin=0.,
+		G4double Ain=0.) const;
+
+  const G4VNIELPartition* GetModel() const { return model; }
+
+  G4bool InRange(G4double energy) const {
+    return (energy >= eMin && energy < eMax);
+  }
+
+  G4double GetLowEnergy() const  { return eMin; }
+  G4double GetHighEnergy() const { return eMax; }
+
+  // Largest absolute difference and number of points from fill
+  G4double GetError(const G4Material* material, G4double Zin=0.,
+		    G4double Ain=0.) const;
+  G4int GetNPoints(const G4Material* material, G4double Zin=0.,
+		   G4double Ain=0.) const;
+
+  static G4double GetTolerance() { return 1e-4; }
+
+protected:
+  struct Table {
+    G4double invStep;			// 1/(spacing in log(E))
+    std::vector<G4double> values;	// Yield at each point
+    std::vector<char> exact;		// Flag intervals over tolerance
+    G4double maxError;			// Over intervals not flagged
+
+    Table() : invStep(0.), maxError(0.) {;}
+  };
+
+  const Table& GetTable(const G4Material* material, G4double Zin,
+			G4double Ain) const;
+
+  void FillValues(Table& table, const G4Material* material, G4double Zin,
+		  G4double Ain, G4int nPerDecade) const;
+
+  G4double CheckValues(Table& table, const G4Material* material,
+		       G4double Zin, G4double Ain) const;
+
+  G4double Interpolate(const Table& table, G4double t) const {
+    G4int j = std::min(G4int(t), G4int(table.values.size())-2);
+    return table.values[j] + (t-j)*(table.values[j+1]-table.values[j]);
+  }
+
+private:
+  const G4VNIELPartition* model;	// Function being tabulated
+  G4double eMin, eMax;			// Tabulated energy range
+  G4double logEmin, logEmax;
+  G4int nPerDecade;			// Initial points per decade
+
+  using Key = std::tuple<const G4Material*, G4double, G4double>;
+  mutable std::map<Key, Table> tables;	// Filled on first use
+
+  mutable Key lastKey;			// Most recently used table
+  mutable const Table* lastTable;
+};
+
+#endif	/* G4CMPNIELTable_hh */
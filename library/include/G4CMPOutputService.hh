@@ -0,0 +1,183 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPOutputService.hh
+/// \brief Definition of the G4CMPOutputService class, which writes
+///   G4CMPElectrodeHit collections from all threads to a single binary
+///   file (see G4CMPHitWriter), using a dedicated writer thread.
+///
+///   There is one service per output file, shared by all threads; use
+///   GetService(fileName) from each thread's sensitive detector.  Hits
+///   are encoded into per-thread column buffers with no locking; only
+///   completed blocks are handed to the writer thread, which appends them
+///   to the file in large sequential writes.
+///
+///   Completed blocks wait in a queue for the writer thread.  To bound
+///   memory, if more than GetMaxQueuedBytes() are waiting, Write() blocks
+///   until the writer thread has caught up.
+///
+///   If event ordering is enabled, the writer thread holds blocks until
+///   all earlier events (by event ID) have been written.  Each sensitive
+///   detector (or other caller of Write()) sharing the file should call
+///   AddProducer() from its own thread; an event is complete when Write()
+///   has been called by every producer on the thread which processed it.
+///   With no producers registered, each call to Write() completes an
+///   event.  At most GetMaxPendingEvents() events are held; beyond that,
+///   the earliest event is written without waiting.
+///
+///   At the end of each run, each thread flushes its own buffers.  The
+///   master thread (or sequential job) waits until every buffer written
+///   during the run has been flushed by its owner, then the writer thread
+///   finishes all pending output.
+//
+// $Id$
+//
+// 20261019  New class for asynchronous multithreaded hit output
+// 20261019  Bound output queue; count producers to complete ordered events
+// 20261019  Only owning thread flushes a buffer; Drain() waits for owners.
+
+#ifndef G4CMPOutputService_hh
+#define G4CMPOutputService_hh 1
+
+#include "globals.hh"
+#include "G4CMPElectrodeHit.hh"
+#include "G4CMPHitWriter.hh"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+class G4CMPOutputService {
+public:
+  // Get service for specified file, creating and opening it if needed
+  static G4CMPOutputService* GetService(const G4String& fileName);
+
+  // Wait for all thread buffers to be flushed, then for output (e.g., at
+  // end of run)
+  static void DrainAll();
+
+  // Finish all output, stop writer threads, and delete services
+  static void CloseAll();
+
+  const G4String& GetFileName() const { return fileName; }
+  G4bool IsOpen() const { return fileWriter.IsOpen(); }
+
+  // Hold blocks for in-order output by (run, event) ID
+  void SetEventOrdered(G4bool value) { eventOrdered = value; }
+  G4bool GetEventOrdered() const { return eventOrdered; }
+
+  void SetMaxPendingEvents(size_t value) { maxPending = value; }
+  size_t GetMaxPendingEvents() const { return maxPending; }
+
+  // Limit on encoded data waiting for writer thread (0 for no limit)
+  void SetMaxQueuedBytes(size_t value) { maxQueuedBytes = value; }
+  size_t GetMaxQueuedBytes() const { return maxQueuedBytes; }
+
+  // Register or remove a caller of Write() on the current thread
+  void AddProducer();
+  void RemoveProducer();
+
+  // Add hits from current thread; in ordered mode, this completes event
+  // when called by every producer on this thread
+  void Write(G4int runID, G4int eventID,
+	     const G4CMPElectrodeHitsCollection* hits);
+
+  // Flush current thread's buffer; each thread must do this at end of run
+  void FlushThreadBuffer();
+
+  // Flush current thread's buffer, wait for other threads to flush theirs,
+  // and wait until all output is on disk
+  void Drain();
+
+protected:
+  G4CMPOutputService(const G4String& fileName);
+  virtual ~G4CMPOutputService();
+
+  // Encoded output from a thread buffer, tagged for ordering
+  struct Block {
+    G4int runID;
+    G4int eventID;
+    G4int producers;			// End of event from thread with N
+    std::vector<char> data;
+  };
+
+  // Per-thread column buffer, handing blocks to writer thread
+  class ThreadBuffer : public G4CMPHitWriter {
+  public:
+    ThreadBuffer(G4CMPOutputService* svc)
+      : service(svc), active(false), runID(0), eventID(0), producers(0) {;}
+    virtual ~ThreadBuffer() { Flush(); }
+
+    void SetEvent(G4int run, G4int evt) { runID = run; eventID = evt; }
+
+    // Number of Write() calls needed for each event on this thread
+    void AddProducers(G4int n) { producers = std::max(producers+n, 0); }
+    G4int GetProducers() const { return producers>0 ? producers : 1; }
+
+    // Written since last FlushThreadBuffer(); used by owning thread only
+    G4bool active;
+
+  protected:
+    virtual void WriteBlock(const std::vector<char>& block);
+
+  private:
+    G4CMPOutputService* service;
+    G4int runID, eventID;
+    G4int producers;
+  };
+
+  ThreadBuffer* GetThreadBuffer();
+  void Enqueue(G4int runID, G4int eventID, G4int producers,
+	       const std::vector<char>& data);
+
+  void WriterLoop();			// Body of writer thread
+  void WriteReadyEvents(G4bool force);	// Called by writer thread only
+  void WaitForOutput();			// Write all held events
+  void Stop();
+
+private:
+  G4String fileName;
+  G4CMPHitWriter fileWriter;		// Owns output file and header
+  std::atomic<bool> eventOrdered;	// May be set from any thread
+  size_t maxPending;
+  std::atomic<size_t> maxQueuedBytes;
+
+  std::mutex bufferMutex;		// Protects buffers list only
+  std::vector<ThreadBuffer*> buffers;	// Owned; one per thread
+
+  std::mutex queueMutex;		// Protects everything below
+  std::condition_variable queueReady;	// Writer waits for blocks
+  std::condition_variable queueDone;	// Drain() waits for writer
+  std::condition_variable queueSpace;	// Enqueue() waits for writer
+  std::deque<Block> queue;
+  size_t queuedBytes;			// Encoded data in queue
+  G4int nActive;			// Thread buffers not yet flushed
+  G4bool flushPending;			// Write all held events, then idle
+  G4bool stopping;
+  std::thread writer;
+
+  // Held blocks, used only by writer thread
+  struct PendingEvent {
+    PendingEvent() : nDone(0), nExpected(0) {;}
+    std::vector<std::vector<char> > blocks;
+    G4int nDone;			// Producers finished with event
+    G4int nExpected;			// Producers on thread, from first done
+
+    G4bool complete() const { return (nExpected > 0 && nDone >= nExpected); }
+  };
+  std::map<std::pair<G4int,G4int>, PendingEvent> pending;
+  std::pair<G4int,G4int> nextEvent;	// (run, event) to write next
+
+  G4CMPOutputService(const G4CMPOutputService&) = delete;
+  G4CMPOutputService& operator=(const G4CMPOutputService&) = delete;
+};
+
+#endif	/* G4CMPOutputService_hh */
@@ -0,0 +1,146 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPPhononCascade.hh
+/// \brief Definition of the G4CMPPhononCascade class, which follows the
+///   high-frequency phonon downconversion cascade within the bulk of a
+///   crystal without creating intermediate Geant4 tracks.
+///
+///   Starting from an L-phonon selected for downconversion, the daughters
+///   are transported in an internal loop, using the same rates as the
+///   G4PhononDownconversion and G4PhononScattering processes, and the decay
+///   kinematics of G4CMPAnharmonicDecay.  Phonons are held in flat arrays
+///   by attribute (energy, time, position, wavevector, mode), in the local
+///   coordinates of the volume.
+///
+///   A phonon leaves the cascade, and is returned as a secondary track,
+///   when its energy falls below the threshold set by
+///   G4CMPConfigManager::GetPhononCascadeEnergy(), or when its next
+///   interaction would be beyond the volume boundary.  Below threshold,
+///   and at surfaces, the normal Geant4 processes take over.
+///
+///   The bulk cascade may also be run without a track, by configuring the
+///   lattice and volume with LoadDataForVolume() and calling Cascade()
+///   with a parent in local coordinates.  The surviving phonons are then
+///   available through GetNumberOfPhonons() and the accessors below.
+//
+// $Id$
+//
+// 20261019  New class for bulk phonon cascade above an energy threshold
+// 20261019  Add Cascade() and phonon accessors for use without a track
+
+#ifndef G4CMPPhononCascade_hh
+#define G4CMPPhononCascade_hh 1
+
+#include "G4CMPProcessUtils.hh"
+#include <vector>
+
+class G4CMPAnharmonicDecay;
+class G4CMPDownconversionRate;
+class G4CMPPhononScatteringRate;
+class G4ParticleChange;
+class G4Track;
+class G4VProcess;
+class G4VSolid;
+
+
+class G4CMPPhononCascade : public G4CMPProcessUtils {
+public:
+  G4CMPPhononCascade(const G4VProcess* theProcess);
+  virtual ~G4CMPPhononCascade();
+
+  void SetVerboseLevel(G4int vb);
+  G4int GetVerboseLevel() const { return verboseLevel; }
+
+  // Configure rates and decay utility for current track's volume
+  virtual void LoadDataForTrack(const G4Track* track);
+
+  // Configure rates and decay utility without a track
+  void LoadDataForVolume(const G4LatticePhysical* lat, const G4VSolid* vol);
+
+  // Energy threshold from configuration; zero disables cascade
+  static G4double GetThreshold();
+
+  // Cascade is used for parent phonons above threshold
+  G4bool IsApplicable(const G4Track& track) const;
+
+  // Decay the parent, follow all daughters in bulk, and add the surviving
+  // phonons to particle change as secondaries; the parent is killed
+  void DoCascade(const G4Track& track, G4ParticleChange& particleChange);
+
+  // Decay an L-phonon and follow all daughters in bulk, without tracks;
+  // position and wavevector are in local coordinates of the volume
+  void Cascade(G4double energy, G4double time, const G4ThreeVector& pos,
+	       const G4ThreeVector& k);
+
+  // Phonons leaving the most recent cascade, in local coordinates
+  size_t GetNumberOfPhonons() const { return emitted.size(); }
+  G4int GetPhononMode(size_t j) const { return mode[emitted[j]]; }
+  G4double GetPhononEnergy(size_t j) const { return energy[emitted[j]]; }
+  G4double GetPhononTime(size_t j) const { return time[emitted[j]]; }
+  G4ThreeVector GetPhononPosition(size_t j) const {
+    return GetPosition(emitted[j]);
+  }
+  G4ThreeVector GetPhononWaveVector(size_t j) const {
+    return GetWaveVector(emitted[j]);
+  }
+
+  // Limit on internal interactions of each phonon, to avoid infinite loops
+  void SetMaxInteractions(G4int value) { maxInteractions = value; }
+  G4int GetMaxInteractions() const { return maxInteractions; }
+
+  // Counters from most recent cascade
+  G4int GetNumberOfDecays() const { return nDecays; }
+  G4int GetNumberOfScatters() const { return nScatters; }
+
+protected:
+  void ClearBuffers();
+
+  // Add phonon to arrays and stack; position and wavevector are local
+  void AddPhonon(G4int mode, G4double energy, G4double time,
+		 const G4ThreeVector& pos, const G4ThreeVector& k);
+
+  // Transport phonon until it leaves the cascade; daughters are stacked
+  void FollowPhonon(size_t i);
+
+  // Create track for phonon at its current position and time
+  G4Track* CreateTrack(const G4Track& parent, size_t i) const;
+
+  G4ThreeVector GetPosition(size_t i) const {
+    return G4ThreeVector(posX[i], posY[i], posZ[i]);
+  }
+
+  G4ThreeVector GetWaveVector(size_t i) const {
+    return G4ThreeVector(kX[i], kY[i], kZ[i]);
+  }
+
+private:
+  G4int verboseLevel;
+  G4String procName;
+  G4int maxInteractions;
+
+  G4CMPAnharmonicDecay* anharmonicDecay;	// Owned utilities
+  G4CMPDownconversionRate* downRate;
+  G4CMPPhononScatteringRate* scatRate;
+
+  const G4VSolid* solid;			// Volume of current track
+  G4double threshold;				// Cached for current cascade
+
+  // Phonon attributes, indexed together; reused between cascades
+  std::vector<G4int>    mode;
+  std::vector<G4double> energy, time;
+  std::vector<G4double> posX, posY, posZ;
+  std::vector<G4double> kX, kY, kZ;
+
+  std::vector<size_t> pending;			// Phonons still to follow
+  std::vector<size_t> emitted;			// Phonons to become tracks
+
+  G4int nDecays, nScatters;
+
+  G4CMPPhononCascade(const G4CMPPhononCascade&) = delete;
+  G4CMPPhononCascade& operator=(const G4CMPPhononCascade&) = delete;
+};
+
+#endif	/* G4CMPPhononCascade_hh */
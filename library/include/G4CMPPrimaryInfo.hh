@@ -0,0 +1,38 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPPrimaryInfo.hh
+/// \brief Definition of the G4CMPPrimaryInfo class.  Attached to primary
+/// charge carriers from G4CMPEnergyPartition, to pass the Luke sampling
+/// factor and macro-carrier multiplicity to the track info.
+//
+// $Id$
+//
+// 20261019  New class for macro-carrier primaries
+// 20261019  Rename from G4CMPMacroCarrierInfo, add Luke sampling factor
+
+#ifndef G4CMPPrimaryInfo_hh
+#define G4CMPPrimaryInfo_hh 1
+
+#include "G4VUserPrimaryParticleInformation.hh"
+#include "globals.hh"
+
+class G4CMPPrimaryInfo : public G4VUserPrimaryParticleInformation {
+public:
+  G4CMPPrimaryInfo(G4double lukeSamp, G4int mult=1)
+    : lukeSampling(lukeSamp), multiplicity(mult) {;}
+  virtual ~G4CMPPrimaryInfo() {;}
+
+  G4double LukeSampling() const   { return lukeSampling; }
+  G4int Multiplicity() const      { return multiplicity; }
+
+  virtual void Print() const;
+
+private:
+  G4double lukeSampling;	// Luke emission rate
+  G4int multiplicity;		// Carriers in macro-carrier bundle
+};
+
+#endif	/* G4CMPPrimaryInfo_hh */
@@ -0,0 +1,123 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPProfiler.hh
+/// \brief Definition of the G4CMPProfiler class, which accumulates call
+///   counts, wall-clock and CPU times for instrumented G4CMP functions.
+///
+///   Each thread fills its own counters; Report() merges all threads.
+///   Instrumentation is only compiled if G4CMP_PROFILE is defined at
+///   build time, and only collects data if enabled at run time with the
+///   /g4cmp/profile macro command (or $G4CMP_PROFILE_ENABLED).
+///
+///   Usage, at the top of a function body:
+///	G4CMP_PROFILE_SCOPE("MyClass::MyFunction");
+///   or, with an index from G4CMP_PROFILE_REGISTER() stored by the caller:
+///	G4CMP_PROFILE_TIMER(myIndex);
+//
+// $Id$
+//
+// 20261019  New class for optional per-function timing of G4CMP hot spots
+
+#ifndef G4CMPProfiler_hh
+#define G4CMPProfiler_hh 1
+
+#include "globals.hh"
+#include <atomic>
+#include <iosfwd>
+#include <vector>
+
+
+class G4CMPProfiler {
+public:
+  // Thread-local instance, created on first use
+  static G4CMPProfiler* Instance();
+
+  // Get index for named profiling point; same name always gives same index
+  static G4int Register(const G4String& name);
+
+  // Run-time switch to collect data; has no effect without G4CMP_PROFILE
+  static void SetEnabled(G4bool value);
+  static G4bool IsEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+  // Merge counters from all threads and print table, sorted by wall time
+  static void Report(std::ostream& os);
+
+  // Zero counters in all threads (e.g., at start of new run)
+  static void Reset();
+
+  // Wall-clock and current-thread CPU times, in Geant4 time units
+  static G4double GetWallTime();
+  static G4double GetCPUTime();
+
+  // Accumulate one call of specified profiling point
+  void Fill(G4int index, G4double wallTime, G4double cpuTime);
+
+private:
+  G4CMPProfiler() {;}				// Use Instance() only
+  ~G4CMPProfiler() {;}
+
+  struct Counter {
+    Counter() : calls(0), wall(0.), cpu(0.) {;}
+    G4long calls;
+    G4double wall;
+    G4double cpu;
+  };
+
+  std::vector<Counter> counters;	// Indexed by registered profiling point
+
+  static std::atomic<G4bool> enabled;
+
+  friend class G4CMPProfilerRegistry;	// Owns all thread instances
+};
+
+
+// Measures time from construction to destruction of local object
+
+class G4CMPProfileTimer {
+public:
+  G4CMPProfileTimer(G4int id)
+    : index(id), active(id>=0 && G4CMPProfiler::IsEnabled()),
+      wall0(0.), cpu0(0.) {
+    if (active) {
+      wall0 = G4CMPProfiler::GetWallTime();
+      cpu0 = G4CMPProfiler::GetCPUTime();
+    }
+  }
+
+  ~G4CMPProfileTimer() {
+    if (active) {
+      G4CMPProfiler::Instance()->Fill(index,
+				      G4CMPProfiler::GetWallTime()-wall0,
+				      G4CMPProfiler::GetCPUTime()-cpu0);
+    }
+  }
+
+private:
+  G4int index;
+  G4bool active;
+  G4double wall0;
+  G4double cpu0;
+
+  G4CMPProfileTimer(const G4CMPProfileTimer&) = delete;
+  G4CMPProfileTimer& operator=(const G4CMPProfileTimer&) = delete;
+};
+
+
+// Macros compile to nothing unless requested at build time
+
+#ifdef G4CMP_PROFILE
+#define G4CMP_PROFILE_REGISTER(name) G4CMPProfiler::Register(name)
+#define G4CMP_PROFILE_TIMER(index) G4CMPProfileTimer g4cmpProfileTimer_(index)
+#define G4CMP_PROFILE_SCOPE(name) \
+  static const G4int g4cmpProfileIndex_ = G4CMPProfiler::Register(name); \
+  G4CMPProfileTimer g4cmpProfileTimer_(g4cmpProfileIndex_)
+#else
+#define G4CMP_PROFILE_REGISTER(name) (-1)
+#define G4CMP_PROFILE_TIMER(index)
+#define G4CMP_PROFILE_SCOPE(name)
+#endif
+
+#endif	/* G4CMPProfiler_hh */
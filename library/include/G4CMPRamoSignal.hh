@@ -0,0 +1,108 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPRamoSignal.hh
+/// \brief Definition of the G4CMPRamoSignal class, which accumulates
+///   time-resolved signals induced on readout channels during charge
+///   transport, using the Shockley-Ramo theorem.
+///
+///   Each channel has a weighting ("Ramo") potential, a mesh field with
+///   1 V on that channel's electrode and zero on all others.  For each step
+///   of a charge q (in units of e+), the induced charge -q*(V(post)-V(pre)),
+///   in units of e+ with V in volts, is added to the channel's trace, spread
+///   uniformly over the time bins covered by the step.  Summed over a track,
+///   this is -q*(V(final)-V(initial)), as computed from end-of-track hits by
+///   the FET digitizer in examples/sensors.
+///
+///   Traces are kept in memory for one event, as increments per time bin;
+///   GetInducedCharge() returns the running sum.  Positions are global
+///   coordinates, as in G4CMPElectrodeHit.  Mesh fields may be shared
+///   between threads, but each instance must be used by only one thread,
+///   e.g., owned by a worker thread's G4CMPElectrodeSensitivity.
+//
+// $Id$
+//
+// 20261019  New class for in-transport Shockley-Ramo signals
+
+#ifndef G4CMPRamoSignal_hh
+#define G4CMPRamoSignal_hh 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include <vector>
+
+class G4CMPMeshElectricField;
+class G4Step;
+
+
+class G4CMPRamoSignal {
+public:
+  G4CMPRamoSignal(G4double binWidth, size_t nBins, G4double startTime=0.);
+  virtual ~G4CMPRamoSignal();
+
+  // Weighting potentials, one per channel in order of addition
+  void AddChannel(const G4String& epotFile);		// Loaded and owned
+  void AddChannel(G4CMPMeshElectricField* field);	// Shared, not owned
+  size_t GetNumberOfChannels() const { return fields.size(); }
+
+  // Changing binning discards current traces
+  void SetBinning(G4double binWidth, size_t nBins, G4double startTime=0.);
+  G4double GetBinWidth() const  { return binWidth; }
+  size_t   GetNumberOfBins() const { return nBins; }
+  G4double GetStartTime() const { return startTime; }
+
+  // Reset traces, and mesh search for this thread, at start of event
+  virtual void Clear();
+
+  // Add signal from step of charge carrier, scaled by track weight;
+  // other particles are ignored
+  virtual void AddStep(const G4Step* step);
+
+  // Add signal from charge (units of e+) moving between pre and post points
+  void AddStep(G4double charge, const G4ThreeVector& prePos, G4double preTime,
+	       const G4ThreeVector& postPos, G4double postTime);
+
+  // Trace increments by channel, then bin; signal before startTime is put
+  // in first bin, and signal after last bin is dropped
+  const std::vector<G4double>& GetTraces() const { return traces; }
+  const G4double* GetTrace(size_t chan) const { return &traces[chan*nBins]; }
+
+  // Induced charge at end of each time bin, for one channel
+  void GetInducedCharge(size_t chan, std::vector<G4double>& charge) const;
+
+  // Total induced charge on channel, including signal outside time bins
+  G4double GetTotalCharge(size_t chan) const { return totals[chan]; }
+
+protected:
+  // Fill weighting potentials for all channels at position
+  void FillPotentials(const G4ThreeVector& pos, std::vector<G4double>& V) const;
+
+  // Spread induced charge on channel uniformly over time interval
+  void Deposit(size_t chan, G4double dq, G4double t0, G4double t1);
+
+  // Add signal for difference between potential arrays
+  void DepositAll(G4double charge, G4double t0, G4double t1);
+
+private:
+  std::vector<G4CMPMeshElectricField*> fields;
+  std::vector<G4CMPMeshElectricField*> ownedFields;
+
+  G4double binWidth;
+  size_t   nBins;
+  G4double startTime;
+
+  std::vector<G4double> traces;		// Increments, [chan][bin]
+  std::vector<G4double> totals;		// Sum of all increments by channel
+
+  // Potentials at end of last step are reused at start of next one
+  G4int lastTrackID;
+  G4int lastStepNumber;
+  std::vector<G4double> preV, postV;
+
+  G4CMPRamoSignal(const G4CMPRamoSignal&) = delete;
+  G4CMPRamoSignal& operator=(const G4CMPRamoSignal&) = delete;
+};
+
+#endif	/* G4CMPRamoSignal_hh */
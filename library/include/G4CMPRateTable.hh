@@ -0,0 +1,87 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPRateTable.hh
+/// \brief Definition of the G4CMPRateTable class, which tabulates a
+///   scattering rate as a function of a single variable (carrier energy,
+///   or electric field magnitude) for fast lookup during tracking.
+///
+///   The range is divided into segments at user-specified edges, such as
+///   energy thresholds.  Within each segment, table points are spaced
+///   uniformly in sqrt(x-x0), so that threshold behaviour like sqrt(E-E0)
+///   is linear between points.  Evaluation is a binary search over the
+///   segment edges and a linear interpolation.
+///
+///   When filled, the rate is compared with the table at the midpoint of
+///   every interval.  The number of points is doubled (up to 16 times the
+///   requested number) until the largest relative difference is within
+///   GetTolerance(), otherwise a warning is issued.
+//
+// $Id$
+//
+// 20261019  New class for tabulated scattering rates
+
+#ifndef G4CMPRateTable_hh
+#define G4CMPRateTable_hh 1
+
+#include "globals.hh"
+#include <vector>
+
+
+class G4CMPRateTable {
+public:
+  G4CMPRateTable() : nPerSegment(0), maxError(0.) {;}
+  virtual ~G4CMPRateTable() {;}
+
+  // Fill table from functor rate(x) over range spanned by edges; returns
+  // maximum relative difference between table and functor
+  template <class Rate>
+  G4double Fill(Rate rate, const std::vector<G4double>& edges,
+		G4int nPoints=128);
+
+  // Interpolated value; caller should check InRange() first
+  G4double Value(G4double x) const;
+  G4double operator()(G4double x) const { return Value(x); }
+
+  G4bool InRange(G4double x) const {
+    return (!values.empty() && x >= edges.front() && x <= edges.back());
+  }
+
+  G4double GetLowEdge() const  { return edges.empty() ? 0. : edges.front(); }
+  G4double GetHighEdge() const { return edges.empty() ? 0. : edges.back(); }
+  G4int GetNSegments() const   { return edges.empty() ? 0 : edges.size()-1; }
+  G4int GetNPoints() const     { return nPerSegment; }	// Per segment
+
+  // Largest relative difference from rate function during fill
+  G4double GetError() const { return maxError; }
+  static G4double GetTolerance() { return 1e-4; }
+
+  // Segment edges at zero and each decade from xlow to xhigh, with
+  // thresholds (if any) inserted
+  static std::vector<G4double>
+  DecadeEdges(G4double xlow, G4double xhigh,
+	      const std::vector<G4double>& thresholds=std::vector<G4double>());
+
+protected:
+  // Position of table point j in segment s
+  G4double Point(G4int s, G4int j) const {
+    G4double u = G4double(j)/nPerSegment;
+    return edges[s] + u*u*(edges[s+1]-edges[s]);
+  }
+
+  template <class Rate> void FillValues(Rate rate, G4int nPoints);
+  template <class Rate> G4double CheckValues(Rate rate) const;
+
+private:
+  std::vector<G4double> edges;		// Segment boundaries
+  std::vector<G4double> invWidth;	// 1/(edges[s+1]-edges[s])
+  std::vector<G4double> values;		// Rate at each point, by segment
+  G4int nPerSegment;			// Intervals in each segment
+  G4double maxError;			// Maximum relative difference
+};
+
+#include "G4CMPRateTable.icc"
+
+#endif	/* G4CMPRateTable_hh */
@@ -14,6 +14,11 @@
 /// a touchable. If the transform or touchable is not provided, an indentity transform is
 /// used.
 ///
+/// For G4Box, G4Tubs and G4Polycone (without phi segments), and
+/// G4ExtrudedSolid with two identical Z sections, the closest surface
+/// point and normal are computed exactly; other solids use a numerical
+/// search over directions (see OptimizeSurfaceAdjustAngle).
+///
 /// Note: All coordinates/vectors passed into functions must be in the global coordinate system.
 /// If a global-to-local transform is supplied, the input coordinates and vectors, and any output
 /// results, will be in the coordinate system of that transform.
@@ -23,6 +28,7 @@
 // 20250424  G4CMP-465 -- Create G4CMPSolidUtils class.
 // 20250429  G4CMP-461 -- Add function for skipping detector flats.
 // 20250430  N. Tenpas -- Add function for getting distance to bounding box.
+// 20261019  Add exact surface point and normal for common solids.
 
 #ifndef G4CMPSolidUtils_hh
 #define G4CMPSolidUtils_hh 1
@@ -39,7 +45,7 @@ class G4CMPSolidUtils {
   public:
     // Default constructor
     G4CMPSolidUtils() : theSolid(0), theTransform(G4AffineTransform()), verboseLevel(0),
-                        verboseLabel("G4CMPSolidUtils") {;}
+                        verboseLabel("G4CMPSolidUtils"), useAnalytic(true) {;}
 
     // Direct constructor with solid & transform for client code in local frame
     G4CMPSolidUtils(const G4VSolid* solid, G4int verbose=0, const G4String& vLabel="G4CMPSolidUtils");
@@ -91,6 +97,10 @@ class G4CMPSolidUtils {
       verboseLabel = vLabel;
     }
 
+    // Exact calculations may be disabled, e.g., for validation
+    void SetUseAnalytic(G4bool value) { useAnalytic = value; }
+    G4bool GetUseAnalytic() const { return useAnalytic; }
+
     const G4VSolid* GetSolid() const { return theSolid; }
     const G4AffineTransform GetTransform() const { return theTransform; }
     G4int GetVerboseLevel() const { return verboseLevel; }
@@ -110,6 +120,16 @@ class G4CMPSolidUtils {
     void RotateDirectionToSolid(const G4ThreeVector& pos,
                                 G4ThreeVector& dir) const;
 
+    // Exact closest surface point and outward normal, if available for
+    // this solid (returns false otherwise).  atEdge is set if pos is outside
+    // the solid and the closest point is on an edge or corner.
+    // pos, surfPoint and surfNorm are in the global coordinate system
+    G4bool HasAnalyticSurface() const;
+    G4bool GetAnalyticSurfacePoint(const G4ThreeVector& pos,
+                                   G4ThreeVector& surfPoint,
+                                   G4ThreeVector& surfNorm,
+                                   G4bool& atEdge) const;
+
     // Efficiently find direction with min distance to surface
     // pos must be in the global coordinate system
     void OptimizeSurfaceAdjustAngle(const G4ThreeVector& pos,
@@ -193,6 +213,7 @@ class G4CMPSolidUtils {
     G4AffineTransform theTransform;
     G4int verboseLevel;
     G4String verboseLabel;
+    G4bool useAnalytic;
 };
 
 #endif	/* G4CMPSolidUtils_hh */
\ No newline at end of file
@@ -11,6 +11,7 @@
 // 20170525  M. Kelsey -- Add default "rule of five" copy/move operators
 // 20211001  M. Kelsey -- Remove electron energy adjustment; set mass instead.
 //		Assign electron valley nearest to momentum direction.
+// 20261019  Add CopyPrimaryInfo() for Luke sampling and multiplicity.
 
 #ifndef G4CMPStackingAction_h
 #define G4CMPStackingAction_h 1
@@ -34,6 +35,7 @@ protected:
   void SetPhononVelocity(const G4Track* theTrack) const;
   void AssignNearestValley(const G4Track* aTrack) const;
   void SetChargeCarrierMass(const G4Track* theTrack) const;
+  void CopyPrimaryInfo(const G4Track* aTrack) const;
 
 public:
   G4CMPStackingAction(const G4CMPStackingAction&) = default;
@@ -17,13 +17,20 @@
 // 20200426  G4CMP-196: Change "impact" name to "trapIon"
 // 20220730  G4CMP-301: Drop trapping processes, as they have built-in MFPs,
 //		don't need TimeStepper for energy-dependent calculation.
+// 20261019  Add G4CMPProfiler timing of GPIL.
+// 20261019  Add step limit at exit from mesh field tetrahedron.
+// 20261019  Move mesh path length and acceleration to static functions.
 
 #ifndef G4CMPTimeStepper_h
 #define G4CMPTimeStepper_h 1
 
 #include "globals.hh"
+#include "G4CMPProfiler.hh"
 #include "G4CMPVDriftProcess.hh"
+#include "G4RotationMatrix.hh"
+#include "G4ThreeVector.hh"
 
+class G4CMPMeshElectricField;
 class G4CMPVScatteringRate;
 
 
@@ -40,12 +47,29 @@ public:
   PostStepGetPhysicalInteractionLength(const G4Track& aTrack,
 				       G4double prevStepSize,
 				       G4ForceCondition* condition) {
+    G4CMP_PROFILE_TIMER(profileGPIL);
     return GetMeanFreePath(aTrack, prevStepSize, condition);
   }
 
   virtual G4VParticleChange* PostStepDoIt(const G4Track& aTrack,
 					  const G4Step& aStep);
 
+  // Acceleration of charge carrier in field, for scalar mass or inverse
+  // mass tensor (same frame as field)
+  static G4ThreeVector FieldAcceleration(G4double charge,
+					 const G4ThreeVector& field,
+					 G4double mass);
+  static G4ThreeVector FieldAcceleration(G4double charge,
+					 const G4ThreeVector& field,
+					 const G4RotationMatrix& mInv);
+
+  // Path length along trajectory with constant acceleration to leave the
+  // mesh element containing pos; DBL_MAX if no limit applies
+  static G4double MeshPathLength(const G4CMPMeshElectricField* mesh,
+				 const G4double pos[3],
+				 const G4ThreeVector& vel,
+				 const G4ThreeVector& accel);
+
   // Allow external process to supply rate model
   void UseLukeRateModel(const G4CMPVScatteringRate* aRate) { lukeRate = aRate; }
   void UseIVRateModel(const G4CMPVScatteringRate* aRate)   { ivRate = aRate; }
@@ -61,6 +85,10 @@ protected:
 			       G4double Estart) const;
   G4double EnergyStep(G4double Estart, G4double Efinal) const;
 
+  // Path length to leave current tetrahedron of mesh field, if any
+  G4double MeshStepLength(const G4Track& aTrack,
+			  const G4ThreeVector& field) const;
+
   // Get scattering rates for other charge-carrier processes
   void ReportRates(const G4Track& aTrack);
 
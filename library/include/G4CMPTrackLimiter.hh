@@ -18,6 +18,8 @@
 // 20250515  Add configuration settings for "stuck track" cuts
 // 20250801  G4CMP-326:  Kill thermal phonons if finite temperature set.
 // 20251025  G4CMP-520:  Remove redundant (and incorrect) InvalidPosition().
+// 20261019  Cache per-track thresholds and particle type; cache thermal
+//	     energy cut per lattice temperature.
 
 #ifndef G4CMPTrackLimiter_hh
 #define G4CMPTrackLimiter_hh 1
@@ -35,7 +37,8 @@ public:
   G4CMPTrackLimiter(const G4String& name="TrackLimiter")
     : G4CMPVProcess(name, fTrackLimiter), stepWindow(10000), minPosShift(0.),
       minFlightRMS(0.), maxPathScale(20.), flightAvg(-1.), flightAvg2(-1.),
-      lastFlight(-1.), lastRMS(-1.) {;}
+      lastFlight(-1.), lastRMS(-1.), isPhonon(false), isCharge(false),
+      energyCut(-1.), maxSteps(-1), thermalTemp(-1.), thermalECut(-1.) {;}
 
   virtual ~G4CMPTrackLimiter() {;}
 
@@ -54,7 +57,10 @@ protected:
   G4bool BelowEnergyCut(const G4Track& track) const;
   G4bool EscapedFromVolume(const G4Step& step) const;
   G4bool ChargeStuck(const G4Track& track);	// Non-const to use caches
-  G4bool PhononIsThermal(const G4Track& track) const;
+  G4bool PhononIsThermal(const G4Track& track);	// Non-const for cache
+
+  // Compute energy above which phonon can never be thermalized
+  void UpdateThermalCut(G4double temp);
 
   virtual G4double GetMeanFreePath(const G4Track&,G4double,G4ForceCondition*);
 
@@ -70,6 +76,13 @@ protected:
   G4double lastRMS;		// Last flight distance RMS computed
   G4ThreeVector lastPos;	// Previous computed position
 
+  G4bool isPhonon;		// Track type, cached for fast selection
+  G4bool isCharge;
+  G4double energyCut;		// Minimum energy for current track type
+  G4int maxSteps;		// Maximum number of steps for charge tracks
+  G4double thermalTemp;		// Lattice temperature used for thermalECut
+  G4double thermalECut;		// Energy above which MB PDF is negligible
+
 private:
   G4CMPTrackLimiter(const G4CMPTrackLimiter&);	// Copying is forbidden
   G4CMPTrackLimiter& operator=(const G4CMPTrackLimiter&);
@@ -20,6 +20,7 @@
 // 20200908  Replace four-arg ctor and UseMesh() with copy constructor.
 // 20200914  Include gradient precalculation in BuildTInverse action.
 // 20240921  Make FirstInteriorTetra() virtual for use with Initialize()
+// 20261019  Add GetExitTime() to compute time to leave tetrahedron
 
 #ifndef G4CMPTriLinearInterp_h 
 #define G4CMPTriLinearInterp_h 
@@ -65,6 +66,11 @@ public:
   G4double GetValue(const G4double pos[], G4bool quiet=false) const;
   G4ThreeVector GetGrad(const G4double pos[], G4bool quiet=false) const;
 
+  // Time for constant-acceleration trajectory to leave tetrahedron; if pos
+  // is on a facet, moving outward, the neighboring tetrahedron is used
+  G4double GetExitTime(const G4double pos[], const G4ThreeVector& vel,
+		       const G4ThreeVector& acc, G4bool quiet=false) const;
+
   void SavePoints(const G4String& fname) const;
   void SaveTetra(const G4String& fname) const;
 
@@ -107,6 +113,10 @@ private:
   G4int FindPointID(const std::vector<G4double>& point, const G4int id) const;
 
   G4bool Cart2Bary(const G4double point[3], G4double bary[4]) const;
+
+  // First time at which a barycentric coordinate reaches zero, and facet
+  G4double BaryExitTime(const G4double bary[4], const G4ThreeVector& vel,
+			const G4ThreeVector& acc, G4int& facet) const;
   G4bool BuildT4x3(size_t itet, mat4x3& ET) const;
 
   G4bool MatInv(const mat3x3& matrix, mat3x3& result, G4bool quiet=false) const;
@@ -0,0 +1,65 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPUniformFieldStepper.hh
+/// \brief Definition of the G4CMPUniformFieldStepper class, a fourth-order
+///   Runge-Kutta stepper which evaluates the electric field only once, at
+///   the start of each step.
+///
+///   For a uniform field, or for a mesh field which is constant within
+///   each tetrahedron, the four RK stages then see the same field as
+///   G4ClassicalRK4, but with one field lookup instead of four.  The most
+///   recent field value is reused if a step begins at the same point (as
+///   with the step-doubling error estimate in G4MagErrorStepper), so a
+///   full step with error estimate needs two field evaluations.
+///
+///   Where the field varies within a step, the step-doubling error
+///   estimate includes the field change at the midpoint, and the driver
+///   reduces the step to meet the requested accuracy.
+//
+// $Id$
+//
+// 20261019  New stepper for uniform or piecewise-constant electric fields
+
+#ifndef G4CMPUniformFieldStepper_hh
+#define G4CMPUniformFieldStepper_hh 1
+
+#include "G4MagErrorStepper.hh"
+#include "G4Field.hh"
+#include "G4FieldTrack.hh"
+
+class G4EquationOfMotion;
+
+
+class G4CMPUniformFieldStepper : public G4MagErrorStepper {
+public:
+  G4CMPUniformFieldStepper(G4EquationOfMotion* eqRhs, G4int numVar=8);
+  virtual ~G4CMPUniformFieldStepper() {;}
+
+  // Classical RK4 step, with field taken from start point
+  virtual void DumbStepper(const G4double yIn[], const G4double dydx[],
+			   G4double h, G4double yOut[]);
+
+  virtual G4int IntegratorOrder() const { return 4; }
+
+protected:
+  // Look up field at start point, or reuse value from previous call
+  void UpdateField(const G4double yIn[]);
+
+private:
+  G4int nVar;
+  G4double lastPoint[4];		// Position and time of field lookup
+  G4bool haveField;
+  G4double field[G4maximum_number_of_field_components];
+
+  G4double yTemp[G4FieldTrack::ncompSVEC];	// Buffers for RK stages
+  G4double dydxTemp[G4FieldTrack::ncompSVEC];
+  G4double dydxMid[G4FieldTrack::ncompSVEC];
+
+  G4CMPUniformFieldStepper(const G4CMPUniformFieldStepper&) = delete;
+  G4CMPUniformFieldStepper& operator=(const G4CMPUniformFieldStepper&) = delete;
+};
+
+#endif	/* G4CMPUniformFieldStepper_hh */
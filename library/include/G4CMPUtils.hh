@@ -21,6 +21,8 @@
 // 20250422  G4CMP-468 -- Add position argument to PhononVelocityIsInward
 // 20250423  G4CMP-468 -- Add function to get diffuse reflection vector
 // 20250510  G4CMP-483 -- Ensure backwards compatibility for vector utilities.
+// 20261019  Add LukePhononWaveVector() for direct Luke emission sampling
+// 20261019  Add touchable arguments to GetLambertianVector, VelocityIsInward
 
 #ifndef G4CMPUtils_hh
 #define G4CMPUtils_hh 1
@@ -91,8 +93,17 @@ namespace G4CMP {
   G4ThreeVector GetLambertianVector(const G4LatticePhysical* theLattice,
                                     const G4ThreeVector& surfNorm, G4int mode,
                                     const G4ThreeVector& surfPoint);
+  G4ThreeVector GetLambertianVector(const G4VTouchable* touchable,
+                                    const G4LatticePhysical* theLattice,
+                                    const G4ThreeVector& surfNorm, G4int mode,
+                                    const G4ThreeVector& surfPoint);
   G4ThreeVector LambertReflection(const G4ThreeVector& surfNorm);
 
+  // Luke phonon emitted by carrier with wavevector k (HV frame for
+  // electrons), where ks is the wavevector at the sound speed.  Returns
+  // zero vector if carrier is below the sound speed.
+  G4ThreeVector LukePhononWaveVector(const G4ThreeVector& k, G4double ks);
+
   // Test that a phonon's wave vector relates to an inward velocity.
   // waveVector, surfNorm, and surfacePos need to be in global coordinates
   G4bool PhononVelocityIsInward(const G4LatticePhysical* lattice, G4int mode,
@@ -102,6 +113,11 @@ namespace G4CMP {
                                 const G4ThreeVector& waveVector,
                                 const G4ThreeVector& surfNorm,
                                 const G4ThreeVector& surfacePos);
+  G4bool PhononVelocityIsInward(const G4VTouchable* touchable,
+                                const G4LatticePhysical* lattice, G4int mode,
+                                const G4ThreeVector& waveVector,
+                                const G4ThreeVector& surfNorm,
+                                const G4ThreeVector& surfacePos);
 
   // Thermal distributions, useful for handling phonon thermalization
   G4double MaxwellBoltzmannPDF(G4double temperature, G4double energy);
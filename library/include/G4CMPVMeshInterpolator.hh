@@ -17,6 +17,8 @@
 // 20240920  Replace TetraIdx data member with function to reference cache.
 // 20240921  Add new Initialize() function to ensure that per-thread TetraIdx
 //		is set properly.
+// 20261019  Add GetExitTime() for step limits at mesh element boundaries.
+// 20261019  Cache verbose level at construction, for use from any thread.
 
 #ifndef G4CMPVMeshInterpolator_h 
 #define G4CMPVMeshInterpolator_h 
@@ -37,8 +39,7 @@ using tetra3d = std::array<G4int,4>;
 class G4CMPVMeshInterpolator {
 protected:
   // This class CANNOT be instantiated directly!
-  G4CMPVMeshInterpolator(const G4String& prefix)
-    : TetraStart(-1), savePrefix(prefix) {;}
+  G4CMPVMeshInterpolator(const G4String& prefix);
 
 public:
   virtual ~G4CMPVMeshInterpolator() {;}
@@ -62,6 +63,10 @@ public:
 	       const std::vector<G4double>& /*v*/,
 	       const std::vector<tetra2d>& /*tetra*/) {;}
 
+  // Diagnostic output level, taken from G4CMPConfigManager when created
+  void SetVerboseLevel(G4int vb) { verboseLevel = vb; }
+  G4int GetVerboseLevel() const { return verboseLevel; }
+
   // Reset TetraIdx before using interpolator
   void Initialize();
 
@@ -69,6 +74,14 @@ public:
   virtual G4double GetValue(const G4double pos[], G4bool quiet=false) const = 0;
   virtual G4ThreeVector GetGrad(const G4double pos[], G4bool quiet=false) const = 0;
 
+  // Time for trajectory pos + vel*t + acc*t^2/2 to leave the mesh element
+  // containing pos, within which the gradient is constant.  Subclasses
+  // without this capability return DBL_MAX (no limit).
+  virtual G4double GetExitTime(const G4double /*pos*/[],
+			       const G4ThreeVector& /*vel*/,
+			       const G4ThreeVector& /*acc*/,
+			       G4bool /*quiet*/=false) const { return DBL_MAX; }
+
   // Write out mesh coordinates and tetrahedra table to text files
   virtual void SavePoints(const G4String& fname) const = 0;
   virtual void SaveTetra(const G4String& fname) const = 0;
@@ -86,6 +99,7 @@ protected:		// Data members available to subclasses directly
 
   G4int TetraStart;			// Start of tetrahedral searches
   G4String savePrefix;			// for use in debugging, SaveXxx()
+  G4int verboseLevel;			// Not looked up during evaluation
 
   // Per-instance storage to remember last tetrahedron used
   mutable G4Cache<G4double> TetraIdxStore;
@@ -12,6 +12,7 @@
 // 20170802  Add registration of external scattering rate (MFP) model
 // 20170905  Add accessors to get currentlty active scattering rate
 // 20190906  Add function to initialize rate model after LoadDataForTrack
+// 20261019  Add G4CMPProfiler timing of GPIL and PostStepDoIt
 
 #ifndef G4CMPVProcess_h
 #define G4CMPVProcess_h 1
@@ -39,12 +40,22 @@ public:
   virtual void StartTracking(G4Track* track);
   virtual void EndTracking();
 
+  // Wrap base implementation with optional profiling timer
+  virtual G4double
+  PostStepGetPhysicalInteractionLength(const G4Track& track,
+				       G4double previousStepSize,
+				       G4ForceCondition* condition);
+
 protected:
   void ConfigureRateModel();		// Subclasses can call this directly
 
   // Uses scattering model to compute MFP; subclasses may override
   virtual G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*);
 
+protected:
+  G4int profileGPIL;		// G4CMPProfiler indices, for subclasses to
+  G4int profileDoIt;		// use with G4CMP_PROFILE_TIMER()
+
 private:
   G4CMPVScatteringRate* rateModel;	// Returns scattering rate in hertz
 
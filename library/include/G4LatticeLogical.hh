@@ -42,6 +42,8 @@
 //		(p_Q) and expectation value of momentum (p).
 // 20231017  E. Michaud -- Add 'AddValley(const G4ThreeVector&)' 
 // 20240510  E. Michhaud -- Add function to compute L0 from other parameters
+// 20261019  Add tabulated anharmonic decay sampling, filled by Initialize()
+// 20261019  Add binary "compiled" lattice I/O; skip K-Vg fill if done
 
 #ifndef G4LatticeLogical_h
 #define G4LatticeLogical_h
@@ -54,6 +56,7 @@
 #include <iosfwd>
 #include <vector>
 
+class G4CMPAnharmonicTable;
 class G4CMPPhononKinematics;
 class G4CMPPhononKinTable;
 
@@ -86,6 +89,12 @@ public:
   // Dump structure in format compatible with reading back
   void Dump(std::ostream& os) const;
 
+  // Binary image of all parameters and K-Vg lookup table, for use by
+  // G4LatticeReader; empty IV model name means to use configured default
+  enum { COMPILED_VERSION=1 };		    // Change with format or contents
+  G4bool WriteCompiled(std::ostream& os) const;
+  G4bool ReadCompiled(std::istream& is);	// False if file is incompatible
+
   // Get group velocity magnitude, direction for input polarization and wavevector
   // NOTE:  Wavevector must be in lattice symmetry frame (X == symmetry axis)
   virtual G4ThreeVector MapKtoVg(G4int mode, const G4ThreeVector& k) const;
@@ -174,6 +183,9 @@ public:
   G4double GetScatteringConstant() const { return fB; }
   G4double GetAnhDecConstant() const { return fA; }
   G4double GetAnhTTFrac() const { return fTTFrac; }
+
+  // Daughter energy fractions for anharmonic decay; null if not filled
+  const G4CMPAnharmonicTable* GetAnharmonicTable() const { return fpAnhTable; }
   G4double GetLDOS() const { return fLDOS; }
   G4double GetSTDOS() const { return fSTDOS; }
   G4double GetFTDOS() const { return fFTDOS; }
@@ -287,8 +299,12 @@ private:
   void CheckBasis();	// Initialize or complete (via cross) basis vectors
   void FillElasticity();	// Unpack reduced Cij into full Cijlk
   void FillMaps();	// Populate lookup tables using kinematics calculator
+  void FillAnharmonicTable();	// Tabulate decay energy distributions
   void FillMassInfo();	// Called from SetMassTensor() to compute derived forms
 
+  // Scalar parameters, in order stored by WriteCompiled()
+  std::vector<G4double*> CompiledParameters();
+
   // Get theta, phi bins and offsets for interpolation
   G4bool FindLookupBins(const G4ThreeVector& k, G4int& iTheta, G4int& iPhi,
 			G4double& dTheta, G4double& dPhi) const;
@@ -320,10 +336,12 @@ private:
   G4bool fHasElasticity;		    // Flag valid elasticity tensors
   G4CMPPhononKinematics* fpPhononKin;	    // Kinematics calculator with tensor
   G4CMPPhononKinTable* fpPhononTable;	    // Kinematics interpolator
+  G4CMPAnharmonicTable* fpAnhTable;	    // Anharmonic decay sampling
 
   // map for group velocity vectors
   enum { KVBINS=315 };			    // K-Vg lookup table binning
   G4ThreeVector fKVMap[G4PhononPolarization::NUM_MODES][KVBINS][KVBINS];
+  G4double fKVMapDensity;		    // Density used for fKVMap, or zero
 
   G4double fA;       // Scaling constant for Anh.Dec. mean free path
   G4double fB;       // Scaling constant for Iso.Scat. mean free path
@@ -36,6 +36,9 @@
 // 20210919  M. Kelsey -- Allow SetVerboseLevel() from const instances.
 // 20220921  G4CMP-319 -- Add utilities for thermal (Maxwellian) distributions
 //		Also, add long missing accessors for Miller orientation
+// 20261019  Add pass-through for tabulated anharmonic decay sampling
+// 20261019  Precompute valley transforms in solid frame; add batch mappings.
+//		Drop thread-local buffer, no longer needed.
 
 #ifndef G4LatticePhysical_h
 #define G4LatticePhysical_h 1
@@ -44,6 +47,7 @@
 #include "G4RotationMatrix.hh"
 #include "G4ThreeVector.hh"
 #include <iosfwd>
+#include <vector>
 
 #define G4CMP_HAS_TEMPERATURE	/* G4CMP-319 -- New feature for user code */
 
@@ -64,7 +68,12 @@ public:
   G4int GetVerboseLevel() const { return verboseLevel; }
 
   // Specific material lattice for this physical instance
-  void SetLatticeLogical(const G4LatticeLogical* Lat) { fLattice = Lat; }
+  // NOTE:  Valley transforms are computed here and in SetMillerOrientation;
+  //	    call again if the logical lattice is modified afterward.
+  void SetLatticeLogical(const G4LatticeLogical* Lat) {
+    fLattice = Lat;
+    FillValleyFrames();
+  }
 
   // Set physical lattice orientation, relative to G4VSolid coordinates
   // Miller orientation aligns lattice normal (hkl) with geometry +Z
@@ -98,6 +107,26 @@ public:
   G4double MapPtoEkin(G4int ivalley, const G4ThreeVector& p_e) const;
   G4double MapV_elToEkin(G4int ivalley, const G4ThreeVector& v_e) const;
 
+  // Batch versions of above for many vectors; output is resized to match
+  // NOTE:  Vectors must be in local (G4VSolid) coordinate system
+  void RotateToLattice(std::vector<G4ThreeVector>& dirs) const;
+  void RotateToSolid(std::vector<G4ThreeVector>& dirs) const;
+
+  void MapPtoV_el(G4int ivalley, const std::vector<G4ThreeVector>& p_e,
+		  std::vector<G4ThreeVector>& v_el) const;
+  void MapPtoK(G4int ivalley, const std::vector<G4ThreeVector>& p_e,
+	       std::vector<G4ThreeVector>& k) const;
+  void MapKtoP(G4int ivalley, const std::vector<G4ThreeVector>& k,
+	       std::vector<G4ThreeVector>& p_e) const;
+  void MapPtoEkin(G4int ivalley, const std::vector<G4ThreeVector>& p_e,
+		  std::vector<G4double>& Ekin) const;
+  void EllipsoidalToSphericalTranformation(G4int iv,
+				   const std::vector<G4ThreeVector>& v,
+				   std::vector<G4ThreeVector>& vHV) const;
+  void SphericalToEllipsoidalTranformation(G4int iv,
+				   const std::vector<G4ThreeVector>& vHV,
+				   std::vector<G4ThreeVector>& v) const;
+
 public:  
   const G4LatticeLogical* GetLattice() const { return fLattice; }
 
@@ -122,6 +151,9 @@ public:
   G4double GetScatteringConstant() const { return fLattice->GetScatteringConstant(); }
   G4double GetAnhDecConstant() const { return fLattice->GetAnhDecConstant(); }
   G4double GetAnhTTFrac() const      { return fLattice->GetAnhTTFrac(); }
+  const G4CMPAnharmonicTable* GetAnharmonicTable() const {
+    return fLattice->GetAnharmonicTable();
+  }
   G4double GetLDOS() const           { return fLattice->GetLDOS(); }
   G4double GetSTDOS() const          { return fLattice->GetSTDOS(); }
   G4double GetFTDOS() const          { return fLattice->GetFTDOS(); }
@@ -155,6 +187,22 @@ public:
   const G4RotationMatrix& GetSqrtTensor() const { return fLattice->GetSqrtTensor(); }
   const G4RotationMatrix& GetSqrtInvTensor() const { return fLattice->GetSqrtInvTensor(); }
 
+  // Valley tensors combined with valley and lattice rotations, to act
+  // directly on local (G4VSolid) vectors.  HV transforms are between local
+  // coordinates and the Herring-Vogt frame of the valley.
+  const G4RotationMatrix& GetValleyMassTensor(G4int iv) const {
+    return GetValleyFrame(iv).mass;
+  }
+  const G4RotationMatrix& GetValleyMInvTensor(G4int iv) const {
+    return GetValleyFrame(iv).mInv;
+  }
+  const G4RotationMatrix& GetValleyToHV(G4int iv) const {
+    return GetValleyFrame(iv).toHV;
+  }
+  const G4RotationMatrix& GetValleyFromHV(G4int iv) const {
+    return GetValleyFrame(iv).fromHV;
+  }
+
   // Electrons are biased to move along energy minima in momentum space
   size_t NumberOfValleys() const { return fLattice->NumberOfValleys(); }
 
@@ -189,11 +237,23 @@ public:
   void Dump(std::ostream& os) const;
 
 private:
-  // Create a thread-local buffer to use with MapAtoB() functions
-  inline G4ThreeVector& tempvec() const {
-    static G4ThreadLocal G4ThreeVector* v=0;
-    if (!v) v = new G4ThreeVector;
-    return *v;
+  // Valley transforms from local (G4VSolid) coordinates, with lattice
+  // orientation R, valley rotation D, and Herring-Vogt transform T
+  struct ValleyFrame {
+    G4RotationMatrix toValley;		// D R^-1
+    G4RotationMatrix fromValley;	// R D^-1
+    G4RotationMatrix mass;		// R D^-1 M D R^-1
+    G4RotationMatrix mInv;		// R D^-1 M^-1 D R^-1
+    G4RotationMatrix toHV;		// T D R^-1
+    G4RotationMatrix fromHV;		// R D^-1 T^-1
+  };
+
+  void FillValleyFrames();
+
+  // Invalid valley index uses identity valley rotation, as does logical
+  const ValleyFrame& GetValleyFrame(G4int iv) const {
+    return ((iv >= 0 && iv+1 < (G4int)fValleyFrames.size())
+	    ? fValleyFrames[iv] : fValleyFrames.back());
   }
 
 private:
@@ -204,6 +264,7 @@ private:
   G4int hMiller, kMiller, lMiller;	// Save Miller indices for dumps
   G4double fRot;
   G4double fTemperature;		// Temperature assigned to volume
+  std::vector<ValleyFrame> fValleyFrames;	// Last entry for invalid index
 };
 
 // Write lattice structure to output stream
@@ -23,6 +23,8 @@
 // 20170810  Add utility function to process list of values with unit.
 // 20190704  Add utility function to process string/name argument
 // 20231102  Add ProcessValleyDirection()
+// 20261019  Use binary "compiled" lattice if newer than config file; add
+//		CompileLattice() to write one.
 
 #ifndef G4LatticeReader_h
 #define G4LatticeReader_h 1
@@ -49,14 +51,28 @@ public:
   // Configuration actions
   void SetVerboseLevel(G4int vb) { verboseLevel = vb; }
 
+  // Uses compiled lattice (see below) in place of file if it is newer
   G4LatticeLogical* MakeLattice(const G4String& filepath);
 
+  // Write lattice from file, with K-Vg table if density is given, in binary
+  // format; default output is next to file found, with ".txt" -> ".bin"
+  G4bool CompileLattice(const G4String& filepath, G4double density=0.,
+			const G4String& outfile="");
+
+  static G4String CompiledName(const G4String& filepath);
+
 protected:
   void DefineUnits();		// Create time^3 and time^4 units for rates
 
   G4bool OpenFile(const G4String& filepath);
   void CloseFile();
 
+  G4LatticeLogical* ParseFile(const G4String& filepath);  // After OpenFile()
+
+  // Compiled lattice must exist and be no older than text file
+  G4bool UseCompiled(const G4String& textfile, const G4String& binfile) const;
+  G4LatticeLogical* ReadCompiled(const G4String& binfile);
+
   G4bool ProcessToken();
   G4bool ProcessValue(const G4String& name);	// Single numerical parameter
   G4bool ProcessList(const G4String& unitcat);	// List of parameters with unit
@@ -95,6 +111,8 @@ private:
   G4String fUnitCat;		// ... G4UnitsCategory of dimensions
 
   G4String fDataDir;		// Directory path ($G4LATTICEDATA)
+  G4String fFilePath;		// Full path of file found by OpenFile()
+  G4bool fHasIVModel;		// File sets IV model, instead of default
   G4double mElectron;		// Electron mass in kilograms
 };
 
@@ -12,6 +12,7 @@
 // 20181010  J. Singh -- Move functionality to G4CMPAnharmonicDecay.
 // 20181011  M. Kelsey -- Add LoadDataForTrack() to initialize decay utility.
 // 20201109  Drop G4CMP_DEBUG protection here, to avoid client rebuilding
+// 20261019  Add G4CMPPhononCascade for bulk downconversion above threshold
 
 #ifndef G4PhononDownconversion_h
 #define G4PhononDownconversion_h 1
@@ -19,6 +20,7 @@
 #include "G4VPhononProcess.hh"
 
 class G4CMPAnharmonicDecay;
+class G4CMPPhononCascade;
 
 
 class G4PhononDownconversion : public G4VPhononProcess {
@@ -35,7 +37,8 @@ public:
   // Configure for current track including AnharmonicDecay utility
   virtual void LoadDataForTrack(const G4Track* track);
 
-  // Perform downconversion using AnharmonicDecay utility
+  // Perform downconversion using AnharmonicDecay utility, or PhononCascade
+  // for phonons above the configured cascade energy
   virtual G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step& );
 
 protected:
@@ -47,6 +50,7 @@ protected:
 
 private:
   G4CMPAnharmonicDecay* anharmonicDecay;
+  G4CMPPhononCascade* phononCascade;
 
   // hide assignment operator as private
   G4PhononDownconversion(G4PhononDownconversion&);
@@ -9,8 +9,12 @@
 // 20220914  G4CMP-322 -- Address compiler warnings for unused arguments.
 // 20250101  G4CMP-440 -- Create separate debugging file per worker thread;
 //		add EventID column to debugging output.
+// 20261019  Sample daughter energies from lattice's inverse CDF tables,
+//		and load lattice constants only when the lattice changes.
+//		Add SampleDecay() for use without tracks (G4CMPPhononCascade).
 
 #include "G4CMPAnharmonicDecay.hh"
+#include "G4CMPAnharmonicTable.hh"
 #include "G4CMPPhononTrackInfo.hh"
 #include "G4CMPSecondaryUtils.hh"
 #include "G4CMPTrackUtils.hh"
@@ -34,7 +38,8 @@
 G4CMPAnharmonicDecay::G4CMPAnharmonicDecay(const G4VProcess* theProcess)
   : verboseLevel(theProcess?theProcess->GetVerboseLevel():0),
     procName(theProcess?theProcess->GetProcessName():"G4CMPAnharmonicDecay"),
-    fBeta(0.), fGamma(0.), fLambda(0.), fMu(0.), fvLvT(1.) {;}
+    fBeta(0.), fGamma(0.), fLambda(0.), fMu(0.), fvLvT(1.), fTTFrac(0.),
+    fCachedLattice(0), fTable(0) {;}
 
 void G4CMPAnharmonicDecay::DoDecay(const G4Track& aTrack, const G4Step&,
 				   G4ParticleChange& aParticleChange) {
@@ -54,18 +59,12 @@ void G4CMPAnharmonicDecay::DoDecay(const G4Track& aTrack, const G4Step&,
   }
 #endif
   // Obtain dynamical constants from this volume's lattice
-  fBeta   = theLattice->GetBeta() / (1e11*pascal);	// Make dimensionless
-  fGamma  = theLattice->GetGamma() / (1e11*pascal);
-  fLambda = theLattice->GetLambda() / (1e11*pascal);
-  fMu     = theLattice->GetMu() / (1e11*pascal);
-
-  fvLvT = theLattice->GetSoundSpeed() / theLattice->GetTransverseSoundSpeed();
+  if (theLattice != fCachedLattice) LoadLatticeConstants();
 
   //Destroy the parent phonon and create the daughter phonons.
   //74% chance that daughter phonons are both transverse
   //26% Transverse and Longitudinal
-  const G4double fracTT = theLattice->GetAnhTTFrac();
-  if (G4UniformRand() <= fracTT) MakeTTSecondaries(aTrack, aParticleChange);
+  if (G4UniformRand() <= fTTFrac) MakeTTSecondaries(aTrack, aParticleChange);
   else MakeLTSecondaries(aTrack, aParticleChange);
 
 #ifdef G4CMP_DEBUG
@@ -98,13 +97,35 @@ void G4CMPAnharmonicDecay::DoDecay(const G4Track& aTrack, const G4Step&,
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
 
+// Dimensionless constants and sampling tables from current lattice
+
+void G4CMPAnharmonicDecay::LoadLatticeConstants() {
+  fCachedLattice = theLattice;
+
+  fBeta   = theLattice->GetBeta() / (1e11*pascal);	// Make dimensionless
+  fGamma  = theLattice->GetGamma() / (1e11*pascal);
+  fLambda = theLattice->GetLambda() / (1e11*pascal);
+  fMu     = theLattice->GetMu() / (1e11*pascal);
+
+  fvLvT = theLattice->GetSoundSpeed() / theLattice->GetTransverseSoundSpeed();
+  fTTFrac = theLattice->GetAnhTTFrac();
+
+  // Lattices which were not initialized have no tables; use rejection
+  fTable = theLattice->GetAnharmonicTable();
+
+  if (verboseLevel>1) {
+    G4cout << procName << " using " << (fTable?"tabulated":"rejection")
+	   << " sampling of decay energies" << G4endl;
+  }
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
 
 //probability density of energy distribution of L'-phonon in L->L'+T process
 
 G4double G4CMPAnharmonicDecay::GetLTDecayProb(G4double d, G4double x) const {
   //d=delta= ratio of group velocities vl/vt and x is the fraction of energy in the longitudinal mode, i.e. x=EL'/EL
-  return (1/(x*x))*(1-x*x)*(1-x*x)*((1+x)*(1+x)-d*d*((1-x)*(1-x)))*(1+x*x-d*d*(1-x)*(1-x))*(1+x*x-d*d*(1-x)*(1-x));
+  return G4CMPAnharmonicTable::LTDecayProb(d, x);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
@@ -113,12 +134,7 @@ G4double G4CMPAnharmonicDecay::GetLTDecayProb(G4double d, G4double x) const {
 
 G4double G4CMPAnharmonicDecay::GetTTDecayProb(G4double d, G4double x) const {
   //dynamic constants from Tamura, PRL31, 1985
-  G4double A = 0.5*(1-d*d)*(fBeta+fLambda+(1+d*d)*(fGamma+fMu));
-  G4double B = fBeta+fLambda+2*d*d*(fGamma+fMu);
-  G4double C = fBeta + fLambda + 2*(fGamma+fMu);
-  G4double D = (1-d*d)*(2*fBeta+4*fGamma+fLambda+3*fMu);
-
-  return (A+B*d*x-B*x*x)*(A+B*d*x-B*x*x)+(C*x*(d-x)-D/(d-x)*(x-d-(1-d*d)/(4*x)))*(C*x*(d-x)-D/(d-x)*(x-d-(1-d*d)/(4*x)));
+  return G4CMPAnharmonicTable::TTDecayProb(d, x, fBeta, fGamma, fLambda, fMu);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
@@ -148,10 +164,25 @@ G4double G4CMPAnharmonicDecay::MakeTTDeviation(G4double d, G4double x) const {
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
 
 
-//Generate daughter phonons from L->T+T process
+// Sample daughters for decay of L-phonon without creating tracks
+
+void G4CMPAnharmonicDecay::SampleDecay(G4double energy, const G4ThreeVector& k,
+				       G4int mode[2], G4ThreeVector dir[2],
+				       G4double Esec[2]) {
+  if (theLattice != fCachedLattice) LoadLatticeConstants();
+
+  G4double theta[2];
+  if (G4UniformRand() <= fTTFrac) SampleTT(energy, k, mode, dir, Esec, theta);
+  else SampleLT(energy, k, mode, dir, Esec, theta);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+
+//Sample daughter phonons from L->T+T process
 
 void G4CMPAnharmonicDecay::
-MakeTTSecondaries(const G4Track& aTrack, G4ParticleChange& aParticleChange) {
+SampleTT(G4double E, const G4ThreeVector& k, G4int mode[2],
+	 G4ThreeVector dir[2], G4double Esec[2], G4double theta[2]) const {
   G4double upperBound=(1+(1/fvLvT))/2;
   G4double lowerBound=(1-(1/fvLvT))/2;
 
@@ -161,44 +192,97 @@ MakeTTSecondaries(const G4Track& aTrack, G4ParticleChange& aParticleChange) {
   //then accept that point.
   //x=fraction of parent phonon energy in first T phonon
   G4double x=0, p=0;
-  do {
+  if (fTable) x = fTable->ShootTT();	// Same distribution, single draw
+  else do {
     x = G4UniformRand()*(upperBound-lowerBound) + lowerBound;
     p = 1.5*G4UniformRand();
   } while (p >= GetTTDecayProb(fvLvT, x*fvLvT));
 
 
   //using energy fraction x to calculate daughter phonon directions
-  G4double theta1=MakeTTDeviation(fvLvT, x);
-  G4double theta2=MakeTTDeviation(fvLvT, 1-x);
-  G4ThreeVector dir1=G4CMP::GetTrackInfo<G4CMPPhononTrackInfo>(aTrack)->k();
-  G4ThreeVector dir2=dir1;
+  theta[0]=MakeTTDeviation(fvLvT, x);
+  theta[1]=MakeTTDeviation(fvLvT, 1-x);
+  dir[0]=k;
+  dir[1]=k;
 
   // FIXME:  These extra randoms change timing and causting outputs of example!
   //G4ThreeVector ran = G4RandomDirection();	// FIXME: Drop this line
   // Is this issue fixed by dropping the above line?
 
   G4double ph=G4UniformRand()*twopi;
-  dir1 = dir1.rotate(dir1.orthogonal(),theta1).rotate(dir1, ph);
-  dir2 = dir2.rotate(dir2.orthogonal(),-theta2).rotate(dir2,ph);
+  dir[0] = dir[0].rotate(dir[0].orthogonal(),theta[0]).rotate(dir[0], ph);
+  dir[1] = dir[1].rotate(dir[1].orthogonal(),-theta[1]).rotate(dir[1],ph);
 
-  G4double E=GetKineticEnergy(aTrack);
-  G4double Esec1 = x*E;
-  G4double Esec2 = E-Esec1;
+  Esec[0] = x*E;
+  Esec[1] = E-Esec[0];
 
   // Make FT or ST phonons (0. means no longitudinal)
-  G4int mode1 = G4CMP::ChoosePhononPolarization(0., theLattice->GetSTDOS(),
-						theLattice->GetFTDOS());
+  mode[0] = G4CMP::ChoosePhononPolarization(0., theLattice->GetSTDOS(),
+					    theLattice->GetFTDOS());
+
+  // Make FT or ST phonon (0. means no longitudinal)
+  mode[1] = G4CMP::ChoosePhononPolarization(0., theLattice->GetSTDOS(),
+					    theLattice->GetFTDOS());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+
+//Sample daughter phonons from L->L'+T process
+
+void G4CMPAnharmonicDecay::
+SampleLT(G4double E, const G4ThreeVector& k, G4int mode[2],
+	 G4ThreeVector dir[2], G4double Esec[2], G4double theta[2]) const {
+  G4double upperBound=1;
+  G4double lowerBound=(fvLvT-1)/(fvLvT+1);
+
+  G4double u=0, x=0;
+  if (fTable) x = fTable->ShootLT();	// Same distribution, single draw
+  else do {
+    u = G4UniformRand();
+    x = G4UniformRand()*(upperBound-lowerBound) + lowerBound;
+  } while (u >= GetLTDecayProb(fvLvT, x)/(2.8/(upperBound-lowerBound)));
+
+
+  //using energy fraction x to calculate daughter phonon directions
+  theta[0]=MakeLDeviation(fvLvT, x);
+  theta[1]=MakeTDeviation(fvLvT, x);
+  dir[0]=k;
+  dir[1]=k;
+
+  G4double ph=G4UniformRand()*twopi;
+  dir[0] = dir[0].rotate(dir[0].orthogonal(),theta[0]).rotate(dir[0], ph);
+  dir[1] = dir[1].rotate(dir[1].orthogonal(),-theta[1]).rotate(dir[1],ph);
+
+  Esec[0] = x*E;
+  Esec[1] = E-Esec[0];
+
+  // First secondary is longitudnal
+  mode[0] = G4PhononPolarization::Long;
 
   // Make FT or ST phonon (0. means no longitudinal)
-  G4int mode2 = G4CMP::ChoosePhononPolarization(0., theLattice->GetSTDOS(),
-						theLattice->GetFTDOS());
+  mode[1] = G4CMP::ChoosePhononPolarization(0., theLattice->GetSTDOS(),
+					    theLattice->GetFTDOS());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+
+//Generate daughter phonons from L->T+T process
+
+void G4CMPAnharmonicDecay::
+MakeTTSecondaries(const G4Track& aTrack, G4ParticleChange& aParticleChange) {
+  G4int mode[2];
+  G4ThreeVector dir[2];
+  G4double Esec[2], theta[2];
+  SampleTT(GetKineticEnergy(aTrack),
+	   G4CMP::GetTrackInfo<G4CMPPhononTrackInfo>(aTrack)->k(),
+	   mode, dir, Esec, theta);
 
   if (verboseLevel>1) {
     G4cout << " MakeTTSecondaries: "
-	   << G4PhononPolarization::Get(mode1)->GetParticleName() << " "
-	   << Esec1/eV << " eV toward " << dir1 << " ; "
-	   << G4PhononPolarization::Get(mode2)->GetParticleName() << " "
-	   << Esec2/eV << " eV toward " << dir2 << G4endl;
+	   << G4PhononPolarization::Get(mode[0])->GetParticleName() << " "
+	   << Esec[0]/eV << " eV toward " << dir[0] << " ; "
+	   << G4PhononPolarization::Get(mode[1])->GetParticleName() << " "
+	   << Esec[1]/eV << " eV toward " << dir[1] << G4endl;
   }
 
   // Construct the secondaries and set their wavevectors
@@ -208,11 +292,11 @@ MakeTTSecondaries(const G4Track& aTrack, G4ParticleChange& aParticleChange) {
 	   << aTrack.GetTouchable()->GetVolume()->GetName() << G4endl;
   }
 
-  G4Track* sec1 = G4CMP::CreatePhonon(aTrack, mode1,
-				      dir1, Esec1, aTrack.GetGlobalTime(),
+  G4Track* sec1 = G4CMP::CreatePhonon(aTrack, mode[0],
+				      dir[0], Esec[0], aTrack.GetGlobalTime(),
                                       aTrack.GetPosition());
-  G4Track* sec2 = G4CMP::CreatePhonon(aTrack, mode2,
-                                      dir2, Esec2, aTrack.GetGlobalTime(),
+  G4Track* sec2 = G4CMP::CreatePhonon(aTrack, mode[1],
+                                      dir[1], Esec[1], aTrack.GetGlobalTime(),
                                       aTrack.GetPosition());
 
   if (!sec1 || !sec2) {
@@ -224,7 +308,7 @@ MakeTTSecondaries(const G4Track& aTrack, G4ParticleChange& aParticleChange) {
   // Pick which secondary gets the weight randomly
 #ifdef G4CMP_DEBUG
   if (output.good()) {
-    output << theta1 << ',' << theta2 << ','
+    output << theta[0] << ',' << theta[1] << ','
 	   << sec1->GetKineticEnergy()/eV << ','
 	   << sec2->GetKineticEnergy()/eV << ',';
   }
@@ -241,51 +325,27 @@ MakeTTSecondaries(const G4Track& aTrack, G4ParticleChange& aParticleChange) {
 
 void G4CMPAnharmonicDecay::
 MakeLTSecondaries(const G4Track& aTrack, G4ParticleChange& aParticleChange) {
-  G4double upperBound=1;
-  G4double lowerBound=(fvLvT-1)/(fvLvT+1);
-
-  G4double u=0, x=0;
-  do {
-    u = G4UniformRand();
-    x = G4UniformRand()*(upperBound-lowerBound) + lowerBound;
-  } while (u >= GetLTDecayProb(fvLvT, x)/(2.8/(upperBound-lowerBound)));
-
-
-  //using energy fraction x to calculate daughter phonon directions
-  G4double thetaL=MakeLDeviation(fvLvT, x);
-  G4double thetaT=MakeTDeviation(fvLvT, x);
-  G4ThreeVector dir1=G4CMP::GetTrackInfo<G4CMPPhononTrackInfo>(aTrack)->k();
-  G4ThreeVector dir2=dir1;
-
-  G4double ph=G4UniformRand()*twopi;
-  dir1 = dir1.rotate(dir1.orthogonal(),thetaL).rotate(dir1, ph);
-  dir2 = dir2.rotate(dir2.orthogonal(),-thetaT).rotate(dir2,ph);
-
-  G4double E=GetKineticEnergy(aTrack);
-  G4double Esec1 = x*E;
-  G4double Esec2 = E-Esec1;
-
-  // First secondary is longitudnal
-  int mode1 = G4PhononPolarization::Long;
-
-  // Make FT or ST phonon (0. means no longitudinal)
-  G4int mode2 = G4CMP::ChoosePhononPolarization(0., theLattice->GetSTDOS(),
-						theLattice->GetFTDOS());
+  G4int mode[2];
+  G4ThreeVector dir[2];
+  G4double Esec[2], theta[2];
+  SampleLT(GetKineticEnergy(aTrack),
+	   G4CMP::GetTrackInfo<G4CMPPhononTrackInfo>(aTrack)->k(),
+	   mode, dir, Esec, theta);
 
   if (verboseLevel>1) {
     G4cout << " MakeLTSecondaries: "
-	   << G4PhononPolarization::Get(mode1)->GetParticleName() << " "
-	   << Esec1/eV << " eV toward " << dir1 << " ; "
-	   << G4PhononPolarization::Get(mode2)->GetParticleName() << " "
-	   << Esec2/eV << " eV toward " << dir2 << G4endl;
+	   << G4PhononPolarization::Get(mode[0])->GetParticleName() << " "
+	   << Esec[0]/eV << " eV toward " << dir[0] << " ; "
+	   << G4PhononPolarization::Get(mode[1])->GetParticleName() << " "
+	   << Esec[1]/eV << " eV toward " << dir[1] << G4endl;
   }
 
   // Construct the secondaries and set their wavevectors
-  G4Track* sec1 = G4CMP::CreatePhonon(aTrack, mode1,
-				      dir1, Esec1, aTrack.GetGlobalTime(),
+  G4Track* sec1 = G4CMP::CreatePhonon(aTrack, mode[0],
+				      dir[0], Esec[0], aTrack.GetGlobalTime(),
                                       aTrack.GetPosition());
-  G4Track* sec2 = G4CMP::CreatePhonon(aTrack, mode2,
-                                      dir2, Esec2, aTrack.GetGlobalTime(),
+  G4Track* sec2 = G4CMP::CreatePhonon(aTrack, mode[1],
+                                      dir[1], Esec[1], aTrack.GetGlobalTime(),
                                       aTrack.GetPosition());
 
   if (!sec1 || !sec2) {
@@ -296,7 +356,7 @@ MakeLTSecondaries(const G4Track& aTrack, G4ParticleChange& aParticleChange) {
 
 #ifdef G4CMP_DEBUG
   if (output.good()) {
-    output << thetaL << ',' << thetaT << ',' << sec1->GetKineticEnergy()/eV
+    output << theta[0] << ',' << theta[1] << ',' << sec1->GetKineticEnergy()/eV
 	   << ',' << sec2->GetKineticEnergy()/eV << ',';
   }
 #endif
@@ -306,4 +366,4 @@ MakeLTSecondaries(const G4Track& aTrack, G4ParticleChange& aParticleChange) {
   aParticleChange.AddSecondary(sec1);
 }
 
-//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo...
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
@@ -0,0 +1,168 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPAnharmonicTable.cc
+/// \brief Implementation of the G4CMPAnharmonicTable class, which tabulates
+///   the inverse CDFs of daughter energy fraction for anharmonic decay.
+//
+// $Id$
+//
+// 20261019  New class for tabulated anharmonic decay sampling
+
+#include "G4CMPAnharmonicTable.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <cmath>
+
+
+// Constructor fills both tables
+
+G4CMPAnharmonicTable::G4CMPAnharmonicTable(G4double d, G4double b,
+					   G4double g, G4double l,
+					   G4double m, G4int nQuant)
+  : vLvT(d), beta(b), gamma(g), lambda(l), mu(m), ttError(0.), ltError(0.) {
+  if (nQuant < 2) nQuant = 2;
+
+  // Finer tables if needed to meet tolerance, up to a reasonable limit
+  const G4int maxQuant = 16*nQuant;
+  for (G4int n=nQuant; n<=maxQuant; n*=2) {
+    ttError = FillQuantiles([this](G4double x) { return TTDensity(x); },
+			    TTLowerBound(vLvT), TTUpperBound(vLvT), n,
+			    ttQuantiles);
+    if (ttError <= GetTolerance()) break;
+  }
+
+  for (G4int n=nQuant; n<=maxQuant; n*=2) {
+    ltError = FillQuantiles([this](G4double x) { return LTDensity(x); },
+			    LTLowerBound(vLvT), LTUpperBound(vLvT), n,
+			    ltQuantiles);
+    if (ltError <= GetTolerance()) break;
+  }
+
+  if (ttError > GetTolerance() || ltError > GetTolerance()) {
+    G4ExceptionDescription msg;
+    msg << "Tabulated decay CDF differs from density by " << ttError
+	<< " (TT), " << ltError << " (LT) with " << ttQuantiles.size()-1
+	<< " and " << ltQuantiles.size()-1 << " quantiles";
+    G4Exception("G4CMPAnharmonicTable", "Anharmonic001", JustWarning, msg);
+  }
+}
+
+
+// Draw using G4UniformRand()
+
+G4double G4CMPAnharmonicTable::ShootTT() const {
+  return SampleTT(G4UniformRand());
+}
+
+G4double G4CMPAnharmonicTable::ShootLT() const {
+  return SampleLT(G4UniformRand());
+}
+
+
+// Probability density of energy distribution of L'-phonon in L->L'+T process
+// d = ratio of sound speeds vL/vT, x = fraction of energy in L' (EL'/EL)
+
+G4double G4CMPAnharmonicTable::LTDecayProb(G4double d, G4double x) {
+  return (1/(x*x))*(1-x*x)*(1-x*x)*((1+x)*(1+x)-d*d*((1-x)*(1-x)))*(1+x*x-d*d*(1-x)*(1-x))*(1+x*x-d*d*(1-x)*(1-x));
+}
+
+// Probability density of energy distribution of T-phonon in L->T+T process
+
+G4double G4CMPAnharmonicTable::TTDecayProb(G4double d, G4double x,
+					   G4double fBeta, G4double fGamma,
+					   G4double fLambda, G4double fMu) {
+  //dynamic constants from Tamura, PRL31, 1985
+  G4double A = 0.5*(1-d*d)*(fBeta+fLambda+(1+d*d)*(fGamma+fMu));
+  G4double B = fBeta+fLambda+2*d*d*(fGamma+fMu);
+  G4double C = fBeta + fLambda + 2*(fGamma+fMu);
+  G4double D = (1-d*d)*(2*fBeta+4*fGamma+fLambda+3*fMu);
+
+  return (A+B*d*x-B*x*x)*(A+B*d*x-B*x*x)+(C*x*(d-x)-D/(d-x)*(x-d-(1-d*d)/(4*x)))*(C*x*(d-x)-D/(d-x)*(x-d-(1-d*d)/(4*x)));
+}
+
+
+// Densities as accepted by rejection sampling, including cutoffs
+
+G4double G4CMPAnharmonicTable::TTDensity(G4double x) const {
+  return std::min(TTDecayProb(vLvT, x*vLvT, beta, gamma, lambda, mu), 1.5);
+}
+
+G4double G4CMPAnharmonicTable::LTDensity(G4double x) const {
+  G4double range = LTUpperBound(vLvT) - LTLowerBound(vLvT);
+  return std::min(LTDecayProb(vLvT, x)*range/2.8, 1.);
+}
+
+
+// Integrate density on fine grid, then invert at equal-probability steps
+
+template <class Density> G4double
+G4CMPAnharmonicTable::FillQuantiles(Density density, G4double xmin,
+				    G4double xmax, G4int nQuant,
+				    std::vector<G4double>& quantiles) const {
+  const G4int nFine = 32*nQuant;		// Integration steps
+  const G4double dx = (xmax-xmin)/nFine;
+
+  std::vector<G4double> cdf(nFine+1, 0.);
+  G4double fLast = std::max(0., density(xmin));
+  for (G4int i=1; i<=nFine; i++) {
+    G4double f = std::max(0., density(xmin+i*dx));
+    G4double fMid = std::max(0., density(xmin+(i-0.5)*dx));
+    cdf[i] = cdf[i-1] + (fLast + 4.*fMid + f)*dx/6.;	// Simpson's rule
+    fLast = f;
+  }
+
+  quantiles.resize(nQuant+1);
+
+  if (!(cdf[nFine] > 0.)) {		// Degenerate density; use uniform
+    for (G4int j=0; j<=nQuant; j++) quantiles[j] = xmin + j*(xmax-xmin)/nQuant;
+    return 1.;
+  }
+
+  for (G4double& c: cdf) c /= cdf[nFine];
+
+  // Energy fraction where CDF crosses each quantile
+  quantiles[0] = xmin;
+  quantiles[nQuant] = xmax;
+  G4int i = 0;
+  for (G4int j=1; j<nQuant; j++) {
+    G4double target = G4double(j)/nQuant;
+    while (i < nFine-1 && cdf[i+1] < target) i++;
+
+    G4double dc = cdf[i+1] - cdf[i];
+    G4double frac = (dc > 0.) ? (target-cdf[i])/dc : 0.;
+    quantiles[j] = xmin + (i+frac)*dx;
+  }
+
+  // Compare CDF of tabulated distribution to integral at each fine step
+  G4double maxError = 0.;
+  G4int j = 0;
+  for (i=0; i<=nFine; i++) {
+    G4double x = xmin + i*dx;
+    while (j < nQuant-1 && quantiles[j+1] < x) j++;
+
+    G4double width = quantiles[j+1] - quantiles[j];
+    G4double frac = (width > 0.) ? (x-quantiles[j])/width : 1.;
+    G4double tableCDF = (j + std::min(1., std::max(0., frac))) / nQuant;
+
+    maxError = std::max(maxError, std::abs(tableCDF - cdf[i]));
+  }
+
+  return maxError;
+}
+
+
+// Linear interpolation between quantiles
+
+G4double
+G4CMPAnharmonicTable::Sample(const std::vector<G4double>& quantiles,
+			     G4double u) const {
+  const G4int nQuant = quantiles.size()-1;
+
+  G4double t = u*nQuant;
+  G4int j = std::min(std::max(G4int(t), 0), nQuant-1);
+
+  return quantiles[j] + (t-j)*(quantiles[j+1]-quantiles[j]);
+}
@@ -17,9 +17,9 @@
 // 20200914  Include TExtend precalculation in FillTInverse action.
 // 20201002  Report tetrahedra errors during FillTInverse() initialization.
 // 20240920  G4CMP-244: Replace TetraIdx with function to access G4Cache.
+// 20261019  Use verbose level cached in base class, not G4CMPConfigManager.
 
 #include "G4CMPBiLinearInterp.hh"
-#include "G4CMPConfigManager.hh"
 #include <algorithm>
 #include <ctime>
 #include <fstream>
@@ -55,6 +55,7 @@ G4CMPBiLinearInterp::G4CMPBiLinearInterp(const G4CMPBiLinearInterp& rhs)
   TInverse = rhs.TInverse;
   TInvGood = rhs.TInvGood;
   TExtend  = rhs.TExtend;
+  verboseLevel = rhs.verboseLevel;
 
   Tetra01 = rhs.Tetra01;	// Not really needed, but for completeness
   Tetra02 = rhs.Tetra02;
@@ -254,7 +255,7 @@ void G4CMPBiLinearInterp::FillTInverse() {
   for (size_t itet=0; itet<ntet; itet++) {
     const tetra2d& tetra = Tetrahedra[itet];	// For convenience below
 #ifdef G4CMPTLI_DEBUG
-    if (G4CMPConfigManager::GetVerboseLevel() > 1) {
+    if (verboseLevel > 1) {
       G4cout << " Processing Tetrahedra[" << itet << "]: " << tetra << G4endl;
     }
 #endif
@@ -309,7 +310,7 @@ void G4CMPBiLinearInterp::FillGradients() {
 		    V[tetra[2]]*ET[2][1]),
 		   0.);
 #ifdef G4CMPTLI_DEBUG
-    if (G4CMPConfigManager::GetVerboseLevel() > 1) {
+    if (verboseLevel > 1) {
       G4cout << " Computed Grad[" << itet << "]: " << Grad[itet] << G4endl;
     }
 #endif
@@ -360,7 +361,7 @@ G4CMPBiLinearInterp::FindTetrahedron(const G4double pt[2], G4double bary[3],
   if (TetraIdx() == -1) TetraIdx() = TetraStart;
 
 #ifdef G4CMPTLI_DEBUG
-  if (G4CMPConfigManager::GetVerboseLevel() > 1) {
+  if (verboseLevel > 1) {
     G4cout << "FindTetrahedron pt " << pt[0] << " " << pt[1]
 	   << "\n starting from TetraIdx " << TetraIdx() << G4endl;
   }
@@ -384,7 +385,7 @@ G4CMPBiLinearInterp::FindTetrahedron(const G4double pt[2], G4double bary[3],
     }	// if (!Cart2bary())
 
 #ifdef G4CMPTLI_DEBUG
-    if (G4CMPConfigManager::GetVerboseLevel() > 2) {
+    if (verboseLevel > 2) {
       G4cout << " Loop " << count << ": Tetra " << TetraIdx() << ": "
 	     << Tetrahedra[TetraIdx()] << "\n bary " << bary[0] << " " << bary[1]
 	     << " " << bary[2] << " norm " << BaryNorm(bary)
@@ -403,7 +404,7 @@ G4CMPBiLinearInterp::FindTetrahedron(const G4double pt[2], G4double bary[3],
       bestTet  = TetraIdx();
 
 #ifdef G4CMPTLI_DEBUG
-      if (G4CMPConfigManager::GetVerboseLevel() > 2) {
+      if (verboseLevel > 2) {
 	G4cout << " New bestTet " << bestTet << " bestBary = " << bestBary
 	       << G4endl;
       }
@@ -432,7 +433,7 @@ G4CMPBiLinearInterp::FindTetrahedron(const G4double pt[2], G4double bary[3],
     TetraIdx() = newTetraIdx;
 
 #ifdef G4CMPTLI_DEBUG
-    if (G4CMPConfigManager::GetVerboseLevel() > 2) {
+    if (verboseLevel > 2) {
       G4cout << " minBaryIdx " << minBaryIdx << ": moved to neighbor tetra "
 	     << TetraIdx() << G4endl;
     }
@@ -443,7 +444,7 @@ G4CMPBiLinearInterp::FindTetrahedron(const G4double pt[2], G4double bary[3],
   TetraIdx() = bestTet;
 
 #ifdef G4CMPTLI_DEBUG
-  if (G4CMPConfigManager::GetVerboseLevel() > 1) {
+  if (verboseLevel > 1) {
     Cart2Bary(pt,bary);
     G4cout << "Tetrahedron not found! Using bestTet " << bestTet << " bary "
 	   << bary[0] << " " << bary[1] << " " << bary[2]
@@ -503,7 +504,7 @@ G4bool G4CMPBiLinearInterp::MatInv(const mat2x2& matrix, mat2x2& result,
 	     << G4endl;
 
 #ifdef G4CMPTLI_DEBUG
-      if (G4CMPConfigManager::GetVerboseLevel() > 1) G4cerr << matrix;
+      if (verboseLevel > 1) G4cerr << matrix;
 #endif
     }
 
@@ -31,6 +31,9 @@
 //	       overloadable function to kill track when max-reflections.
 // 20251028  G4CMP-527:  Use CheckStepBoundary() in ApplyBoundaryAction(),
 //	       add warning (G4cerr) message for points that need adjustment.
+// 20261019  Resolve surface property, electrode and probabilities once per
+//	       boundary and particle type; cache normals of planar faces.
+//	       Discard cache at start of run or on geometry rebuild.
 
 #include "G4CMPBoundaryUtils.hh"
 #include "G4CMPConfigManager.hh"
@@ -43,20 +46,36 @@
 #include "G4CMPUtils.hh"
 #include "G4CMPVElectrodePattern.hh"
 #include "G4CMPVTrackInfo.hh"
+#include "G4Box.hh"
 #include "G4ExceptionSeverity.hh"
 #include "G4GeometryTolerance.hh"
 #include "G4LatticeManager.hh"
 #include "G4LatticePhysical.hh"
 #include "G4LogicalSurface.hh"
 #include "G4ParticleChange.hh"
+#include "G4Para.hh"
 #include "G4ParticleDefinition.hh"
+#include "G4Run.hh"
+#include "G4RunManager.hh"
 #include "G4Step.hh"
 #include "G4StepPoint.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4Track.hh"
+#include "G4Trap.hh"
+#include "G4Trd.hh"
 #include "G4VPhysicalVolume.hh"
 #include "G4VProcess.hh"
 #include "G4VSolid.hh"
+#include "G4VTouchable.hh"
+#include <atomic>
+#include <cmath>
+
+
+// Bumped whenever geometry is rebuilt, shared by all threads
+
+namespace {
+  std::atomic<G4int> geometryVersion(0);
+}
 
 
 // Constructor and destructor
@@ -66,7 +85,8 @@ G4CMPBoundaryUtils::G4CMPBoundaryUtils(G4VProcess* process)
     procName(process->GetProcessName()), procUtils(0),
     kCarTolerance(G4GeometryTolerance::GetInstance()->GetSurfaceTolerance()),
     maximumReflections(-1), prePV(0), postPV(0), surfProp(0), matTable(0),
-    electrode(0) {
+    electrode(0), surfState(0), cacheRunID(-1),
+    cacheGeometry(geometryVersion.load()) {
   procUtils = dynamic_cast<G4CMPProcessUtils*>(process);
   if (!procUtils) {
     G4Exception("G4CMPBoundaryUtils::G4CMPBoundaryUtils", "Boundary000",
@@ -139,11 +159,74 @@ G4bool G4CMPBoundaryUtils::GetBoundingVolumes(const G4Step& aStep) {
   return true;
 }
 
+// Surfaces and their properties may be replaced between runs
+
+void G4CMPBoundaryUtils::InvalidateSurfaceCache() { geometryVersion++; }
+
+void G4CMPBoundaryUtils::CheckSurfaceCache() {
+  const G4RunManager* runMgr = G4RunManager::GetRunManager();
+  const G4Run* run = runMgr ? runMgr->GetCurrentRun() : nullptr;
+  G4int runID = run ? run->GetRunID() : -1;
+  G4int geomID = geometryVersion.load();
+
+  if (runID != cacheRunID || geomID != cacheGeometry) {
+    if (buVerboseLevel>1 && !surfaceCache.empty()) {
+      G4cout << procName << "::CheckSurfaceCache clearing "
+	     << surfaceCache.size() << " surfaces" << G4endl;
+    }
+
+    ClearSurfaceCache();
+    cacheRunID = runID;
+    cacheGeometry = geomID;
+  }
+}
+
 G4bool G4CMPBoundaryUtils::GetSurfaceProperty(const G4Step& aStep) {
-  surfProp = nullptr;				// Avoid stale cache!
-  matTable = nullptr;
-  electrode = nullptr;
-  
+  const G4ParticleDefinition* pd = aStep.GetTrack()->GetParticleDefinition();
+
+  CheckSurfaceCache();
+
+  // Surface is resolved on first encounter, then reused for later hits
+  SurfaceKey key(BoundaryPV(prePV,postPV), SurfaceType(pd));
+  auto cached = surfaceCache.find(key);
+  if (cached == surfaceCache.end()) {
+    cached = surfaceCache.emplace(key, SurfaceState()).first;
+    ResolveSurfaceState(aStep, cached->second);
+  }
+
+  surfState = &(cached->second);
+  surfProp  = surfState->surfProp;
+  matTable  = surfState->matTable;
+  electrode = surfState->electrode;
+
+  // Verify that surface property is G4CMP compatible
+  if (!surfState->valid) {
+    G4Exception((procName+"::GetSurfaceProperty").c_str(),
+		"Boundary003", EventMustBeAborted,
+		"Surface property is not G4CMP compatible");
+    return false;			// Badly defined, not undefined!
+  }
+
+  // Initialize electrode for current track
+  if (electrode) {
+    electrode->SetVerboseLevel(buVerboseLevel);
+    electrode->LoadDataForTrack(aStep.GetTrack());
+  }
+
+  return true;
+}
+
+// Look up surface and particle-specific parameters for current boundary
+
+void G4CMPBoundaryUtils::ResolveSurfaceState(const G4Step& aStep,
+					     SurfaceState& state) {
+  // Only convex, flat-faced solids can reuse normals between hits
+  G4VSolid* preSolid = prePV->GetLogicalVolume()->GetSolid();
+  state.planar = (dynamic_cast<G4Box*>(preSolid) ||
+		  dynamic_cast<G4Trd*>(preSolid) ||
+		  dynamic_cast<G4Trap*>(preSolid) ||
+		  dynamic_cast<G4Para*>(preSolid));
+
   // Look for specific surface between pre- and post-step points first
   G4LogicalSurface* surface =
     G4CMPLogicalBorderSurface::GetSurface(prePV, postPV);
@@ -164,7 +247,7 @@ G4bool G4CMPBoundaryUtils::GetSurfaceProperty(const G4Step& aStep) {
 
   hasSurface[bound] = false;		// Remember this boundary
 
-  if (!surface) return true;			// Can handle undefined surfaces
+  if (!surface) return;			// Can handle undefined surfaces
 
   G4SurfaceProperty* baseSP = surface->GetSurfaceProperty();
   if (!baseSP) {
@@ -172,47 +255,86 @@ G4bool G4CMPBoundaryUtils::GetSurfaceProperty(const G4Step& aStep) {
 		"Boundary002", JustWarning,
 		("No surface property defined for "+surface->GetName()).c_str()
 		);
-    return true;			// Can handle undefined surfaces
+    return;				// Can handle undefined surfaces
   }
 
-  // Verify that surface property is G4CMP compatible
-  surfProp = dynamic_cast<G4CMPSurfaceProperty*>(baseSP);
-  if (!surfProp) {
-    G4Exception((procName+"::GetSurfaceProperty").c_str(),
-		"Boundary003", EventMustBeAborted,
-		"Surface property is not G4CMP compatible");
-    return false;			// Badly defined, not undefined!
+  // Incompatible surface property is reported on every hit
+  state.surfProp = dynamic_cast<G4CMPSurfaceProperty*>(baseSP);
+  if (!state.surfProp) {
+    state.valid = false;
+    return;
   }
     
   // Extract particle-specific information for later
   const G4ParticleDefinition* pd = aStep.GetTrack()->GetParticleDefinition();
   if (G4CMP::IsChargeCarrier(pd)) {
-    matTable = surfProp->GetChargeMaterialPropertiesTablePointer();
-    electrode = surfProp->GetChargeElectrode();
+    state.matTable = state.surfProp->GetChargeMaterialPropertiesTablePointer();
+    state.electrode = state.surfProp->GetChargeElectrode();
   }
 
   if (G4CMP::IsPhonon(pd)) {
-    matTable = surfProp->GetPhononMaterialPropertiesTablePointer();
-    electrode = surfProp->GetPhononElectrode();
+    state.matTable = state.surfProp->GetPhononMaterialPropertiesTablePointer();
+    state.electrode = state.surfProp->GetPhononElectrode();
   }
 
-  if (!matTable) {
+  if (!state.matTable) {
     G4Exception((procName+"::GetSurfaceProperty").c_str(),
 		"Boundary004", JustWarning,
 		(pd->GetParticleName()+" has no surface properties").c_str()
 		);
-    return true;			// Can handle undefined surfaces
+    return;				// Can handle undefined surfaces
   }
 
-  // Initialize electrode for current track
-  if (electrode) {
-    electrode->SetVerboseLevel(buVerboseLevel);
-    electrode->LoadDataForTrack(aStep.GetTrack());
+  // Numerical parameters used for every hit on this surface
+  state.absProb  = state.matTable->GetConstProperty("absProb");
+  state.reflProb = state.matTable->GetConstProperty("reflProb");
+  if (G4CMP::IsChargeCarrier(pd)) {
+    state.minKElec = state.matTable->GetConstProperty("minKElec");
+    state.minKHole = state.matTable->GetConstProperty("minKHole");
+  }
+
+  if (buVerboseLevel>1) {
+    G4cout << procName << " resolved surface " << surface->GetName()
+	   << " for " << pd->GetParticleName() << ": absProb " << state.absProb
+	   << " reflProb " << state.reflProb
+	   << (state.planar ? " (planar)" : "") << G4endl;
   }
 
   hasSurface[bound] = true;		// Record good surface defined
+}
 
-  return true;
+G4int G4CMPBoundaryUtils::SurfaceType(const G4ParticleDefinition* pd) {
+  return (G4CMP::IsChargeCarrier(pd) ? 1 : G4CMP::IsPhonon(pd) ? 2 : 0);
+}
+
+
+// Outward normal at surfacePoint; flat faces are found with one dot product
+
+void G4CMPBoundaryUtils::ComputeSurfaceNormal(const G4Step& aStep) {
+  const G4VTouchable* preTouch = aStep.GetPreStepPoint()->GetTouchable();
+
+  G4ThreeVector pos = surfacePoint;
+  G4CMP::RotateToLocalPosition(preTouch, pos);
+
+  G4bool planar = (surfState && surfState->planar);
+  G4bool found = false;
+  if (planar) {
+    for (const PlanarFace& face: surfState->faces) {
+      if (std::fabs(face.normal.dot(pos) - face.offset) <= kCarTolerance) {
+	localNormal = face.normal;
+	found = true;
+	break;
+      }
+    }
+  }
+
+  if (!found) {
+    localNormal = prePV->GetLogicalVolume()->GetSolid()->SurfaceNormal(pos);
+    if (planar) surfState->faces.push_back({localNormal, localNormal.dot(pos)});
+  }
+
+  surfaceNormal = localNormal;
+  G4CMP::RotateToGlobalDirection(preTouch, surfaceNormal);
 }
 
 
@@ -314,6 +436,9 @@ G4CMPBoundaryUtils::ApplyBoundaryAction(const G4Track& aTrack,
     aParticleChange.ProposePosition(surfacePoint);
   }
 
+  // Only charge carriers use the precomputed normal
+  if (matTable && G4CMP::IsChargeCarrier(aTrack)) ComputeSurfaceNormal(aStep);
+
   if (!matTable) {
     if (buVerboseLevel>2) G4cout << "BU::Apply: !matTable" << G4endl;
     DoSimpleKill(aTrack, aStep, aParticleChange);
@@ -339,7 +464,8 @@ G4CMPBoundaryUtils::ApplyBoundaryAction(const G4Track& aTrack,
 // Default conditions for absorption or reflection
 
 G4bool G4CMPBoundaryUtils::AbsorbTrack(const G4Track&, const G4Step&) const {
-  G4double absProb = GetMaterialProperty("absProb");
+  G4double absProb = surfState ? surfState->absProb
+    : GetMaterialProperty("absProb");
   G4double rand = G4UniformRand();
   if (buVerboseLevel>2) {
     G4cout << " AbsorbTrack: absProb " << absProb << " rand " << rand
@@ -350,7 +476,8 @@ G4bool G4CMPBoundaryUtils::AbsorbTrack(const G4Track&, const G4Step&) const {
 }
 
 G4bool G4CMPBoundaryUtils::ReflectTrack(const G4Track&, const G4Step&) const {
-  G4double reflProb = GetMaterialProperty("reflProb");
+  G4double reflProb = surfState ? surfState->reflProb
+    : GetMaterialProperty("reflProb");
   G4double rand = G4UniformRand();
   if (buVerboseLevel>2) {
     G4cout << " ReflectTrack: reflProb " << reflProb << " rand " << rand
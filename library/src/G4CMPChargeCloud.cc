@@ -12,6 +12,11 @@
 ///   sphere will be "folded" inward at bounding surfaces.
 ///
 // $Id$
+//
+// 20261019  Add lattice fill option; only points beyond the volume's safety
+//		distance from the center are checked; 64-bit bin indices,
+//		with GetBinCenter() returning the center of GetBinIndex() bin.
+// 20261019  Split Generate() into Prepare() and GeneratePoints().
 
 #include "G4CMPChargeCloud.hh"
 #include "G4CMPGeometryUtils.hh"
@@ -25,6 +30,8 @@
 #include "G4VSolid.hh"
 #include "G4VTouchable.hh"
 #include "Randomize.hh"
+#include <algorithm>
+#include <cmath>
 #include <math.h>
 
 
@@ -33,7 +40,8 @@
 G4CMPChargeCloud::G4CMPChargeCloud(const G4LatticeLogical* lat,
 				   const G4VSolid* solid)
   : verboseLevel(0), theLattice(0), theSolid(solid), theTouchable(nullptr),
-    avgLatticeSpacing(0.), radiusScale(0.), binSpacing(0.), cloudRadius(0.) {
+    latticeFill(Diamond), avgLatticeSpacing(0.), radiusScale(0.),
+    binSpacing(0.), safety(0.), cloudRadius(0.), nChecked(0) {
   SetLattice(lat);
 }
 
@@ -71,11 +79,17 @@ void G4CMPChargeCloud::SetLattice(const G4LatticeLogical* lat) {
 					  lat->GetBasis(1).mag() *
 					  lat->GetBasis(2).mag());
 
-  radiusScale = avgLatticeSpacing/4.;	// 8 atoms per unit cell, r = a0/2.
+  // Radius per charge, r = a0/2 per unit cell, e.g. a0/4 for diamond
+  radiusScale = avgLatticeSpacing/2./cbrt(G4double(latticeFill));
 
   binSpacing = 4.*avgLatticeSpacing;	// Box sizes for collecting primaries
 }
 
+void G4CMPChargeCloud::SetLatticeFill(LatticeFill fill) {
+  latticeFill = fill;
+  SetLattice(theLattice);		// Recompute radius scale
+}
+
 
 // Store touchable (transform) and volume shape
 
@@ -100,6 +114,28 @@ void G4CMPChargeCloud::UseVolume(const G4VPhysicalVolume* vol) {
 
 const std::vector<G4ThreeVector>& 
 G4CMPChargeCloud::Generate(G4int npos, const G4ThreeVector& center) {
+  Prepare(npos, center);
+  nChecked = GeneratePoints(0, npos);
+
+  if (verboseLevel>2) {
+    for (G4int i=0; i<npos; i++) {
+      G4cout << " point " << i << " @ " << theCloud[i] << " in bin "
+	     << theCloudBins[i] << G4endl;
+    }
+  }
+
+  if (verboseLevel>1) {
+    G4cout << " safety " << safety/nm << " nm, " << nChecked << " of " << npos
+	   << " points checked against volume" << G4endl;
+  }
+
+  return theCloud;
+}
+
+
+// Size buffers and compute cloud parameters for filling in blocks
+
+void G4CMPChargeCloud::Prepare(G4int npos, const G4ThreeVector& center) {
   localCenter = center;
   if (theTouchable) G4CMP::RotateToLocalPosition(theTouchable, localCenter);
 
@@ -111,28 +147,46 @@ G4CMPChargeCloud::Generate(G4int npos, const G4ThreeVector& center) {
 	   << binSpacing/nm << " nm" << G4endl;
   }
 
-  theCloud.clear();
-  theCloud.reserve(npos);
-
-  theCloudBins.clear();
-  theCloudBins.reserve(npos);
+  theCloud.resize(npos);
+  theCloudBins.resize(npos);
 
-  for (G4int i=0; i<npos; i++) {
-    theCloud.push_back(GeneratePoint(cloudRadius)+localCenter);
-    if (theSolid) AdjustToVolume(theCloud.back());	// Checkout boundaries
+  // Points inside safety distance can not reach boundaries
+  safety = ComputeSafety();
+  nChecked = 0;
+}
 
-    theCloudBins.push_back(GetBinIndex(theCloud.back()));
+// Fill points [begin,end) of prepared cloud, return number checked
 
-    if (theTouchable)
-      G4CMP::RotateToGlobalPosition(theTouchable, theCloud.back());
+G4int G4CMPChargeCloud::GeneratePoints(size_t begin, size_t end) {
+  G4int nCheck = 0;
+  for (size_t i=begin; i<end; i++) {
+    G4ThreeVector& point = theCloud[i];
+    point = GeneratePoint(cloudRadius);
+    G4bool check = (point.mag2() >= safety*safety);
 
-    if (verboseLevel>2) {
-      G4cout << " point " << i << " @ " << theCloud.back() << " in bin "
-	     << theCloudBins.back() << G4endl;
+    point += localCenter;
+    if (check) {
+      AdjustToVolume(point);		// Checkout boundaries
+      nCheck++;
     }
+
+    theCloudBins[i] = GetBinIndex(point);
+
+    if (theTouchable) G4CMP::RotateToGlobalPosition(theTouchable, point);
   }
 
-  return theCloud;
+  return nCheck;
+}
+
+
+// Distance from center within which all points are inside volume
+
+G4double G4CMPChargeCloud::ComputeSafety() const {
+  if (!theSolid) return kInfinity;		// No boundaries to check
+
+  // Isotropic safety is an underestimate of distance to surface
+  return (theSolid->Inside(localCenter) == kInside
+	  ? theSolid->DistanceToOut(localCenter) : 0.);
 }
 
 
@@ -184,7 +238,7 @@ void G4CMPChargeCloud::AdjustToVolume(G4ThreeVector& point) const {
 // Conversions between local position and bin index (ijk)
 // Binning is done in units of 4 lattice spacings, centered on (0,0,0)
 
-G4int G4CMPChargeCloud::GetBinIndex(G4ThreeVector pos) const {
+G4long G4CMPChargeCloud::GetBinIndex(G4ThreeVector pos) const {
   // NOTE:  Argument passed by value for use in computations below
 
   // Convert local position in volume to bin index (w/(0,0,0) at bin center)
@@ -194,14 +248,20 @@ G4int G4CMPChargeCloud::GetBinIndex(G4ThreeVector pos) const {
 
   pos /= binSpacing;
 
-  // Bin index (ijk) allows up to 64 billion unit cells in cloud
-  return (int(pos.z())*1000 + int(pos.y()))*1000 + int(pos.x());
+  // Points folded in at boundaries may be outside the nominal range
+  auto axisBin = [](G4double x) {
+    return std::min(std::max(G4long(std::floor(x)), G4long(0)), binMask);
+  };
+
+  // Bin index (kji) with 21 bits per axis
+  return ((axisBin(pos.z()) << binBits | axisBin(pos.y())) << binBits
+	  | axisBin(pos.x()));
 }
 
-G4ThreeVector G4CMPChargeCloud::GetBinCenter(G4int ibin) const {
-  G4ThreeVector pbin((ibin%1000 - 0.5)*binSpacing - cloudRadius,
-		     ((ibin/1000)%1000 - 0.5)*binSpacing - cloudRadius,
-		     (ibin/1000000 - 0.5)*binSpacing - cloudRadius);
+G4ThreeVector G4CMPChargeCloud::GetBinCenter(G4long ibin) const {
+  G4ThreeVector pbin((ibin & binMask)*binSpacing - cloudRadius,
+		     ((ibin >> binBits) & binMask)*binSpacing - cloudRadius,
+		     ((ibin >> 2*binBits) & binMask)*binSpacing - cloudRadius);
   pbin += localCenter;
 
   return pbin;
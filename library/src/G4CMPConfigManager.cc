@@ -48,11 +48,23 @@
 // 20250325  G4CMP-463: Add parameter for phonon surface step size & limit.
 // 20250711  G4CMP-491: Turn off phonon surface displacement loop by default.
 // 20251104  G4CMP-527: Add missing ehMaxSteps initializer in copy constructor.
+// 20261019  Add flag to enable G4CMPProfiler timing (requires G4CMP_PROFILE).
+// 20261019  Add energy threshold for bulk phonon cascade (G4CMPPhononCascade).
+// 20261019  Add field stepper selection and per-volume field accuracy.
+// 20261019  Add flag to limit charge steps to field mesh tetrahedra.
+// 20261019  Add flag to use tabulated IV scattering rates.
+// 20261019  Add task size for splitting large partitions across tasks.
+// 20261019  Add thread count for partitioning tasks.
+// 20261019  Add flag to use tabulated NIEL yield (G4CMPNIELTable).
+// 20261019  Discard cached boundary surfaces when geometry is rebuilt.
 
 #include "G4CMPConfigManager.hh"
+#include "G4CMPBoundaryUtils.hh"
 #include "G4CMPConfigMessenger.hh"
 #include "G4CMPLewinSmithNIEL.hh"
 #include "G4CMPLindhardNIEL.hh"
+#include "G4CMPNIELTable.hh"
+#include "G4CMPProfiler.hh"
 #include "G4CMPEmpiricalNIEL.hh"
 #include "G4CMPImpactTunlNIEL.hh"
 #include "G4CMPSarkisNIEL.hh"
@@ -94,9 +106,14 @@ G4CMPConfigManager::G4CMPConfigManager()
     ehMaxSteps(getenv("G4CMP_EH_MAX_STEPS")?atoi(getenv("G4CMP_EH_MAX_STEPS")):-1),
     maxLukePhonons(getenv("G4MP_MAX_LUKE")?atoi(getenv("G4MP_MAX_LUKE")):-1),
     pSurfStepLimit(getenv("G4CMP_PHON_SURFLIMIT")?strtod(getenv("G4CMP_PHON_SURFLIMIT"),0):-1),
+    macroCharges(getenv("G4CMP_MACRO_CHARGES")?atoi(getenv("G4CMP_MACRO_CHARGES")):1),
+    macroSplitHits(getenv("G4CMP_MACRO_SPLIT")?atoi(getenv("G4CMP_MACRO_SPLIT")):0),
+    partitionTaskSize(getenv("G4CMP_PARTITION_TASKS")?atoi(getenv("G4CMP_PARTITION_TASKS")):0),
+    partitionThreads(getenv("G4CMP_PARTITION_THREADS")?atoi(getenv("G4CMP_PARTITION_THREADS")):0),
     LatticeDir(getenv("G4LATTICEDATA")?getenv("G4LATTICEDATA"):"./CrystalMaps"),
     IVRateModel(getenv("G4CMP_IV_RATE_MODEL")?getenv("G4CMP_IV_RATE_MODEL"):""),
     lukeFilename(getenv("G4CMP_LUKE_FILE")?getenv("G4CMP_LUKE_FILE"):"LukePhononEnergies"),
+    fieldStepper(getenv("G4CMP_FIELD_STEPPER")?getenv("G4CMP_FIELD_STEPPER"):"ClassicalRK4"),
     eTrapMFP(getenv("G4CMP_ETRAPPING_MFP")?strtod(getenv("G4CMP_ETRAPPING_MFP"),0)*mm:DBL_MAX),
     hTrapMFP(getenv("G4CMP_HTRAPPING_MFP")?strtod(getenv("G4CMP_HTRAPPING_MFP"),0)*mm:DBL_MAX),
     eDTrapIonMFP(getenv("G4CMP_EDTRAPION_MFP")?strtod(getenv("G4CMP_EDTRAPION_MFP"),0)*mm:DBL_MAX),
@@ -113,13 +130,20 @@ G4CMPConfigManager::G4CMPConfigManager()
     combineSteps(getenv("G4CMP_COMBINE_STEPLEN")?strtod(getenv("G4CMP_COMBINE_STEPLEN"),0):0.),
     EminPhonons(getenv("G4CMP_EMIN_PHONONS")?strtod(getenv("G4CMP_EMIN_PHONONS"),0)*eV:0.),
     EminCharges(getenv("G4CMP_EMIN_CHARGES")?strtod(getenv("G4CMP_EMIN_CHARGES"),0)*eV:0.),
+    EcascadePhonons(getenv("G4CMP_PHONON_CASCADE")?strtod(getenv("G4CMP_PHONON_CASCADE"),0)*eV:0.),
+    fieldDelta(getenv("G4CMP_FIELD_DELTA")?strtod(getenv("G4CMP_FIELD_DELTA"),0)*mm:10*nm),
+    fieldEpsilon(getenv("G4CMP_FIELD_EPSILON")?strtod(getenv("G4CMP_FIELD_EPSILON"),0):1e-6),
     pSurfStepSize(getenv("G4CMP_PHON_SURFSTEP")?strtod(getenv("G4CMP_PHON_SURFSTEP"),0)*um:0.),
     useKVsolver(getenv("G4CMP_USE_KVSOLVER")?atoi(getenv("G4CMP_USE_KVSOLVER")):0),
     fanoEnabled(getenv("G4CMP_FANO_ENABLED")?atoi(getenv("G4CMP_FANO_ENABLED")):1),
     kaplanKeepPh(getenv("G4CMP_KAPLAN_KEEP")?atoi(getenv("G4CMP_KAPLAN_KEEP")):true),
     chargeCloud(getenv("G4CMP_CHARGE_CLOUD")?atoi(getenv("G4CMP_CHARGE_CLOUD")):0),
     recordMinE(getenv("G4CMP_RECORD_EMIN")?atoi(getenv("G4CMP_RECORD_EMIN")):true),
-    nielPartition(0),
+    profiling(getenv("G4CMP_PROFILE_ENABLED")?atoi(getenv("G4CMP_PROFILE_ENABLED")):false),
+    meshSteps(getenv("G4CMP_MESH_STEPS")?atoi(getenv("G4CMP_MESH_STEPS")):false),
+    rateTables(getenv("G4CMP_RATE_TABLES")?atoi(getenv("G4CMP_RATE_TABLES")):false),
+    nielTables(getenv("G4CMP_NIEL_TABLES")?atoi(getenv("G4CMP_NIEL_TABLES")):false),
+    nielPartition(0), nielTable(0),
     Empklow(getenv("G4CMP_EMPIRICAL_KLOW")?strtod(getenv("G4CMP_EMPIRICAL_KLOW"),0):0.040),
     Empkhigh(getenv("G4CMP_EMPIRICAL_KHigh")?strtod(getenv("G4CMP_EMPIRICAL_KHigh"),0):0.142),
     EmpElow(getenv("G4CMP_EMPIRICAL_ELOW")?strtod(getenv("G4CMP_EMPIRICAL_ELOW"),0)*keV:0.39*keV),
@@ -135,10 +159,13 @@ G4CMPConfigManager::G4CMPConfigManager()
     setNIEL(getenv("G4CMP_NIEL_FUNCTION"));
   else 
     setNIEL(new G4CMPLewinSmithNIEL);
+
+  if (profiling) setProfiling(profiling);
 }
 
 G4CMPConfigManager::~G4CMPConfigManager() {
   delete messenger; messenger=0;
+  delete nielTable; nielTable=0;
 }
 
 // Duplicate existing (master) instances; don't need to check envvars
@@ -147,9 +174,14 @@ G4CMPConfigManager::G4CMPConfigManager(const G4CMPConfigManager& master)
   : verbose(master.verbose), fPhysicsModelID(master.fPhysicsModelID), 
     ehBounces(master.ehBounces), pBounces(master.pBounces),
     ehMaxSteps(master.ehMaxSteps), maxLukePhonons(master.maxLukePhonons),
-    pSurfStepLimit(master.pSurfStepLimit), version(master.version),
+    pSurfStepLimit(master.pSurfStepLimit),
+    macroCharges(master.macroCharges), macroSplitHits(master.macroSplitHits),
+    partitionTaskSize(master.partitionTaskSize),
+    partitionThreads(master.partitionThreads),
+    version(master.version),
     LatticeDir(master.LatticeDir), IVRateModel(master.IVRateModel),
-    lukeFilename(master.lukeFilename), eTrapMFP(master.eTrapMFP),
+    lukeFilename(master.lukeFilename), fieldStepper(master.fieldStepper),
+    eTrapMFP(master.eTrapMFP),
     hTrapMFP(master.hTrapMFP), eDTrapIonMFP(master.eDTrapIonMFP),
     eATrapIonMFP(master.eATrapIonMFP), hDTrapIonMFP(master.hDTrapIonMFP),
     hATrapIonMFP(master.hATrapIonMFP),
@@ -158,19 +190,25 @@ G4CMPConfigManager::G4CMPConfigManager(const G4CMPConfigManager& master)
     genPhonons(master.genPhonons), genCharges(master.genCharges), 
     lukeSample(master.lukeSample), combineSteps(master.combineSteps),
     EminPhonons(master.EminPhonons), EminCharges(master.EminCharges),
+    EcascadePhonons(master.EcascadePhonons),
+    fieldDelta(master.fieldDelta), fieldEpsilon(master.fieldEpsilon),
     pSurfStepSize(master.pSurfStepSize), useKVsolver(master.useKVsolver),
     fanoEnabled(master.fanoEnabled), kaplanKeepPh(master.kaplanKeepPh),
     chargeCloud(master.chargeCloud), recordMinE(master.recordMinE),
-    nielPartition(master.nielPartition),
+    profiling(master.profiling), meshSteps(master.meshSteps),
+    rateTables(master.rateTables), nielTables(master.nielTables),
+    nielPartition(master.nielPartition), nielTable(0),
     Empklow(master.Empklow), Empkhigh(master.Empkhigh),
     EmpElow(master.EmpElow), EmpEhigh(master.EmpEhigh),
     EmpEDepK(master.EmpEDepK), EmpkFixed(master.EmpkFixed),
+    fieldAccuracy(master.fieldAccuracy),
     messenger(new G4CMPConfigMessenger(this)) {;}
 
 
 // Trigger rebuild of geometry if parameters change
 
 void G4CMPConfigManager::UpdateGeometry() {
+  G4CMPBoundaryUtils::InvalidateSurfaceCache();
   G4RunManager::GetRunManager()->ReinitializeGeometry(true);
 }
 
@@ -199,10 +237,49 @@ void G4CMPConfigManager::setNIEL(G4String name) {
 }
 
 void G4CMPConfigManager::setNIEL(G4VNIELPartition* niel) {
+  delete nielTable; nielTable = 0;
   delete nielPartition;
   nielPartition = niel;
 }
 
+// Tables are filled on demand, so each thread builds its own
+
+const G4VNIELPartition* G4CMPConfigManager::getNIEL() {
+  if (!nielTables || !nielPartition) return nielPartition;
+
+  if (!nielTable || nielTable->GetModel() != nielPartition) {
+    delete nielTable;
+    nielTable = new G4CMPNIELTable(nielPartition);
+  }
+
+  return nielTable;
+}
+
+
+// Profiling flag is global to all threads
+
+void G4CMPConfigManager::setProfiling(G4bool value) {
+  profiling = value;
+  G4CMPProfiler::SetEnabled(value);
+}
+
+
+// Look up volume-specific field accuracy, with global defaults
+
+G4bool G4CMPConfigManager::getFieldAccuracy(const G4String& volume,
+					    G4double& delta,
+					    G4double& epsilon) const {
+  delta = fieldDelta;
+  epsilon = fieldEpsilon;
+
+  auto vol = fieldAccuracy.find(volume);
+  if (vol == fieldAccuracy.end()) return false;
+
+  if (vol->second.first > 0.) delta = vol->second.first;
+  if (vol->second.second > 0.) epsilon = vol->second.second;
+  return true;
+}
+
 
 // Report configuration setting for diagnostics
 
@@ -232,14 +309,26 @@ void G4CMPConfigManager::printConfig(std::ostream& os) const {
      << "\n/g4cmp/produceCharges " << genCharges << "\t\t\t\t# G4CMP_MAKE_CHARGES"
      << "\n/g4cmp/sampleLuke " << lukeSample << "\t\t\t\t# G4CMP_LUKE_SAMPLE"
      << "\n/g4cmp/maxLukePhonons " << maxLukePhonons << "\t\t\t# G4CMP_MAX_LUKE"
+     << "\n/g4cmp/macroCharges " << macroCharges << "\t\t\t\t# G4CMP_MACRO_CHARGES"
+     << "\n/g4cmp/macroSplitHits " << macroSplitHits << "\t\t\t# G4CMP_MACRO_SPLIT"
+     << "\n/g4cmp/partitionTaskSize " << partitionTaskSize << "\t\t\t# G4CMP_PARTITION_TASKS"
+     << "\n/g4cmp/partitionThreads " << partitionThreads << "\t\t\t# G4CMP_PARTITION_THREADS"
      << "\n/g4cmp/combiningStepLength " << combineSteps/mm << " mm\t\t\t# G4CMP_COMBINE_STEPLEN"
      << "\n/g4cmp/minEPhonons " << EminPhonons/eV << " eV\t\t\t\t# G4CMP_EMIN_PHONONS"
      << "\n/g4cmp/minECharges " << EminCharges/eV << " eV\t\t\t\t# G4CMP_EMIN_CHARGES"
+     << "\n/g4cmp/phononCascadeEnergy " << EcascadePhonons/eV << " eV\t\t# G4CMP_PHONON_CASCADE"
+     << "\n/g4cmp/fieldStepper " << fieldStepper << "\t\t# G4CMP_FIELD_STEPPER"
+     << "\n/g4cmp/fieldDeltaOneStep " << fieldDelta/mm << " mm\t\t# G4CMP_FIELD_DELTA"
+     << "\n/g4cmp/fieldEpsilon " << fieldEpsilon << "\t\t\t# G4CMP_FIELD_EPSILON"
      << "\n/g4cmp/useKVsolver " << useKVsolver << "\t\t\t\t# G4CMP_USE_KVSOLVER"
      << "\n/g4cmp/enableFanoStatistics " << fanoEnabled << "\t\t\t# G4CMP_FANO_ENABLED"
      << "\n/g4cmp/kaplanKeepPhonons " << kaplanKeepPh << "\t\t\t# G4CMP_KAPLAN_KEEP "
      << "\n/g4cmp/createChargeCloud " << chargeCloud << "\t\t\t# G4CMP_CHARGE_CLOUD"
      << "\n/g4cmp/recordMinETracks " << recordMinE << "\t\t\t# G4CMP_RECORD_EMIN"
+     << "\n/g4cmp/profile " << profiling << "\t\t\t\t# G4CMP_PROFILE_ENABLED"
+     << "\n/g4cmp/meshStepLimit " << meshSteps << "\t\t\t# G4CMP_MESH_STEPS"
+     << "\n/g4cmp/useRateTables " << rateTables << "\t\t\t# G4CMP_RATE_TABLES"
+     << "\n/g4cmp/useNIELTables " << nielTables << "\t\t\t# G4CMP_NIEL_TABLES"
      << "\n/g4cmp/NIELPartition "
      << (nielPartition ? typeid(*nielPartition).name() : "---")
      << "\t# G4CMP_NIEL_FUNCTION "
@@ -250,4 +339,9 @@ void G4CMPConfigManager::printConfig(std::ostream& os) const {
      << "\n/g4cmp/NIELPartition/Empirical/kFixed " << Empkhigh << "\t# G4CMP_EMPIRICAL_KFIXED"
      << "\n/g4cmp/NIELPartition/Empirical/EDepK " << EmpEDepK << "\t# G4CMP_EMPIRICAL_EDEPK "
      << std::endl;
+
+  for (const auto& vol: fieldAccuracy) {
+    os << "/g4cmp/fieldAccuracy " << vol.first << " " << vol.second.first/mm
+       << " mm " << vol.second.second << std::endl;
+  }
 }
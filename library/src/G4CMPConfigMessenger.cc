@@ -44,15 +44,28 @@
 // 20250212  G4CMP-457: Add macro command for Lindhard empirical ionization.
 // 20250502  G4CMP-358: Add macro command for maximum steps (stuck tracks).
 // 20250325  G4CMP-463: Add parameter for phonon surface step size & limit.
+// 20261019  Add macro commands to enable and print G4CMPProfiler timing.
+// 20261019  Add phononCascadeEnergy command for bulk phonon cascade.
+// 20261019  Add commands for field stepper and per-volume field accuracy.
+// 20261019  Add meshStepLimit command to limit charge steps to tetrahedra.
+// 20261019  Add useRateTables command for tabulated IV scattering rates.
+// 20261019  Add macroCharges and macroSplitHits for macro-carrier transport.
+// 20261019  Add partitionTaskSize to split large partitions across tasks.
+// 20261019  Add partitionThreads for partitioning task pool.
+// 20261019  Add useNIELTables command for tabulated NIEL yield.
 
 #include "G4CMPConfigMessenger.hh"
 #include "G4CMPConfigManager.hh"
+#include "G4CMPProfiler.hh"
 #include "G4UIcmdWithABool.hh"
 #include "G4UIcmdWithADouble.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithAnInteger.hh"
 #include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include <sstream>
 
 
 // Constructor and destructor
@@ -60,15 +73,20 @@
 G4CMPConfigMessenger::G4CMPConfigMessenger(G4CMPConfigManager* mgr)
   : G4UImessenger("/g4cmp/",
 		  "User configuration for G4CMP phonon/charge carrier library"),
-    theManager(mgr), versionCmd(0), printCmd(0), verboseCmd(0), ehBounceCmd(0),
-    pBounceCmd(0), maxStepsCmd(0), maxLukeCmd(0), pSurfStepLimitCmd(0),
-    clearCmd(0), minEPhononCmd(0), minEChargeCmd(0), sampleECmd(0),
+    theManager(mgr), versionCmd(0), printCmd(0), printProfileCmd(0),
+    verboseCmd(0), ehBounceCmd(0),
+    pBounceCmd(0), maxStepsCmd(0), maxLukeCmd(0), macroCmd(0),
+    macroSplitCmd(0), partTaskCmd(0), partThreadCmd(0), pSurfStepLimitCmd(0),
+    clearCmd(0), minEPhononCmd(0), minEChargeCmd(0), cascadeECmd(0),
+    fieldDeltaCmd(0), sampleECmd(0),
     comboStepCmd(0), trapEMFPCmd(0), trapHMFPCmd(0), eDTrapIonMFPCmd(0),
     eATrapIonMFPCmd(0), hDTrapIonMFPCmd(0), hATrapIonMFPCmd(0), tempCmd(0),
     pSurfStepSizeCmd(0), minstepCmd(0), makePhononCmd(0), makeChargeCmd(0),
-    lukePhononCmd(0), dirCmd(0), lukeFileCmd(0), ivRateModelCmd(0),
-    nielPartitionCmd(0),kvmapCmd(0), fanoStatsCmd(0), kaplanKeepCmd(0),
-    ehCloudCmd(0), recordMinECmd(0) {
+    lukePhononCmd(0), fieldEpsilonCmd(0), dirCmd(0), lukeFileCmd(0),
+    ivRateModelCmd(0), nielPartitionCmd(0), fieldStepperCmd(0),
+    fieldAccuracyCmd(0), kvmapCmd(0), fanoStatsCmd(0), kaplanKeepCmd(0),
+    ehCloudCmd(0), recordMinECmd(0), profileCmd(0), meshStepCmd(0),
+    rateTableCmd(0), nielTableCmd(0) {
   verboseCmd = CreateCommand<G4UIcmdWithAnInteger>("verbose",
 					   "Enable diagnostic messages");
 
@@ -78,6 +96,16 @@ G4CMPConfigMessenger::G4CMPConfigMessenger(G4CMPConfigManager* mgr)
   versionCmd = CreateCommand<G4UIcmdWithoutParameter>("version",
 					    "Report G4CMP version string");
 
+  profileCmd = CreateCommand<G4UIcmdWithABool>("profile",
+	  "Collect call counts and timing for G4CMP processes and utilities");
+  profileCmd->SetGuidance("Requires library built with G4CMP_PROFILE.");
+  profileCmd->SetGuidance("Summary is printed at the end of each run.");
+  profileCmd->SetParameterName("enable",true,false);
+  profileCmd->SetDefaultValue(true);
+
+  printProfileCmd = CreateCommand<G4UIcmdWithoutParameter>("printProfile",
+		    "Report G4CMP timing accumulated from all threads");
+
   dirCmd = CreateCommand<G4UIcmdWithAString>("LatticeData",
 			     "Set directory for lattice configuration files");
   dirCmd->AvailableForStates(G4State_PreInit);
@@ -114,6 +142,35 @@ G4CMPConfigMessenger::G4CMPConfigMessenger(G4CMPConfigManager* mgr)
   maxLukeCmd->SetGuidance("This is a soft maximum, estimated from the bias");
   maxLukeCmd->SetGuidance("voltage of the device and the downsampling scale");
 
+  macroCmd = CreateCommand<G4UIcmdWithAnInteger>("macroCharges",
+		 "Set number of charge carriers transported by each track");
+  macroCmd->SetGuidance("Each track is a bundle with statistical weight and");
+  macroCmd->SetGuidance("diffusion width; 1 (default) transports single carriers");
+  macroCmd->SetParameterName("N",false);
+  macroCmd->SetRange("N>=1");
+
+  macroSplitCmd = CreateCommand<G4UIcmdWithAnInteger>("macroSplitHits",
+		      "Set number of electrode hits from each carrier bundle");
+  macroSplitCmd->SetGuidance("Hits are spread by the bundle's diffusion width;");
+  macroSplitCmd->SetGuidance("0 (default) records one hit per carrier");
+  macroSplitCmd->SetParameterName("N",false);
+  macroSplitCmd->SetRange("N>=0");
+
+  partTaskCmd = CreateCommand<G4UIcmdWithAnInteger>("partitionTaskSize",
+		    "Set number of tracks generated by each partitioning task");
+  partTaskCmd->SetGuidance("Larger energy deposits are split across tasks");
+  partTaskCmd->SetGuidance("in G4CMP's own thread pool; 0 (default) is serial.");
+  partTaskCmd->SetGuidance("Results do not depend on the task size.");
+  partTaskCmd->SetParameterName("N",false);
+  partTaskCmd->SetRange("N>=0");
+
+  partThreadCmd = CreateCommand<G4UIcmdWithAnInteger>("partitionThreads",
+		      "Set number of threads for partitioning tasks");
+  partThreadCmd->SetGuidance("0 (default) uses all cores; 1 runs tasks in order");
+  partThreadCmd->SetGuidance("on the event's own thread");
+  partThreadCmd->SetParameterName("N",false);
+  partThreadCmd->SetRange("N>=0");
+
   minEPhononCmd = CreateCommand<G4UIcmdWithADoubleAndUnit>("minEPhonons",
           "Minimum energy for creating or tracking phonons");
   minEPhononCmd->SetUnitCategory("Energy");
@@ -122,6 +179,69 @@ G4CMPConfigMessenger::G4CMPConfigMessenger(G4CMPConfigManager* mgr)
           "Minimum energy for creating or tracking charge carriers");
   minEChargeCmd->SetUnitCategory("Energy");
 
+  cascadeECmd = CreateCommand<G4UIcmdWithADoubleAndUnit>("phononCascadeEnergy",
+	  "Energy above which phonon downconversion is done in bulk");
+  cascadeECmd->SetGuidance("Downconversion and scattering of phonons above");
+  cascadeECmd->SetGuidance("this energy are done without creating tracks,");
+  cascadeECmd->SetGuidance("until they reach a boundary or fall below it.");
+  cascadeECmd->SetGuidance("Zero (default) disables the bulk cascade.");
+  cascadeECmd->SetUnitCategory("Energy");
+
+  fieldStepperCmd = CreateCommand<G4UIcmdWithAString>("fieldStepper",
+	  "Select integrator for charge transport in electric field");
+  fieldStepperCmd->SetGuidance("ClassicalRK4     : Fourth-order Runge-Kutta");
+  fieldStepperCmd->SetGuidance("DormandPrince745 : Embedded RK, with FSAL");
+  fieldStepperCmd->SetGuidance("Midpoint         : Second-order, for mesh fields");
+  fieldStepperCmd->SetGuidance("UniformField     : RK4 with one field lookup per");
+  fieldStepperCmd->SetGuidance("                   step, for constant fields");
+  fieldStepperCmd->SetGuidance("Takes effect when G4CMPFieldManager is created.");
+  fieldStepperCmd->SetCandidates("ClassicalRK4 DormandPrince745 Midpoint UniformField");
+
+  fieldDeltaCmd = CreateCommand<G4UIcmdWithADoubleAndUnit>("fieldDeltaOneStep",
+	  "Position accuracy for charge transport in electric field");
+  fieldDeltaCmd->SetUnitCategory("Length");
+
+  fieldEpsilonCmd = CreateCommand<G4UIcmdWithADouble>("fieldEpsilon",
+	  "Relative accuracy for charge transport in electric field");
+
+  fieldAccuracyCmd = new G4UIcommand("/g4cmp/fieldAccuracy", this);
+  fieldAccuracyCmd->SetGuidance("Set field transport accuracy for one volume");
+  fieldAccuracyCmd->SetGuidance("Volume may be physical or logical volume name.");
+  fieldAccuracyCmd->SetGuidance("Zero or negative values use global settings.");
+
+  G4UIparameter* param = new G4UIparameter("volume", 's', false);
+  fieldAccuracyCmd->SetParameter(param);
+  param = new G4UIparameter("delta", 'd', false);
+  fieldAccuracyCmd->SetParameter(param);
+  param = new G4UIparameter("unit", 's', true);
+  param->SetDefaultUnit("um");
+  fieldAccuracyCmd->SetParameter(param);
+  param = new G4UIparameter("epsilon", 'd', true);
+  param->SetDefaultValue(0.);
+  fieldAccuracyCmd->SetParameter(param);
+
+  meshStepCmd = CreateCommand<G4UIcmdWithABool>("meshStepLimit",
+	  "Limit charge steps to tetrahedra of mesh electric field");
+  meshStepCmd->SetGuidance("Field is constant along each step; best used");
+  meshStepCmd->SetGuidance("with /g4cmp/fieldStepper UniformField.");
+  meshStepCmd->SetParameterName("enable",true,false);
+  meshStepCmd->SetDefaultValue(true);
+
+  rateTableCmd = CreateCommand<G4UIcmdWithABool>("useRateTables",
+	  "Use tabulated intervalley scattering rates");
+  rateTableCmd->SetGuidance("Tables are filled for each lattice when first used,");
+  rateTableCmd->SetGuidance("with analytic rates outside the tabulated range.");
+  rateTableCmd->SetParameterName("enable",true,false);
+  rateTableCmd->SetDefaultValue(true);
+
+  nielTableCmd = CreateCommand<G4UIcmdWithABool>("useNIELTables",
+	  "Use tabulated NIEL yield function for energy partitioning");
+  nielTableCmd->SetGuidance("Tables are filled for each material and recoil");
+  nielTableCmd->SetGuidance("species when first used, in log(E) from 10 eV");
+  nielTableCmd->SetGuidance("to 100 MeV, with /g4cmp/NIELPartition outside.");
+  nielTableCmd->SetParameterName("enable",true,false);
+  nielTableCmd->SetDefaultValue(true);
+
   recordMinECmd = CreateCommand<G4UIcmdWithABool>("recordMinETracks",
 	  "Store NIEL for killed tracks which fall below minimum energy");
   recordMinECmd->SetParameterName("record",true,false);
@@ -237,13 +357,27 @@ G4CMPConfigMessenger::~G4CMPConfigMessenger() {
   delete printCmd; printCmd=0;
   delete verboseCmd; verboseCmd=0;
   delete versionCmd; versionCmd=0;
+  delete profileCmd; profileCmd=0;
+  delete meshStepCmd; meshStepCmd=0;
+  delete rateTableCmd; rateTableCmd=0;
+  delete nielTableCmd; nielTableCmd=0;
+  delete printProfileCmd; printProfileCmd=0;
   delete ehBounceCmd; ehBounceCmd=0;
   delete pBounceCmd; pBounceCmd=0;
   delete maxStepsCmd; maxStepsCmd=0;
   delete maxLukeCmd; maxLukeCmd=0;
+  delete macroCmd; macroCmd=0;
+  delete macroSplitCmd; macroSplitCmd=0;
+  delete partTaskCmd; partTaskCmd=0;
+  delete partThreadCmd; partThreadCmd=0;
   delete clearCmd; clearCmd=0;
   delete minEPhononCmd; minEPhononCmd=0;
   delete minEChargeCmd; minEChargeCmd=0;
+  delete cascadeECmd; cascadeECmd=0;
+  delete fieldStepperCmd; fieldStepperCmd=0;
+  delete fieldDeltaCmd; fieldDeltaCmd=0;
+  delete fieldEpsilonCmd; fieldEpsilonCmd=0;
+  delete fieldAccuracyCmd; fieldAccuracyCmd=0;
   delete recordMinECmd; recordMinECmd=0;
   delete sampleECmd; sampleECmd=0;
   delete comboStepCmd; comboStepCmd=0;
@@ -285,6 +419,10 @@ void G4CMPConfigMessenger::SetNewValue(G4UIcommand* cmd, G4String value) {
   if (cmd == makeChargeCmd) theManager->SetGenCharges(StoD(value));
   if (cmd == lukePhononCmd) theManager->SetLukeSampling(StoD(value));
   if (cmd == maxLukeCmd) theManager->SetMaxLukePhonons(StoI(value));
+  if (cmd == macroCmd) theManager->SetMacroCharges(StoI(value));
+  if (cmd == macroSplitCmd) theManager->SetMacroSplitHits(StoI(value));
+  if (cmd == partTaskCmd) theManager->SetPartitionTaskSize(StoI(value));
+  if (cmd == partThreadCmd) theManager->SetPartitionThreads(StoI(value));
   if (cmd == ehBounceCmd) theManager->SetMaxChargeBounces(StoI(value));
   if (cmd == pBounceCmd) theManager->SetMaxPhononBounces(StoI(value));
   if (cmd == maxStepsCmd) theManager->SetMaxChargeSteps(StoI(value));
@@ -302,9 +440,28 @@ void G4CMPConfigMessenger::SetNewValue(G4UIcommand* cmd, G4String value) {
   if (cmd == minEPhononCmd)
     theManager->SetMinPhononEnergy(minEPhononCmd->GetNewDoubleValue(value));
 
+  if (cmd == cascadeECmd)
+    theManager->SetPhononCascadeEnergy(cascadeECmd->GetNewDoubleValue(value));
+
   if (cmd == minEChargeCmd)
     theManager->SetMinChargeEnergy(minEChargeCmd->GetNewDoubleValue(value));
 
+  if (cmd == fieldStepperCmd) theManager->SetFieldStepper(value);
+
+  if (cmd == fieldDeltaCmd)
+    theManager->SetFieldDeltaOneStep(fieldDeltaCmd->GetNewDoubleValue(value));
+
+  if (cmd == fieldEpsilonCmd) theManager->SetFieldEpsilon(StoD(value));
+
+  if (cmd == fieldAccuracyCmd) {
+    G4String volume, unit;
+    G4double delta=0., epsilon=0.;
+    std::istringstream args(value);
+    args >> volume >> delta >> unit >> epsilon;
+    theManager->SetFieldAccuracy(volume, delta*G4UIcommand::ValueOf(unit),
+				 epsilon);
+  }
+
   if (cmd == recordMinECmd) theManager->RecordMinETracks(StoB(value));
 
   // TEMPORARY: If sampling energy is set and Luke=1., set Luke=-1.
@@ -348,6 +505,12 @@ void G4CMPConfigMessenger::SetNewValue(G4UIcommand* cmd, G4String value) {
     G4cout << "G4CMP version: " << theManager->Version() << G4endl;
 
   if (cmd == printCmd) G4cout << *theManager << G4endl;
+
+  if (cmd == profileCmd) theManager->EnableProfiling(StoB(value));
+  if (cmd == meshStepCmd) theManager->LimitStepsToMesh(StoB(value));
+  if (cmd == rateTableCmd) theManager->UseRateTables(StoB(value));
+  if (cmd == nielTableCmd) theManager->UseNIELTables(StoB(value));
+  if (cmd == printProfileCmd) G4CMPProfiler::Report(G4cout);
     
   if (cmd == EmpklowCmd)
     theManager->SetEmpklow(EmpklowCmd->GetNewDoubleValue(value));
@@ -10,6 +10,7 @@
 //
 // 20170815  Drop call to LoadDataForTrack(); now handled in process.
 // 20170820  Compute rate for L-type phonons; otherwise return 0.
+// 20261019  Move calculation to RateForEnergy(), for bulk phonon cascade
 
 #include "G4CMPDownconversionRate.hh"
 #include "G4LatticePhysical.hh"
@@ -24,8 +25,12 @@ G4double G4CMPDownconversionRate::Rate(const G4Track& aTrack) const {
   // If current particle type not L-phonon, do not decay
   if (aTrack.GetDefinition() != G4PhononLong::Definition()) return 0.;
 
+  return RateForEnergy(GetKineticEnergy(aTrack));
+}
+
+G4double G4CMPDownconversionRate::RateForEnergy(G4double energy) const {
   G4double A = theLattice->GetAnhDecConstant();
-  G4double Eoverh = GetKineticEnergy(aTrack)/h_Planck;
+  G4double Eoverh = energy/h_Planck;
   
   return (Eoverh*Eoverh*Eoverh*Eoverh*Eoverh*A);
 }
@@ -20,6 +20,10 @@
 // 20251015  Resolve shadowed declaration in DoFinalReflection()
 // 20251024  G4CMP-519: Protect against possible zero energy in DoAbsorption()
 // 20251028  G4CMP-527: Move CheckStepBoundary() to ApplyBoundaryAction()
+// 20261019  Add G4CMPProfiler timing of GPIL and PostStepDoIt().
+// 20261019  Use resolved surface state and cached normal from BoundaryUtils
+// 20261019  Partitioner computes its own sampling factors without changing
+//		G4CMPConfigManager, so let DoPartition() compute them.
 
 #include "G4CMPDriftBoundaryProcess.hh"
 #include "G4CMPConfigManager.hh"
@@ -27,6 +31,7 @@
 #include "G4CMPDriftHole.hh"
 #include "G4CMPEnergyPartition.hh"
 #include "G4CMPGeometryUtils.hh"
+#include "G4CMPProfiler.hh"
 #include "G4CMPSecondaryUtils.hh"
 #include "G4CMPSurfaceProperty.hh"
 #include "G4CMPUtils.hh"
@@ -47,9 +52,7 @@
 
 G4CMPDriftBoundaryProcess::G4CMPDriftBoundaryProcess(const G4String& name)
   : G4CMPVDriftProcess(name, fChargeBoundary), G4CMPBoundaryUtils(this),
-    partitioner(new G4CMPEnergyPartition) {
-  partitioner->UseDownsampling(false);		// Apply preset scaling factors
-}
+    partitioner(new G4CMPEnergyPartition) {;}
 
 G4CMPDriftBoundaryProcess::~G4CMPDriftBoundaryProcess() {
   delete partitioner;
@@ -62,6 +65,7 @@ G4double G4CMPDriftBoundaryProcess::
 PostStepGetPhysicalInteractionLength(const G4Track& aTrack,
 				     G4double previousStepSize,
 				     G4ForceCondition* condition) {
+  G4CMP_PROFILE_TIMER(profileGPIL);
   return GetMeanFreePath(aTrack, previousStepSize, condition);
 }
 
@@ -75,6 +79,7 @@ GetMeanFreePath(const G4Track&, G4double, G4ForceCondition* condition) {
 G4VParticleChange* 
 G4CMPDriftBoundaryProcess::PostStepDoIt(const G4Track& aTrack,
                                          const G4Step& aStep) {
+  G4CMP_PROFILE_TIMER(profileDoIt);
   // NOTE:  G4VProcess::SetVerboseLevel is not virtual!  Can't overload it
   G4CMPBoundaryUtils::SetVerboseLevel(verboseLevel);
 
@@ -106,8 +111,9 @@ G4CMPDriftBoundaryProcess::PostStepDoIt(const G4Track& aTrack,
 
 G4bool G4CMPDriftBoundaryProcess::AbsorbTrack(const G4Track& aTrack,
                                               const G4Step& aStep) const {
-  G4double absMinK = (G4CMP::IsElectron(aTrack) ? GetMaterialProperty("minKElec")
-		      : G4CMP::IsHole(aTrack) ? GetMaterialProperty("minKHole")
+  const SurfaceState* state = GetSurfaceState();
+  G4double absMinK = (G4CMP::IsElectron(aTrack) ? state->minKElec
+		      : G4CMP::IsHole(aTrack) ? state->minKHole
 		      : -1.);
 
   if (absMinK < 0.) {
@@ -118,9 +124,8 @@ G4bool G4CMPDriftBoundaryProcess::AbsorbTrack(const G4Track& aTrack,
   G4ThreeVector kvec = GetLocalWaveVector(aTrack);
 
   // NOTE:  K vector above is in local coords, must use local normal
-  // Must use PreStepPoint volume for transform.
-  G4ThreeVector surfNorm = G4CMP::GetLocalDirection(aTrack.GetTouchable(),
-                                                    G4CMP::GetSurfaceNormal(aStep));
+  // Normal was computed in PreStepPoint volume by ApplyBoundaryAction()
+  const G4ThreeVector& surfNorm = GetLocalSurfaceNormal();
 
   if (verboseLevel>2) {
     G4cout << " AbsorbTrack: local k-perp " << kvec*surfNorm
@@ -147,8 +152,6 @@ void G4CMPDriftBoundaryProcess::DoAbsorption(const G4Track& aTrack,
 
   G4double eAbs = GetKineticEnergy(aTrack);
   if (eAbs > 0.) {
-    // Compute direct-phonon downsampling here
-    partitioner->ComputePhononSampling(eAbs);
     partitioner->DoPartition(0., eAbs);
     partitioner->GetSecondaries(&aParticleChange);
     
@@ -180,13 +183,13 @@ DoReflection(const G4Track& aTrack, const G4Step& aStep,
 }
 
 void G4CMPDriftBoundaryProcess::
-DoReflectionElectron(const G4Track& aTrack, const G4Step& aStep,
+DoReflectionElectron(const G4Track& aTrack, const G4Step& /*aStep*/,
 		     G4ParticleChange& /*particleChange*/) {
   if (verboseLevel>1)
     G4cout << GetProcessName() << ": Electron reflected" << G4endl;
 
   // Get outward normal from current volume
-  G4ThreeVector surfNorm = G4CMP::GetSurfaceNormal(aStep);
+  G4ThreeVector surfNorm = GetSurfaceNormal();
 
   // FUTURE: Get specular vs. diffuse probability from parameters
   G4bool specular = false;
@@ -254,7 +257,7 @@ DoReflectionHole(const G4Track& /*aTrack*/, const G4Step& aStep,
   if (verboseLevel>1)
     G4cout << GetProcessName() << ": Hole reflected" << G4endl;
 
-  G4ThreeVector surfNorm = G4CMP::GetSurfaceNormal(aStep);
+  G4ThreeVector surfNorm = GetSurfaceNormal();
 
   // TODO: If we do the electrons Lambertian, we should do the holes also
   G4ThreeVector momDir = aStep.GetPostStepPoint()->GetMomentumDirection();
@@ -8,12 +8,16 @@
 // 20180827  M. Kelsey -- Prevent partitioner from recomputing sampling factors
 // 20210328  Modify above; compute direct-phonon sampling factor here
 // 20250929  M. Kelsey -- Include residual kinetic energy in phonon release
+// 20261019  Add G4CMPProfiler timing of PostStepDoIt().
+// 20261019  Partitioner computes its own sampling factors without changing
+//		G4CMPConfigManager, so let DoPartition() compute them.
 
 #include "G4CMPDriftRecombinationProcess.hh"
 #include "G4CMPConfigManager.hh"
 #include "G4CMPDriftElectron.hh"
 #include "G4CMPDriftHole.hh"
 #include "G4CMPEnergyPartition.hh"
+#include "G4CMPProfiler.hh"
 #include "G4CMPSecondaryUtils.hh"
 #include "G4CMPUtils.hh"
 #include "G4LatticePhysical.hh"
@@ -26,9 +30,7 @@
 
 G4CMPDriftRecombinationProcess::
 G4CMPDriftRecombinationProcess(const G4String &name, G4CMPProcessSubType type)
-  : G4CMPVDriftProcess(name, type), partitioner(new G4CMPEnergyPartition) {
-  partitioner->UseDownsampling(false);		// Apply preset scaling factors
-}
+  : G4CMPVDriftProcess(name, type), partitioner(new G4CMPEnergyPartition) {;}
 
 G4CMPDriftRecombinationProcess::~G4CMPDriftRecombinationProcess() {
   delete partitioner;
@@ -47,6 +49,7 @@ G4CMPDriftRecombinationProcess::GetMeanFreePath(const G4Track&, G4double,
 G4VParticleChange* 
 G4CMPDriftRecombinationProcess::PostStepDoIt(const G4Track& aTrack,
 					     const G4Step& aStep) {
+  G4CMP_PROFILE_TIMER(profileDoIt);
   aParticleChange.Initialize(aTrack);
 
   // If the particle has not come to rest, do nothing
@@ -72,7 +75,6 @@ G4CMPDriftRecombinationProcess::PostStepDoIt(const G4Track& aTrack,
   G4double Erecomb = (0.5*theLattice->GetBandGapEnergy()
 		      + aTrack.GetKineticEnergy());
 
-  partitioner->ComputePhononSampling(Erecomb);
   partitioner->DoPartition(0., Erecomb);
   partitioner->GetSecondaries(&aParticleChange);
 
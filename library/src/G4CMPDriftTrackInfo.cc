@@ -12,16 +12,23 @@
 // $Id$
 //
 // 20161111 Initial commit - R. Agnese
+// 20261019 Add multiplicity and diffusion width for macro-carrier bundles
+// 20261019 Add Luke sampling factor, set by G4CMPEnergyPartition
+// 20261019 Diffusion width uses only displacement transverse to field
 
 #include "G4CMPDriftTrackInfo.hh"
+#include "G4CMPConfigManager.hh"
+#include "G4CMPFieldUtils.hh"
 #include "G4LatticePhysical.hh"
 #include "G4ParticleDefinition.hh"
+#include "G4Track.hh"
+#include <cmath>
 
 //G4Allocator<G4CMPDriftTrackInfo> G4CMPDriftTrackInfoAllocator;
 
 G4CMPDriftTrackInfo::G4CMPDriftTrackInfo(const G4LatticePhysical* lat,
                                          G4int valIdx) :
-                                         G4CMPVTrackInfo(lat) {
+  G4CMPVTrackInfo(lat), lukeSampling(G4CMPConfigManager::GetLukeSampling()) {
   SetValleyIndex(valIdx);
 }
 
@@ -37,6 +44,45 @@ void G4CMPDriftTrackInfo::SetValleyIndex(G4int valIdx) {
   valleyIdx = valIdx;
 }
 
+void G4CMPDriftTrackInfo::SetMultiplicity(G4int mult) {
+  if (mult < 1) {
+    G4Exception("G4CMPDriftTrackInfo::SetMultiplicity", "DriftTrackInfo002",
+		EventMustBeAborted, "multiplicity must be at least one");
+    return;
+  }
+
+  multiplicity = mult;
+}
+
+// Each carrier in a bundle would scatter independently; treat the path
+// between scatters as a random-walk segment.  Displacement along the field
+// is common drift, so only the transverse part, l_perp^2/2 per transverse
+// axis, spreads the bundle.  Without a field, use l^2/3 per axis.
+
+G4double G4CMPDriftTrackInfo::DiffusionWidth() const {
+  return std::sqrt(diffusion2);
+}
+
+void G4CMPDriftTrackInfo::AddScattering(const G4Track& track) {
+  AddDiffusion(scattered ? lastScatter : track.GetVertexPosition(),
+	       track.GetPosition(), G4CMP::GetFieldAtPosition(track));
+}
+
+void G4CMPDriftTrackInfo::AddDiffusion(const G4ThreeVector& start,
+				       const G4ThreeVector& end,
+				       const G4ThreeVector& field) {
+  G4ThreeVector seg = end - start;
+
+  if (field.mag2() > 0.) {
+    diffusion2 += seg.perp2(field)/2.;
+  } else {
+    diffusion2 += seg.mag2()/3.;
+  }
+
+  lastScatter = end;
+  scattered = true;
+}
+
 void G4CMPDriftTrackInfo::Print() const {
 //TODO
 }
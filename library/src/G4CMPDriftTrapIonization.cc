@@ -8,9 +8,11 @@
 //		particle types
 // 20200604  G4CMP-208: Comment out unused function arguments
 // 20250929  G4CMP-478: Change secondary minimal energy from 1e-3 to 1e-6
+// 20261019  Add G4CMPProfiler timing of PostStepDoIt().
 
 #include "G4CMPDriftTrapIonization.hh"
 #include "G4CMPConfigManager.hh"
+#include "G4CMPProfiler.hh"
 #include "G4CMPSecondaryUtils.hh"
 #include "G4CMPUtils.hh"
 #include "G4ExceptionSeverity.hh"
@@ -82,6 +84,7 @@ G4CMPDriftTrapIonization::GetMeanFreePath(const G4Track&, G4double,
 G4VParticleChange* 
 G4CMPDriftTrapIonization::PostStepDoIt(const G4Track& aTrack,
 				       const G4Step& /*aStep*/) {
+  G4CMP_PROFILE_TIMER(profileDoIt);
   aParticleChange.Initialize(aTrack);
 
   if (verboseLevel > 1) {
@@ -9,10 +9,16 @@
 // 20200504  G4CMP-195:  Reduce length of charge-trapping parameter names;
 //		provide static function for MFP access; remove unnecessary
 //		#includes.
+// 20261019  Add G4CMPProfiler timing of PostStepDoIt().
+// 20261019  Macro-carrier bundles trap one carrier at a time, with MFP
+//		reduced by the bundle multiplicity.
 
 #include "G4CMPDriftTrappingProcess.hh"
 #include "G4CMPConfigManager.hh"
+#include "G4CMPDriftTrackInfo.hh"
 #include "G4CMPEnergyPartition.hh"
+#include "G4CMPProfiler.hh"
+#include "G4CMPTrackUtils.hh"
 #include "G4CMPUtils.hh"
 #include "G4Track.hh"
 
@@ -39,9 +45,14 @@ G4CMPDriftTrappingProcess::GetMeanFreePath(const G4ParticleDefinition* pd) {
 	  : DBL_MAX);
 }
 
-G4double G4CMPDriftTrappingProcess::GetMeanFreePath(const G4Track&, G4double,
+G4double G4CMPDriftTrappingProcess::GetMeanFreePath(const G4Track& aTrack,
+						    G4double,
 						    G4ForceCondition*) {
-  return GetMeanFreePath(GetCurrentParticle());
+  G4double mfp = GetMeanFreePath(GetCurrentParticle());
+
+  // Any one of the carriers in a macro-carrier bundle may be trapped
+  G4int mult = G4CMP::GetTrackInfo<G4CMPDriftTrackInfo>(aTrack)->Multiplicity();
+  return (mult > 1 && mfp < DBL_MAX) ? mfp/mult : mfp;
 }
 
 // Process actions
@@ -49,6 +60,7 @@ G4double G4CMPDriftTrappingProcess::GetMeanFreePath(const G4Track&, G4double,
 G4VParticleChange* 
 G4CMPDriftTrappingProcess::PostStepDoIt(const G4Track& aTrack,
 					const G4Step& /*aStep*/) {
+  G4CMP_PROFILE_TIMER(profileDoIt);
   aParticleChange.Initialize(aTrack);
 
   if (verboseLevel > 1) {
@@ -58,8 +70,16 @@ G4CMPDriftTrappingProcess::PostStepDoIt(const G4Track& aTrack,
            << G4endl;
   }
 
-  // NOTE: If trap depth allows for energy release, use partitioner here
-  aParticleChange.ProposeTrackStatus(fStopAndKill);
+  // Bundle loses one carrier and continues, with weight reduced to match
+  auto trackInfo = G4CMP::GetTrackInfo<G4CMPDriftTrackInfo>(aTrack);
+  G4int mult = trackInfo->Multiplicity();
+  if (mult > 1) {
+    aParticleChange.ProposeWeight(aTrack.GetWeight()*(mult-1.)/mult);
+    trackInfo->SetMultiplicity(mult-1);
+  } else {
+    // NOTE: If trap depth allows for energy release, use partitioner here
+    aParticleChange.ProposeTrackStatus(fStopAndKill);
+  }
 
   ClearNumberOfInteractionLengthLeft();		// All processes should do this!
   return &aParticleChange;
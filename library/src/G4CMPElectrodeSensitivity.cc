@@ -4,10 +4,16 @@
 \***********************************************************************/
 
 #include "G4CMPElectrodeSensitivity.hh"
+#include "G4CMPConfigManager.hh"
+#include "G4CMPDriftTrackInfo.hh"
 #include "G4CMPElectrodeHit.hh"
+#include "G4CMPGeometryUtils.hh"
+#include "G4CMPRamoSignal.hh"
+#include "G4CMPTrackUtils.hh"
 #include "G4CMPUtils.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4SDManager.hh"
+#include "Randomize.hh"
 
 #include "G4CMPDriftElectron.hh"
 #include "G4CMPDriftHole.hh"
@@ -16,13 +22,14 @@
 #include "G4PhononTransSlow.hh"
 
 G4CMPElectrodeSensitivity::G4CMPElectrodeSensitivity(G4String name)
-  :G4VSensitiveDetector(name), hitsCollection(nullptr) {
+  :G4VSensitiveDetector(name), hitsCollection(nullptr), ramoSignal(nullptr) {
   collectionName.insert("G4CMPElectrodeHit");
 }
 
 G4CMPElectrodeSensitivity::G4CMPElectrodeSensitivity(G4CMPElectrodeSensitivity&& in) :
   G4VSensitiveDetector(std::move(in)),
-  hitsCollection(in.hitsCollection) {
+  hitsCollection(in.hitsCollection), ramoSignal(in.ramoSignal) {
+  in.ramoSignal = nullptr;
 }
 
 G4CMPElectrodeSensitivity& G4CMPElectrodeSensitivity::operator=(G4CMPElectrodeSensitivity&& in) {
@@ -37,28 +44,98 @@ G4CMPElectrodeSensitivity& G4CMPElectrodeSensitivity::operator=(G4CMPElectrodeSe
 
   // Our members
   hitsCollection = in.hitsCollection;
+  std::swap(ramoSignal, in.ramoSignal);
 
   return *this;
 }
 
+G4CMPElectrodeSensitivity::~G4CMPElectrodeSensitivity() {
+  delete ramoSignal;
+}
+
+void G4CMPElectrodeSensitivity::SetRamoSignal(G4CMPRamoSignal* signal) {
+  if (signal == ramoSignal) return;
+  delete ramoSignal;
+  ramoSignal = signal;
+}
+
 void G4CMPElectrodeSensitivity::Initialize(G4HCofThisEvent* HCE) {
   hitsCollection = new G4CMPElectrodeHitsCollection(SensitiveDetectorName,
                                                     collectionName[0]);
   G4int HCID = G4SDManager::GetSDMpointer()->GetCollectionID(hitsCollection);
   HCE->AddHitsCollection(HCID, hitsCollection);
+
+  if (ramoSignal) ramoSignal->Clear();
 }
 
 G4bool G4CMPElectrodeSensitivity::ProcessHits(G4Step* aStep,
                                               G4TouchableHistory* ROhist) {
+  // Signals are induced by every charge step, not just at electrodes
+  if (ramoSignal) ramoSignal->AddStep(aStep);
+
   if (IsHit(aStep, ROhist)) {
     auto hit = new G4CMPElectrodeHit;
     G4CMP::FillHit(aStep, hit); // Mutates hit
-    hitsCollection->insert(hit);
+
+    if (G4CMP::IsChargeCarrier(aStep->GetTrack()))
+      InsertChargeHits(aStep, hit);
+    else
+      hitsCollection->insert(hit);
   }
 
   return true;
 }
 
+void G4CMPElectrodeSensitivity::InsertChargeHits(const G4Step* step,
+                                                 G4CMPElectrodeHit* hit) {
+  auto trackInfo = G4CMP::GetTrackInfo<G4CMPDriftTrackInfo>(step->GetTrack());
+  G4int nsplit = NumberOfSplitHits(trackInfo ? trackInfo->Multiplicity() : 1);
+
+  if (nsplit <= 1) {
+    hitsCollection->insert(hit);
+    return;
+  }
+
+  std::vector<G4CMPElectrodeHit*> subhits;
+  SplitHit(hit, nsplit, trackInfo->DiffusionWidth(),
+           G4CMP::GetSurfaceNormal(*step), subhits);
+
+  for (G4CMPElectrodeHit* subhit: subhits) hitsCollection->insert(subhit);
+}
+
+G4int G4CMPElectrodeSensitivity::NumberOfSplitHits(G4int multiplicity) {
+  G4int nsplit = G4CMPConfigManager::GetMacroSplitHits();
+  return (nsplit <= 0 || nsplit > multiplicity) ? multiplicity : nsplit;
+}
+
+void G4CMPElectrodeSensitivity::
+SplitHit(G4CMPElectrodeHit* hit, G4int nsplit, G4double sigma,
+         const G4ThreeVector& norm, std::vector<G4CMPElectrodeHit*>& subhits) {
+  subhits.clear();
+  if (!hit) return;
+
+  if (nsplit < 1) nsplit = 1;
+  subhits.reserve(nsplit);
+
+  // Each sub-hit carries an equal share of the bundle's weight and energy
+  hit->SetWeight(hit->GetWeight()/nsplit);
+  hit->SetEnergyDeposit(hit->GetEnergyDeposit()/nsplit);
+
+  // Carriers are spread around the bundle in the plane of the electrode
+  const G4ThreeVector center = hit->GetFinalPosition();
+  G4ThreeVector uhat = norm.orthogonal().unit();
+  G4ThreeVector vhat = norm.cross(uhat).unit();
+
+  for (G4int i=0; i<nsplit; i++) {
+    G4CMPElectrodeHit* subhit = (i==0) ? hit : new G4CMPElectrodeHit(*hit);
+    if (sigma > 0.) {
+      subhit->SetFinalPosition(center + G4RandGauss::shoot(0.,sigma)*uhat
+                               + G4RandGauss::shoot(0.,sigma)*vhat);
+    }
+    subhits.push_back(subhit);
+  }
+}
+
 G4bool G4CMPElectrodeSensitivity::IsHit(const G4Step* step,
                                         const G4TouchableHistory*) const {
   /* Charge carriers do not deposit energy when they land on an electrode.
@@ -65,19 +65,32 @@
 // 20240731  G4CMP-416 -- eIon below bandgap should be converted to phonons
 // 20250127  G4CMP-449 -- Conslidate LukeSampling() function, allow -1.
 // 20251001  G4CMP-503 -- Avoid reporting 'NaN' in phonon energy summary.
+// 20261019  Charge cloud bin indices are now 64-bit.
+// 20261019  Group charge pairs into macro-carrier bundles (G4CMP_MACRO_CHARGES)
+// 20261019  Keep sampling factors in data members instead of writing them
+//		back to G4CMPConfigManager; pass Luke sampling to charges.
+// 20261019  Fill particle list in place; large lists may be split across
+//		G4TaskGroup tasks, each with its own random engine.
+// 20261019  Run tasks in a separate thread pool, with random streams which
+//		do not depend on task size.  Compute charge cloud, positions and
+//		kinematics in tasks; only G4Track allocation stays serial.
+//		Electron and hole in a pair share one charge cloud point.
 
 #include "G4CMPEnergyPartition.hh"
 #include "G4CMPChargeCloud.hh"
 #include "G4CMPConfigManager.hh"
 #include "G4CMPDriftElectron.hh"
 #include "G4CMPDriftHole.hh"
+#include "G4CMPDriftTrackInfo.hh"
 #include "G4CMPFanoBinomial.hh"
 #include "G4CMPFieldUtils.hh"
 #include "G4CMPGeometryUtils.hh"
 #include "G4CMPPartitionData.hh"
 #include "G4CMPPartitionSummary.hh"
-#include "G4CMPSecondaryUtils.hh"
+#include "G4CMPPhononTrackInfo.hh"
+#include "G4CMPPrimaryInfo.hh"
 #include "G4CMPStepAccumulator.hh"
+#include "G4CMPTrackUtils.hh"
 #include "G4CMPUtils.hh"
 #include "G4VNIELPartition.hh"
 #include "G4DynamicParticle.hh"
@@ -98,34 +111,80 @@
 #include "G4RunManager.hh"
 #include "G4SDManager.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "G4Track.hh"
 #include "G4VParticleChange.hh"
 #include "G4VPhysicalVolume.hh"
+#include "G4VTouchable.hh"
 #include "Randomize.hh"
+#include "CLHEP/Random/MixMaxRng.h"
 #include "CLHEP/Random/RandBinomial.h"
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <vector>
 
+#ifdef G4MULTITHREADED
+#include "G4AutoLock.hh"
+#include "G4TaskGroup.hh"
+#include "G4ThreadPool.hh"
+#include <atomic>
+#include <map>
+#endif
 
-// Constructors and destructor
 
-// TEMPORARY:  Flag to either compute Luke sampling, or use preset value
 namespace {
-  G4double lukeDownsampling = true;
+  // Particles per random stream in FillInTasks(); shorter lists use the
+  // event's engine directly
+  const size_t streamSize = 1024;
+
+#ifdef G4MULTITHREADED
+  // Partition tasks have their own pool, one per thread count, kept for the
+  // whole job.  Waiting on the event pool could run another event's work
+  // inline; waiting here can only run other partition blocks.
+  G4ThreadPool* GetPartitionPool(G4int nThreads) {
+    static G4Mutex poolMutex = G4MUTEX_INITIALIZER;
+    static std::map<G4int, G4ThreadPool*> pools;
+
+    G4AutoLock lock(&poolMutex);
+    G4ThreadPool*& pool = pools[nThreads];
+    if (!pool) {
+      G4ThreadPool::Config config;
+      config.pool_size = nThreads;
+
+      // Pool threads must act as workers, so that thread-local singletons
+      // (e.g. G4CMPConfigManager) are copied from the master; IDs are
+      // offset to avoid those of event workers
+      config.initializer = [] {
+	static std::atomic<G4int> poolThreads(0);
+	G4Threading::G4SetThreadId(10000 + poolThreads++);
+      };
+
+      pool = new G4ThreadPool(config);
+    }
+
+    return pool;
+  }
+#endif
 }
 
+
+// Constructors and destructor
+
 G4CMPEnergyPartition::G4CMPEnergyPartition(G4Material* mat,
 					   G4LatticePhysical* lat)
   : G4CMPProcessUtils(), verboseLevel(G4CMPConfigManager::GetVerboseLevel()),
     fillSummaryData(false), material(mat), biasVoltage(0.), 
     holeFraction(0.5), nParticlesMinimum(10),
-    applyDownsampling(true), cloud(new G4CMPChargeCloud),
+    applyDownsampling(true),
+    chargeSampling(G4CMPConfigManager::GetGenCharges()),
+    phononSampling(G4CMPConfigManager::GetGenPhonons()),
+    lukeSampling(G4CMPConfigManager::GetLukeSampling()),
+    cloud(new G4CMPChargeCloud),
     nPairsTrue(0), nPairsGen(0), chargeEnergyLeft(0.),
     nPhononsTrue(0), nPhononsGen(0), phononEnergyLeft(0.),
     summary(0) {
   SetLattice(lat);
-
-  // TEMPORARY: If user set Luke sampling negative, we compute it below
-  lukeDownsampling = (G4CMPConfigManager::GetLukeSampling() < 0.);
 }
 
 G4CMPEnergyPartition::G4CMPEnergyPartition(const G4VPhysicalVolume* volume)
@@ -344,13 +403,21 @@ void G4CMPEnergyPartition::DoPartition(G4double eIon, G4double eNIEL) {
   summary->trueNIEL = eNIEL;
   summary->lindhardYield = eIon / (eIon+eNIEL);
 
+  // Start from configured rates; G4CMPConfigManager is not modified
+  chargeSampling = G4CMPConfigManager::GetGenCharges();
+  phononSampling = G4CMPConfigManager::GetGenPhonons();
+  lukeSampling   = G4CMPConfigManager::GetLukeSampling();
+
   // Apply downsampling if requested
   if (applyDownsampling) ComputeDownsampling(eIon, eNIEL);
 
+  // Negative Luke sampling means to use the phonon production rate
+  if (lukeSampling < 0.) lukeSampling = phononSampling;
+
   summary->samplingEnergy  = G4CMPConfigManager::GetSamplingEnergy();
-  summary->samplingCharges = G4CMPConfigManager::GetGenCharges();
-  summary->samplingPhonons = G4CMPConfigManager::GetGenPhonons();
-  summary->samplingLuke    = G4CMPConfigManager::GetLukeSampling();
+  summary->samplingCharges = chargeSampling;
+  summary->samplingPhonons = phononSampling;
+  summary->samplingLuke    = lukeSampling;
 
   chargeEnergyLeft = eIon;
   GenerateCharges(eIon);
@@ -399,14 +466,14 @@ void
 G4CMPEnergyPartition::ComputePhononSampling(G4double eNIEL) {
   G4double samplingScale = G4CMPConfigManager::GetSamplingEnergy();
   if (samplingScale <= 0.) return;		// No downsampling computation
-  if (G4CMPConfigManager::GetGenPhonons() <= 0.) return;
+  if (phononSampling <= 0.) return;
 
   // Downsample non-ionizing energy the same way we do ionization
   G4double phononSamp = (eNIEL>samplingScale) ? samplingScale/eNIEL : 1.;
   if (verboseLevel>2)
     G4cout << " Downsample " << phononSamp << " primary phonons" << G4endl;
   
-  G4CMPConfigManager::SetGenPhonons(phononSamp);
+  phononSampling = phononSamp;
 }
 
 // Compute charge scaling factor only if not fully suppressed
@@ -415,19 +482,19 @@ void
 G4CMPEnergyPartition::ComputeChargeSampling(G4double eIon) {
   G4double samplingScale = G4CMPConfigManager::GetSamplingEnergy();
   if (samplingScale <= 0.) return;		// No downsampling computation
-  if (G4CMPConfigManager::GetGenCharges() <= 0.) return;
+  if (chargeSampling <= 0.) return;
   
   G4double chargeSamp = (eIon>samplingScale)? samplingScale/eIon : 1.;
   if (verboseLevel>2)
     G4cout << " Downsample " << chargeSamp << " primary charges" << G4endl;
   
-  G4CMPConfigManager::SetGenCharges(chargeSamp);
+  chargeSampling = chargeSamp;
 }
 
 // Compute Luke scaling factor only if not fully suppressed
 
 void G4CMPEnergyPartition::ComputeLukeSampling(G4double eIon) {
-  if (!lukeDownsampling) return;		// User preset a fixed fraction
+  if (lukeSampling >= 0.) return;		// User preset a fixed fraction
 
   // Scales to user-desired "maximum" (approximate) number of Luke phonons
   G4int maxCount = G4CMPConfigManager::GetMaxLukePhonons();
@@ -449,7 +516,7 @@ void G4CMPEnergyPartition::ComputeLukeSampling(G4double eIon) {
 		     / theLattice->GetPairProductionEnergy() );
   G4double nluke = npair * (voltage+1.) * 500;	// <E> ~ 2 meV 
 
-  G4double lukeSamp = std::min(maxCount/nluke, 1.);
+  G4double lukeSamp = (nluke > 0.) ? std::min(maxCount/nluke, 1.) : 1.;
   
   if (verboseLevel>2) {
     G4cout << " bias " << voltage << " V"
@@ -458,7 +525,7 @@ void G4CMPEnergyPartition::ComputeLukeSampling(G4double eIon) {
 	   << "\n Downsample " << lukeSamp << " Luke-phonon emission" << G4endl;
   }
 
-  G4CMPConfigManager::SetLukeSampling(lukeSamp);
+  lukeSampling = lukeSamp;
 }
 
 
@@ -480,7 +547,7 @@ void G4CMPEnergyPartition::GenerateCharges(G4double energy) {
   }
 
   // Only apply downsampling to sufficiently large statistics
-  G4double scale = G4CMPConfigManager::GetGenCharges();
+  G4double scale = chargeSampling;
   if (scale>0. && (G4int)nPairsTrue <= nParticlesMinimum) scale = 1.;
 
   if (verboseLevel>1) {
@@ -489,20 +556,35 @@ void G4CMPEnergyPartition::GenerateCharges(G4double energy) {
   }
 
   // Compute number of pairs to generate, adjust sampling scale to match
-  nPairsGen = std::round(scale*nPairsTrue);
-  scale = nPairsTrue>0 ? double(nPairsGen)/nPairsTrue : 1.;
+  size_t nPairs = std::round(scale*nPairsTrue);
+  scale = nPairsTrue>0 ? double(nPairs)/nPairsTrue : 1.;
+  chargeSampling = scale;			// Actual sampling, for tracks
+
+  G4double nPairsWeighted = nPairs>0 ? nPairs/scale : 0.;
 
-  G4double nPairsWeighted = nPairsGen>0 ? nPairsGen/scale : 0.;
+  // Macro-carrier tracks each represent a bundle of pairs
+  size_t nMacro = std::max(G4CMPConfigManager::GetMacroCharges(), 1);
+  nPairsGen = (nPairs + nMacro-1) / nMacro;
 
   // Create requested number of charge pairs with scaling factor
   if (nPairsGen > 0) {
-    particles.reserve(particles.size() + nPairsGen);
-
-    // Generate number of requested charge pairs, each with same energy
-    for (size_t i=0; i<nPairsGen; i++) AddChargePair(ePair, 1./scale);
+    size_t first = particles.size();
+    particles.resize(first + 2*nPairsGen);
+
+    // Generate number of requested charge pairs, each with same energy;
+    // pairs are spread evenly across bundles, weighted by multiplicity
+    FillInTasks(nPairsGen, [&](size_t begin, size_t end) {
+	for (size_t i=begin; i<end; i++) {
+	  G4int mult = nPairs/nPairsGen + (i < nPairs%nPairsGen ? 1 : 0);
+	  FillChargePair(first+2*i, ePair, mult/scale, mult);
+	}
+      });
     
-    if (verboseLevel>2)
-      G4cout << " generated " << nPairsGen << " e-h pairs" << G4endl;
+    if (verboseLevel>2) {
+      G4cout << " generated " << nPairs << " e-h pairs";
+      if (nPairsGen != nPairs) G4cout << " in " << nPairsGen << " bundles";
+      G4cout << G4endl;
+    }
     
     chargeEnergyLeft = energy - ePair*nPairsWeighted;
     if (chargeEnergyLeft < 0.) chargeEnergyLeft = 0.;	// Avoid round-offs
@@ -518,7 +600,7 @@ void G4CMPEnergyPartition::GenerateCharges(G4double energy) {
     summary->chargeFano = nPairsTrue*theLattice->GetPairProductionEnergy();
     summary->chargeGenerated = ePair*nPairsWeighted;
     summary->truePairs = nPairsTrue;
-    summary->numberOfPairs = nPairsGen;
+    summary->numberOfPairs = nPairs;
     summary->samplingCharges = scale;		// Store actual sampling used
     summary->lukeEnergyEst = nPairsWeighted * abs(biasVoltage);
   }
@@ -531,14 +613,15 @@ void G4CMPEnergyPartition::GenerateCharges(G4double energy) {
   }
 }
 
-void G4CMPEnergyPartition::AddChargePair(G4double ePair, G4double wt) {
+void G4CMPEnergyPartition::FillChargePair(size_t index, G4double ePair,
+					  G4double wt, G4int mult) {
   G4double eFree = ePair - theLattice->GetBandGapEnergy(); // TODO: Is this right?
 
-  particles.push_back(Data(G4CMPDriftElectron::Definition(),G4RandomDirection(),
-			   (1.-holeFraction)*eFree, wt));
+  particles[index] = Data(G4CMPDriftElectron::Definition(),G4RandomDirection(),
+			  (1.-holeFraction)*eFree, wt, mult);
 
-  particles.push_back(Data(G4CMPDriftHole::Definition(), G4RandomDirection(),
-			   holeFraction*eFree, wt));
+  particles[index+1] = Data(G4CMPDriftHole::Definition(), G4RandomDirection(),
+			    holeFraction*eFree, wt, mult);
 }
 
 void G4CMPEnergyPartition::GeneratePhonons(G4double energy) {
@@ -556,7 +639,7 @@ void G4CMPEnergyPartition::GeneratePhonons(G4double energy) {
   ePhon = energy / nPhononsTrue;		// Split energy evenly to all
 
   // Only apply downsampling to sufficiently large statistics
-  G4double scale = G4CMPConfigManager::GetGenPhonons();
+  G4double scale = phononSampling;
 
   if (scale>0. && (G4int)nPhononsTrue <= nParticlesMinimum) scale = 1.;
 
@@ -568,13 +651,17 @@ void G4CMPEnergyPartition::GeneratePhonons(G4double energy) {
   // Compute number of phonons to generate, adjust sampling scale to match
   nPhononsGen = std::round(scale*nPhononsTrue);
   scale = nPhononsTrue>0 ? double(nPhononsGen)/nPhononsTrue : 1.;
+  phononSampling = scale;			// Actual sampling, for tracks
 
   // Create requested number of phonons with scaling factor
   if (nPhononsGen > 0) {
-    particles.reserve(particles.size() + nPhononsGen);
+    size_t first = particles.size();
+    particles.resize(first + nPhononsGen);
 
     // Generate number of requested charge pairs, each with same energy
-    for (size_t i=0; i<nPhononsGen; i++) AddPhonon(ePhon, 1./scale);
+    FillInTasks(nPhononsGen, [&](size_t begin, size_t end) {
+	for (size_t i=begin; i<end; i++) FillPhonon(first+i, ePhon, 1./scale);
+      });
     
     if (verboseLevel>2)
       G4cout << " generated " << nPhononsGen << " phonons" << G4endl;
@@ -590,11 +677,164 @@ void G4CMPEnergyPartition::GeneratePhonons(G4double energy) {
   }
 }
 
-void G4CMPEnergyPartition::AddPhonon(G4double ePhon, G4double wt) {
+void G4CMPEnergyPartition::FillPhonon(size_t index, G4double ePhon,
+				      G4double wt) {
   G4ParticleDefinition* pd =
     G4PhononPolarization::Get(ChoosePhononPolarization());
 
-  particles.push_back(Data(pd, G4RandomDirection(), ePhon, wt));
+  particles[index] = Data(pd, G4RandomDirection(), ePhon, wt);
+}
+
+
+// Split generation of large particle lists into blocks of fixed size.  Each
+// block gets an engine seeded from the event's random stream, so results
+// do not depend on the task size, nor on how many threads run the tasks.
+
+void G4CMPEnergyPartition::
+FillInTasks(size_t n, const std::function<void(size_t,size_t)>& fill) const {
+  if (n <= streamSize) {			// Small lists done in place
+    fill(0, n);
+    return;
+  }
+
+  size_t nStreams = (n + streamSize-1) / streamSize;
+
+  std::vector<long> seeds(nStreams);
+  for (auto& seed: seeds)
+    seed = CLHEP::RandFlat::shootInt(std::numeric_limits<long>::max());
+
+  // Random engine is thread-local; swap in each block's engine while filling
+  auto fillStreams = [&](size_t first, size_t last) {
+    CLHEP::HepRandomEngine* threadEngine = G4Random::getTheEngine();
+    for (size_t i=first; i<last; i++) {
+      CLHEP::MixMaxRng engine(seeds[i]);
+      G4Random::setTheEngine(&engine);
+      fill(i*streamSize, std::min(n, (i+1)*streamSize));
+      G4Random::setTheEngine(threadEngine);
+    }
+  };
+
+  // Task size is rounded up to whole random streams
+  size_t taskSize = std::max(G4CMPConfigManager::GetPartitionTaskSize(), 0);
+  size_t perTask = (taskSize + streamSize-1) / streamSize;
+
+  G4int nThreads = G4CMPConfigManager::GetPartitionThreads();
+  if (nThreads <= 0) nThreads = G4Threading::G4GetNumberOfCores();
+
+  if (perTask == 0 || perTask >= nStreams || nThreads == 1) {
+    fillStreams(0, nStreams);			// Same streams, in order
+    return;
+  }
+
+  size_t nTasks = (nStreams + perTask-1) / perTask;
+  if (verboseLevel>1) {
+    G4cout << " FillInTasks " << n << " entries in " << nTasks << " tasks"
+	   << " on " << nThreads << " threads" << G4endl;
+  }
+
+#ifdef G4MULTITHREADED
+  G4TaskGroup<void> blocks(GetPartitionPool(nThreads));
+  for (size_t i=0; i<nTasks; i++) {
+    blocks.exec(fillStreams, i*perTask, std::min(nStreams, (i+1)*perTask));
+  }
+  blocks.wait();
+#else
+  fillStreams(0, nStreams);
+#endif
+}
+
+
+// Generate charge cloud around center, with one point per charge pair
+
+void G4CMPEnergyPartition::
+GenerateCloud(const G4VTouchable* touch, const G4ThreeVector& center) const {
+  cloud->SetVerboseLevel(verboseLevel);
+  cloud->SetTouchable(touch);
+  cloud->Prepare(nPairsGen, center);
+
+  FillInTasks(nPairsGen, [&](size_t begin, size_t end) {
+      cloud->GeneratePoints(begin, end);
+    });
+}
+
+
+// Compute positions and kinematics for secondaries in tasks, leaving only
+// allocation of tracks (thread-local G4Allocator) to the calling thread.
+// Charge pairs are first in the particle list, electron then hole.
+
+void G4CMPEnergyPartition::
+FillKinematics(const G4VTouchable* touch, const G4ThreeVector& center) const {
+  G4bool doCloud = G4CMPConfigManager::CreateChargeCloud();	// Convenience
+  if (doCloud) GenerateCloud(touch, center);
+
+  kinematics.resize(particles.size());
+
+  FillInTasks(particles.size(), [&](size_t begin, size_t end) {
+      for (size_t i=begin; i<end; i++) {
+	G4bool qcloud = doCloud && G4CMP::IsChargeCarrier(particles[i].pd);
+	FillKinematics(i, touch, qcloud ? cloud->GetPosition(i/2) : center);
+      }
+    });
+}
+
+void G4CMPEnergyPartition::
+FillKinematics(size_t index, const G4VTouchable* touch,
+	       const G4ThreeVector& pos) const {
+  const Data& p = particles[index];
+  Kinematics& k = kinematics[index];
+
+  k.pos = pos;
+  k.vdir = p.dir;
+  k.vel = 0.;
+  k.mass = 0.;
+  k.valley = -1;
+
+  // Wavevector must be local when passed to lattice
+  G4ThreeVector ldir = G4CMP::GetLocalDirection(touch, p.dir);
+
+  if (G4CMP::IsPhonon(p.pd)) {
+    G4int mode = G4PhononPolarization::Get(p.pd);
+    k.vdir = theLattice->MapKtoVDir(mode, ldir);
+    G4CMP::RotateToGlobalDirection(touch, k.vdir);
+    k.vel = theLattice->MapKtoV(mode, ldir);
+  } else if (G4CMP::IsElectron(p.pd)) {
+    k.valley = G4CMP::FindNearestValley(theLattice, ldir);
+    G4ThreeVector plocal = theLattice->MapEkintoP(k.valley, ldir, p.ekin);
+    k.mass = theLattice->GetElectronEffectiveMass(k.valley, plocal);
+  } else {
+    k.mass = theLattice->GetHoleMass();
+  }
+}
+
+
+// Create track with precomputed kinematics, as G4CMP::CreateSecondary() does;
+// charges get partition's Luke sampling and multiplicity
+
+G4Track* G4CMPEnergyPartition::CreateTrack(size_t index, G4double time) const {
+  const Data& p = particles[index];
+  const Kinematics& k = kinematics[index];
+
+  G4Track* sec = 0;
+  if (G4CMP::IsPhonon(p.pd)) {
+    sec = new G4Track(new G4DynamicParticle(p.pd, k.vdir, p.ekin), time, k.pos);
+    G4CMP::AttachTrackInfo(sec, new G4CMPPhononTrackInfo(theLattice, p.dir));
+
+    sec->SetVelocity(k.vel);
+    sec->UseGivenVelocity(true);
+  } else {
+    // NOTE:  G4CMP uses true mass units: convert MeV/c^2 to MeV for Geant4
+    sec = new G4Track(new G4DynamicParticle(p.pd, p.dir, p.ekin,
+					    k.mass*c_squared), time, k.pos);
+
+    auto trackInfo = new G4CMPDriftTrackInfo(theLattice, k.valley);
+    trackInfo->SetLukeSampling(lukeSampling);
+    trackInfo->SetMultiplicity(p.mult);
+    G4CMP::AttachTrackInfo(sec, trackInfo);
+  }
+
+  sec->SetGoodForTrackingFlag(true);	// Protect against production cuts
+
+  return sec;
 }
 
 
@@ -641,6 +881,8 @@ GetPrimaries(std::vector<G4PrimaryParticle*>& primaries) const {
     thePrim->SetMomentumDirection(p.dir);
     thePrim->SetKineticEnergy(p.ekin);
     thePrim->SetWeight(p.wt);
+    if (G4CMP::IsChargeCarrier(p.pd))
+      thePrim->SetUserInformation(new G4CMPPrimaryInfo(lukeSampling, p.mult));
     primaries.push_back(thePrim);
 
     if (verboseLevel==3) {
@@ -680,19 +922,15 @@ GetPrimaries(G4Event* event, const G4ThreeVector& pos, G4double time,
 
   // Generate charge carriers in region around track position
   G4bool doCloud = G4CMPConfigManager::CreateChargeCloud();	// Convenience
-  if (doCloud) {
-    cloud->SetVerboseLevel(verboseLevel);
-    cloud->SetTouchable(touch);
-    cloud->Generate(nPairsGen, newpos);
-  }
+  if (doCloud) GenerateCloud(touch, newpos);
 
   // Buffer for active vertices, for use with charge cloud
-  std::map<G4int, G4PrimaryVertex*> activeVtx;
+  std::map<G4long, G4PrimaryVertex*> activeVtx;
 
   G4int ichg = 0;		// Counter to track charge cloud entries
   for (size_t i=0; i<primaries.size(); i++) {
     G4bool qcloud = doCloud && !G4CMP::IsPhonon(primaries[i]->GetG4code());
-    G4int chgbin = qcloud ? cloud->GetPositionBin(ichg++) : -1;
+    G4long chgbin = qcloud ? cloud->GetPositionBin(ichg++/2) : -1;
 
     G4PrimaryVertex*& vertex = activeVtx[chgbin];	// Ref for convenience
 
@@ -806,31 +1044,24 @@ GetSecondaries(std::vector<G4Track*>& secondaries, G4double trkWeight) const {
   secondaries.clear();
   secondaries.reserve(particles.size());
 
-  // Generate charge carriers in region around track position
-  G4bool doCloud = G4CMPConfigManager::CreateChargeCloud();	// Convenience
-  if (doCloud) {
-    cloud->SetVerboseLevel(verboseLevel);
-    cloud->SetTouchable(GetCurrentTouchable());
-    cloud->Generate(nPairsGen, GetCurrentTrack()->GetPosition());
-  }
+  // Positions (including charge cloud) and kinematics are done in tasks
+  const G4VTouchable* touch = GetCurrentTouchable();
+  FillKinematics(touch, G4CMP::ApplySurfaceClearance(touch,
+				      GetCurrentTrack()->GetPosition()));
 
   if (verboseLevel>1) G4cout << " processing " << particles.size() << G4endl;
 
+  G4double time = GetCurrentTrack()->GetGlobalTime();
   G4Track* theSec = 0;
-  G4int ichg = 0;			// Index to deal with charge cloud
 
   for (size_t i=0; i<particles.size(); i++) {
     const Data& p = particles[i];	// For convenience below
 
     // Set weights so that generated particles map back to expected true number
-    theSec = G4CMP::CreateSecondary(*GetCurrentTrack(), p.pd, p.dir, p.ekin);
+    theSec = CreateTrack(i, time);
     theSec->SetWeight(trkWeight*p.wt);
     secondaries.push_back(theSec);
 
-    // Adjust positions of charges according to generated distribution
-    if (doCloud && G4CMP::IsChargeCarrier(theSec))
-      theSec->SetPosition(cloud->GetPosition(ichg++));
-
     if (verboseLevel==3) {
       G4cout << i << " : " << p.pd->GetParticleName() << " " << p.ekin/eV
 	     << " eV along " << p.dir << " (wt " << p.wt << ")"
@@ -33,6 +33,7 @@
 //		method of each process separately.
 // 20240703 I. Ataee -- Cleaning up the code and using MapPtoV_el instea of redoing
 //		what it does in the EvaluateRhsGivenB method.
+// 20261019  Use valley inverse mass tensor in local frame from lattice
 
 #include "G4CMPEqEMField.hh"
 #include "G4CMPConfigManager.hh"
@@ -149,40 +150,9 @@ void G4CMPEqEMField::EvaluateRhsGivenB(const G4double y[],
 	   << force.mag()/(volt/cm) << G4endl;
 #endif
 
-  theLattice->RotateToLattice(force);
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>2)
-    G4cout << " Field (lat)     " << force/(volt/cm) << " "
-	   << force.mag()/(volt/cm) << G4endl;
-#endif
-
-  // Rotate force into and out of valley frame, applying Herring-Vogt transform
-  const G4RotationMatrix& nToV = theLattice->GetValley(valleyIndex);
-  const G4RotationMatrix& vToN = theLattice->GetValleyInv(valleyIndex);
-
-  force.transform(nToV);			// Rotate to valley
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>2)
-    G4cout << " Field (val)     " << force/(volt/cm) << " "
-	   << force.mag()/(volt/cm) << G4endl;
-#endif
-
-  force *= theLattice->GetMInvTensor();
+  // Apply inverse mass tensor for valley, combined with lattice orientation
+  force *= theLattice->GetValleyMInvTensor(valleyIndex);
   force *= theLattice->GetElectronMass();
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>2)
-    G4cout << " m0M^-1*E     " << force/(volt/cm) << " "
-	   << force.mag()/(volt/cm) << G4endl;
-#endif
-
-  force.transform(vToN);			// Back to lattice
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>2)
-    G4cout << " m0M^-1*E (lat) " << force/(volt/cm) << " "
-	   << force.mag()/(volt/cm) << G4endl;
-#endif
-
-  theLattice->RotateToSolid(force);		// Back to crystal frame
 #ifdef G4CMP_DEBUG
   if (verboseLevel>2)
     G4cout << " m0M^-1*E (loc) " << force/(volt/cm) << " "
@@ -22,6 +22,8 @@
 // 20210901  Add local verbosity flag for reporting diagnostics, pass through
 //		to G4CMPLocalEMField.
 // 20211010  "stepperLength" is suppsed to be in units of time, not distance?
+// 20261019  Select stepper by name (G4CMPConfigManager::GetFieldStepper());
+//		apply DeltaOneStep and epsilon per volume on volume change.
 
 #include "G4CMPFieldManager.hh"
 #include "G4CMPConfigManager.hh"
@@ -31,8 +33,10 @@
 #include "G4CMPLocalElectroMagField.hh"
 #include "G4CMPDriftTrackInfo.hh"
 #include "G4CMPTrackUtils.hh"
+#include "G4CMPUniformFieldStepper.hh"
 #include "G4ChordFinder.hh"
 #include "G4ClassicalRK4.hh"
+#include "G4DormandPrince745.hh"
 #include "G4ElectroMagneticField.hh"
 #include "G4LatticeManager.hh"
 #include "G4LatticePhysical.hh"
@@ -42,6 +46,7 @@
 #include "G4ParticleDefinition.hh"
 #include "G4PhysicalConstants.hh"
 #include "G4RotationMatrix.hh"
+#include "G4SimpleRunge.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4ThreeVector.hh"
 #include "G4Track.hh"
@@ -57,7 +62,8 @@ G4CMPFieldManager::G4CMPFieldManager(G4ElectroMagneticField *detectorField,
   : G4FieldManager(new G4CMPLocalElectroMagField(detectorField)),
     verboseLevel(vb==0?G4CMPConfigManager::GetVerboseLevel():vb),
     myDetectorField(0), stepperVars(8), stepperLength(1*um),
-    latticeNulls(0), maxLatticeNulls(3) {
+    latticeNulls(0), maxLatticeNulls(3),
+    stepperType(G4CMPConfigManager::GetFieldStepper()) {
   if (verboseLevel)
     G4cout << "G4CMPFieldManager wrapped global field in LocalEMField." << G4endl;
 
@@ -74,7 +80,8 @@ G4CMPFieldManager::G4CMPFieldManager(G4CMPLocalElectroMagField *detectorField,
   : G4FieldManager(detectorField),
     verboseLevel(vb==0?G4CMPConfigManager::GetVerboseLevel():vb),
     myDetectorField(detectorField), stepperVars(8), stepperLength(1*um),
-    latticeNulls(0), maxLatticeNulls(3) {
+    latticeNulls(0), maxLatticeNulls(3),
+    stepperType(G4CMPConfigManager::GetFieldStepper()) {
   if (verboseLevel)
     G4cout << "G4CMPFieldManager provided with wrapped LocalEMField." << G4endl;
 
@@ -83,9 +90,7 @@ G4CMPFieldManager::G4CMPFieldManager(G4CMPLocalElectroMagField *detectorField,
 }
 
 G4CMPFieldManager::~G4CMPFieldManager() {
-  delete theEqMotion;       theEqMotion=0;
-  delete theStepper;        theStepper=0;
-  delete theChordFinder;    theChordFinder=0;
+  DeleteTransport();
 }
 
 
@@ -93,7 +98,7 @@ G4CMPFieldManager::~G4CMPFieldManager() {
 
 void G4CMPFieldManager::CreateTransport() {
   theEqMotion    = new G4CMPEqEMField(myDetectorField);
-  theStepper     = new G4ClassicalRK4(theEqMotion, stepperVars);
+  theStepper     = CreateStepper();
   theDriver      = new G4MagInt_Driver(stepperLength, theStepper, stepperVars);
   theChordFinder = new G4ChordFinder(theDriver);
   SetChordFinder(theChordFinder);
@@ -102,9 +107,47 @@ void G4CMPFieldManager::CreateTransport() {
   theDriver->SetVerboseLevel(verboseLevel);
   theChordFinder->SetVerbose(verboseLevel);
 
-  SetMinimumEpsilonStep(1e-6);
-  SetMaximumEpsilonStep(1e-6);
-  SetDeltaOneStep(10*nm);
+  SetMinimumEpsilonStep(G4CMPConfigManager::GetFieldEpsilon());
+  SetMaximumEpsilonStep(G4CMPConfigManager::GetFieldEpsilon());
+  SetDeltaOneStep(G4CMPConfigManager::GetFieldDeltaOneStep());
+}
+
+void G4CMPFieldManager::DeleteTransport() {
+  delete theEqMotion;       theEqMotion=0;
+  delete theStepper;        theStepper=0;
+  delete theChordFinder;    theChordFinder=0;
+}
+
+G4MagIntegratorStepper* G4CMPFieldManager::CreateStepper() const {
+  if (verboseLevel)
+    G4cout << "G4CMPFieldManager using " << stepperType << " stepper" << G4endl;
+
+  if (stepperType == "DormandPrince745")
+    return new G4DormandPrince745(theEqMotion, stepperVars);
+
+  if (stepperType == "Midpoint")
+    return new G4SimpleRunge(theEqMotion, stepperVars);
+
+  if (stepperType == "UniformField")
+    return new G4CMPUniformFieldStepper(theEqMotion, stepperVars);
+
+  if (stepperType != "ClassicalRK4") {
+    G4Exception("G4CMPFieldManager::CreateStepper", "FieldMan004",
+		JustWarning, ("Unknown stepper "+stepperType+
+			      ", using ClassicalRK4").c_str());
+  }
+
+  return new G4ClassicalRK4(theEqMotion, stepperVars);
+}
+
+// Replace integrator, rebuilding equation, driver and chord finder
+
+void G4CMPFieldManager::SetStepperType(const G4String& name) {
+  if (name == stepperType) return;
+
+  stepperType = name;
+  DeleteTransport();
+  CreateTransport();
 }
 
 
@@ -185,6 +228,8 @@ void G4CMPFieldManager::ConfigureForTrack(const G4Track* aTrack) {
 				 GetLogicalVolume()->GetSolid());
     myDetectorField->SetTransforms(localToGlobal);
     theEqMotion->SetTransforms(localToGlobal);
+
+    ApplyAccuracy(aTrack->GetVolume());
   }
 
   G4int iv = -1;
@@ -197,6 +242,32 @@ void G4CMPFieldManager::ConfigureForTrack(const G4Track* aTrack) {
   }
 }
 
+// Set DeltaOneStep and epsilon from configuration for volume
+
+void G4CMPFieldManager::ApplyAccuracy(const G4VPhysicalVolume* volume) {
+  // Logical volume name is used if physical volume isn't configured
+  G4double delta, epsilon;
+  if (!G4CMPConfigManager::GetFieldAccuracy(volume->GetName(), delta, epsilon)) {
+    G4CMPConfigManager::GetFieldAccuracy(volume->GetLogicalVolume()->GetName(),
+					 delta, epsilon);
+  }
+
+  if (verboseLevel > 1) {
+    G4cout << " volume " << volume->GetName() << " DeltaOneStep "
+	   << delta/nm << " nm epsilon " << epsilon << G4endl;
+  }
+
+  // Keep minimum below maximum as values are changed
+  if (epsilon > GetMaximumEpsilonStep()) {
+    SetMaximumEpsilonStep(epsilon);
+    SetMinimumEpsilonStep(epsilon);
+  } else {
+    SetMinimumEpsilonStep(epsilon);
+    SetMaximumEpsilonStep(epsilon);
+  }
+  SetDeltaOneStep(delta);
+}
+
 void G4CMPFieldManager::SetChargeValleyForTrack(const G4LatticePhysical* lat,
                                                 G4int valley) {
   if (valley < -1 || valley > static_cast<G4int>(lat->NumberOfValleys() - 1)) {
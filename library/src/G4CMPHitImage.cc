@@ -0,0 +1,390 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPHitImage.cc
+/// \brief Implementation of the G4CMPHitImage class, which histograms the
+///   final positions of G4CMPElectrodeHits on a face.
+//
+// $Id$
+//
+// 20261019  New class for in-memory images of electrode hits
+// 20261019  Read() rejects files with invalid or duplicate modes, or slices
+
+#include "G4CMPHitImage.hh"
+#include "G4CMPHitWriter.hh"
+#include "G4SystemOfUnits.hh"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+
+namespace {
+  template <class T> void writeValue(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <class T> G4bool readValue(std::istream& in, T& value) {
+    return (G4bool)in.read(reinterpret_cast<char*>(&value), sizeof(T));
+  }
+
+  void writeVector(std::ostream& out, const G4ThreeVector& v,
+		   G4double unit) {
+    writeValue<double>(out, v.x()/unit);
+    writeValue<double>(out, v.y()/unit);
+    writeValue<double>(out, v.z()/unit);
+  }
+
+  G4bool readVector(std::istream& in, G4ThreeVector& v, G4double unit) {
+    double x=0., y=0., z=0.;
+    G4bool good = readValue(in, x) && readValue(in, y) && readValue(in, z);
+    v.set(x*unit, y*unit, z*unit);
+    return good;
+  }
+
+  void writeEdges(std::ostream& out, const std::vector<G4double>& edges,
+		  G4double unit) {
+    writeValue<uint32_t>(out, edges.size());
+    for (G4double edge: edges) writeValue<double>(out, edge/unit);
+  }
+
+  G4bool readEdges(std::istream& in, std::vector<G4double>& edges,
+		   G4double unit) {
+    uint32_t n = 0;
+    if (!readValue(in, n) || n > (1U<<20)) return false;
+
+    edges.resize(n);
+    for (G4double& edge: edges) {
+      double value = 0.;
+      if (!readValue(in, value)) return false;
+      edge = value*unit;
+    }
+    return true;
+  }
+}
+
+const char G4CMPHitImage::kMagic[8] = { 'G','4','C','M','P','I','M','G' };
+const uint32_t G4CMPHitImage::kVersion;
+
+
+// Constructor
+
+G4CMPHitImage::G4CMPHitImage()
+  : origin(0.,0.,0.), uAxis(1.,0.,0.), vAxis(0.,1.,0.), nu(100), nv(100),
+    umin(-5.*mm), umax(5.*mm), vmin(-5.*mm), vmax(5.*mm), uScale(0.),
+    vScale(0.), weighting(kCount), nEntries(0), nOutside(0) {
+  SetModes({ G4CMPHitWriter::kPhononL, G4CMPHitWriter::kPhononTS,
+	     G4CMPHitWriter::kPhononTF });
+}
+
+
+// Configuration
+
+void G4CMPHitImage::SetFace(const G4ThreeVector& o, const G4ThreeVector& u,
+			    const G4ThreeVector& v) {
+  origin = o;
+  uAxis = u.unit();
+  vAxis = v.unit();
+  Reset();
+}
+
+void G4CMPHitImage::SetBinning(size_t nBinsU, G4double uLow, G4double uHigh,
+			       size_t nBinsV, G4double vLow, G4double vHigh) {
+  if (nBinsU == 0 || nBinsV == 0 || uHigh <= uLow || vHigh <= vLow) {
+    G4Exception("G4CMPHitImage::SetBinning", "HitImage001",
+		FatalErrorInArgument, "Image must have bins and positive size");
+    return;
+  }
+
+  nu = nBinsU; umin = uLow; umax = uHigh;
+  nv = nBinsV; vmin = vLow; vmax = vHigh;
+  Resize();
+}
+
+void G4CMPHitImage::SetModes(const std::vector<G4int>& types) {
+  modes.clear();
+  modeIndex.assign(G4CMPHitWriter::kNumParticleTypes, -1);
+
+  for (G4int type: types) {
+    if (type < 0 || type >= G4CMPHitWriter::kNumParticleTypes) continue;
+    if (modeIndex[type] >= 0) continue;		// Ignore duplicates
+
+    modeIndex[type] = modes.size();
+    modes.push_back(type);
+  }
+
+  Resize();
+}
+
+void G4CMPHitImage::SetTimeSlices(const std::vector<G4double>& edges) {
+  if (edges.size() == 1 || !std::is_sorted(edges.begin(), edges.end())) {
+    G4Exception("G4CMPHitImage::SetTimeSlices", "HitImage002",
+		FatalErrorInArgument, "Need at least two increasing edges");
+    return;
+  }
+
+  timeEdges = edges;
+  Resize();
+}
+
+void G4CMPHitImage::SetEnergySlices(const std::vector<G4double>& edges) {
+  if (edges.size() == 1 || !std::is_sorted(edges.begin(), edges.end())) {
+    G4Exception("G4CMPHitImage::SetEnergySlices", "HitImage002",
+		FatalErrorInArgument, "Need at least two increasing edges");
+    return;
+  }
+
+  energyEdges = edges;
+  Resize();
+}
+
+void G4CMPHitImage::SetWeighting(Weighting value) {
+  weighting = value;
+  Reset();
+}
+
+size_t G4CMPHitImage::GetNTimeSlices() const {
+  return timeEdges.empty() ? 1 : timeEdges.size()-1;
+}
+
+size_t G4CMPHitImage::GetNEnergySlices() const {
+  return energyEdges.empty() ? 1 : energyEdges.size()-1;
+}
+
+
+// Allocate contents for current configuration
+
+void G4CMPHitImage::Resize() {
+  uScale = nu/(umax-umin);
+  vScale = nv/(vmax-vmin);
+
+  contents.clear();
+  contents.resize(modes.size()*GetNTimeSlices()*GetNEnergySlices()*nu*nv,
+		  0.);
+  nEntries = nOutside = 0;
+}
+
+void G4CMPHitImage::Reset() {
+  if (contents.empty()) Resize();
+  else std::fill(contents.begin(), contents.end(), 0.);
+
+  nEntries = nOutside = 0;
+}
+
+
+// Accumulate hits
+
+void G4CMPHitImage::Fill(const G4CMPElectrodeHitsCollection* hits) {
+  if (!hits) return;
+
+  for (const G4CMPElectrodeHit* hit: *hits->GetVector()) Fill(hit);
+}
+
+void G4CMPHitImage::Fill(const G4CMPElectrodeHit* hit) {
+  if (!hit) return;
+
+  Fill(G4CMPHitWriter::GetParticleType(hit->GetParticleName()),
+       hit->GetFinalPosition(), hit->GetFinalTime(), hit->GetEnergyDeposit(),
+       hit->GetWeight());
+}
+
+void G4CMPHitImage::Fill(G4int type, const G4ThreeVector& pos, G4double time,
+			 G4double energy, G4double weight) {
+  if (type < 0 || type >= (G4int)modeIndex.size() || modeIndex[type] < 0)
+    return;					// Mode not imaged
+
+  nEntries++;
+
+  G4int tSlice = FindSlice(timeEdges, time);
+  G4int eSlice = FindSlice(energyEdges, energy);
+
+  const G4ThreeVector local = pos - origin;
+  G4double u = (local.dot(uAxis) - umin) * uScale;
+  G4double v = (local.dot(vAxis) - vmin) * vScale;
+
+  if (tSlice < 0 || eSlice < 0 ||
+      !(u >= 0. && u < nu && v >= 0. && v < nv)) {
+    nOutside++;
+    return;
+  }
+
+  size_t index = ((modeIndex[type]*GetNTimeSlices() + tSlice)
+		  * GetNEnergySlices() + eSlice) * nv;
+  index = (index + size_t(v)) * nu + size_t(u);
+
+  contents[index] += (weighting == kEnergy) ? weight*energy/eV : weight;
+}
+
+G4int G4CMPHitImage::FindSlice(const std::vector<G4double>& edges,
+			       G4double value) {
+  if (edges.empty()) return 0;
+  if (value < edges.front() || value >= edges.back()) return -1;
+
+  return std::upper_bound(edges.begin(), edges.end(), value)-edges.begin()-1;
+}
+
+
+// Combine images from different threads or jobs
+
+G4bool G4CMPHitImage::SameConfiguration(const G4CMPHitImage& other) const {
+  return (origin == other.origin && uAxis == other.uAxis &&
+	  vAxis == other.vAxis && nu == other.nu && nv == other.nv &&
+	  umin == other.umin && umax == other.umax && vmin == other.vmin &&
+	  vmax == other.vmax && modes == other.modes &&
+	  timeEdges == other.timeEdges && energyEdges == other.energyEdges &&
+	  weighting == other.weighting);
+}
+
+G4bool G4CMPHitImage::Merge(const G4CMPHitImage& other) {
+  if (!SameConfiguration(other)) {
+    G4Exception("G4CMPHitImage::Merge", "HitImage003", JustWarning,
+		"Images have different configurations; not merged");
+    return false;
+  }
+
+  for (size_t i=0; i<contents.size(); i++) contents[i] += other.contents[i];
+  nEntries += other.nEntries;
+  nOutside += other.nOutside;
+
+  return true;
+}
+
+
+// Access contents
+
+const G4double* G4CMPHitImage::GetImage(size_t mode, size_t tSlice,
+					size_t eSlice) const {
+  if (mode >= modes.size() || tSlice >= GetNTimeSlices() ||
+      eSlice >= GetNEnergySlices()) return 0;
+
+  return &contents[((mode*GetNTimeSlices() + tSlice) * GetNEnergySlices()
+		    + eSlice) * nv*nu];
+}
+
+
+// Binary file output, with configuration in header
+
+G4bool G4CMPHitImage::Write(const G4String& fileName) const {
+  std::ofstream output(fileName, std::ios::binary|std::ios::trunc);
+  if (!output.good()) {
+    G4ExceptionDescription msg;
+    msg << "Error opening output file " << fileName;
+    G4Exception("G4CMPHitImage::Write", "HitImage004", JustWarning, msg);
+    return false;
+  }
+
+  output.write(kMagic, sizeof(kMagic));
+  writeValue<uint32_t>(output, kVersion);
+  writeValue<uint32_t>(output, weighting);
+
+  writeValue<uint32_t>(output, modes.size());
+  for (G4int type: modes) writeValue<uint8_t>(output, type);
+
+  writeVector(output, origin, mm);
+  writeVector(output, uAxis, 1.);
+  writeVector(output, vAxis, 1.);
+
+  writeValue<uint32_t>(output, nu);
+  writeValue<double>(output, umin/mm);
+  writeValue<double>(output, umax/mm);
+  writeValue<uint32_t>(output, nv);
+  writeValue<double>(output, vmin/mm);
+  writeValue<double>(output, vmax/mm);
+
+  writeEdges(output, timeEdges, ns);
+  writeEdges(output, energyEdges, eV);
+
+  writeValue<uint64_t>(output, nEntries);
+  writeValue<uint64_t>(output, nOutside);
+
+  output.write(reinterpret_cast<const char*>(contents.data()),
+	       contents.size()*sizeof(double));
+
+  if (!output.good()) {
+    G4ExceptionDescription msg;
+    msg << "Error writing to output file " << fileName;
+    G4Exception("G4CMPHitImage::Write", "HitImage005", JustWarning, msg);
+    return false;
+  }
+
+  return true;
+}
+
+G4bool G4CMPHitImage::Read(const G4String& fileName) {
+  std::ifstream input(fileName, std::ios::binary);
+
+  char magic[sizeof(kMagic)];
+  uint32_t version=0, weight=0, nModes=0, nBinsU=0, nBinsV=0;
+  input.read(magic, sizeof(magic));
+  G4bool good = (input.good() && memcmp(magic, kMagic, sizeof(magic)) == 0 &&
+		 readValue(input, version) && version == kVersion &&
+		 readValue(input, weight) && readValue(input, nModes) &&
+		 nModes <= G4CMPHitWriter::kNumParticleTypes);
+
+  std::vector<G4int> types;
+  for (uint32_t i=0; good && i<nModes; i++) {
+    uint8_t type = 0;
+    good = readValue(input, type);
+    types.push_back(type);
+  }
+
+  G4ThreeVector o, u, v;
+  double uLow=0., uHigh=0., vLow=0., vHigh=0.;
+  std::vector<G4double> tEdges, eEdges;
+  uint64_t entries=0, outside=0;
+  good = (good && readVector(input, o, mm) && readVector(input, u, 1.) &&
+	  readVector(input, v, 1.) && readValue(input, nBinsU) &&
+	  readValue(input, uLow) && readValue(input, uHigh) &&
+	  readValue(input, nBinsV) && readValue(input, vLow) &&
+	  readValue(input, vHigh) && readEdges(input, tEdges, ns) &&
+	  readEdges(input, eEdges, eV) && readValue(input, entries) &&
+	  readValue(input, outside));
+
+  if (!good || nBinsU == 0 || nBinsV == 0) {
+    G4ExceptionDescription msg;
+    msg << fileName << " is not a version " << kVersion << " G4CMP image file";
+    G4Exception("G4CMPHitImage::Read", "HitImage006", JustWarning, msg);
+    return false;
+  }
+
+  // Configuration must be accepted as is, or contents would be misplaced
+  std::vector<G4bool> used(G4CMPHitWriter::kNumParticleTypes, false);
+  for (G4int type: types) {
+    if (type >= G4CMPHitWriter::kNumParticleTypes || used[type]) good = false;
+    else used[type] = true;
+  }
+
+  good &= (weight == kCount || weight == kEnergy);
+  good &= (tEdges.size() != 1 && std::is_sorted(tEdges.begin(), tEdges.end()));
+  good &= (eEdges.size() != 1 && std::is_sorted(eEdges.begin(), eEdges.end()));
+
+  if (!good) {
+    G4ExceptionDescription msg;
+    msg << fileName << " has invalid or duplicate modes, weighting or slices";
+    G4Exception("G4CMPHitImage::Read", "HitImage008", JustWarning, msg);
+    return false;
+  }
+
+  origin = o; uAxis = u; vAxis = v;
+  nu = nBinsU; umin = uLow*mm; umax = uHigh*mm;
+  nv = nBinsV; vmin = vLow*mm; vmax = vHigh*mm;
+  weighting = Weighting(weight);
+  timeEdges = tEdges;
+  energyEdges = eEdges;
+  SetModes(types);				// Calls Resize()
+
+  input.read(reinterpret_cast<char*>(contents.data()),
+	     contents.size()*sizeof(double));
+  if (!input.good()) {
+    G4ExceptionDescription msg;
+    msg << fileName << " is truncated";
+    G4Exception("G4CMPHitImage::Read", "HitImage007", JustWarning, msg);
+    Reset();
+    return false;
+  }
+
+  nEntries = entries;
+  nOutside = outside;
+  return true;
+}
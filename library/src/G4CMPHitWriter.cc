@@ -0,0 +1,292 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPHitWriter.cc
+/// \brief Implementation of the G4CMPHitWriter class, which writes
+///   collections of G4CMPElectrodeHit to a compact binary file.
+//
+// $Id$
+//
+// 20261019  New class for binary columnar output of electrode hits
+// 20261019  Separate block encoding from file output, for G4CMPOutputService
+
+#include "G4CMPHitWriter.hh"
+#include "G4AutoLock.hh"
+#include "G4SystemOfUnits.hh"
+#include <cstring>
+
+
+namespace {
+  G4Mutex writeMutex = G4MUTEX_INITIALIZER;	// Serializes file access
+
+  const char* particleNames[G4CMPHitWriter::kNumParticleTypes] = {
+    "unknown", "phononL", "phononTS", "phononTF",
+    "G4CMPDriftElectron", "G4CMPDriftHole"
+  };
+
+  // Type codes for each column in file header; must match EncodeBlock()
+  const char columnTypes[] = "iib" "rrrrr" "rrrrrr";
+}
+
+const char G4CMPHitWriter::kMagic[8] = { 'G','4','C','M','P','H','I','T' };
+const uint32_t G4CMPHitWriter::kVersion;
+const uint32_t G4CMPHitWriter::kBlockMarker;
+
+
+// Constructor and destructor
+
+G4CMPHitWriter::G4CMPHitWriter(const G4String& fn, size_t rows)
+  : blockRows(rows>0 ? rows : 1), doublePrecision(false), currentRun(-1) {
+  if (!fn.empty()) Open(fn);
+}
+
+G4CMPHitWriter::~G4CMPHitWriter() {
+  Close();
+}
+
+
+// Open file for appending; header is written to new or empty files
+
+G4bool G4CMPHitWriter::Open(const G4String& fn) {
+  if (output.is_open()) Close();
+  fileName = fn;
+
+  G4AutoLock l(&writeMutex);
+
+  // Existing file must have compatible header
+  std::ifstream existing(fileName, std::ios::binary|std::ios::ate);
+  G4bool needHeader = !existing.good() || existing.tellg() <= 0;
+
+  if (!needHeader) {
+    char magic[8];
+    uint32_t version=0, realSize=0;
+    existing.seekg(0);
+    existing.read(magic, sizeof(magic));
+    existing.read((char*)&version, sizeof(version));
+    existing.read((char*)&realSize, sizeof(realSize));
+
+    if (!existing.good() || memcmp(magic, kMagic, sizeof(magic)) != 0 ||
+	version != kVersion || (realSize != 4 && realSize != 8)) {
+      G4ExceptionDescription msg;
+      msg << fileName << " is not a version " << kVersion << " G4CMP hit file";
+      G4Exception("G4CMPHitWriter::Open", "HitWriter001", JustWarning, msg);
+      return false;
+    }
+
+    doublePrecision = (realSize == 8);	// Match existing contents
+  }
+  existing.close();
+
+  output.open(fileName, std::ios::binary|std::ios::app);
+  if (!output.good()) {
+    G4ExceptionDescription msg;
+    msg << "Error opening output file " << fileName;
+    G4Exception("G4CMPHitWriter::Open", "HitWriter002", JustWarning, msg);
+    output.close();
+    return false;
+  }
+
+  if (needHeader) WriteHeader();
+
+  return output.good();
+}
+
+void G4CMPHitWriter::Close() {
+  if (!output.is_open()) return;
+
+  Flush();
+  output.close();
+}
+
+
+// Buffer hits for output; block is written when buffer fills
+
+void G4CMPHitWriter::Write(G4int runID, G4int evtID,
+			   const G4CMPElectrodeHitsCollection* hits) {
+  if (!hits) return;
+
+  const std::vector<G4CMPElectrodeHit*>* hitVec = hits->GetVector();
+  for (const G4CMPElectrodeHit* hit: *hitVec) Write(runID, evtID, hit);
+}
+
+void G4CMPHitWriter::Write(G4int runID, G4int evtID,
+			   const G4CMPElectrodeHit* hit) {
+  if (!hit) return;
+
+  if (runID != currentRun) {		// Run ID is stored per block
+    Flush();
+    currentRun = runID;
+  }
+
+  eventID.push_back(evtID);
+  trackID.push_back(hit->GetTrackID());
+  particle.push_back(GetParticleType(hit->GetParticleName()));
+
+  startE.push_back(hit->GetStartEnergy()/eV);
+  startX.push_back(hit->GetStartPosition().x()/m);
+  startY.push_back(hit->GetStartPosition().y()/m);
+  startZ.push_back(hit->GetStartPosition().z()/m);
+  startT.push_back(hit->GetStartTime()/ns);
+  eDep.push_back(hit->GetEnergyDeposit()/eV);
+  weight.push_back(hit->GetWeight());
+  finalX.push_back(hit->GetFinalPosition().x()/m);
+  finalY.push_back(hit->GetFinalPosition().y()/m);
+  finalZ.push_back(hit->GetFinalPosition().z()/m);
+  finalT.push_back(hit->GetFinalTime()/ns);
+
+  if (eventID.size() >= blockRows) Flush();
+}
+
+
+// Write any buffered hits as a (partial) block
+
+void G4CMPHitWriter::Flush() {
+  if (eventID.empty()) return;
+
+  EncodeBlock();		// Done outside of lock, in local buffer
+  ClearColumns();
+  WriteBlock(blockBuffer);
+}
+
+
+// Write a block already encoded by this or another writer
+
+void G4CMPHitWriter::WriteEncodedBlock(const std::vector<char>& block) {
+  if (block.empty() || !output.is_open()) return;
+
+  G4AutoLock l(&writeMutex);
+  output.write(block.data(), block.size());
+  output.flush();
+
+  if (!output.good()) {
+    G4Exception("G4CMPHitWriter::WriteEncodedBlock", "HitWriter003",
+		JustWarning, ("Error writing to "+fileName).c_str());
+  }
+}
+
+
+// Convert between particle names and stored enum
+
+G4CMPHitWriter::ParticleType
+G4CMPHitWriter::GetParticleType(const G4String& name) {
+  for (G4int i=1; i<kNumParticleTypes; i++) {
+    if (name == particleNames[i]) return ParticleType(i);
+  }
+
+  return kUnknown;
+}
+
+const char* G4CMPHitWriter::GetParticleName(G4int type) {
+  return ((type>=0 && type<kNumParticleTypes) ? particleNames[type]
+	  : particleNames[kUnknown]);
+}
+
+
+// Column names, with units, in storage order
+
+const std::vector<G4String>& G4CMPHitWriter::GetColumnNames() {
+  static const std::vector<G4String> names = {
+    "Event ID", "Track ID", "Particle Name", "Start Energy [eV]",
+    "Start X [m]", "Start Y [m]", "Start Z [m]", "Start Time [ns]",
+    "Energy Deposited [eV]", "Track Weight", "End X [m]", "End Y [m]",
+    "End Z [m]", "Final Time [ns]"
+  };
+
+  return names;
+}
+
+
+// Files ending in ".bin" are written with this class by the examples
+
+G4bool G4CMPHitWriter::IsBinaryFile(const G4String& fn) {
+  const G4String ext = ".bin";
+  return (fn.length() > ext.length() &&
+	  fn.compare(fn.length()-ext.length(), ext.length(), ext) == 0);
+}
+
+
+// Write file header (called with mutex locked)
+
+void G4CMPHitWriter::WriteHeader() {
+  blockBuffer.clear();
+
+  blockBuffer.insert(blockBuffer.end(), kMagic, kMagic+sizeof(kMagic));
+  AppendBytes<uint32_t>(kVersion);
+  AppendBytes<uint32_t>(doublePrecision ? 8 : 4);
+
+  AppendBytes<uint32_t>(kNumParticleTypes);
+  for (const char* name: particleNames) {
+    uint16_t len = strlen(name);
+    AppendBytes(len);
+    blockBuffer.insert(blockBuffer.end(), name, name+len);
+  }
+
+  const std::vector<G4String>& names = GetColumnNames();
+  AppendBytes<uint32_t>(names.size());
+  for (size_t i=0; i<names.size(); i++) {
+    AppendBytes<uint8_t>(columnTypes[i]);
+    AppendBytes<uint16_t>(names[i].length());
+    blockBuffer.insert(blockBuffer.end(), names[i].begin(), names[i].end());
+  }
+
+  output.write(blockBuffer.data(), blockBuffer.size());
+  output.flush();
+}
+
+
+// Fill blockBuffer from column buffers; order must match GetColumnNames()
+
+void G4CMPHitWriter::EncodeBlock() {
+  blockBuffer.clear();
+
+  AppendBytes<uint32_t>(kBlockMarker);
+  AppendBytes<int32_t>(currentRun);
+  AppendBytes<uint32_t>(eventID.size());
+
+  AppendColumn(eventID);
+  AppendColumn(trackID);
+  AppendColumn(particle);
+  AppendReals(startE);
+  AppendReals(startX);
+  AppendReals(startY);
+  AppendReals(startZ);
+  AppendReals(startT);
+  AppendReals(eDep);
+  AppendReals(weight);
+  AppendReals(finalX);
+  AppendReals(finalY);
+  AppendReals(finalZ);
+  AppendReals(finalT);
+}
+
+void G4CMPHitWriter::ClearColumns() {
+  eventID.clear(); trackID.clear(); particle.clear();
+  startE.clear(); startX.clear(); startY.clear(); startZ.clear();
+  startT.clear(); eDep.clear(); weight.clear();
+  finalX.clear(); finalY.clear(); finalZ.clear(); finalT.clear();
+}
+
+
+// Copy raw bytes into block buffer
+
+template <class T> void G4CMPHitWriter::AppendBytes(const T& value) {
+  const char* bytes = reinterpret_cast<const char*>(&value);
+  blockBuffer.insert(blockBuffer.end(), bytes, bytes+sizeof(T));
+}
+
+template <class T>
+void G4CMPHitWriter::AppendColumn(const std::vector<T>& column) {
+  const char* bytes = reinterpret_cast<const char*>(column.data());
+  blockBuffer.insert(blockBuffer.end(), bytes, bytes+column.size()*sizeof(T));
+}
+
+void G4CMPHitWriter::AppendReals(const std::vector<G4double>& column) {
+  if (doublePrecision) {
+    AppendColumn(column);
+  } else {
+    blockBuffer.reserve(blockBuffer.size() + column.size()*sizeof(float));
+    for (G4double value: column) AppendBytes<float>(value);
+  }
+}
@@ -13,9 +13,12 @@
 // 20210908  Use global track position to query field; configure field.
 // 20211003  Use encapsulated G4CMPFieldUtils to get field.
 // 20230829  Rotated E-field to local frame first and changed Mass Multiplication in HV transformation
+// 20261019  Use tabulated rate vs. field if enabled (G4CMP_RATE_TABLES)
 
 #include "G4CMPIVRateLinear.hh"
+#include "G4CMPConfigManager.hh"
 #include "G4CMPFieldUtils.hh"
+#include "G4LatticeLogical.hh"
 #include "G4LatticePhysical.hh"
 #include "G4LogicalVolume.hh"
 #include "G4RotationMatrix.hh"
@@ -47,22 +50,58 @@ G4double G4CMPIVRateLinear::Rate(const G4Track& aTrack) const {
   // NOTE:  Separate steps to avoid matrix-matrix multiplications
   fieldVector = theLattice->EllipsoidalToSphericalTranformation(GetValleyIndex(aTrack), fieldVector);
   // fieldVector *= sqrt(theLattice->GetElectronMass()/(electron_mass_c2/c_squared));
-  fieldVector /= volt/cm;			// Strip units for MFP below
   if (verboseLevel > 1) {
-    G4cout << " in HV space " << fieldVector << " ("
-	   << fieldVector.mag() << ") V/cm" << G4endl;
+    G4cout << " in HV space " << fieldVector/(volt/cm) << " ("
+	   << fieldVector.mag()/(volt/cm) << ") V/cm" << G4endl;
   }
 
-  // Compute mean free path -- NOTE FIELD UNITS ARE V/cm HERE
-  G4double rate = theLattice->GetIVLinRate0() +
-    theLattice->GetIVLinRate1() * pow(fieldVector.mag(),
-				      theLattice->GetIVLinExponent());
+  G4double fieldHV = fieldVector.mag();
+  G4double rate = ((rateTable && rateTable->InRange(fieldHV))
+		   ? rateTable->Value(fieldHV) : FieldRate(fieldHV));
 
   if (verboseLevel > 1) G4cout << "IV rate = " << rate/hertz << " Hz" << G4endl;
   return rate;
 }
 
 
+// Compute mean free path -- NOTE FIELD UNITS ARE V/cm HERE
+
+G4double G4CMPIVRateLinear::FieldRate(G4double fieldHV) const {
+  return ( theLattice->GetIVLinRate0() +
+	   theLattice->GetIVLinRate1() * pow(fieldHV/(volt/cm),
+					     theLattice->GetIVLinExponent()) );
+}
+
+
+// Fill table for new lattice, from zero up to 100 kV/cm
+
+void G4CMPIVRateLinear::LoadDataForTrack(const G4Track* track) {
+  G4CMPProcessUtils::LoadDataForTrack(track);
+  LoadDataForLattice();
+}
+
+void G4CMPIVRateLinear::LoadDataForLattice() {
+  rateTable = 0;
+  if (!theLattice || !G4CMPConfigManager::UseRateTables()) return;
+
+  auto table = rateTables.find(theLattice);
+  if (table == rateTables.end()) {
+    table = rateTables.emplace(theLattice, G4CMPRateTable()).first;
+    table->second.Fill([this](G4double f) { return FieldRate(f); },
+		       G4CMPRateTable::DecadeEdges(1e-2*volt/cm, 1e5*volt/cm));
+
+    if (verboseLevel) {
+      G4cout << "G4CMPIVRateLinear " << theLattice->GetLattice()->GetName()
+	     << " table " << table->second.GetNSegments() << " segments, "
+	     << table->second.GetNPoints() << " points, max error "
+	     << table->second.GetError() << G4endl;
+    }
+  }
+
+  rateTable = &table->second;
+}
+
+
 // Threshold is minimum energy of any scattering channel
 
 G4double G4CMPIVRateLinear::Threshold(G4double Eabove) const {
@@ -16,9 +16,12 @@
 // 20230829  Rotated E-field to local frame first and changed Mass
 //	       Multiplication in HV transformation
 // 20250515  Apply IV energy thresholds to reduce zero-voltage scatters
+// 20261019  Use tabulated rate vs. field if enabled (G4CMP_RATE_TABLES)
 
 #include "G4CMPIVRateQuadratic.hh"
+#include "G4CMPConfigManager.hh"
 #include "G4CMPFieldUtils.hh"
+#include "G4LatticeLogical.hh"
 #include "G4LatticePhysical.hh"
 #include "G4LogicalVolume.hh"
 #include "G4RotationMatrix.hh"
@@ -53,23 +56,60 @@ G4double G4CMPIVRateQuadratic::Rate(const G4Track& aTrack) const {
   // NOTE:  Separate steps to avoid matrix-matrix multiplications
   fieldVector = theLattice->EllipsoidalToSphericalTranformation(GetValleyIndex(aTrack), fieldVector);
   // fieldVector *= sqrt(theLattice->GetElectronMass()/(electron_mass_c2/c_squared));
-  fieldVector /= volt/m;			// Strip units for MFP below
-
   if (verboseLevel > 1) {
-    G4cout << " in HV space " << fieldVector*0.01 << " ("
-	   << fieldVector.mag()*0.01 << ") V/cm" << G4endl;
+    G4cout << " in HV space " << fieldVector/(volt/cm) << " ("
+	   << fieldVector.mag()/(volt/cm) << ") V/cm" << G4endl;
   }
 
-  // Compute mean free path; field vector units are V/m below
-  G4double E_0 = theLattice->GetIVQuadField() / (volt/m);
-  G4double rate = theLattice->GetIVQuadRate() *
-    pow((E_0*E_0 + fieldVector.mag2()), theLattice->GetIVQuadExponent()/2.0);
+  G4double fieldHV = fieldVector.mag();
+  G4double rate = ((rateTable && rateTable->InRange(fieldHV))
+		   ? rateTable->Value(fieldHV) : FieldRate(fieldHV));
 
   if (verboseLevel > 1) G4cout << "IV rate = " << rate/hertz << " Hz" << G4endl;
   return rate;
 }
 
 
+// Compute mean free path; field units are V/m below
+
+G4double G4CMPIVRateQuadratic::FieldRate(G4double fieldHV) const {
+  G4double E_0 = theLattice->GetIVQuadField() / (volt/m);
+  G4double E_HV = fieldHV / (volt/m);
+
+  return ( theLattice->GetIVQuadRate() *
+	   pow((E_0*E_0 + E_HV*E_HV), theLattice->GetIVQuadExponent()/2.0) );
+}
+
+
+// Fill table for new lattice, from zero up to 100 kV/cm
+
+void G4CMPIVRateQuadratic::LoadDataForTrack(const G4Track* track) {
+  G4CMPProcessUtils::LoadDataForTrack(track);
+  LoadDataForLattice();
+}
+
+void G4CMPIVRateQuadratic::LoadDataForLattice() {
+  rateTable = 0;
+  if (!theLattice || !G4CMPConfigManager::UseRateTables()) return;
+
+  auto table = rateTables.find(theLattice);
+  if (table == rateTables.end()) {
+    table = rateTables.emplace(theLattice, G4CMPRateTable()).first;
+    table->second.Fill([this](G4double f) { return FieldRate(f); },
+		       G4CMPRateTable::DecadeEdges(1e-2*volt/cm, 1e5*volt/cm));
+
+    if (verboseLevel) {
+      G4cout << "G4CMPIVRateQuadratic " << theLattice->GetLattice()->GetName()
+	     << " table " << table->second.GetNSegments() << " segments, "
+	     << table->second.GetNPoints() << " points, max error "
+	     << table->second.GetError() << G4endl;
+    }
+  }
+
+  rateTable = &table->second;
+}
+
+
 // Threshold is minimum energy of any scattering channel
 
 G4double G4CMPIVRateQuadratic::Threshold(G4double Eabove) const {
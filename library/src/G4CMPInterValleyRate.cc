@@ -12,8 +12,11 @@
 // 20170830  Follow Jacoboni, with unified D0/D1 expression and units; drop
 //		acoustic rate, as it is _intra_valley.
 // 20170919  Add interface for threshold identification
+// 20261019  Use tabulated rate vs. energy if enabled (G4CMP_RATE_TABLES)
 
 #include "G4CMPInterValleyRate.hh"
+#include "G4CMPConfigManager.hh"
+#include "G4LatticeLogical.hh"
 #include "G4LatticePhysical.hh"
 #include "G4LogicalVolume.hh"
 #include "G4PhysicalConstants.hh"
@@ -28,6 +31,12 @@
 
 void G4CMPInterValleyRate::LoadDataForTrack(const G4Track* track) {
   G4CMPProcessUtils::LoadDataForTrack(track);
+  LoadDataForLattice();
+}
+
+void G4CMPInterValleyRate::LoadDataForLattice() {
+  rateTable = 0;
+  if (!theLattice) return;
 
   // Should temperature be a lattice configuration?
   kT = k_Boltzmann * 0.015*kelvin;
@@ -41,6 +50,30 @@ void G4CMPInterValleyRate::LoadDataForTrack(const G4Track* track) {
 
   m_DOS = theLattice->GetElectronDOSMass();
   m_DOS3half = sqrt(m_DOS*m_DOS*m_DOS);
+
+  if (!G4CMPConfigManager::UseRateTables()) return;
+
+  // Fill table for new lattice, with segments at IV thresholds
+  auto table = rateTables.find(theLattice);
+  if (table == rateTables.end()) {
+    table = rateTables.emplace(theLattice, G4CMPRateTable()).first;
+
+    G4int vb = verboseLevel;		// Suppress diagnostics from fill
+    verboseLevel = 0;
+    table->second.Fill([this](G4double E) { return EnergyRate(E); },
+		       G4CMPRateTable::DecadeEdges(1e-4*eV, 1.*eV,
+						   theLattice->GetIVEnergy()));
+    verboseLevel = vb;
+
+    if (verboseLevel) {
+      G4cout << "G4CMPInterValleyRate " << theLattice->GetLattice()->GetName()
+	     << " table " << table->second.GetNSegments() << " segments, "
+	     << table->second.GetNPoints() << " points, max error "
+	     << table->second.GetError() << G4endl;
+    }
+  }
+
+  rateTable = &table->second;
 }
 
 
@@ -54,6 +87,13 @@ G4double G4CMPInterValleyRate::Rate(const G4Track& aTrack) const {
   if (verboseLevel>1)
     G4cout << "G4CMPInterValleyRate eTrk " << eTrk/eV << " eV" << G4endl;
 
+  if (rateTable && rateTable->InRange(eTrk)) {
+    G4double rate = rateTable->Value(eTrk);
+    if (verboseLevel>1) G4cout << "IV rate = " << rate/hertz << " Hz (table)"
+			       << G4endl;
+    return rate;
+  }
+
   G4double orate = opticalRate();
   if (verboseLevel>2) G4cout << "IV phonons  " << orate/hertz << " Hz" << G4endl;
  
@@ -66,6 +106,14 @@ G4double G4CMPInterValleyRate::Rate(const G4Track& aTrack) const {
 }
 
 
+// Analytic rate at specified energy, used to fill table
+
+G4double G4CMPInterValleyRate::EnergyRate(G4double energy) const {
+  eTrk = energy;
+  return opticalRate() + scatterRate();
+}
+
+
 // Compute components of overall intervalley rate
 
 G4double G4CMPInterValleyRate::acousticRate() const {
@@ -27,6 +27,8 @@
 // 20190906  Push selected rate model back to G4CMPTimeStepper for consistency
 // 20231122  Remove 50% momentum flip (see G4CMP-375)
 // 20240823  Allow ConfigManager IVRateModel setting to override config.txt
+// 20261019  Add G4CMPProfiler timing of PostStepDoIt().
+// 20261019  Accumulate macro-carrier diffusion width at each scatter.
 
 #include "G4CMPInterValleyScattering.hh"
 #include "G4CMPConfigManager.hh"
@@ -34,6 +36,7 @@
 #include "G4CMPInterValleyRate.hh"
 #include "G4CMPIVRateQuadratic.hh"
 #include "G4CMPIVRateLinear.hh"
+#include "G4CMPProfiler.hh"
 #include "G4CMPTimeStepper.hh"
 #include "G4CMPTrackUtils.hh"
 #include "G4CMPUtils.hh"
@@ -113,6 +116,7 @@ G4double G4CMPInterValleyScattering::GetMeanFreePath(const G4Track& track,
 G4VParticleChange* 
 G4CMPInterValleyScattering::PostStepDoIt(const G4Track& aTrack, 
 					 const G4Step& aStep) {
+  G4CMP_PROFILE_TIMER(profileDoIt);
   InitializeParticleChange(GetValleyIndex(aTrack), aTrack);
   G4StepPoint* postStepPoint = aStep.GetPostStepPoint();
   
@@ -135,7 +139,10 @@ G4CMPInterValleyScattering::PostStepDoIt(const G4Track& aTrack,
   
   // picking a new valley at random if IV-scattering process was triggered
   valley = ChangeValley(valley);
-  G4CMP::GetTrackInfo<G4CMPDriftTrackInfo>(aTrack)->SetValleyIndex(valley);
+
+  auto trackInfo = G4CMP::GetTrackInfo<G4CMPDriftTrackInfo>(aTrack);
+  trackInfo->SetValleyIndex(valley);
+  trackInfo->AddScattering(aTrack);		// Macro-carrier diffusion
 
   p = theLattice->RotateFromValley(valley, p);
   p = theLattice->MapKtoP(valley, p); // p is p again
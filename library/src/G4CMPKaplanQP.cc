@@ -68,10 +68,12 @@
 //		Add Fermi-Dirac occupation statistics for QP energy spectrum.
 // 20250101  G4CMP-439: Create separate debugging file per worker thread;
 //		add EventID and TrackID columns to debugging output.
+// 20261019  Add G4CMPProfiler timing of AbsorbPhonon().
 
 #include "globals.hh"
 #include "G4CMPKaplanQP.hh"
 #include "G4CMPConfigManager.hh"
+#include "G4CMPProfiler.hh"
 #include "G4CMPUtils.hh"
 #include "G4Event.hh"
 #include "G4EventManager.hh"
@@ -186,6 +188,7 @@ void G4CMPKaplanQP::SetFilmProperties(G4MaterialPropertiesTable* prop) {
 
 G4double G4CMPKaplanQP::
 AbsorbPhonon(G4double energy, std::vector<G4double>& reflectedEnergies) const {
+  G4CMP_PROFILE_SCOPE("G4CMPKaplanQP::AbsorbPhonon");
   // FIXME: Make the properties table optional, but check if all data filled
   if (!ParamsReady()) {
     G4Exception("G4CMPKaplanQP::AbsorbPhonon()", "G4CMP001",
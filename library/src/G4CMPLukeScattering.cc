@@ -46,6 +46,11 @@
 // 20250223  G4CMP-462 -- Restore use of G4CMP_DEBUG flag to hide changes to
 //		lattice verbosity, which causes a data race.
 // 20250508  G4CMP-480 -- Pass global phonon wavevector to CreatePhonon.
+// 20261019  Add G4CMPProfiler timing of PostStepDoIt().
+// 20261019  Sample phonon wavevector directly, without accept/reject loop
+//		or rotations; move debugging file output to separate function.
+// 20261019  Accumulate macro-carrier diffusion width at each emission.
+// 20261019  Use Luke sampling from track info, set by G4CMPEnergyPartition.
 
 #include "G4CMPLukeScattering.hh"
 #include "G4CMPConfigManager.hh"
@@ -53,6 +58,7 @@
 #include "G4CMPDriftHole.hh"
 #include "G4CMPDriftTrackInfo.hh"
 #include "G4CMPLukeEmissionRate.hh"
+#include "G4CMPProfiler.hh"
 #include "G4CMPSecondaryUtils.hh"
 #include "G4CMPTrackUtils.hh"
 #include "G4CMPUtils.hh"
@@ -92,6 +98,7 @@ G4CMPLukeScattering::~G4CMPLukeScattering() {
 
 G4VParticleChange* G4CMPLukeScattering::PostStepDoIt(const G4Track& aTrack,
                                                      const G4Step& aStep) {
+  G4CMP_PROFILE_TIMER(profileDoIt);
   // Is the initializer in the correct place or should it be after the
   // boundary check?
   InitializeParticleChange(GetValleyIndex(aTrack), aTrack);
@@ -108,26 +115,10 @@ G4VParticleChange* G4CMPLukeScattering::PostStepDoIt(const G4Track& aTrack,
     return G4VDiscreteProcess::PostStepDoIt(aTrack, aStep);
   }
 
-  if (verboseLevel && !output.is_open()) {
-    const G4String& debugfile = G4CMPConfigManager::GetLukeDebugFile();
-    output.open(G4CMP::DebuggingFileThread(debugfile));
-    if (!output.good()) {
-      G4Exception("G4LatticeReader::MakeLattice", "Lattice001",
-		  FatalException, ("Unable to open "+debugfile).c_str());
-    }
-
-    output << "Event ID,Track ID,Track Type,Track Weight,Track Energy [eV],Track Momentum [eV],WaveVector,"
-	   << "Phonon Theta,Phonon Energy [eV],Phonon Weight,Recoil WaveVector,"
-	   << "Final Energy [eV],Final Momentum [eV]"
-	   << std::endl;
-  }
-
-  // For convenience in diagnostic output below
-  const G4String& trkName = aTrack.GetDefinition()->GetParticleName();
-
   // Collect ancillary information needed for kinematics
   auto trackInfo = G4CMP::GetTrackInfo<G4CMPDriftTrackInfo>(aTrack);
   const G4LatticePhysical* lat = trackInfo->Lattice();
+  trackInfo->AddScattering(aTrack);		// Macro-carrier diffusion
 
   G4int iValley = GetValleyIndex(aTrack);	// Doesn't change valley
 
@@ -153,7 +144,6 @@ G4VParticleChange* G4CMPLukeScattering::PostStepDoIt(const G4Track& aTrack,
     return &aParticleChange;
   }
 
-  G4ThreeVector kdir = ktrk.unit();
   G4double kmag = ktrk.mag();
   G4double gammaSound = 1/sqrt(1.-lat->GetSoundSpeed()*lat->GetSoundSpeed()/c_squared);
   G4double kSound = gammaSound * lat->GetSoundSpeed() * mass / hbar_Planck;
@@ -188,150 +178,54 @@ G4VParticleChange* G4CMPLukeScattering::PostStepDoIt(const G4Track& aTrack,
 	   << G4endl;
   }
 
-  // Final state kinematics, generated in accept/reject loop below
-  G4double theta_phonon=0, phi_phonon=0, q=0, Ephonon=0, Erecoil=0, qmag=0;
-  G4ThreeVector qvec, k_recoil, precoil;	// Outgoing wave vectors
-  G4int newValley = iValley;			// Test for valley change
-
-  // Iterate to avoid non-physical phonon emission
-  const G4int maxThrows = 1000;		// Avoids potential infinite loop
-  G4bool goodThrow = false;
-  G4int iThrow = 0;
-  while (!goodThrow && iThrow++ < maxThrows) {
-    theta_phonon = MakePhononTheta(kmag, kSound);
-    phi_phonon   = G4UniformRand()*twopi;
-    q = 2*(kmag*cos(theta_phonon)-kSound);
-
-    if (verboseLevel > 1) {
-      G4cout << " theta_phonon = " << theta_phonon
-	     << " phi_phonon = " << phi_phonon << " q = " << q << G4endl;
-    }
-    
-    // Sanity check for phonon production: should be forward, like Cherenkov
-    if (theta_phonon>acos(kSound/kmag) || theta_phonon>halfpi) {
-      if (verboseLevel) {
-	G4cerr << GetProcessName() << " TRY AGAIN: theta_phonon "
-	       << theta_phonon << " exceeds cone angle " << acos(kSound/kmag)
-	       << G4endl;
-      }
-
-      continue;			// Try again
-    }
-    
-    // Generate phonon momentum vector
-    qvec = q*kdir;
-    qvec.rotate(kdir.orthogonal(), theta_phonon);
-    qvec.rotate(kdir, phi_phonon);
-    
-    if (verboseLevel > 1) {
-      G4cout << " qvec = " << qvec << G4endl
-	     << " ktrk.qvec = " << ktrk.dot(qvec)/(kmag*q)
-	     << " ktr-qvec angle " << acos(ktrk.dot(qvec)/(kmag*q))
-	     << G4endl;
-    }
-    
-    // Get recoil wavevector (in HV frame), convert to new local momentum
-    k_recoil = ktrk - qvec;
-    qmag = qvec.mag();
-    Ephonon = MakePhononEnergy(qmag);
-    // Make sure energy is conserved
-    Erecoil = Etrk - Ephonon;
-
-    if (IsHole()) {
-      precoil = k_recoil * hbarc;
-    } else {
-      // Rotating phonon wavevector out of valley frame into solid frame
-      qvec = lat->SphericalToEllipsoidalTranformation(iValley, qvec);
-      qvec = qmag * qvec.unit();
-      // First transform the recoil wavevector back to the ellipsoidal frame
-      precoil = lat->SphericalToEllipsoidalTranformation(iValley, k_recoil);
-      // Then transform the recoil wavevector to transport momentum
-      precoil = lat->MapKtoP(iValley, precoil);
-      // Energy should be conserved, so we use the precoil to get the direction
-      // of the movement, while the magnitude of the momentum is given by the
-      // Erecoil and direction of the movement and the valley.
-      precoil = lat->MapEkintoP(iValley, precoil, Erecoil);
-    }
-
-    if (verboseLevel > 1) {
-      G4cout << "p_recoil = " << precoil/eV << " " << precoil.mag()/eV << G4endl
-	     << "E_recoil = " << Erecoil/eV << " eV" << G4endl;
-    }
-    
-    if (verboseLevel > 1) {
-      G4cout << " E_phonon = " << Ephonon/eV << " eV" << G4endl;
-    }
-
-    // Sanity check for electrons: recoil energy must be smaller
-    if (IsElectron()) {
-      /***** Leave code in place for future tuning of IV scattering
-      // See if momentum should be kicked into new valley
-      newValley = FindNearestValley(precoil);
-
-      if (verboseLevel && iValley != newValley) {
-	G4double ErecNew = lat->MapPtoEkin(newValley, precoil);
-
-	G4cout << " MOVED valley " << iValley << " to " << newValley
-	       << " Erecoil : original " << Erecoil/eV << " new "
-	       << ErecNew/eV << " eV" << G4endl;
-
-	Erecoil = ErecNew;
-      }
-      *****/
-
-      G4double Efinal = Erecoil + Ephonon;
-      G4double DeltaE = Efinal - GetKineticEnergy(aTrack);
-
-      if (DeltaE > 1e-9) {
-	if (verboseLevel>1) {
-	  G4cerr << " ECONS: E(recoil+phonon) " << Efinal/eV << " eV"
-		 << " too large by " << DeltaE/eV << G4endl;
-	}
-      }
-
-      // If too little outgoing energy, rescale momentum to balance
-      if (DeltaE < -1e-9) {
-	if (verboseLevel>1) {
-	  G4cerr << " ECONS: E(recoil+phonon) " << Efinal/eV << " eV"
-		 << " too small by " << DeltaE/eV << G4endl;
-	}
-      }
-    }
-
-    goodThrow = true;		// Nothing failed, get out of loop
-  }	// while (goodThrow...)
+  // Final state kinematics, sampled directly (no accept/reject needed)
+  G4ThreeVector qvec = G4CMP::LukePhononWaveVector(ktrk, kSound);
+  G4double qmag = qvec.mag();
+  G4double theta_phonon = (verboseLevel ? qvec.angle(ktrk) : 0.);
+  G4double Ephonon = MakePhononEnergy(qmag);
+  G4double Erecoil = Etrk - Ephonon;		// Make sure energy is conserved
 
-  if (!goodThrow) {
-    G4cerr << GetProcessName() << " ERROR: Unable to generate phonon after "
-	   << iThrow << " attempts" << G4endl;
+  // Get recoil wavevector (in HV frame), convert to new local momentum
+  G4ThreeVector k_recoil = ktrk - qvec;
+  G4ThreeVector precoil;
+  G4int newValley = iValley;			// Doesn't change valley
 
-    return &aParticleChange;	// Unable to generate phonon
-  } else if (verboseLevel && iThrow>1) {
-    G4cout << GetProcessName() << " " << trkName << " phonon required "
-	   << iThrow << " attempts" << G4endl;
+  if (IsHole()) {
+    precoil = k_recoil * hbarc;
+  } else {
+    // Rotating phonon wavevector out of valley frame into solid frame
+    qvec = lat->SphericalToEllipsoidalTranformation(iValley, qvec);
+    qvec = qmag * qvec.unit();
+    // First transform the recoil wavevector back to the ellipsoidal frame
+    precoil = lat->SphericalToEllipsoidalTranformation(iValley, k_recoil);
+    // Then transform the recoil wavevector to transport momentum
+    precoil = lat->MapKtoP(iValley, precoil);
+    // Energy should be conserved, so we use the precoil to get the direction
+    // of the movement, while the magnitude of the momentum is given by the
+    // Erecoil and direction of the movement and the valley.
+    precoil = lat->MapEkintoP(iValley, precoil, Erecoil);
   }
 
   // Report phonon emission results
   if (verboseLevel > 1) {
-    G4cout << "q = " << q << " |qvec| " << qvec.mag() << G4endl
+    G4cout << " theta_phonon = " << theta_phonon << " q = " << qmag
+	   << G4endl
 	   << " Ephonon = " << Ephonon/eV << " eV" << G4endl
-           << " k_recoil(HV) = " << k_recoil << " " << k_recoil.mag()
-	   << " newValley = " << newValley
-           << G4endl;
-  }
+	   << " k_recoil(HV) = " << k_recoil << " " << k_recoil.mag()
+	   << " newValley = " << newValley << G4endl
+	   << " p_recoil = " << precoil/eV << " " << precoil.mag()/eV << G4endl
+	   << " E_recoil = " << Erecoil/eV << " eV" << G4endl;
 
-  if (output.good()) {
-    output << G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID() << ","
-	   << aTrack.GetTrackID() << "," << trkName << ","
-	   << aTrack.GetWeight() << "," << GetKineticEnergy(aTrack)/eV << ","
-	   << GetLocalMomentum(aTrack).mag()/eV << "," << kmag << ","
-	   << theta_phonon << "," << Ephonon/eV << ",";
+    if (IsElectron()) {
+      G4cout << " ECONS: E(recoil+phonon) - E(track) "
+	     << (Erecoil+Ephonon-GetKineticEnergy(aTrack))/eV << " eV"
+	     << G4endl;
+    }
   }
 
   // Create real phonon to be propagated, with random polarization
   // If phonon is not created, register the energy as deposited
-  G4double weight =
-    G4CMP::ChoosePhononWeight(G4CMPConfigManager::GetLukeSampling());
+  G4double weight = G4CMP::ChoosePhononWeight(trackInfo->LukeSampling());
   if (weight > 0.) {
     G4Track* phonon = G4CMP::CreatePhonon(aTrack,
                                           G4PhononPolarization::UNKNOWN,
@@ -361,11 +255,45 @@ G4VParticleChange* G4CMPLukeScattering::PostStepDoIt(const G4Track& aTrack,
   RotateToGlobalDirection(precoil);	// Update track in world coordinates
   FillParticleChange(newValley, Erecoil, precoil);
 
-  if (output.good()) {
-    output << aTrack.GetWeight()*weight << "," << k_recoil.mag() << ","
-	   << Erecoil/eV << "," << precoil.mag()/eV << std::endl;
+  if (verboseLevel) {
+    WriteDebugOutput(aTrack, kmag, theta_phonon, Ephonon,
+		     aTrack.GetWeight()*weight, k_recoil.mag(), Erecoil,
+		     precoil.mag());
   }
 
   ClearNumberOfInteractionLengthLeft();
   return &aParticleChange;
 }
+
+
+// Write kinematics of emission to debugging file, opening if necessary
+
+void G4CMPLukeScattering::WriteDebugOutput(const G4Track& aTrack,
+					   G4double kmag, G4double theta,
+					   G4double Ephonon, G4double phononWt,
+					   G4double kRecoil, G4double Erecoil,
+					   G4double pRecoil) {
+  if (!output.is_open()) {
+    const G4String& debugfile = G4CMPConfigManager::GetLukeDebugFile();
+    output.open(G4CMP::DebuggingFileThread(debugfile));
+    if (!output.good()) {
+      G4Exception("G4LatticeReader::MakeLattice", "Lattice001",
+		  FatalException, ("Unable to open "+debugfile).c_str());
+    }
+
+    output << "Event ID,Track ID,Track Type,Track Weight,Track Energy [eV],Track Momentum [eV],WaveVector,"
+	   << "Phonon Theta,Phonon Energy [eV],Phonon Weight,Recoil WaveVector,"
+	   << "Final Energy [eV],Final Momentum [eV]"
+	   << std::endl;
+  }
+
+  if (!output.good()) return;
+
+  output << G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID() << ","
+	 << aTrack.GetTrackID() << ","
+	 << aTrack.GetDefinition()->GetParticleName() << ","
+	 << aTrack.GetWeight() << "," << GetKineticEnergy(aTrack)/eV << ","
+	 << GetLocalMomentum(aTrack).mag()/eV << "," << kmag << ","
+	 << theta << "," << Ephonon/eV << "," << phononWt << ","
+	 << kRecoil << "," << Erecoil/eV << "," << pRecoil/eV << std::endl;
+}
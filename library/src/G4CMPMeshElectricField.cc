@@ -22,6 +22,11 @@
 // 20190919  BUG FIX:  2D project functions need 'break' in switch statements.
 // 20200519  Move local "static" buffers to class for thread safety.
 // 20210323  For 2D radial fields, need to manually protect rho < 0.
+// 20261019  Add GetExitTime() for step limits at tetrahedron boundaries.
+// 20261019  Use local position in Project2D(), Expand2Dat(), so that
+//	     GetPotential() can be called on a shared instance from threads.
+// 20261019  Cache verbose level at construction; G4CMPConfigManager must
+//	     not be used from non-Geant4 threads (e.g., FET digitizer).
 
 #include "G4CMPMeshElectricField.hh"
 #include "G4CMPBiLinearInterp.hh"
@@ -39,7 +44,8 @@ using std::vector;
 
 G4CMPMeshElectricField::
 G4CMPMeshElectricField(const G4String& EPotFileName, G4double Vscale)
-  : G4ElectricField(), Interp(0), xCoord(kUndefined), yCoord(kUndefined) {
+  : G4ElectricField(), Interp(0), xCoord(kUndefined), yCoord(kUndefined),
+    verboseLevel(G4CMPConfigManager::GetVerboseLevel()) {
   BuildInterp(EPotFileName, Vscale);
 }
 
@@ -50,7 +56,8 @@ G4CMPMeshElectricField(const vector<array<G4double,3> >& xyz,
 		       const vector<G4double>& v,
 		       const vector<array<G4int,4> >& tetra,
 		       EAxis xdim, EAxis ydim)
-  : G4ElectricField(), Interp(0), xCoord(xdim), yCoord(ydim) {
+  : G4ElectricField(), Interp(0), xCoord(xdim), yCoord(ydim),
+    verboseLevel(G4CMPConfigManager::GetVerboseLevel()) {
   if (xdim == kUndefined) {	// Assume true 3D Cartesian mesh
     BuildInterp(xyz, v, tetra);
   } else {			// Projected 2D mesh with specified coordinates
@@ -65,7 +72,8 @@ G4CMPMeshElectricField(const std::vector<std::array<G4double,2> >& xy,
 		       const std::vector<G4double>& v,
 		       const std::vector<std::array<G4int,3> >& tetra,
 		       EAxis xdim, EAxis ydim)
-  : G4ElectricField(), Interp(0), xCoord(xdim), yCoord(ydim) {
+  : G4ElectricField(), Interp(0), xCoord(xdim), yCoord(ydim),
+    verboseLevel(G4CMPConfigManager::GetVerboseLevel()) {
   BuildInterp(xy, v, tetra);
 }
 
@@ -73,22 +81,24 @@ G4CMPMeshElectricField(const std::vector<std::array<G4double,2> >& xy,
 
 G4CMPMeshElectricField::G4CMPMeshElectricField(const G4CMPTriLinearInterp& tli)
   : G4ElectricField(), Interp(tli.Clone()), xCoord(kUndefined),
-    yCoord(kUndefined) {;}
+    yCoord(kUndefined), verboseLevel(G4CMPConfigManager::GetVerboseLevel()) {;}
 
 G4CMPMeshElectricField::G4CMPMeshElectricField(const G4CMPBiLinearInterp& bli,
 					       EAxis xdim, EAxis ydim)
-  : G4ElectricField(), Interp(bli.Clone()), xCoord(xdim), yCoord(ydim) {;}
+  : G4ElectricField(), Interp(bli.Clone()), xCoord(xdim), yCoord(ydim),
+    verboseLevel(G4CMPConfigManager::GetVerboseLevel()) {;}
 
 G4CMPMeshElectricField::
 G4CMPMeshElectricField(const G4CMPVMeshInterpolator* mesh,
 		       EAxis xdim, EAxis ydim)
-  : G4ElectricField(), Interp(mesh->Clone()), xCoord(xdim), yCoord(ydim) {;}
+  : G4ElectricField(), Interp(mesh->Clone()), xCoord(xdim), yCoord(ydim),
+    verboseLevel(G4CMPConfigManager::GetVerboseLevel()) {;}
 
 // Copy constructor and assignment operator
 
 G4CMPMeshElectricField::G4CMPMeshElectricField(const G4CMPMeshElectricField &p)
   : G4ElectricField(p), Interp(p.Interp->Clone()), xCoord(p.xCoord),
-    yCoord(p.yCoord) {;}
+    yCoord(p.yCoord), verboseLevel(p.verboseLevel) {;}
 
 G4CMPMeshElectricField& 
 G4CMPMeshElectricField::operator=(const G4CMPMeshElectricField &p) {
@@ -99,6 +109,7 @@ G4CMPMeshElectricField::operator=(const G4CMPMeshElectricField &p) {
     Interp = p.Interp->Clone();
     xCoord = p.xCoord;
     yCoord = p.yCoord;
+    verboseLevel = p.verboseLevel;
   }
 
   return *this;
@@ -108,6 +119,13 @@ G4CMPMeshElectricField::~G4CMPMeshElectricField() {
   delete Interp;
 }
 
+// Diagnostic output level, passed through to interpolator
+
+void G4CMPMeshElectricField::SetVerboseLevel(G4int vb) {
+  verboseLevel = vb;
+  if (Interp) Interp->SetVerboseLevel(vb);
+}
+
 
 // Create 3D or 2D mesh interpolators from preconstructed mesh tables
 
@@ -132,7 +150,7 @@ BuildInterp(const std::vector<std::array<G4double,2> >& xy,
 
 void G4CMPMeshElectricField::BuildInterp(const G4String& EPotFileName,
                                         G4double VScale) {
-  if (G4CMPConfigManager::GetVerboseLevel() > 0) {
+  if (verboseLevel > 0) {
     G4cout << "G4CMPMeshElectricField::Constructor: Creating Electric Field " 
           << EPotFileName;
 
@@ -167,7 +185,7 @@ void G4CMPMeshElectricField::BuildInterp(const G4String& EPotFileName,
   }
   epotFile.close();
 
-  if (G4CMPConfigManager::GetVerboseLevel() > 1) {
+  if (verboseLevel > 1) {
     G4cout << " Voltage from " << vmin/volt << " to " << vmax/volt << " V"
           << G4endl;
   }
@@ -219,6 +237,14 @@ G4double G4CMPMeshElectricField::GetPotential(const G4double Point[3]) const {
   }
 }
 
+G4double G4CMPMeshElectricField::GetExitTime(const G4double Point[3],
+					     const G4ThreeVector& vel,
+					     const G4ThreeVector& acc) const {
+  // 2D meshes are projected; elements are not bounded in third dimension
+  return (xCoord == kUndefined ? Interp->GetExitTime(Point, vel, acc, true)
+	  : DBL_MAX);
+}
+
 
 // Convert between 3D and 2D coordinates for projected meshes
 
@@ -233,7 +259,7 @@ namespace {
 
 void G4CMPMeshElectricField::Project2D(const G4double Point[3],
 				       G4double Project[2]) const {
-  pos_.set(Point[0],Point[1],Point[2]);
+  const G4ThreeVector pos(Point[0],Point[1],Point[2]);
 
   Project[0] = Project[1] = 0.;
   
@@ -241,9 +267,9 @@ void G4CMPMeshElectricField::Project2D(const G4double Point[3],
   case kXAxis:    Project[0] = Point[0];  break;
   case kYAxis:    Project[0] = Point[1];  break;
   case kZAxis:    Project[0] = Point[2];  break;
-  case kRho:      Project[0] = pos_.rho(); break;
-  case kRadial3D: Project[0] = pos_.r();   break;
-  case kPhi:	  Project[0] = pos_.phi(); break;
+  case kRho:      Project[0] = pos.rho(); break;
+  case kRadial3D: Project[0] = pos.r();   break;
+  case kPhi:	  Project[0] = pos.phi(); break;
   default: ;
   }
   
@@ -251,14 +277,14 @@ void G4CMPMeshElectricField::Project2D(const G4double Point[3],
   case kXAxis:    Project[1] = Point[0];  break;
   case kYAxis:    Project[1] = Point[1];  break;
   case kZAxis:    Project[1] = Point[2];  break;
-  case kRho:      Project[1] = pos_.rho(); break;
-  case kRadial3D: Project[1] = pos_.r();   break;
-  case kPhi:	  Project[1] = pos_.phi(); break;
+  case kRho:      Project[1] = pos.rho(); break;
+  case kRadial3D: Project[1] = pos.r();   break;
+  case kPhi:	  Project[1] = pos.phi(); break;
   default: ;
   }
 
-  if (G4CMPConfigManager::GetVerboseLevel() > 2) {
-    G4cout << "Project2D Point " << pos_ << " onto axes " << AxisName(xCoord)
+  if (verboseLevel > 2) {
+    G4cout << "Project2D Point " << pos << " onto axes " << AxisName(xCoord)
 	   << " " << AxisName(yCoord) << " : (" << Project[0] << ","
 	   << Project[1] << ")" << G4endl;
   }
@@ -266,7 +292,7 @@ void G4CMPMeshElectricField::Project2D(const G4double Point[3],
 
 void G4CMPMeshElectricField::Expand2Dat(const G4double Point[3],
 					G4ThreeVector& Efield) const {
-  pos_.set(Point[0],Point[1],Point[2]);
+  const G4ThreeVector pos(Point[0],Point[1],Point[2]);
 
   G4double xval = Efield.x(), yval = Efield.y();
 
@@ -278,24 +304,24 @@ void G4CMPMeshElectricField::Expand2Dat(const G4double Point[3],
   // Radial field (e.g., spherical electrode) is easy
   // NOTE: CLHEP doesn't like R<0; flip angles manually to compensate
   if (xCoord == kRadial3D) {
-    Efield.setRThetaPhi(fabs(xval), xval<0?pi-pos_.theta():pos_.theta(),
-			pos_.phi()+(xval<0?pi:0.));
+    Efield.setRThetaPhi(fabs(xval), xval<0?pi-pos.theta():pos.theta(),
+			pos.phi()+(xval<0?pi:0.));
   }
 
   // Cylindrical field around Z axis is easy
   // NOTE: CLHEP doesn't like R<0; flip angle manually to compensate
   if (xCoord == kRho && yCoord == kZAxis) {
-    Efield.setRhoPhiZ(fabs(xval), pos_.phi()+(xval<0?pi:0.), yval);
+    Efield.setRhoPhiZ(fabs(xval), pos.phi()+(xval<0?pi:0.), yval);
   }
 
   // Cylindrical fields around other axes are more complicated
   if (xCoord == kRho && yCoord == kXAxis) {
-    G4double phiYZ = atan2(pos_.z(), pos_.y());
+    G4double phiYZ = atan2(pos.z(), pos.y());
     Efield.set(yval, xval*cos(phiYZ), xval*sin(phiYZ));
   }
   
   if (xCoord == kRho && yCoord == kYAxis) {
-    G4double phiZX = atan2(pos_.x(), pos_.z());
+    G4double phiZX = atan2(pos.x(), pos.z());
     Efield.set(xval*sin(phiZX), yval, xval*cos(phiZX));
   }
 }
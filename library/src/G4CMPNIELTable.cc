@@ -0,0 +1,161 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPNIELTable.cc
+/// \brief Implementation of the G4CMPNIELTable class, which tabulates
+///   a NIEL yield function for each material and recoiling species.
+//
+// $Id$
+//
+// 20261019  New class for tabulated NIEL yield functions
+
+#include "G4CMPNIELTable.hh"
+#include "G4CMPConfigManager.hh"
+#include "G4ExceptionSeverity.hh"
+#include "G4Material.hh"
+#include <algorithm>
+#include <cmath>
+
+
+// Constructor
+
+G4CMPNIELTable::G4CMPNIELTable(const G4VNIELPartition* niel, G4double emin,
+			       G4double emax, G4int nPoints)
+  : G4VNIELPartition(), model(niel), eMin(emin), eMax(emax),
+    logEmin(0.), logEmax(0.), nPerDecade(std::max(nPoints, 2)),
+    lastKey(nullptr, 0., 0.), lastTable(nullptr) {
+  if (!model || eMin <= 0. || eMax <= eMin) {
+    G4ExceptionDescription msg;
+    msg << "Invalid NIEL table: function " << model << " energy range "
+	<< eMin/eV << " to " << eMax/eV << " eV";
+    G4Exception("G4CMPNIELTable", "NIELTable001", FatalErrorInArgument, msg);
+    return;
+  }
+
+  logEmin = std::log(eMin);
+  logEmax = std::log(eMax);
+}
+
+
+// Interpolate in log(E), or use wrapped function outside of table
+
+G4double G4CMPNIELTable::
+PartitionNIEL(G4double energy, const G4Material* material, G4double Zin,
+	      G4double Ain) const {
+  if (!material || !InRange(energy))
+    return model->PartitionNIEL(energy, material, Zin, Ain);
+
+  const Table& table = GetTable(material, Zin, Ain);
+
+  G4double t = (std::log(energy) - logEmin) * table.invStep;
+  if (table.exact[std::min(size_t(t), table.exact.size()-1)])
+    return model->PartitionNIEL(energy, material, Zin, Ain);
+
+  return Interpolate(table, t);
+}
+
+
+// Fill table for material and species, if not already done
+
+G4double G4CMPNIELTable::Fill(const G4Material* material, G4double Zin,
+			      G4double Ain) const {
+  return material ? GetTable(material, Zin, Ain).maxError : 0.;
+}
+
+G4double G4CMPNIELTable::GetError(const G4Material* material, G4double Zin,
+				  G4double Ain) const {
+  auto table = tables.find(Key(material, Zin, Ain));
+  return (table == tables.end()) ? 0. : table->second.maxError;
+}
+
+G4int G4CMPNIELTable::GetNPoints(const G4Material* material, G4double Zin,
+				 G4double Ain) const {
+  auto table = tables.find(Key(material, Zin, Ain));
+  return (table == tables.end()) ? 0 : table->second.values.size();
+}
+
+
+// Look up table, filling new one with finer points until tolerance is met
+
+const G4CMPNIELTable::Table&
+G4CMPNIELTable::GetTable(const G4Material* material, G4double Zin,
+			 G4double Ain) const {
+  Key key(material, Zin, Ain);
+  if (lastTable && key == lastKey) return *lastTable;
+
+  auto table = tables.find(key);
+  if (table == tables.end()) {
+    table = tables.emplace(key, Table()).first;
+
+    const std::vector<char>& exact = table->second.exact;
+
+    G4double error = 0.;
+    G4int nExact = 0;
+    for (G4int n=nPerDecade; n<=16*nPerDecade; n*=2) {
+      FillValues(table->second, material, Zin, Ain, n);
+      error = CheckValues(table->second, material, Zin, Ain);
+      if (error <= GetTolerance()) break;
+
+      // Finer points don't help across a jump; stop if no improvement
+      G4int nLast = nExact;
+      nExact = std::count(exact.begin(), exact.end(), 1);
+      if (nLast > 0 && nExact >= nLast) break;
+    }
+
+    nExact = std::count(exact.begin(), exact.end(), 1);
+    if (G4CMPConfigManager::GetVerboseLevel()) {
+      G4cout << "G4CMPNIELTable " << material->GetName() << " Z " << Zin
+	     << " A " << Ain << ": " << table->second.values.size()
+	     << " points, max difference " << table->second.maxError;
+      if (nExact > 0) G4cout << "; " << nExact << " intervals not tabulated";
+      G4cout << G4endl;
+    }
+  }
+
+  lastKey = key;
+  lastTable = &table->second;
+
+  return table->second;
+}
+
+void G4CMPNIELTable::FillValues(Table& table, const G4Material* material,
+				G4double Zin, G4double Ain, G4int nPoints) const {
+  G4int n = std::ceil((logEmax-logEmin)/std::log(10.) * nPoints);
+  if (n < 1) n = 1;
+
+  G4double step = (logEmax-logEmin)/n;
+  table.invStep = 1./step;
+
+  table.values.resize(n+1);
+  for (G4int i=0; i<=n; i++) {
+    G4double energy = (i==n) ? eMax : std::exp(logEmin + i*step);
+    table.values[i] = model->PartitionNIEL(energy, material, Zin, Ain);
+  }
+
+  table.exact.assign(n, 0);
+  table.maxError = 0.;
+}
+
+// Compare midpoint of each interval, flag intervals outside tolerance;
+// return largest difference, including flagged intervals
+
+G4double G4CMPNIELTable::CheckValues(Table& table, const G4Material* material,
+				     G4double Zin, G4double Ain) const {
+  const G4int n = table.exact.size();
+  const G4double step = 1./table.invStep;
+
+  G4double error = 0.;
+  for (G4int j=0; j<n; j++) {
+    G4double energy = std::exp(logEmin + (j+0.5)*step);
+    G4double diff = std::abs(Interpolate(table, j+0.5) -
+			     model->PartitionNIEL(energy, material, Zin, Ain));
+
+    error = std::max(error, diff);
+    if (diff > GetTolerance()) table.exact[j] = 1;
+    else table.maxError = std::max(table.maxError, diff);
+  }
+
+  return error;
+}
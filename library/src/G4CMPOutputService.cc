@@ -0,0 +1,357 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPOutputService.cc
+/// \brief Implementation of the G4CMPOutputService class, which writes
+///   G4CMPElectrodeHit collections from all threads to a single binary
+///   file, using a dedicated writer thread.
+//
+// $Id$
+//
+// 20261019  New class for asynchronous multithreaded hit output
+// 20261019  Discard thread buffers after CloseAll(); bound output queue;
+//		count producers to complete ordered events
+// 20261019  Only owning thread flushes a buffer; Drain() waits for owners.
+
+#include "G4CMPOutputService.hh"
+#include "G4ApplicationState.hh"
+#include "G4AutoLock.hh"
+#include "G4StateManager.hh"
+#include "G4Threading.hh"
+#include "G4VStateDependent.hh"
+
+
+namespace {
+  G4Mutex registryMutex = G4MUTEX_INITIALIZER;
+
+  // Services by filename; closed at end of job
+  class G4CMPOutputRegistry : public std::map<G4String, G4CMPOutputService*> {
+  public:
+    ~G4CMPOutputRegistry() { G4CMPOutputService::CloseAll(); }
+  };
+
+  G4CMPOutputRegistry& theRegistry() {
+    static G4CMPOutputRegistry registry;
+    return registry;
+  }
+
+  // Each thread's buffers, so that Write() needs no locking.  Buffers
+  // are owned by the services, so entries are stale after CloseAll()
+  using BufferMap = std::map<G4CMPOutputService*, G4CMPHitWriter*>;
+
+  G4ThreadLocal BufferMap* threadBuffers = 0;
+  G4ThreadLocal unsigned threadBuffersClosed = 0;
+  std::atomic<unsigned> nCloseAll(0);
+
+  BufferMap* GetThreadBuffers(G4bool create) {
+    if (threadBuffers && threadBuffersClosed != nCloseAll) {
+      threadBuffers->clear();
+    }
+    threadBuffersClosed = nCloseAll;
+
+    if (!threadBuffers && create) threadBuffers = new BufferMap;
+    return threadBuffers;
+  }
+
+  // Flush this thread's buffers when it finishes a run; the master
+  // thread (or sequential job) also waits for all output to be written
+
+  class G4CMPOutputRunObserver : public G4VStateDependent {
+  public:
+    G4CMPOutputRunObserver() : G4VStateDependent() {;}
+
+    virtual G4bool Notify(G4ApplicationState requestedState) {
+      G4ApplicationState current =
+	G4StateManager::GetStateManager()->GetCurrentState();
+
+      if (current == G4State_GeomClosed && requestedState == G4State_Idle) {
+	BufferMap* buffers = GetThreadBuffers(false);
+	if (buffers) {
+	  for (auto& buf: *buffers) buf.first->FlushThreadBuffer();
+	}
+
+	if (!G4Threading::IsWorkerThread()) G4CMPOutputService::DrainAll();
+      }
+
+      return true;
+    }
+  };
+
+  G4ThreadLocal G4bool observerCreated = false;
+
+  void CreateRunObserver() {
+    if (observerCreated) return;
+    new G4CMPOutputRunObserver;		// G4StateManager takes ownership
+    observerCreated = true;
+  }
+}
+
+
+// Get service for specified file, creating and opening it if needed
+
+G4CMPOutputService* G4CMPOutputService::GetService(const G4String& fn) {
+  CreateRunObserver();
+
+  G4AutoLock l(&registryMutex);
+  G4CMPOutputService*& svc = theRegistry()[fn];
+  if (!svc) svc = new G4CMPOutputService(fn);
+
+  return svc;
+}
+
+void G4CMPOutputService::DrainAll() {
+  G4AutoLock l(&registryMutex);
+  for (auto& svc: theRegistry()) svc.second->Drain();
+}
+
+void G4CMPOutputService::CloseAll() {
+  G4AutoLock l(&registryMutex);
+  for (auto& svc: theRegistry()) delete svc.second;
+  theRegistry().clear();
+
+  // Other threads discard their entries when next used
+  nCloseAll++;
+  GetThreadBuffers(false);
+}
+
+
+// Constructor and destructor
+
+G4CMPOutputService::G4CMPOutputService(const G4String& fn)
+  : fileName(fn), eventOrdered(false), maxPending(100000),
+    maxQueuedBytes(64*1024*1024), queuedBytes(0), nActive(0),
+    flushPending(false), stopping(false), nextEvent(-1,0) {
+  if (!fileWriter.Open(fileName)) return;	// G4CMPHitWriter reports
+
+  writer = std::thread(&G4CMPOutputService::WriterLoop, this);
+}
+
+G4CMPOutputService::~G4CMPOutputService() {
+  Stop();
+
+  std::lock_guard<std::mutex> l(bufferMutex);
+  for (ThreadBuffer* buf: buffers) delete buf;
+  buffers.clear();
+
+  fileWriter.Close();
+}
+
+
+// Add hits from current thread; in ordered mode, this completes event
+
+void G4CMPOutputService::Write(G4int runID, G4int eventID,
+			       const G4CMPElectrodeHitsCollection* hits) {
+  if (!IsOpen()) return;
+
+  ThreadBuffer* buf = GetThreadBuffer();
+  if (!buf->active) {			// Drain() must wait for this thread
+    buf->active = true;
+    std::lock_guard<std::mutex> l(queueMutex);
+    nActive++;
+  }
+
+  buf->SetEvent(runID, eventID);
+  buf->Write(runID, eventID, hits);
+
+  if (eventOrdered) {			// Hand off whole event, even if empty
+    buf->Flush();
+    Enqueue(runID, eventID, buf->GetProducers(), std::vector<char>());
+  }
+}
+
+
+// Register or remove a caller of Write() on the current thread
+
+void G4CMPOutputService::AddProducer() {
+  if (IsOpen()) GetThreadBuffer()->AddProducers(1);
+}
+
+void G4CMPOutputService::RemoveProducer() {
+  if (IsOpen()) GetThreadBuffer()->AddProducers(-1);
+}
+
+
+// Flush current thread's buffer; only the owning thread may do this
+
+void G4CMPOutputService::FlushThreadBuffer() {
+  BufferMap* bufs = GetThreadBuffers(false);
+  if (!bufs) return;
+
+  auto entry = bufs->find(this);
+  if (entry == bufs->end()) return;
+
+  ThreadBuffer* buf = static_cast<ThreadBuffer*>(entry->second);
+  buf->Flush();				// Blocks are queued before count drops
+
+  if (buf->active) {
+    buf->active = false;
+    std::lock_guard<std::mutex> l(queueMutex);
+    nActive--;
+    queueDone.notify_all();
+  }
+}
+
+
+// Flush this thread's buffer, wait for other threads to flush theirs, and
+// wait until all output is on disk
+
+void G4CMPOutputService::Drain() {
+  if (!IsOpen()) return;
+
+  FlushThreadBuffer();
+
+  {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    queueDone.wait(lock, [this]() { return nActive <= 0 || stopping; });
+  }
+
+  WaitForOutput();
+}
+
+void G4CMPOutputService::WaitForOutput() {
+  std::unique_lock<std::mutex> lock(queueMutex);
+  flushPending = true;
+  queueReady.notify_one();
+  queueDone.wait(lock, [this]() { return !flushPending || stopping; });
+}
+
+
+// Finish all output and stop writer thread
+// NOTE:  Called at end of job, when worker threads have finished, so any
+//	  buffers they did not flush can be flushed here
+
+void G4CMPOutputService::Stop() {
+  if (!writer.joinable()) return;
+
+  FlushThreadBuffer();
+
+  {
+    std::lock_guard<std::mutex> l(bufferMutex);
+    for (ThreadBuffer* buf: buffers) {
+      if (buf->active) buf->Flush();
+    }
+  }
+
+  WaitForOutput();
+
+  {
+    std::lock_guard<std::mutex> l(queueMutex);
+    stopping = true;
+  }
+  queueReady.notify_one();
+  writer.join();
+}
+
+
+// Per-thread column buffer, created on first use
+
+G4CMPOutputService::ThreadBuffer* G4CMPOutputService::GetThreadBuffer() {
+  G4CMPHitWriter*& buf = (*GetThreadBuffers(true))[this];
+  if (!buf) {
+    CreateRunObserver();
+
+    ThreadBuffer* newBuf = new ThreadBuffer(this);
+    newBuf->SetDoublePrecision(fileWriter.GetDoublePrecision());
+
+    std::lock_guard<std::mutex> l(bufferMutex);
+    buffers.push_back(newBuf);
+    buf = newBuf;
+  }
+
+  return static_cast<ThreadBuffer*>(buf);
+}
+
+void G4CMPOutputService::ThreadBuffer::WriteBlock(const std::vector<char>& block) {
+  service->Enqueue(runID, eventID, 0, block);
+}
+
+
+// Hand encoded block to writer thread, waiting if queue is full
+// NOTE:  A block larger than the limit is accepted into an empty queue
+
+void G4CMPOutputService::Enqueue(G4int runID, G4int eventID, G4int producers,
+				 const std::vector<char>& data) {
+  std::unique_lock<std::mutex> lock(queueMutex);
+  queueSpace.wait(lock, [this, &data]() {
+    return (maxQueuedBytes == 0 || queuedBytes == 0 || stopping ||
+	    queuedBytes + data.size() <= maxQueuedBytes);
+  });
+
+  queue.push_back(Block{runID, eventID, producers, data});
+  queuedBytes += data.size();
+  queueReady.notify_one();
+}
+
+
+// Body of writer thread: take all queued blocks, write without lock
+
+void G4CMPOutputService::WriterLoop() {
+  std::unique_lock<std::mutex> lock(queueMutex);
+
+  while (true) {
+    queueReady.wait(lock, [this]() {
+      return !queue.empty() || flushPending || stopping;
+    });
+
+    std::deque<Block> work;
+    work.swap(queue);
+    queuedBytes = 0;
+    G4bool doFlush = flushPending;
+    lock.unlock();
+    queueSpace.notify_all();
+
+    for (Block& blk: work) {
+      if (!eventOrdered) {
+	fileWriter.WriteEncodedBlock(blk.data);
+      } else {
+	PendingEvent& pe = pending[std::make_pair(blk.runID, blk.eventID)];
+	if (!blk.data.empty()) pe.blocks.push_back(std::move(blk.data));
+	if (blk.producers > 0) {
+	  pe.nDone++;
+	  pe.nExpected = blk.producers;
+	}
+      }
+    }
+
+    WriteReadyEvents(doFlush);
+
+    lock.lock();
+    if (doFlush) flushPending = false;
+    queueDone.notify_all();
+
+    if (stopping && queue.empty()) break;
+  }
+}
+
+
+// Write held events in (run, event) order, as far as possible
+// If "force" is set, everything held is written, complete or not
+
+void G4CMPOutputService::WriteReadyEvents(G4bool force) {
+  while (!pending.empty()) {
+    auto first = pending.begin();
+    const std::pair<G4int,G4int>& key = first->first;
+
+    // Events from a later run mean the earlier run has finished
+    G4bool laterRun = (pending.rbegin()->first.first > key.first);
+
+    if (key.first > nextEvent.first) nextEvent = std::make_pair(key.first, 0);
+
+    G4bool ready = (first->second.complete() &&
+		    (key == nextEvent || key < nextEvent || laterRun ||
+		     pending.size() > maxPending));
+
+    if (!ready && !force) break;
+
+    for (const auto& blk: first->second.blocks) {
+      fileWriter.WriteEncodedBlock(blk);
+    }
+
+    nextEvent = std::make_pair(key.first, key.second+1);
+    pending.erase(first);
+  }
+
+  if (force) nextEvent = std::make_pair(-1, 0);	// Start over with next run
+}
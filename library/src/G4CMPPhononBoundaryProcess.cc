@@ -41,6 +41,7 @@
 // 20250429  G4CMP-461 -- Implement ability to skip flats during displacement.
 // 20250505  G4CMP-458 -- Rename GetReflectedVector to GetSpecularVector.
 // 20250505  G4CMP-471 -- Update diagnostic output for surface displacement loop.
+// 20261019  Add G4CMPProfiler timing of GPIL, PostStepDoIt(), GetSpecularVector().
 
 #include "G4CMPPhononBoundaryProcess.hh"
 #include "G4CMPAnharmonicDecay.hh"
@@ -48,6 +49,7 @@
 #include "G4CMPGeometryUtils.hh"
 #include "G4CMPParticleChangeForPhonon.hh"
 #include "G4CMPPhononTrackInfo.hh"
+#include "G4CMPProfiler.hh"
 #include "G4CMPSolidUtils.hh"
 #include "G4CMPSurfaceProperty.hh"
 #include "G4CMPTrackUtils.hh"
@@ -107,6 +109,7 @@ G4double G4CMPPhononBoundaryProcess::
 PostStepGetPhysicalInteractionLength(const G4Track& aTrack,
                                      G4double previousStepSize,
                                      G4ForceCondition* condition) {
+  G4CMP_PROFILE_TIMER(profileGPIL);
   return GetMeanFreePath(aTrack, previousStepSize, condition);
 }
 
@@ -123,6 +126,7 @@ G4double G4CMPPhononBoundaryProcess::GetMeanFreePath(const G4Track& /*aTrack*/,
 G4VParticleChange*
 G4CMPPhononBoundaryProcess::PostStepDoIt(const G4Track& aTrack,
                                          const G4Step& aStep) {
+  G4CMP_PROFILE_TIMER(profileDoIt);
   // NOTE:  G4VProcess::SetVerboseLevel is not virtual!  Can't overlaod it
   G4CMPBoundaryUtils::SetVerboseLevel(verboseLevel);
 
@@ -270,6 +274,7 @@ G4ThreeVector G4CMPPhononBoundaryProcess::
 GetSpecularVector(const G4ThreeVector& waveVector,
                   G4ThreeVector& surfNorm, G4int mode,
                   G4ThreeVector& /*surfacePoint*/) {
+  G4CMP_PROFILE_SCOPE("G4CMPPhononBoundaryProcess::GetSpecularVector");
   // Specular reflecton should reverse momentum along normal
   G4ThreeVector reflectedKDir = waveVector.unit();
   G4double kPerp = reflectedKDir * surfNorm;		// Dot product between k and norm
@@ -0,0 +1,257 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPPhononCascade.cc
+/// \brief Implementation of the G4CMPPhononCascade class, which follows
+///   high-frequency phonon downconversion in bulk without Geant4 tracks.
+//
+// $Id$
+//
+// 20261019  New class for bulk phonon cascade above an energy threshold
+// 20261019  Split bulk cascade from DoCascade(), for use without a track
+
+#include "G4CMPPhononCascade.hh"
+#include "G4CMPAnharmonicDecay.hh"
+#include "G4CMPConfigManager.hh"
+#include "G4CMPDownconversionRate.hh"
+#include "G4CMPPhononScatteringRate.hh"
+#include "G4CMPPhononTrackInfo.hh"
+#include "G4CMPProfiler.hh"
+#include "G4CMPSecondaryUtils.hh"
+#include "G4CMPTrackUtils.hh"
+#include "G4CMPUtils.hh"
+#include "G4ExceptionSeverity.hh"
+#include "G4LatticePhysical.hh"
+#include "G4ParticleChange.hh"
+#include "G4PhononPolarization.hh"
+#include "G4RandomDirection.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "G4VProcess.hh"
+#include "G4VSolid.hh"
+#include "G4VTouchable.hh"
+#include "Randomize.hh"
+#include <cmath>
+
+
+// Constructor and destructor
+
+G4CMPPhononCascade::G4CMPPhononCascade(const G4VProcess* theProcess)
+  : verboseLevel(theProcess?theProcess->GetVerboseLevel():0),
+    procName(theProcess?theProcess->GetProcessName():"G4CMPPhononCascade"),
+    maxInteractions(10000),
+    anharmonicDecay(new G4CMPAnharmonicDecay(theProcess)),
+    downRate(new G4CMPDownconversionRate),
+    scatRate(new G4CMPPhononScatteringRate),
+    solid(0), threshold(0.), nDecays(0), nScatters(0) {;}
+
+G4CMPPhononCascade::~G4CMPPhononCascade() {
+  delete anharmonicDecay;
+  delete downRate;
+  delete scatRate;
+}
+
+
+// Pass verbosity through to utilities
+
+void G4CMPPhononCascade::SetVerboseLevel(G4int vb) {
+  verboseLevel = vb;
+  anharmonicDecay->SetVerboseLevel(vb);
+  downRate->SetVerboseLevel(vb);
+  scatRate->SetVerboseLevel(vb);
+}
+
+
+// Configure rates and decay utility for current track's volume
+
+void G4CMPPhononCascade::LoadDataForTrack(const G4Track* track) {
+  G4CMPProcessUtils::LoadDataForTrack(track);
+  anharmonicDecay->LoadDataForTrack(track);
+  downRate->LoadDataForTrack(track);
+  scatRate->LoadDataForTrack(track);
+
+  solid = track->GetTouchable()->GetSolid();
+}
+
+void G4CMPPhononCascade::LoadDataForVolume(const G4LatticePhysical* lat,
+					   const G4VSolid* vol) {
+  SetLattice(lat);
+  anharmonicDecay->SetLattice(lat);
+  downRate->SetLattice(lat);
+  scatRate->SetLattice(lat);
+
+  solid = vol;
+}
+
+
+// Energy threshold from configuration; zero disables cascade
+
+G4double G4CMPPhononCascade::GetThreshold() {
+  return G4CMPConfigManager::GetPhononCascadeEnergy();
+}
+
+G4bool G4CMPPhononCascade::IsApplicable(const G4Track& track) const {
+  G4double ecut = GetThreshold();
+  return (ecut > 0. && theLattice && solid && &track == GetCurrentTrack() &&
+	  track.GetKineticEnergy() >= ecut);
+}
+
+
+// Decay the parent, follow all daughters in bulk, and emit survivors
+
+void G4CMPPhononCascade::DoCascade(const G4Track& aTrack,
+				   G4ParticleChange& aParticleChange) {
+  G4CMP_PROFILE_SCOPE("G4CMPPhononCascade::DoCascade");
+
+  // Parent decays at its current position, just as in G4CMPAnharmonicDecay
+  G4ThreeVector pos0 = GetLocalPosition(aTrack);
+  G4ThreeVector k0 = G4CMP::GetTrackInfo<G4CMPPhononTrackInfo>(aTrack)->k();
+  RotateToLocalDirection(k0);
+
+  Cascade(GetKineticEnergy(aTrack), aTrack.GetGlobalTime(), pos0, k0);
+
+  if (verboseLevel) {
+    G4cout << procName << " cascade from " << aTrack.GetKineticEnergy()/eV
+	   << " eV: " << nDecays << " decays, " << nScatters << " scatters, "
+	   << emitted.size() << " phonons emitted" << G4endl;
+  }
+
+  // Surviving phonons become secondary tracks
+  aParticleChange.SetNumberOfSecondaries(G4int(emitted.size()));
+  for (size_t i: emitted) {
+    G4Track* sec = CreateTrack(aTrack, i);
+    if (sec) aParticleChange.AddSecondary(sec);
+  }
+
+  if (aParticleChange.GetNumberOfSecondaries() != G4int(emitted.size())) {
+    G4Exception("G4CMPPhononCascade::DoCascade", "Cascade001",
+		JustWarning, "Error creating secondaries");
+  }
+
+  aParticleChange.ProposeEnergy(0.);
+  aParticleChange.ProposeTrackStatus(fStopAndKill);
+}
+
+
+// Decay L-phonon and follow all daughters, in local coordinates
+
+void G4CMPPhononCascade::Cascade(G4double E0, G4double t0,
+				 const G4ThreeVector& pos0,
+				 const G4ThreeVector& k0) {
+  ClearBuffers();
+  threshold = GetThreshold();
+
+  G4int dmode[2];
+  G4ThreeVector dk[2];
+  G4double dE[2];
+  anharmonicDecay->SampleDecay(E0, k0, dmode, dk, dE);
+  nDecays++;
+
+  AddPhonon(dmode[0], dE[0], t0, pos0, dk[0]);
+  AddPhonon(dmode[1], dE[1], t0, pos0, dk[1]);
+
+  while (!pending.empty()) {
+    size_t i = pending.back();
+    pending.pop_back();
+    FollowPhonon(i);
+  }
+}
+
+
+// Discard phonons from previous cascade, keeping array capacity
+
+void G4CMPPhononCascade::ClearBuffers() {
+  mode.clear();
+  energy.clear();
+  time.clear();
+  posX.clear(); posY.clear(); posZ.clear();
+  kX.clear(); kY.clear(); kZ.clear();
+
+  pending.clear();
+  emitted.clear();
+
+  nDecays = nScatters = 0;
+}
+
+
+// Add phonon to arrays and stack; position and wavevector are local
+
+void G4CMPPhononCascade::AddPhonon(G4int pmode, G4double pE, G4double ptime,
+				   const G4ThreeVector& pos,
+				   const G4ThreeVector& k) {
+  pending.push_back(mode.size());
+
+  mode.push_back(pmode);
+  energy.push_back(pE);
+  time.push_back(ptime);
+  posX.push_back(pos.x()); posY.push_back(pos.y()); posZ.push_back(pos.z());
+  kX.push_back(k.x()); kY.push_back(k.y()); kZ.push_back(k.z());
+}
+
+
+// Transport phonon until it leaves the cascade; daughters are stacked
+
+void G4CMPPhononCascade::FollowPhonon(size_t i) {
+  G4ThreeVector pos = GetPosition(i);
+  G4ThreeVector k = GetWaveVector(i);
+
+  for (G4int nStep=0; nStep<maxInteractions; nStep++) {
+    if (energy[i] < threshold) break;
+
+    // Same rates as G4PhononDownconversion and G4PhononScattering
+    G4double rateDown = (mode[i] == G4PhononPolarization::Long
+			 ? downRate->RateForEnergy(energy[i]) : 0.);
+    G4double rateScat = scatRate->RateForEnergy(energy[i]);
+    G4double rate = rateDown + rateScat;
+    if (rate <= 0.) break;
+
+    // Distance to next interaction along group velocity
+    G4double dt = -std::log(G4UniformRand()) / rate;
+    G4ThreeVector vdir = theLattice->MapKtoVDir(mode[i], k);
+    G4double step = theLattice->MapKtoV(mode[i], k) * dt;
+
+    // Phonon would reach surface; let Geant4 transport it from here
+    if (step >= solid->DistanceToOut(pos, vdir)) break;
+
+    pos += step*vdir;
+    time[i] += dt;
+
+    if (G4UniformRand()*rate < rateDown) {	// Replace parent by daughter
+      G4int dmode[2];
+      G4ThreeVector dk[2];
+      G4double dE[2];
+      anharmonicDecay->SampleDecay(energy[i], k, dmode, dk, dE);
+      nDecays++;
+
+      mode[i] = dmode[0];
+      energy[i] = dE[0];
+      k = dk[0];
+
+      AddPhonon(dmode[1], dE[1], time[i], pos, dk[1]);
+    } else {					// Same as G4PhononScattering
+      k = G4RandomDirection();
+      mode[i] = G4CMP::ChoosePhononPolarization(theLattice->GetLDOS(),
+						theLattice->GetSTDOS(),
+						theLattice->GetFTDOS());
+      nScatters++;
+    }
+  }
+
+  posX[i] = pos.x(); posY[i] = pos.y(); posZ[i] = pos.z();
+  kX[i] = k.x(); kY[i] = k.y(); kZ[i] = k.z();
+
+  emitted.push_back(i);
+}
+
+
+// Create track for phonon at its current position and time
+
+G4Track* G4CMPPhononCascade::CreateTrack(const G4Track& parent,
+					 size_t i) const {
+  G4ThreeVector pos = GetGlobalPosition(GetPosition(i));
+  G4ThreeVector k = GetGlobalDirection(GetWaveVector(i));
+
+  return G4CMP::CreatePhonon(parent, mode[i], k, energy[i], time[i], pos);
+}
@@ -7,6 +7,8 @@
 /// \brief Compute rate for phonon impurity scattering (mode mixing)
 //
 // $Id$
+//
+// 20261019  Move calculation to RateForEnergy(), for bulk phonon cascade
 
 #include "G4CMPPhononScatteringRate.hh"
 #include "G4LatticePhysical.hh"
@@ -16,8 +18,12 @@
 // Scattering rate is computed from electric field
 
 G4double G4CMPPhononScatteringRate::Rate(const G4Track& aTrack) const {
+  return RateForEnergy(GetKineticEnergy(aTrack));
+}
+
+G4double G4CMPPhononScatteringRate::RateForEnergy(G4double energy) const {
   G4double B = theLattice->GetScatteringConstant();
-  G4double Eoverh = GetKineticEnergy(aTrack)/h_Planck;
+  G4double Eoverh = energy/h_Planck;
   
   return (Eoverh*Eoverh*Eoverh*Eoverh*B);
 }
@@ -0,0 +1,21 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPPrimaryInfo.cc
+/// \brief Implementation of the G4CMPPrimaryInfo class.
+//
+// $Id$
+//
+// 20261019  New class for macro-carrier primaries
+// 20261019  Rename from G4CMPMacroCarrierInfo, add Luke sampling factor
+
+#include "G4CMPPrimaryInfo.hh"
+#include "G4ios.hh"
+
+
+void G4CMPPrimaryInfo::Print() const {
+  G4cout << "G4CMPPrimaryInfo: Luke sampling " << lukeSampling
+	 << " multiplicity " << multiplicity << G4endl;
+}
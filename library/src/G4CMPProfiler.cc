@@ -0,0 +1,212 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPProfiler.cc
+/// \brief Implementation of the G4CMPProfiler class, which accumulates
+///   call counts, wall-clock and CPU times for instrumented G4CMP functions.
+//
+// $Id$
+//
+// 20261019  New class for optional per-function timing of G4CMP hot spots
+
+#include "G4CMPProfiler.hh"
+#include "G4ApplicationState.hh"
+#include "G4AutoLock.hh"
+#include "G4StateManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "G4VStateDependent.hh"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <time.h>
+
+
+// Shared registry of profiling point names and per-thread instances
+
+class G4CMPProfilerRegistry {
+public:
+  ~G4CMPProfilerRegistry() {
+    for (auto& inst: instances) delete inst;
+  }
+
+  std::vector<G4String> names;
+  std::map<G4String, G4int> indices;
+  std::vector<G4CMPProfiler*> instances;
+};
+
+namespace {
+  G4Mutex profMutex = G4MUTEX_INITIALIZER;	// For thread protection
+
+  G4CMPProfilerRegistry& theRegistry() {
+    static G4CMPProfilerRegistry registry;
+    return registry;
+  }
+
+  // Report and reset counters when master thread finishes a run
+
+  class G4CMPProfilerRunObserver : public G4VStateDependent {
+  public:
+    G4CMPProfilerRunObserver() : G4VStateDependent() {;}
+
+    virtual G4bool Notify(G4ApplicationState requestedState) {
+      G4ApplicationState current =
+	G4StateManager::GetStateManager()->GetCurrentState();
+
+      if (current == G4State_GeomClosed && requestedState == G4State_Idle &&
+	  G4CMPProfiler::IsEnabled()) {
+	G4CMPProfiler::Report(G4cout);
+	G4CMPProfiler::Reset();
+      }
+
+      return true;
+    }
+  };
+
+  G4bool observerCreated = false;	// Set only by master thread
+}
+
+std::atomic<G4bool> G4CMPProfiler::enabled(false);
+
+
+// Thread-local instance, recorded in registry for merging
+
+G4CMPProfiler* G4CMPProfiler::Instance() {
+  static G4ThreadLocal G4CMPProfiler* theInstance = 0;
+
+  if (!theInstance) {
+    theInstance = new G4CMPProfiler;
+
+    G4AutoLock l(&profMutex);
+    theRegistry().instances.push_back(theInstance);
+  }
+
+  return theInstance;
+}
+
+
+// Look up or assign index for named profiling point
+
+G4int G4CMPProfiler::Register(const G4String& name) {
+  G4AutoLock l(&profMutex);
+
+  G4CMPProfilerRegistry& reg = theRegistry();
+  auto found = reg.indices.find(name);
+  if (found != reg.indices.end()) return found->second;
+
+  G4int index = reg.names.size();
+  reg.names.push_back(name);
+  reg.indices[name] = index;
+
+  return index;
+}
+
+
+// Turn data collection on or off; master thread will report after each run
+
+void G4CMPProfiler::SetEnabled(G4bool value) {
+#ifndef G4CMP_PROFILE
+  if (value) {
+    G4Exception("G4CMPProfiler::SetEnabled", "Profile001", JustWarning,
+		"G4CMP was built without G4CMP_PROFILE; no data collected.");
+  }
+#endif
+
+  enabled.store(value, std::memory_order_relaxed);
+
+  if (value && !observerCreated && !G4Threading::IsWorkerThread()) {
+    new G4CMPProfilerRunObserver;	// G4StateManager takes ownership
+    observerCreated = true;
+  }
+}
+
+
+// Clock access, converted to Geant4 units
+
+G4double G4CMPProfiler::GetWallTime() {
+  auto now = std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration<G4double, std::nano>(now).count() * ns;
+}
+
+G4double G4CMPProfiler::GetCPUTime() {
+#ifdef CLOCK_THREAD_CPUTIME_ID
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec*s + ts.tv_nsec*ns;
+#else
+  return std::clock() * (s/CLOCKS_PER_SEC);	// Whole process, not thread
+#endif
+}
+
+
+// Accumulate one call; counters grow as new points are registered
+
+void G4CMPProfiler::Fill(G4int index, G4double wallTime, G4double cpuTime) {
+  if (index < 0) return;
+  if ((size_t)index >= counters.size()) counters.resize(index+1);
+
+  Counter& c = counters[index];
+  c.calls++;
+  c.wall += wallTime;
+  c.cpu += cpuTime;
+}
+
+
+// Zero all threads' counters
+
+void G4CMPProfiler::Reset() {
+  G4AutoLock l(&profMutex);
+
+  for (auto& inst: theRegistry().instances) {
+    for (auto& c: inst->counters) c = Counter();
+  }
+}
+
+
+// Merge counters from all threads and print table
+// NOTE:  Should be called when worker threads are idle (e.g., end of run)
+
+void G4CMPProfiler::Report(std::ostream& os) {
+  G4AutoLock l(&profMutex);
+
+  G4CMPProfilerRegistry& reg = theRegistry();
+  std::vector<Counter> sum(reg.names.size());
+
+  for (const auto& inst: reg.instances) {
+    for (size_t i=0; i<inst->counters.size() && i<sum.size(); i++) {
+      sum[i].calls += inst->counters[i].calls;
+      sum[i].wall  += inst->counters[i].wall;
+      sum[i].cpu   += inst->counters[i].cpu;
+    }
+  }
+
+  std::vector<size_t> order;
+  for (size_t i=0; i<sum.size(); i++) if (sum[i].calls > 0) order.push_back(i);
+
+  std::sort(order.begin(), order.end(),
+	    [&sum](size_t a, size_t b) { return sum[a].wall > sum[b].wall; });
+
+  std::ios::fmtflags oldFlags = os.flags();
+
+  os << "G4CMPProfiler summary for " << reg.instances.size() << " threads"
+     << "\n" << std::setw(50) << std::left << "Function" << std::right
+     << std::setw(12) << "Calls" << std::setw(14) << "Wall [ms]"
+     << std::setw(14) << "CPU [ms]" << std::setw(14) << "Wall/call [us]"
+     << std::endl;
+
+  os << std::fixed << std::setprecision(3);
+  for (size_t i: order) {
+    const Counter& c = sum[i];
+    os << std::setw(50) << std::left << reg.names[i] << std::right
+       << std::setw(12) << c.calls << std::setw(14) << c.wall/ms
+       << std::setw(14) << c.cpu/ms << std::setw(14) << c.wall/c.calls/us
+       << std::endl;
+  }
+
+  os.flags(oldFlags);
+}
@@ -0,0 +1,196 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPRamoSignal.cc
+/// \brief Implementation of the G4CMPRamoSignal class, which accumulates
+///   time-resolved Shockley-Ramo signals during charge transport.
+//
+// $Id$
+//
+// 20261019  New class for in-transport Shockley-Ramo signals
+
+#include "G4CMPRamoSignal.hh"
+#include "G4CMPMeshElectricField.hh"
+#include "G4CMPUtils.hh"
+#include "G4CMPVMeshInterpolator.hh"
+#include "G4DynamicParticle.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include <algorithm>
+#include <numeric>
+
+
+// Constructor and destructor
+
+G4CMPRamoSignal::G4CMPRamoSignal(G4double dt, size_t n, G4double t0)
+  : binWidth(dt), nBins(n), startTime(t0), lastTrackID(-1),
+    lastStepNumber(-1) {;}
+
+G4CMPRamoSignal::~G4CMPRamoSignal() {
+  for (G4CMPMeshElectricField* field: ownedFields) delete field;
+}
+
+
+// Add weighting potential for next channel
+
+void G4CMPRamoSignal::AddChannel(const G4String& epotFile) {
+  G4CMPMeshElectricField* field = new G4CMPMeshElectricField(epotFile);
+  ownedFields.push_back(field);
+  AddChannel(field);
+}
+
+void G4CMPRamoSignal::AddChannel(G4CMPMeshElectricField* field) {
+  if (!field) {
+    G4Exception("G4CMPRamoSignal::AddChannel", "RamoSignal001",
+		FatalErrorInArgument, "Null weighting potential for channel");
+    return;
+  }
+
+  fields.push_back(field);
+  Clear();
+}
+
+void G4CMPRamoSignal::SetBinning(G4double dt, size_t n, G4double t0) {
+  if (dt <= 0.) {
+    G4Exception("G4CMPRamoSignal::SetBinning", "RamoSignal002",
+		FatalErrorInArgument, "Time bin width must be positive");
+    return;
+  }
+
+  binWidth = dt;
+  nBins = n;
+  startTime = t0;
+  Clear();
+}
+
+
+// Reset for new event
+
+void G4CMPRamoSignal::Clear() {
+  traces.assign(fields.size()*nBins, 0.);
+  totals.assign(fields.size(), 0.);
+  preV.resize(fields.size());
+  postV.resize(fields.size());
+  lastTrackID = lastStepNumber = -1;
+
+  // Shared meshes need search index initialized in this thread
+  for (G4CMPMeshElectricField* field: fields)
+    field->GetInterpolator()->Initialize();
+}
+
+
+// Add signal from charge carrier step
+
+void G4CMPRamoSignal::AddStep(const G4Step* step) {
+  if (fields.empty() || !step) return;
+
+  const G4Track* track = step->GetTrack();
+  if (!G4CMP::IsChargeCarrier(track)) return;
+
+  const G4StepPoint* pre = step->GetPreStepPoint();
+  const G4StepPoint* post = step->GetPostStepPoint();
+
+  // Consecutive steps of same track start where last one ended
+  G4int trackID = track->GetTrackID();
+  G4int stepNumber = track->GetCurrentStepNumber();
+  if (trackID == lastTrackID && stepNumber == lastStepNumber+1)
+    preV.swap(postV);
+  else
+    FillPotentials(pre->GetPosition(), preV);
+
+  FillPotentials(post->GetPosition(), postV);
+  lastTrackID = trackID;
+  lastStepNumber = stepNumber;
+
+  // Weighted tracks (downsampled or macro-carrier) induce the full charge
+  DepositAll(track->GetWeight()*track->GetDynamicParticle()->GetCharge()/eplus,
+	     pre->GetGlobalTime(), post->GetGlobalTime());
+}
+
+void G4CMPRamoSignal::AddStep(G4double charge,
+			      const G4ThreeVector& prePos, G4double preTime,
+			      const G4ThreeVector& postPos, G4double postTime) {
+  if (fields.empty()) return;
+
+  FillPotentials(prePos, preV);
+  FillPotentials(postPos, postV);
+  lastTrackID = lastStepNumber = -1;	// Not from a G4Track
+
+  DepositAll(charge, preTime, postTime);
+}
+
+
+// Evaluate weighting potentials for all channels, as fraction of 1 V
+
+void G4CMPRamoSignal::FillPotentials(const G4ThreeVector& pos,
+				     std::vector<G4double>& V) const {
+  const G4double point[3] = { pos.x(), pos.y(), pos.z() };
+  for (size_t chan=0; chan<fields.size(); chan++)
+    V[chan] = fields[chan]->GetPotential(point)/volt;
+}
+
+
+// Induced charge on each channel from change of potentials over step
+
+void G4CMPRamoSignal::DepositAll(G4double charge, G4double t0, G4double t1) {
+  for (size_t chan=0; chan<fields.size(); chan++) {
+    G4double dq = -charge*(postV[chan]-preV[chan]);
+    if (dq != 0.) Deposit(chan, dq, t0, t1);
+  }
+}
+
+void G4CMPRamoSignal::Deposit(size_t chan, G4double dq, G4double t0,
+			      G4double t1) {
+  totals[chan] += dq;
+  if (nBins == 0) return;
+
+  G4double* trace = &traces[chan*nBins];
+
+  // Work in units of bins from start of trace
+  G4double u0 = (t0-startTime)/binWidth;
+  G4double u1 = (t1-startTime)/binWidth;
+  if (u1 < u0) std::swap(u0, u1);
+
+  const G4double uEnd = G4double(nBins);
+  if (u1 <= 0.) { trace[0] += dq; return; }	// Before trace starts
+  if (u0 >= uEnd) return;			// After trace ends
+
+  if (u1 == u0) {				// Instantaneous step
+    trace[size_t(u0)] += dq;
+    return;
+  }
+
+  const G4double rate = dq/(u1-u0);		// Charge per bin of overlap
+  if (u0 < 0.) {
+    trace[0] += -u0*rate;
+    u0 = 0.;
+  }
+
+  u1 = std::min(u1, uEnd);
+  while (u0 < u1) {
+    size_t bin = size_t(u0);
+    G4double next = std::min(G4double(bin+1), u1);
+    trace[bin] += (next-u0)*rate;
+    u0 = next;
+  }
+}
+
+
+// Running sum of increments gives induced charge vs. time
+
+void G4CMPRamoSignal::GetInducedCharge(size_t chan,
+				       std::vector<G4double>& charge) const {
+  charge.resize(nBins);
+  if (chan >= fields.size()) {
+    std::fill(charge.begin(), charge.end(), 0.);
+    return;
+  }
+
+  std::partial_sum(traces.begin()+chan*nBins, traces.begin()+(chan+1)*nBins,
+		   charge.begin());
+}
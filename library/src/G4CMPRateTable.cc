@@ -0,0 +1,53 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPRateTable.cc
+/// \brief Implementation of the G4CMPRateTable class, which tabulates
+///   a scattering rate as a function of energy or field.
+//
+// $Id$
+//
+// 20261019  New class for tabulated scattering rates
+
+#include "G4CMPRateTable.hh"
+#include <algorithm>
+#include <cmath>
+
+
+// Locate segment, then interpolate linearly in sqrt(x-x0)
+
+G4double G4CMPRateTable::Value(G4double x) const {
+  if (values.empty()) return 0.;
+
+  const G4int nSeg = GetNSegments();
+  G4int s = std::upper_bound(edges.begin(), edges.end()-1, x) - edges.begin();
+  s = std::min(std::max(s-1, 0), nSeg-1);
+
+  G4double t = nPerSegment * std::sqrt(std::max(0., (x-edges[s])*invWidth[s]));
+  G4int j = std::min(G4int(t), nPerSegment-1);
+
+  const G4double* v = &values[s*(nPerSegment+1)+j];
+  return v[0] + (t-j)*(v[1]-v[0]);
+}
+
+
+// Segment edges at each decade, with thresholds inserted
+
+std::vector<G4double>
+G4CMPRateTable::DecadeEdges(G4double xlow, G4double xhigh,
+			    const std::vector<G4double>& thresholds) {
+  std::vector<G4double> xedges(1, 0.);
+  for (G4double x=xlow; x<xhigh*(1.-1e-9); x*=10.) xedges.push_back(x);
+  xedges.push_back(xhigh);
+
+  for (G4double x: thresholds) {
+    if (x > 0. && x < xhigh) xedges.push_back(x);
+  }
+
+  std::sort(xedges.begin(), xedges.end());
+  xedges.erase(std::unique(xedges.begin(), xedges.end()), xedges.end());
+
+  return xedges;
+}
@@ -28,11 +28,13 @@
 //	       tracks; neutrals get everything at endpoint.
 // 20220815  G4CMP-308 : Factor step-accumulation procedures to HitMerging.
 // 20220828  Call HitMerging::ProcessEvent() to ensure event ID is set.
+// 20261019  Add G4CMPProfiler timing of PostStepDoIt().
 
 #include "G4CMPSecondaryProduction.hh"
 #include "G4CMPConfigManager.hh"
 #include "G4CMPHitMerging.hh"
 #include "G4CMPProcessSubType.hh"
+#include "G4CMPProfiler.hh"
 #include "G4CMPUtils.hh"
 #include "G4LatticeManager.hh"
 #include "G4ParticleDefinition.hh"
@@ -89,6 +91,7 @@ void G4CMPSecondaryProduction::LoadDataForTrack(const G4Track* track) {
 G4VParticleChange* 
 G4CMPSecondaryProduction::PostStepDoIt(const G4Track& track,
 				       const G4Step& step) {
+  G4CMP_PROFILE_TIMER(profileDoIt);
   aParticleChange.Initialize(track); 
 
   // Only apply to tracks while they are in lattice-configured volumes
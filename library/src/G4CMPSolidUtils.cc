@@ -26,14 +26,246 @@
 // 20250424  G4CMP-465 -- Create G4CMPSolidUtils class.
 // 20250429  G4CMP-461 -- Add function for skipping detector flats.
 // 20250430  N. Tenpas -- Add function for getting distance to bounding box.
+// 20261019  Add exact surface point and normal for common solids.
+// 20261019  Return last surface point from AdjustToEdgePosition() if search
+//		ends beyond the edge.
 
 #include "G4CMPSolidUtils.hh"
 #include "G4AffineTransform.hh"
+#include "G4Box.hh"
+#include "G4ExtrudedSolid.hh"
 #include "G4PhysicalConstants.hh"
+#include "G4Polycone.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4TwoVector.hh"
+#include "G4Tubs.hh"
 #include "G4VSolid.hh"
 #include "G4VTouchable.hh"
 #include "G4UnitsTable.hh"
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <vector>
+
+
+// Exact closest surface points for common solids, in solid's local frame
+
+namespace {
+  // Closest point on boundary of a polygon (x,y), or of the cross section
+  // (r,z) of a solid of revolution, where edges along the axis are skipped
+  struct PolygonPoint {
+    G4TwoVector point;		// Closest point on boundary
+    G4TwoVector normal;		// Outward normal of closest edge
+    G4bool corner;		// Closest point is a vertex between edges
+    G4bool inside;		// Test point is inside polygon
+  };
+
+  G4bool ClosestOnPolygon(const std::vector<G4TwoVector>& poly,
+			  const G4TwoVector& p, G4bool skipAxis,
+			  G4double tol, PolygonPoint& result) {
+    const size_t n = poly.size();
+    if (n < 3) return false;
+
+    // Outward normal of edge (a->b) is (dy,-dx) for counterclockwise order
+    G4double area2 = 0.;
+    for (size_t i=0; i<n; i++) {
+      const G4TwoVector& a = poly[i];
+      const G4TwoVector& b = poly[(i+1)%n];
+      area2 += a.x()*b.y() - b.x()*a.y();
+    }
+    const G4double orient = (area2 > 0.) ? 1. : -1.;
+
+    auto isSurface = [&](size_t i) {
+      const G4TwoVector& a = poly[i];
+      const G4TwoVector& b = poly[(i+1)%n];
+      return (!skipAxis || a.x() > tol || b.x() > tol) && a != b;
+    };
+
+    auto edgeNormal = [&](size_t i) {
+      G4TwoVector ab = poly[(i+1)%n] - poly[i];
+      return G4TwoVector(orient*ab.y(), -orient*ab.x()).unit();
+    };
+
+    G4double best = DBL_MAX;
+    size_t bestVertex = n;		// n means closest point is not a vertex
+    result.inside = false;
+
+    for (size_t i=0; i<n; i++) {
+      const G4TwoVector& a = poly[i];
+      const G4TwoVector& b = poly[(i+1)%n];
+
+      // Crossing test for point inside polygon
+      if ((a.y() > p.y()) != (b.y() > p.y()) &&
+	  p.x() < a.x() + (p.y()-a.y())*(b.x()-a.x())/(b.y()-a.y())) {
+	result.inside = !result.inside;
+      }
+
+      if (!isSurface(i)) continue;
+
+      G4TwoVector ab = b - a;
+      G4double t = std::min(1., std::max(0., (p-a).dot(ab)/ab.mag2()));
+      G4TwoVector q = a + t*ab;
+      G4double d2 = (p-q).mag2();
+
+      if (d2 < best) {
+	best = d2;
+	result.point = q;
+	result.normal = edgeNormal(i);
+	bestVertex = (t <= 0.) ? i : (t >= 1.) ? (i+1)%n : n;
+      }
+    }
+
+    if (best == DBL_MAX) return false;
+
+    // Vertex between parallel edges is not a corner
+    result.corner = false;
+    if (bestVertex < n) {
+      size_t prev = (bestVertex+n-1)%n;
+      result.corner = (!isSurface(prev) || !isSurface(bestVertex) ||
+		       edgeNormal(prev).dot(edgeNormal(bestVertex)) < 1.-1e-9);
+    }
+
+    return true;
+  }
+
+  // Solid of revolution, with (r,z) cross section
+  G4bool RevolvedSurfacePoint(const std::vector<G4TwoVector>& rz,
+			      const G4ThreeVector& p, G4double tol,
+			      G4ThreeVector& surf, G4ThreeVector& norm,
+			      G4bool& atEdge) {
+    G4double rho = p.perp();
+    G4ThreeVector rhoHat = (rho > 0.) ? G4ThreeVector(p.x()/rho, p.y()/rho, 0.)
+      : G4ThreeVector(1.,0.,0.);
+
+    G4TwoVector prz(rho, p.z());
+    PolygonPoint pp;
+    if (!ClosestOnPolygon(rz, prz, true, tol, pp)) return false;
+
+    atEdge = (!pp.inside && pp.corner);
+
+    G4TwoVector nrz = pp.normal;
+    if (atEdge && (prz-pp.point).mag2() > 0.) nrz = (prz-pp.point).unit();
+
+    surf = pp.point.x()*rhoHat + G4ThreeVector(0.,0.,pp.point.y());
+    norm = nrz.x()*rhoHat + G4ThreeVector(0.,0.,nrz.y());
+    return true;
+  }
+
+  G4bool BoxSurfacePoint(const G4Box* box, const G4ThreeVector& p,
+			 G4ThreeVector& surf, G4ThreeVector& norm,
+			 G4bool& atEdge) {
+    const G4double half[3] = { box->GetXHalfLength(), box->GetYHalfLength(),
+			       box->GetZHalfLength() };
+
+    // Outside: clamp each coordinate to box
+    G4int nOut = 0, axis = 0;
+    surf = p;
+    for (G4int i=0; i<3; i++) {
+      if (std::abs(p[i]) > half[i]) {
+	surf[i] = (p[i] > 0.) ? half[i] : -half[i];
+	nOut++;
+	axis = i;
+      }
+    }
+
+    // Inside: move to nearest face
+    if (nOut == 0) {
+      for (G4int i=1; i<3; i++) {
+	if (half[i]-std::abs(p[i]) < half[axis]-std::abs(p[axis])) axis = i;
+      }
+      surf[axis] = (p[axis] >= 0.) ? half[axis] : -half[axis];
+    }
+
+    atEdge = (nOut > 1);
+
+    if (atEdge) norm = (p - surf).unit();
+    else {
+      norm.set(0.,0.,0.);
+      norm[axis] = (surf[axis] > 0.) ? 1. : -1.;
+    }
+
+    return true;
+  }
+
+  G4bool TubsSurfacePoint(const G4Tubs* tubs, const G4ThreeVector& p,
+			  G4double tol, G4ThreeVector& surf,
+			  G4ThreeVector& norm, G4bool& atEdge) {
+    if (tubs->GetDeltaPhiAngle() < twopi) return false;
+
+    const G4double rmin = tubs->GetInnerRadius();
+    const G4double rmax = tubs->GetOuterRadius();
+    const G4double dz = tubs->GetZHalfLength();
+
+    const std::vector<G4TwoVector> rz = {
+      G4TwoVector(rmin,-dz), G4TwoVector(rmax,-dz),
+      G4TwoVector(rmax,dz), G4TwoVector(rmin,dz)
+    };
+
+    return RevolvedSurfacePoint(rz, p, tol, surf, norm, atEdge);
+  }
+
+  G4bool PolyconeSurfacePoint(const G4Polycone* pcon, const G4ThreeVector& p,
+			      G4double tol, G4ThreeVector& surf,
+			      G4ThreeVector& norm, G4bool& atEdge) {
+    if (pcon->IsOpen()) return false;
+
+    std::vector<G4TwoVector> rz(pcon->GetNumRZCorner());
+    for (size_t i=0; i<rz.size(); i++) {
+      rz[i].set(pcon->GetCorner(i).r, pcon->GetCorner(i).z);
+    }
+
+    return RevolvedSurfacePoint(rz, p, tol, surf, norm, atEdge);
+  }
+
+  // Right prism only: two Z sections with the same offset and unit scale
+  G4bool ExtrudedSurfacePoint(const G4ExtrudedSolid* xtru,
+			      const G4ThreeVector& p, G4double tol,
+			      G4ThreeVector& surf, G4ThreeVector& norm,
+			      G4bool& atEdge) {
+    if (xtru->GetNofZSections() != 2) return false;
+
+    const G4ExtrudedSolid::ZSection zlo = xtru->GetZSection(0);
+    const G4ExtrudedSolid::ZSection zhi = xtru->GetZSection(1);
+    if (zlo.fScale != 1. || zhi.fScale != 1. || zlo.fOffset != zhi.fOffset)
+      return false;
+
+    std::vector<G4TwoVector> poly = xtru->GetPolygon();
+    for (G4TwoVector& v: poly) v += zlo.fOffset;
+
+    G4TwoVector pxy(p.x(), p.y());
+    PolygonPoint pp;
+    if (!ClosestOnPolygon(poly, pxy, false, tol, pp)) return false;
+
+    G4bool inZ = (p.z() >= zlo.fZ && p.z() <= zhi.fZ);
+
+    if (pp.inside && inZ) {		// Inside: nearest of side or end
+      G4double dSide = (pxy - pp.point).mag();
+      G4double dLow = p.z() - zlo.fZ, dHigh = zhi.fZ - p.z();
+
+      atEdge = false;
+      if (dSide <= std::min(dLow, dHigh)) {
+	surf.set(pp.point.x(), pp.point.y(), p.z());
+	norm.set(pp.normal.x(), pp.normal.y(), 0.);
+      } else {
+	surf.set(p.x(), p.y(), (dHigh <= dLow) ? zhi.fZ : zlo.fZ);
+	norm.set(0., 0., (dHigh <= dLow) ? 1. : -1.);
+      }
+      return true;
+    }
+
+    // Outside: closest point of polygon and of Z range are independent
+    G4TwoVector qxy = pp.inside ? pxy : pp.point;
+    surf.set(qxy.x(), qxy.y(), std::min(zhi.fZ, std::max(zlo.fZ, p.z())));
+
+    atEdge = !pp.inside && (!inZ || pp.corner);
+
+    if (atEdge) norm = (p - surf).unit();
+    else if (pp.inside) norm.set(0., 0., (p.z() > zhi.fZ) ? 1. : -1.);
+    else norm.set(pp.normal.x(), pp.normal.y(), 0.);
+
+    return true;
+  }
+}
 
 
 // Direct constructors
@@ -41,27 +273,27 @@
 G4CMPSolidUtils::G4CMPSolidUtils(const G4VSolid* solid,
                                  G4int verbose, const G4String& vLabel)
   : theSolid(solid), theTransform(G4AffineTransform()), verboseLevel(verbose),
-    verboseLabel(vLabel) {;}
+    verboseLabel(vLabel), useAnalytic(true) {;}
 
 G4CMPSolidUtils::G4CMPSolidUtils(const G4VSolid* solid,
                                  const G4AffineTransform& trans,
                                  G4int verbose, const G4String& vLabel)
   : theSolid(solid), theTransform(trans), verboseLevel(verbose),
-    verboseLabel(vLabel) {;}
+    verboseLabel(vLabel), useAnalytic(true) {;}
 
 G4CMPSolidUtils::G4CMPSolidUtils(const G4VSolid* solid,
                                  const G4RotationMatrix& rot,
                                  const G4ThreeVector& disp,
                                  G4int verbose, const G4String& vLabel)
   : theSolid(solid), theTransform(G4AffineTransform(rot, disp)),
-    verboseLevel(verbose), verboseLabel(vLabel) {;}
+    verboseLevel(verbose), verboseLabel(vLabel), useAnalytic(true) {;}
 
 G4CMPSolidUtils::G4CMPSolidUtils(const G4VTouchable* touch, G4int verbose,
                                  const G4String& vLabel)
   : theSolid(touch->GetSolid()),
     theTransform(G4AffineTransform(touch->GetRotation(),
 				   touch->GetTranslation())),
-    verboseLevel(verbose), verboseLabel(vLabel) {;}
+    verboseLevel(verbose), verboseLabel(vLabel), useAnalytic(true) {;}
 
 
 // Copy operation
@@ -72,6 +304,7 @@ G4CMPSolidUtils::operator=(const G4CMPSolidUtils& right) {
   theTransform = right.theTransform;
   verboseLevel = right.verboseLevel;
   verboseLabel = right.verboseLabel;
+  useAnalytic = right.useAnalytic;
   return *this;
 }
 
@@ -98,6 +331,46 @@ G4double G4CMPSolidUtils::GetDistanceToSolid(const G4ThreeVector& pos,
 }
 
 
+// Exact closest surface point and normal for supported solids
+
+G4bool G4CMPSolidUtils::HasAnalyticSurface() const {
+  G4ThreeVector surf, norm;
+  G4bool atEdge;
+  return GetAnalyticSurfacePoint(G4ThreeVector(), surf, norm, atEdge);
+}
+
+G4bool G4CMPSolidUtils::
+GetAnalyticSurfacePoint(const G4ThreeVector& pos, G4ThreeVector& surfPoint,
+			G4ThreeVector& surfNorm, G4bool& atEdge) const {
+  if (!useAnalytic || !theSolid) return false;
+
+  G4ThreeVector localPos = GetLocalPosition(pos);
+  G4double tol = theSolid->GetTolerance();
+  G4bool found = false;
+  atEdge = false;
+
+  if (const G4Box* box = dynamic_cast<const G4Box*>(theSolid)) {
+    found = BoxSurfacePoint(box, localPos, surfPoint, surfNorm, atEdge);
+  } else if (const G4Tubs* tubs = dynamic_cast<const G4Tubs*>(theSolid)) {
+    found = TubsSurfacePoint(tubs, localPos, tol, surfPoint, surfNorm, atEdge);
+  } else if (const G4Polycone* pcon = dynamic_cast<const G4Polycone*>(theSolid)) {
+    found = PolyconeSurfacePoint(pcon, localPos, tol, surfPoint, surfNorm,
+				 atEdge);
+  } else if (const G4ExtrudedSolid* xtru =
+	     dynamic_cast<const G4ExtrudedSolid*>(theSolid)) {
+    found = ExtrudedSurfacePoint(xtru, localPos, tol, surfPoint, surfNorm,
+				 atEdge);
+  }
+
+  if (found) {
+    TransformToGlobalPoint(surfPoint);
+    TransformToGlobalDirection(surfNorm);
+  }
+
+  return found;
+}
+
+
 // Get the direction for the shortest distance to a solid
 
 G4ThreeVector G4CMPSolidUtils::GetDirectionToSolid(const G4ThreeVector& pos) const {
@@ -110,6 +383,15 @@ G4ThreeVector G4CMPSolidUtils::GetDirectionToSolid(const G4ThreeVector& pos) con
 
 void G4CMPSolidUtils::RotateDirectionToSolid(const G4ThreeVector& pos,
                                              G4ThreeVector& dir) const {
+  // Exact solution, if available for this solid
+  G4ThreeVector surfPoint, surfNorm;
+  G4bool atEdge;
+  if (GetAnalyticSurfacePoint(pos, surfPoint, surfNorm, atEdge)) {
+    dir = surfPoint - pos;
+    if (dir.mag2() > 0.) dir.setMag(1.);
+    return;
+  }
+
   // Angles to be adjusted in place by OptimizeSurfaceAdjustAngle
   // Start at theta = pi/2 so "fit" can be determined by phi
   G4double bestTheta = pi / 2;
@@ -220,6 +502,14 @@ AdjustToClosestSurfacePoint(G4ThreeVector& pos) const {
   // Do nothing if already on surface
   if (theSolid->Inside(GetLocalPosition(pos)) == kSurface) return;
 
+  // Exact solution, if available for this solid
+  G4ThreeVector surfPoint, surfNorm;
+  G4bool atEdge;
+  if (GetAnalyticSurfacePoint(pos, surfPoint, surfNorm, atEdge)) {
+    pos = surfPoint;
+    return;
+  }
+
   G4double minDist = GetDistanceToSolid(pos);
   G4ThreeVector optDir = minDist * GetDirectionToSolid(pos);
 
@@ -286,7 +576,10 @@ AdjustToEdgePosition(const G4ThreeVector& vTan,
   G4double low = 0.0*um;
   G4double mid = 0;
   G4ThreeVector originalPos = pos;
+  G4ThreeVector lastSurfPos = pos;	// Surface point at "low"
   G4double tolerance = theSolid->GetTolerance();
+  G4ThreeVector surfPoint, surfNorm;
+  G4bool atEdge = false;
 
   // Binary search to bring surface point to edge
   G4int maxItr = 100;
@@ -296,13 +589,27 @@ AdjustToEdgePosition(const G4ThreeVector& vTan,
     pos = originalPos + mid * vTan;
 
     // Modify pos in place to surface if adjusting on curved surfaces
-    if (curvedSurf == 1) AdjustToClosestSurfacePoint(pos);
+    // Beyond an edge, the closest point is not on a face (as with the
+    // numerical search, which does not converge there)
+    if (curvedSurf == 1) {
+      if (GetAnalyticSurfacePoint(pos, surfPoint, surfNorm, atEdge)) {
+	if (atEdge) pos.set(kInfinity,kInfinity,kInfinity);
+	else pos = surfPoint;
+      } else {
+	AdjustToClosestSurfacePoint(pos);
+      }
+    }
     isIn = theSolid->Inside(GetLocalPosition(pos));
 
-    if (isIn == kSurface) low = mid; // Move out
-    else high = mid; // Move in
+    if (isIn == kSurface) {	// Move out
+      low = mid;
+      lastSurfPos = pos;
+    } else high = mid;		// Move in
   }
 
+  // Trial point may be past the edge if search did not converge
+  if (isIn != kSurface) pos = lastSurfPos;
+
   if (verboseLevel>2) {
     G4cout << verboseLabel << "::AdjustToEdgePosition"
 	   << ": initialPos = " << originalPos
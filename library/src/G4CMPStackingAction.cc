@@ -27,6 +27,7 @@
 // 20240122 G4CMP-446 -- SetPhononVelocity() should use global-to-local
 //		transform for k vector and Vg.
 // 20250508 N. Tenpas -- Add coordinate transforms in SetPhononVelocity.
+// 20261019 Transfer Luke sampling and multiplicity from primary info.
 
 #include "G4CMPStackingAction.hh"
 
@@ -34,6 +35,7 @@
 #include "G4CMPDriftElectron.hh"
 #include "G4CMPDriftTrackInfo.hh"
 #include "G4CMPPhononTrackInfo.hh"
+#include "G4CMPPrimaryInfo.hh"
 #include "G4CMPTrackUtils.hh"
 #include "G4CMPUtils.hh"
 #include "G4LatticeManager.hh"
@@ -44,6 +46,7 @@
 #include "G4PhononTransFast.hh"
 #include "G4PhononTransSlow.hh"
 #include "G4PhysicalConstants.hh"
+#include "G4PrimaryParticle.hh"
 #include "G4RandomDirection.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4ThreeVector.hh"
@@ -93,6 +96,8 @@ G4CMPStackingAction::ClassifyNewTrack(const G4Track* aTrack) {
       AssignNearestValley(aTrack);
       SetChargeCarrierMass(aTrack);
     }
+
+    CopyPrimaryInfo(aTrack);
   }
 
   ReleaseTrack();
@@ -167,3 +172,23 @@ void G4CMPStackingAction::SetChargeCarrierMass(const G4Track* aTrack) const {
 
   dynp->SetMass(mass*c_squared);	// Converts to Geant4 [M]=[E] units
 }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+
+// Copy Luke sampling and multiplicity from primary's user information
+
+void G4CMPStackingAction::CopyPrimaryInfo(const G4Track* aTrack) const {
+  const G4PrimaryParticle* prim =
+    aTrack->GetDynamicParticle()->GetPrimaryParticle();
+  if (!prim) return;
+
+  const G4CMPPrimaryInfo* primInfo =
+    dynamic_cast<const G4CMPPrimaryInfo*>(prim->GetUserInformation());
+  if (!primInfo) return;
+
+  auto driftInfo = G4CMP::GetTrackInfo<G4CMPDriftTrackInfo>(*aTrack);
+  if (driftInfo) {
+    driftInfo->SetLukeSampling(primInfo->LukeSampling());
+    driftInfo->SetMultiplicity(primInfo->Multiplicity());
+  }
+}
@@ -47,6 +47,13 @@
 //              flips
 // 20240712 M. Kelsey -- Protect minimum MFP calculation for zero field.
 // 20250616 M. Kelsey -- Rename MFP variables to be more descriptive.
+// 20261019  Add G4CMPProfiler timing of PostStepDoIt().
+// 20261019  Add step limit at exit from mesh field tetrahedron, computed
+//		with constant acceleration in the tetrahedron's field.
+// 20261019  Use valley inverse mass tensor in local frame from lattice.
+// 20261019  BUG FIX:  Lattice masses already include c^2, don't rescale
+//		mesh acceleration; no mesh limit if exit time fails.  Split
+//		Simpson's rule at minimum speed for path length.
 
 #include "G4CMPTimeStepper.hh"
 #include "G4CMPConfigManager.hh"
@@ -55,6 +62,8 @@
 #include "G4CMPDriftTrackInfo.hh"
 #include "G4CMPFieldUtils.hh"
 #include "G4CMPGeometryUtils.hh"
+#include "G4CMPMeshElectricField.hh"
+#include "G4CMPProfiler.hh"
 #include "G4CMPTrackUtils.hh"
 #include "G4CMPUtils.hh"
 #include "G4CMPVProcess.hh"
@@ -172,8 +181,19 @@ G4double G4CMPTimeStepper::GetMeanFreePath(const G4Track& aTrack, G4double,
       G4cout << "TS field stopping mfpEstop " << mfpEstop/m << " m" << G4endl;
   }
 
+  // End step where field changes, at boundary of mesh tetrahedron
+  G4double mfpMesh = DBL_MAX;
+  if (G4CMPConfigManager::LimitStepsToMesh() && fieldVector.mag() > 0.) {
+    mfpMesh = MeshStepLength(aTrack, fieldVector);
+
+    if (verboseLevel>1)
+      G4cout << "TS mesh tetrahedron exit mfpMesh " << mfpMesh/m << " m"
+	     << G4endl;
+  }
+
   // Take shortest distance from above options
-  G4double mfp = std::min({mfpEstop, mfpLong, mfpFast, mfpLuke, mfpIV});
+  G4double mfp = std::min({mfpEstop, mfpLong, mfpFast, mfpLuke, mfpIV,
+			   mfpMesh});
 
   if (verboseLevel) {
     G4cout << GetProcessName() << (IsElectron()?" elec":" hole")
@@ -188,6 +208,7 @@ G4double G4CMPTimeStepper::GetMeanFreePath(const G4Track& aTrack, G4double,
 
 G4VParticleChange* G4CMPTimeStepper::PostStepDoIt(const G4Track& aTrack,
 						  const G4Step& aStep) {
+  G4CMP_PROFILE_TIMER(profileDoIt);
   InitializeParticleChange(GetValleyIndex(aTrack), aTrack);
 
   // Report basic kinematics
@@ -292,6 +313,84 @@ G4double G4CMPTimeStepper::EnergyStep(G4double Estart, G4double Efinal) const {
 }
 
 
+// Get path length to exit from current tetrahedron of mesh field
+
+G4double G4CMPTimeStepper::MeshStepLength(const G4Track& aTrack,
+					  const G4ThreeVector& field) const {
+  const G4LogicalVolume* vol = aTrack.GetVolume()->GetLogicalVolume();
+  const G4CMPMeshElectricField* mesh = G4CMP::GetMeshField(vol);
+  if (!mesh) return DBL_MAX;
+
+  // Acceleration in local frame; electrons use valley mass tensor,
+  // following G4CMPEqEMField
+  G4double charge = aTrack.GetDynamicParticle()->GetCharge();
+  G4ThreeVector vel = GetLocalVelocityVector(aTrack);
+  G4ThreeVector accel = GetLocalDirection(field);
+
+  if (IsElectron()) {
+    accel = FieldAcceleration(charge, accel,
+		theLattice->GetValleyMInvTensor(GetValleyIndex(aTrack)));
+  } else {
+    accel = FieldAcceleration(charge, accel, theLattice->GetHoleMass());
+  }
+
+  // Mesh without local field wrapper is in global coordinates
+  G4double pos[3];
+  if (G4CMP::GetLocalField(vol)) {
+    GetLocalPosition(aTrack, pos);
+  } else {
+    for (G4int i=0; i<3; i++) pos[i] = aTrack.GetPosition()[i];
+    RotateToGlobalDirection(vel);
+    RotateToGlobalDirection(accel);
+  }
+
+  return MeshPathLength(mesh, pos, vel, accel);
+}
+
+
+// Acceleration of charge carrier in field; masses are true masses
+
+G4ThreeVector G4CMPTimeStepper::FieldAcceleration(G4double charge,
+						  const G4ThreeVector& field,
+						  G4double mass) {
+  return charge*field/mass;
+}
+
+G4ThreeVector
+G4CMPTimeStepper::FieldAcceleration(G4double charge,
+				    const G4ThreeVector& field,
+				    const G4RotationMatrix& mInv) {
+  return charge*(mInv*field);
+}
+
+
+// Path length along trajectory with constant acceleration to leave the
+// mesh element containing pos
+
+G4double G4CMPTimeStepper::MeshPathLength(const G4CMPMeshElectricField* mesh,
+					  const G4double pos[3],
+					  const G4ThreeVector& vel,
+					  const G4ThreeVector& accel) {
+  G4double tExit = mesh->GetExitTime(pos, vel, accel);
+  if (tExit <= 0. || tExit >= DBL_MAX) return DBL_MAX;	// Other limits apply
+
+  // Path length from t0 to t1 by Simpson's rule on speed along trajectory
+  auto path = [&vel, &accel](G4double t0, G4double t1) {
+    return (t1-t0)/6. * ((vel+t0*accel).mag() + 4.*(vel+0.5*(t0+t1)*accel).mag()
+			 + (vel+t1*accel).mag());
+  };
+
+  // Speed has a kink if carrier reverses; integrate each side separately,
+  // and extend slightly so next step starts inside neighboring tetrahedron
+  G4double a2 = accel.mag2();
+  G4double tMin = (a2 > 0.) ? -vel.dot(accel)/a2 : 0.;
+  if (tMin <= 0. || tMin >= tExit) tMin = tExit;
+
+  G4double sExit = path(0., tMin) + path(tMin, tExit);
+  return sExit*(1.+1e-6);
+}
+
+
 // Report Luke and IV rates for diagnostics
 
 void G4CMPTimeStepper::ReportRates(const G4Track& aTrack) {
@@ -21,10 +21,15 @@
 // 20251015  G4CMP-516:  Add excessPath to ChargeStuck() boolean return.
 // 20251024  G4CMP-523:  Remove alternative "stuck tracks" testing code.
 // 20251025  G4CMP-520:  Remove redundant (and incorrect) InvalidPosition().
+// 20261019  Cache per-track thresholds and particle type; cache thermal
+//	     energy cut per lattice temperature; check for escape using
+//	     volume pointers before any other work.
+// 20261019  Add G4CMPProfiler timing of GPIL and PostStepDoIt().
 
 #include "G4CMPTrackLimiter.hh"
 #include "G4CMPConfigManager.hh"
 #include "G4CMPGeometryUtils.hh"
+#include "G4CMPProfiler.hh"
 #include "G4CMPUtils.hh"
 #include "G4ForceCondition.hh"
 #include "G4LatticePhysical.hh"
@@ -53,6 +58,15 @@ void G4CMPTrackLimiter::LoadDataForTrack(const G4Track* track) {
   G4CMPProcessUtils::LoadDataForTrack(track);
 
   flightAvg = flightAvg2 = lastFlight = lastRMS = 0.;
+
+  // Particle type and configuration can't change during a track
+  isPhonon = G4CMPProcessUtils::IsPhonon();
+  isCharge = G4CMPProcessUtils::IsChargeCarrier();
+
+  energyCut = (isCharge ? G4CMPConfigManager::GetMinChargeEnergy()
+	       : isPhonon ? G4CMPConfigManager::GetMinPhononEnergy() : -1.);
+
+  maxSteps = isCharge ? G4CMPConfigManager::GetMaxChargeSteps() : -1;
 }
 
 
@@ -67,11 +81,13 @@ G4double G4CMPTrackLimiter::GetMeanFreePath(const G4Track&, G4double,
 G4double G4CMPTrackLimiter::
 PostStepGetPhysicalInteractionLength(const G4Track& trk, G4double sl,
 				     G4ForceCondition* condition) {
+  G4CMP_PROFILE_TIMER(profileGPIL);
   return GetMeanFreePath(trk, sl, condition);	// No GPIL handling needed
 }
 
 G4VParticleChange* G4CMPTrackLimiter::PostStepDoIt(const G4Track& track,
                                                     const G4Step& step) {
+  G4CMP_PROFILE_TIMER(profileDoIt);
   aParticleChange.Initialize(track);
 
   if (verboseLevel>1) G4cout << GetProcessName() << "::PostStepDoIt" << G4endl;
@@ -124,19 +140,19 @@ G4VParticleChange* G4CMPTrackLimiter::PostStepDoIt(const G4Track& track,
 // Evaluate current track
 
 G4bool G4CMPTrackLimiter::BelowEnergyCut(const G4Track& track) const {
-  G4double ecut =
-    (G4CMP::IsChargeCarrier(track) ? G4CMPConfigManager::GetMinChargeEnergy()
-     : G4CMP::IsPhonon(track) ? G4CMPConfigManager::GetMinPhononEnergy() : -1.);
-
-  return (track.GetKineticEnergy() < ecut);
+  return (track.GetKineticEnergy() < energyCut);
 }
 
 G4bool G4CMPTrackLimiter::EscapedFromVolume(const G4Step& step) const {
-    G4StepPoint* preS = step.GetPreStepPoint();
-    G4StepPoint* postS = step.GetPostStepPoint();
+  G4StepPoint* preS = step.GetPreStepPoint();
+  G4StepPoint* postS = step.GetPostStepPoint();
 
-  G4VPhysicalVolume* prePV  = step.GetPreStepPoint()->GetPhysicalVolume();
-  G4VPhysicalVolume* postPV = step.GetPostStepPoint()->GetPhysicalVolume();
+  G4VPhysicalVolume* prePV  = preS->GetPhysicalVolume();
+  G4VPhysicalVolume* postPV = postS->GetPhysicalVolume();
+
+  // Usual case: step starts and ends in tracking volume; nothing to report
+  if (verboseLevel<=1 && prePV == GetCurrentVolume() &&
+      postPV == GetCurrentVolume()) return false;
 
   if (verboseLevel>1) {
     G4cout << GetProcessName() << "::EscapedFromVolume()" << G4endl
@@ -175,12 +191,19 @@ G4bool G4CMPTrackLimiter::EscapedFromVolume(const G4Step& step) const {
   return escape;
 }
 
-G4bool G4CMPTrackLimiter::PhononIsThermal(const G4Track& track) const {
-  if (!IsPhonon()) return false;	// Only phonons thermalize
+// Note: non-const here to use thermal energy cache
+
+G4bool G4CMPTrackLimiter::PhononIsThermal(const G4Track& track) {
+  if (!isPhonon || !theLattice) return false;	// Only phonons thermalize
 
   G4double temp = theLattice->GetTemperature();
   if (temp <= 0.) return false;
 
+  if (temp != thermalTemp) UpdateThermalCut(temp);
+
+  // Energetic phonons can't pass the Maxwell-Boltzmann test; skip it
+  if (track.GetKineticEnergy() > thermalECut) return false;
+
   if (verboseLevel>1)
     G4cout << GetProcessName() << "::PhononIsThermal()" << G4endl;
 
@@ -190,19 +213,31 @@ G4bool G4CMPTrackLimiter::PhononIsThermal(const G4Track& track) const {
 	   << G4endl;
   }
 
-  G4bool isThermal = G4CMP::IsThermalized(track);
+  G4bool isThermal = G4CMP::IsThermalized(temp, track.GetKineticEnergy());
   if (verboseLevel>1) G4cout << " thermal? " << isThermal << G4endl;
 
   return isThermal;
 }
 
+// Maxwell-Boltzmann PDF, 2*sqrt(E/(pi*kT))*exp(-E/kT), is below 2^-53 for
+// E > 40 kT, so no uniform random value can be accepted in IsThermalized().
+
+void G4CMPTrackLimiter::UpdateThermalCut(G4double temp) {
+  thermalTemp = temp;
+  thermalECut = 40.*k_Boltzmann*temp;
+
+  if (verboseLevel>1) {
+    G4cout << GetProcessName() << " thermal cut " << thermalECut/eV << " eV"
+	   << " @ " << temp/kelvin << " K" << G4endl;
+  }
+}
+
 // Note: non-const here to use accumulator caches
 
 G4bool G4CMPTrackLimiter::ChargeStuck(const G4Track& track) {
-  if (!G4CMP::IsChargeCarrier(track)) return false;	// Ignore phonons
+  if (!isCharge) return false;		// Ignore phonons
 
   // How long and how far has the track been travelling?
-  const G4double maxSteps = G4CMPConfigManager::GetMaxChargeSteps();
   G4int nstep = track.GetCurrentStepNumber();
 
   G4bool tooManySteps = (maxSteps>0 && nstep>maxSteps);
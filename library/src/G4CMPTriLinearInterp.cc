@@ -25,9 +25,13 @@
 //		gradient (field) precalc in UseMesh functions.
 // 20201002  Report tetrahedra errors during FillTInverse() initialization.
 // 20240920  G4CMP-244: Replace TetraIdx with function to access G4Cache.
+// 20261019  Add G4CMPProfiler timing of FindTetrahedron().
+// 20261019  Add GetExitTime() to compute time to leave tetrahedron, for
+//		step limits in piecewise-constant field.
+// 20261019  Use verbose level cached in base class, not G4CMPConfigManager.
 
 #include "G4CMPTriLinearInterp.hh"
-#include "G4CMPConfigManager.hh"
+#include "G4CMPProfiler.hh"
 #include "libqhullcpp/Qhull.h"
 #include "libqhullcpp/QhullFacetList.h"
 #include "libqhullcpp/QhullFacetSet.h"
@@ -67,6 +71,7 @@ G4CMPTriLinearInterp::G4CMPTriLinearInterp(const G4CMPTriLinearInterp& rhs)
   TInverse = rhs.TInverse;
   TInvGood = rhs.TInvGood;
   TExtend  = rhs.TExtend;
+  verboseLevel = rhs.verboseLevel;
 
   Tetra012 = rhs.Tetra012;	// Not really needed, but for completeness
   Tetra013 = rhs.Tetra013;
@@ -380,7 +385,7 @@ void G4CMPTriLinearInterp::FillTInverse() {
   for (size_t itet=0; itet<ntet; itet++) {
     const tetra3d& tetra = Tetrahedra[itet];	// For convenience below
 #ifdef G4CMPTLI_DEBUG
-    if (G4CMPConfigManager::GetVerboseLevel() > 1) {
+    if (verboseLevel > 1) {
       G4cout << " Processing Tetrahedra[" << itet << "]: " << tetra << G4endl;
     }
 #endif
@@ -437,7 +442,7 @@ void G4CMPTriLinearInterp::FillGradients() {
 		    V[tetra[2]]*ET[2][2] + V[tetra[3]]*ET[3][2])
 		   );
 #ifdef G4CMPTLI_DEBUG
-    if (G4CMPConfigManager::GetVerboseLevel() > 1) {
+    if (verboseLevel > 1) {
       G4cout << " Computed Grad[" << itet << "]: " << Grad[itet] << G4endl;
     }
 #endif
@@ -477,11 +482,93 @@ G4CMPTriLinearInterp::GetGrad(const G4double pos[3], G4bool quiet) const {
 }
 
 
+// Time for trajectory pos + vel*t + acc*t^2/2 to leave the tetrahedron
+// containing pos.  If pos is on a facet and moving outward, the walk
+// continues into the neighbor across that facet.  Returns DBL_MAX if the
+// trajectory never leaves, or pos is outside the mesh; zero if the
+// trajectory is leaving the hull, or no exit could be resolved.
+
+G4double G4CMPTriLinearInterp::GetExitTime(const G4double pos[3],
+					   const G4ThreeVector& vel,
+					   const G4ThreeVector& acc,
+					   G4bool quiet) const {
+  G4CMP_PROFILE_SCOPE("G4CMPTriLinearInterp::GetExitTime");
+
+  G4double bary[4] = { 0. };
+  FindTetrahedron(pos, bary, quiet);
+  if (TetraIdx() < 0) return DBL_MAX;
+
+  // Point may be on a vertex or edge shared by several tetrahedra
+  for (size_t count = 0; count < 32; ++count) {
+    G4int facet = -1;
+    G4double tExit = BaryExitTime(bary, vel, acc, facet);
+    if (tExit > 0. || facet < 0) return tExit;
+
+    G4int newTetraIdx = Neighbors[TetraIdx()][facet];
+    if (newTetraIdx == -1) return 0.;		// Leaving hull of mesh
+
+    TetraIdx() = newTetraIdx;
+    if (!Cart2Bary(pos, bary)) break;
+  }
+
+  return 0.;
+}
+
+// Each barycentric coordinate is quadratic along the trajectory, with
+// coefficients from its gradient (rows of TExtend).  Returns earliest
+// positive root, with index of facet (opposite vertex) where it occurs.
+// At an edge or vertex, the facet crossed most steeply is chosen.
+
+G4double G4CMPTriLinearInterp::BaryExitTime(const G4double bary[4],
+					    const G4ThreeVector& vel,
+					    const G4ThreeVector& acc,
+					    G4int& facet) const {
+  const G4double barySafety = 1e-10;	// Same tolerance as FindTetrahedron
+  const mat4x3& ET = TExtend[TetraIdx()];
+
+  G4double tExit = DBL_MAX;
+  G4double exitRate = 0.;
+  facet = -1;
+
+  for (G4int i=0; i<4; i++) {
+    // Solve b0 + b1*t + b2*t^2 = 0, with b0 non-negative inside tetrahedron
+    G4double b0 = std::max(bary[i], 0.);
+    G4double b1 = ET[i][0]*vel[0] + ET[i][1]*vel[1] + ET[i][2]*vel[2];
+    G4double b2 = 0.5*(ET[i][0]*acc[0] + ET[i][1]*acc[1] + ET[i][2]*acc[2]);
+
+    G4double ti = DBL_MAX;
+    if (b0 <= barySafety && (b1 < 0. || (b1 == 0. && b2 < 0.))) {
+      ti = 0.;					// Already leaving via facet
+    } else if (b2 == 0.) {
+      if (b1 < 0.) ti = -b0/b1;
+    } else {
+      G4double disc = b1*b1 - 4.*b2*b0;
+      if (disc >= 0.) {				// Numerically stable roots
+	G4double q = -0.5*(b1 + (b1<0.?-1.:1.)*sqrt(disc));
+	G4double r1 = q/b2;
+	G4double r2 = (q != 0.) ? b0/q : -1.;
+	if (r1 > 0.) ti = r1;
+	if (r2 > 0. && r2 < ti) ti = r2;
+      }
+    }
+
+    if (ti < tExit || (ti == 0. && tExit == 0. && b1 < exitRate)) {
+      tExit = ti;
+      exitRate = b1;
+      facet = i;
+    }
+  }
+
+  return tExit;
+}
+
+
 // Identify tetrahedron enclosing point, returning barycentric coords
 
 void 
 G4CMPTriLinearInterp::FindTetrahedron(const G4double pt[3], G4double bary[4],
 				      G4bool quiet) const {
+  G4CMP_PROFILE_SCOPE("G4CMPTriLinearInterp::FindTetrahedron");
   const G4double barySafety = -1e-10;	// Deal with points close to facets
 
   G4double bestBary = 0.;	// Norm of barycentric coordinates (below)
@@ -490,7 +577,7 @@ G4CMPTriLinearInterp::FindTetrahedron(const G4double pt[3], G4double bary[4],
   if (TetraIdx() == -1) TetraIdx() = TetraStart;
 
 #ifdef G4CMPTLI_DEBUG
-  if (G4CMPConfigManager::GetVerboseLevel() > 1) {
+  if (verboseLevel > 1) {
     G4cout << "FindTetrahedron pt " << pt[0] << " " << pt[1] << " " << pt[2]
 	   << "\n starting from TetraIdx " << TetraIdx() << G4endl;
   }
@@ -514,7 +601,7 @@ G4CMPTriLinearInterp::FindTetrahedron(const G4double pt[3], G4double bary[4],
     }	// if (!Cart2bary())
 
 #ifdef G4CMPTLI_DEBUG
-    if (G4CMPConfigManager::GetVerboseLevel() > 2) {
+    if (verboseLevel > 2) {
       G4cout << " Loop " << count << ": Tetra " << TetraIdx() << ": "
 	     << Tetrahedra[TetraIdx()] << "\n bary " << bary[0] << " " << bary[1]
 	     << " " << bary[2] << " " << bary[3] << " norm " << BaryNorm(bary)
@@ -533,7 +620,7 @@ G4CMPTriLinearInterp::FindTetrahedron(const G4double pt[3], G4double bary[4],
       bestTet  = TetraIdx();
 
 #ifdef G4CMPTLI_DEBUG
-      if (G4CMPConfigManager::GetVerboseLevel() > 2) {
+      if (verboseLevel > 2) {
 	G4cout << " New bestTet " << bestTet << " bestBary = " << bestBary
 	       << G4endl;
       }
@@ -562,7 +649,7 @@ G4CMPTriLinearInterp::FindTetrahedron(const G4double pt[3], G4double bary[4],
     TetraIdx() = newTetraIdx;
 
 #ifdef G4CMPTLI_DEBUG
-    if (G4CMPConfigManager::GetVerboseLevel() > 2) {
+    if (verboseLevel > 2) {
       G4cout << " minBaryIdx " << minBaryIdx << ": moved to neighbor tetra "
 	     << TetraIdx() << G4endl;
     }
@@ -573,7 +660,7 @@ G4CMPTriLinearInterp::FindTetrahedron(const G4double pt[3], G4double bary[4],
   TetraIdx() = bestTet;
 
 #ifdef G4CMPTLI_DEBUG
-  if (G4CMPConfigManager::GetVerboseLevel() > 1) {
+  if (verboseLevel > 1) {
     Cart2Bary(pt,bary);
     G4cout << "Tetrahedron not found! Using bestTet " << bestTet << " bary "
 	   << bary[0] << " " << bary[1] << " " << bary[2] << " " << bary[3]
@@ -636,7 +723,7 @@ G4bool G4CMPTriLinearInterp::MatInv(const mat3x3& matrix, mat3x3& result,
 	     << G4endl;
 
 #ifdef G4CMPTLI_DEBUG
-      if (G4CMPConfigManager::GetVerboseLevel() > 1) G4cerr << matrix;
+      if (verboseLevel > 1) G4cerr << matrix;
 #endif
     }
 
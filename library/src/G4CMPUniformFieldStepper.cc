@@ -0,0 +1,77 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPUniformFieldStepper.cc
+/// \brief Implementation of the G4CMPUniformFieldStepper class, a
+///   fourth-order Runge-Kutta stepper which evaluates the electric field
+///   once per step.
+//
+// $Id$
+//
+// 20261019  New stepper for uniform or piecewise-constant electric fields
+
+#include "G4CMPUniformFieldStepper.hh"
+#include "G4EquationOfMotion.hh"
+#include "G4ExceptionSeverity.hh"
+
+
+// Constructor
+
+G4CMPUniformFieldStepper::G4CMPUniformFieldStepper(G4EquationOfMotion* eqRhs,
+						   G4int numVar)
+  : G4MagErrorStepper(eqRhs, numVar), nVar(numVar), haveField(false) {
+  if (nVar > G4FieldTrack::ncompSVEC) {
+    G4Exception("G4CMPUniformFieldStepper", "Stepper001", FatalException,
+		"Too many integration variables for stepper buffers.");
+  }
+
+  for (G4double& x: lastPoint) x = 0.;
+  for (G4double& f: field) f = 0.;
+}
+
+
+// Look up field at start point, or reuse value from previous call
+
+void G4CMPUniformFieldStepper::UpdateField(const G4double yIn[]) {
+  // Time is index 7 in the field track state vector
+  G4double point[4] = { yIn[0], yIn[1], yIn[2], (nVar>7 ? yIn[7] : 0.) };
+
+  if (haveField && point[0] == lastPoint[0] && point[1] == lastPoint[1] &&
+      point[2] == lastPoint[2] && point[3] == lastPoint[3]) return;
+
+  GetEquationOfMotion()->GetFieldValue(point, field);
+  for (G4int i=0; i<4; i++) lastPoint[i] = point[i];
+  haveField = true;
+}
+
+
+// Classical RK4 step, with field taken from start point
+
+void G4CMPUniformFieldStepper::DumbStepper(const G4double yIn[],
+					   const G4double dydx[],
+					   G4double h, G4double yOut[]) {
+  UpdateField(yIn);
+  const G4EquationOfMotion* eq = GetEquationOfMotion();
+
+  const G4double hh = 0.5*h;
+  G4int i;
+
+  for (i=0; i<nVar; i++) yTemp[i] = yIn[i] + hh*dydx[i];	// k2
+  eq->EvaluateRhsGivenB(yTemp, field, dydxTemp);
+
+  for (i=0; i<nVar; i++) yTemp[i] = yIn[i] + hh*dydxTemp[i];	// k3
+  eq->EvaluateRhsGivenB(yTemp, field, dydxMid);
+
+  for (i=0; i<nVar; i++) {
+    yTemp[i] = yIn[i] + h*dydxMid[i];				// k4
+    dydxMid[i] += dydxTemp[i];
+  }
+  eq->EvaluateRhsGivenB(yTemp, field, dydxTemp);
+
+  const G4double h6 = h/6.;
+  for (i=0; i<nVar; i++) {
+    yOut[i] = yIn[i] + h6*(dydx[i] + dydxTemp[i] + 2.*dydxMid[i]);
+  }
+}
@@ -21,6 +21,8 @@
 // 20250422  G4CMP-468 -- Add displaced point test to PhononVelocityIsInward.
 // 20250423  G4CMP-468 -- Add function to get diffuse reflection vector.
 // 20250510  G4CMP-483 -- Ensure backwards compatibility for vector utilities.
+// 20261019  Add LukePhononWaveVector() for direct Luke emission sampling
+// 20261019  Pass touchable explicitly to GetLambertianVector, VelocityIsInward
 
 #include "G4CMPUtils.hh"
 #include "G4CMPConfigManager.hh"
@@ -43,6 +45,7 @@
 #include "G4TrackingManager.hh"
 #include "G4VProcess.hh"
 #include "Randomize.hh"
+#include <cmath>
 #include <string>
 
 
@@ -223,14 +226,23 @@ G4ThreeVector
 G4CMP::GetLambertianVector(const G4LatticePhysical* theLattice,
 			   const G4ThreeVector& surfNorm, G4int mode,
 			   const G4ThreeVector& surfPoint) {
+  return GetLambertianVector(GetCurrentTouchable(), theLattice, surfNorm,
+			     mode, surfPoint);
+}
+
+G4ThreeVector
+G4CMP::GetLambertianVector(const G4VTouchable* touchable,
+			   const G4LatticePhysical* theLattice,
+			   const G4ThreeVector& surfNorm, G4int mode,
+			   const G4ThreeVector& surfPoint) {
   G4ThreeVector reflectedKDir;
   const G4int maxTries = 1000;
   G4int nTries = 0;
   do {
     reflectedKDir = LambertReflection(surfNorm);
   } while (nTries++ < maxTries &&
-           !PhononVelocityIsInward(theLattice, mode, reflectedKDir, surfNorm,
-                                   surfPoint));
+           !PhononVelocityIsInward(touchable, theLattice, mode, reflectedKDir,
+                                   surfNorm, surfPoint));
 
   return reflectedKDir;
 }
@@ -263,8 +275,16 @@ G4bool G4CMP::PhononVelocityIsInward(const G4LatticePhysical* lattice,
                                      const G4ThreeVector& surfNorm,
                                      const G4ThreeVector& surfacePos) {
   // Get touchable for coordinate rotations
-  const G4VTouchable* touchable = GetCurrentTouchable();
+  return PhononVelocityIsInward(GetCurrentTouchable(), lattice, mode,
+				waveVector, surfNorm, surfacePos);
+}
 
+G4bool G4CMP::PhononVelocityIsInward(const G4VTouchable* touchable,
+				     const G4LatticePhysical* lattice,
+                                     G4int mode,
+                                     const G4ThreeVector& waveVector,
+                                     const G4ThreeVector& surfNorm,
+                                     const G4ThreeVector& surfacePos) {
   if (!touchable) {
     G4Exception("G4CMP::PhononVelocityIsInward", "G4CMPUtils001",
 		EventMustBeAborted, "Current track does not have valid touchable!");
@@ -338,6 +358,33 @@ G4bool G4CMP::IsThermalized(const G4Track* track) {
 }
 
 
+// Generate Luke phonon wavevector for carrier above sound speed
+// The polar angle distribution has inverse CDF (G4CMPProcessUtils::
+// MakePhononTheta)  cos(theta) = v + (1-v)*cbrt(1-u),  with v = ks/k,
+// so the Mach ratio only rescales a single variable, w = cbrt(1-u), and
+// q = 2(k*cos(theta)-ks) = 2k(1-v)*w.  Azimuth convention matches the
+// rotations previously used in G4CMPLukeScattering.
+
+G4ThreeVector G4CMP::LukePhononWaveVector(const G4ThreeVector& k,
+					  G4double ks) {
+  G4double kmag = k.mag();
+  if (kmag <= ks) return G4ThreeVector();
+
+  G4double v = ks/kmag;
+  G4double w = std::cbrt(1.-G4UniformRand());
+  G4double cosTh = v + (1.-v)*w;
+  G4double sinTh = std::sqrt(std::max(0., 1.-cosTh*cosTh));
+  G4double phi = G4UniformRand()*twopi;
+
+  G4ThreeVector kdir = k/kmag;
+  G4ThreeVector perp1 = kdir.orthogonal().unit().cross(kdir);
+  G4ThreeVector perp2 = kdir.cross(perp1);
+
+  G4double q = 2.*kmag*(1.-v)*w;
+  return q*(cosTh*kdir + sinTh*(std::cos(phi)*perp1 + std::sin(phi)*perp2));
+}
+
+
 // Search particle's processes for specified name
 
 G4VProcess*
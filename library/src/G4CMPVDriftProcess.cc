@@ -21,6 +21,7 @@
 // 20170620  Follow interface changes in G4CMPProcessUtils
 // 20201231  FillParticleChange() should also reset valley index if requested
 // 20230210  I. Ataee -- Change energy-momentum relation to relativistic in FillParticleChange
+// 20261019  Call G4CMPVProcess GPIL, to include optional profiling timer.
 
 #include "G4CMPVDriftProcess.hh"
 #include "G4CMPConfigManager.hh"
@@ -70,9 +71,9 @@ G4CMPVDriftProcess::PostStepGetPhysicalInteractionLength(
                       G4double previousStepSize,
                       G4ForceCondition* condition) {
   G4double trueLength =
-    G4VDiscreteProcess::PostStepGetPhysicalInteractionLength(track,
-                                                             previousStepSize,
-                                                             condition);
+    G4CMPVProcess::PostStepGetPhysicalInteractionLength(track,
+                                                        previousStepSize,
+                                                        condition);
 
   G4double minLength = G4CMPConfigManager::GetMinStepScale();
   minLength *= (IsElectron() ? theLattice->GetElectronScatter()
@@ -14,8 +14,18 @@
 // 20200914  Add function call to precompute potential gradients (field)
 // 20240921  Add new Initialize() function to set tetra index cache
 // 20250223  G4CMP-462: Avoid data race with worker thread Initialize()
+// 20261019  Cache verbose level at construction; interpolators may be used
+//		from non-Geant4 threads, where G4CMPConfigManager must not be.
 
 #include "G4CMPVMeshInterpolator.hh"
+#include "G4CMPConfigManager.hh"
+
+
+// Constructor
+
+G4CMPVMeshInterpolator::G4CMPVMeshInterpolator(const G4String& prefix)
+  : TetraStart(-1), savePrefix(prefix),
+    verboseLevel(G4CMPConfigManager::GetVerboseLevel()) {;}
 
 
 // Replace values at mesh points without rebuilding tables
@@ -14,9 +14,11 @@
 // 20190906  Bug fix in UseRateModel(), check for good pointer, not null;
 //		Add function to initialize rate model after LoadDataForTrack
 // 20210915  Change diagnostic output to verbose=3 or higher.
+// 20261019  Add G4CMPProfiler timing of GPIL and PostStepDoIt
 
 #include "G4CMPVProcess.hh"
 #include "G4CMPConfigManager.hh"
+#include "G4CMPProfiler.hh"
 #include "G4CMPVScatteringRate.hh"
 #include "G4ForceCondition.hh"
 #include "G4SystemOfUnits.hh"
@@ -27,6 +29,8 @@
 G4CMPVProcess::G4CMPVProcess(const G4String& processName,
 			     G4CMPProcessSubType stype)
   : G4VDiscreteProcess(processName, fPhonon), G4CMPProcessUtils(),
+    profileGPIL(G4CMP_PROFILE_REGISTER(processName+"::GetMeanFreePath")),
+    profileDoIt(G4CMP_PROFILE_REGISTER(processName+"::PostStepDoIt")),
     rateModel(0) {
   verboseLevel = G4CMPConfigManager::GetVerboseLevel();
   SetProcessSubType(stype);
@@ -73,6 +77,19 @@ void G4CMPVProcess::ConfigureRateModel() {
 }
 
 
+// Time base-class GPIL, which calls through to GetMeanFreePath()
+
+G4double G4CMPVProcess::
+PostStepGetPhysicalInteractionLength(const G4Track& track,
+				     G4double previousStepSize,
+				     G4ForceCondition* condition) {
+  G4CMP_PROFILE_TIMER(profileGPIL);
+  return G4VDiscreteProcess::PostStepGetPhysicalInteractionLength(track,
+							previousStepSize,
+							condition);
+}
+
+
 // Compute MFP using track velocity and scattering rate
 
 G4double G4CMPVProcess::GetMeanFreePath(const G4Track& aTrack, G4double,
@@ -58,17 +58,25 @@
 // 20231017  E. Michaud -- Add 'AddValley(const G4ThreeVector&)'
 // 20240426  S. Zatschler -- Add explicit fallthrough statements to switch cases
 // 20240510  E. Michhaud -- Add function to compute L0 from other parameters
+// 20261019  Add G4CMPProfiler timing of Map*() functions.
+// 20261019  Fill tabulated anharmonic decay sampling in Initialize().
+// 20261019  Add binary "compiled" lattice I/O; Initialize() skips filling
+//		K-Vg table if already filled (or read) for current density.
 
 #include "G4LatticeLogical.hh"
+#include "G4CMPAnharmonicTable.hh"	// **** THIS BREAKS G4 PORTING ****
 #include "G4CMPPhononKinematics.hh"	// **** THIS BREAKS G4 PORTING ****
 #include "G4CMPPhononKinTable.hh"	// **** THIS BREAKS G4 PORTING ****
 #include "G4CMPConfigManager.hh"	// **** THIS BREAKS G4 PORTING ****
+#include "G4CMPProfiler.hh"		// **** THIS BREAKS G4 PORTING ****
 #include "G4CMPUnitsTable.hh"		// **** THIS BREAKS G4 PORTING ****
 #include "G4RotationMatrix.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4PhysicalConstants.hh"
 #include <cmath>
+#include <cstring>
 #include <fstream>
+#include <stdint.h>
 
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
@@ -76,7 +84,7 @@
 G4LatticeLogical::G4LatticeLogical(const G4String& name)
   : verboseLevel(0), fName(name), fDensity(0.), fNImpurity(0.),
     fPermittivity(1.), fElasticity{}, fElReduced{}, fHasElasticity(false),
-    fpPhononKin(0), fpPhononTable(0),
+    fpPhononKin(0), fpPhononTable(0), fpAnhTable(0), fKVMapDensity(0.),
     fA(0), fB(0), fLDOS(0), fSTDOS(0), fFTDOS(0), fTTFrac(0),
     fBeta(0), fGamma(0), fLambda(0), fMu(0),
     fVSound(0.), fVTrans(0.), fL0_e(0.), fL0_h(0.), 
@@ -101,6 +109,7 @@ G4LatticeLogical::G4LatticeLogical(const G4String& name)
 G4LatticeLogical::~G4LatticeLogical() {
   delete fpPhononKin; fpPhononKin = 0;
   delete fpPhononTable; fpPhononTable = 0;
+  delete fpAnhTable; fpAnhTable = 0;
 }
 
 // Copy and move operators (to handle owned pointers)
@@ -166,6 +175,9 @@ G4LatticeLogical& G4LatticeLogical::operator=(const G4LatticeLogical& rhs) {
   if (!rhs.fpPhononKin)   fpPhononKin = new G4CMPPhononKinematics(this);
   if (!rhs.fpPhononTable) fpPhononTable = new G4CMPPhononKinTable(fpPhononKin);
 
+  delete fpAnhTable;
+  fpAnhTable = rhs.fpAnhTable ? new G4CMPAnharmonicTable(*rhs.fpAnhTable) : 0;
+
   SetElReduced(rhs.fElReduced);
   FillElasticity();
 
@@ -176,6 +188,7 @@ G4LatticeLogical& G4LatticeLogical::operator=(const G4LatticeLogical& rhs) {
       }
     }
   }
+  fKVMapDensity = rhs.fKVMapDensity;
 
   return *this;
 }
@@ -199,11 +212,13 @@ void G4LatticeLogical::SetElReduced(const ReducedElasticity& mat) {
   }
 
   fHasElasticity = true;
+  fKVMapDensity = 0.;			// K-Vg table must be refilled
 }
 
 void G4LatticeLogical::SetCpq(G4int p, G4int q, G4double value) {
   if (p>0 && p<7 && q>0 && q<7) fElReduced[p-1][q-1] = value;
   fHasElasticity = true;
+  fKVMapDensity = 0.;
 }
 
 
@@ -220,6 +235,8 @@ void G4LatticeLogical::SetCrystal(G4CMPCrystalGroup::Bravais group, G4double a,
   fBasis[0] = a*fCrystal.axis[0];	// Basis vectors include spacing
   fBasis[1] = b*fCrystal.axis[1];
   fBasis[2] = c*fCrystal.axis[2];
+
+  fKVMapDensity = 0.;			// Symmetry changes elasticity tensor
 }
 
 
@@ -243,8 +260,33 @@ void G4LatticeLogical::Initialize(const G4String& newName) {
   if (fpPhononKin) fpPhononTable = new G4CMPPhononKinTable(fpPhononKin);
   *****/
 
-  // Populate phonon lookup tables if not read from files
-  FillMaps();
+  // Populate phonon lookup tables if not read from compiled file
+  if (fKVMapDensity != fDensity) FillMaps();
+
+  FillAnharmonicTable();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+
+/////////////////////////////////////////////////////////////
+//Tabulate daughter energy distributions for anharmonic decay
+/////////////////////////////////////////////////////////////
+void G4LatticeLogical::FillAnharmonicTable() {
+  delete fpAnhTable; fpAnhTable = 0;
+
+  // Decay kinematics require L faster than T phonons
+  if (fVTrans <= 0. || fVSound <= fVTrans) return;
+
+  fpAnhTable = new G4CMPAnharmonicTable(fVSound/fVTrans, fBeta/(1e11*pascal),
+					fGamma/(1e11*pascal),
+					fLambda/(1e11*pascal),
+					fMu/(1e11*pascal));
+
+  if (verboseLevel) {
+    G4cout << "G4LatticeLogical " << fName << " anharmonic decay tables:"
+	   << " CDF error " << fpAnhTable->GetTTError() << " (TT), "
+	   << fpAnhTable->GetLTError() << " (LT)" << G4endl;
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
@@ -339,6 +381,8 @@ void G4LatticeLogical::FillMaps() {
     }
   }
 
+  fKVMapDensity = fDensity;		// Phonon velocities scale with density
+
   if (verboseLevel) {
     G4cout << "G4LatticeLogical::FillMaps populated " << KVBINS
 	   << " bins in theta and phi for all polarizations." << G4endl;
@@ -352,6 +396,7 @@ void G4LatticeLogical::FillMaps() {
 
 G4ThreeVector G4LatticeLogical::MapKtoVg(G4int mode,
 					 const G4ThreeVector& k) const {
+  G4CMP_PROFILE_SCOPE("G4LatticeLogical::MapKtoVg");
   return ( (fpPhononKin && G4CMPConfigManager::UseKVSolver())
 	   ? ComputeKtoVg(mode,k)
 	   : LookupKtoVg(mode,k) );
@@ -439,6 +484,7 @@ G4LatticeLogical::FindLookupBins(const G4ThreeVector& k,
 
 G4ThreeVector 
 G4LatticeLogical::MapPtoV_el(G4int ivalley, const G4ThreeVector& p_e) const {
+  G4CMP_PROFILE_SCOPE("G4LatticeLogical::MapPtoV_el");
 #ifdef G4CMP_DEBUG
   if (verboseLevel>1)
     G4cout << "G4LatticeLogical::MapPtoV_el " << ivalley << " " << p_e << G4endl;
@@ -449,6 +495,7 @@ G4LatticeLogical::MapPtoV_el(G4int ivalley, const G4ThreeVector& p_e) const {
 
 G4ThreeVector 
 G4LatticeLogical::MapV_elToP(G4int ivalley, const G4ThreeVector& v_e) const {
+  G4CMP_PROFILE_SCOPE("G4LatticeLogical::MapV_elToP");
 #ifdef G4CMP_DEBUG
   if (verboseLevel>1)
     G4cout << "G4LatticeLogical::MapV_elToP " << ivalley << " " << v_e << G4endl;
@@ -472,6 +519,7 @@ G4LatticeLogical::MapV_elToP(G4int ivalley, const G4ThreeVector& v_e) const {
 
 G4ThreeVector 
 G4LatticeLogical::MapPToP_Q(G4int ivalley, const G4ThreeVector& P) const {
+  G4CMP_PROFILE_SCOPE("G4LatticeLogical::MapPToP_Q");
 #ifdef G4CMP_DEBUG
   if (verboseLevel>1)
     G4cout << "G4LatticeLogical::MapPToP_Q " << ivalley << " " << P
@@ -491,6 +539,7 @@ G4LatticeLogical::MapPToP_Q(G4int ivalley, const G4ThreeVector& P) const {
 
 G4ThreeVector 
 G4LatticeLogical::MapP_QToP(G4int ivalley, const G4ThreeVector& P_Q) const {
+  G4CMP_PROFILE_SCOPE("G4LatticeLogical::MapP_QToP");
 #ifdef G4CMP_DEBUG
   if (verboseLevel>1)
     G4cout << "G4LatticeLogical::MapP_QToP " << ivalley << " " << P_Q << G4endl;
@@ -509,6 +558,7 @@ G4LatticeLogical::MapP_QToP(G4int ivalley, const G4ThreeVector& P_Q) const {
 
 G4ThreeVector
 G4LatticeLogical::MapV_elToK(G4int ivalley, const G4ThreeVector &v_e) const {
+  G4CMP_PROFILE_SCOPE("G4LatticeLogical::MapV_elToK");
 #ifdef G4CMP_DEBUG
   if (verboseLevel>1)
     G4cout << "G4LatticeLogical::MapV_elToK " << ivalley << " " << v_e << G4endl;
@@ -520,6 +570,7 @@ G4LatticeLogical::MapV_elToK(G4int ivalley, const G4ThreeVector &v_e) const {
 
 G4ThreeVector 
 G4LatticeLogical::MapPtoK(G4int ivalley, const G4ThreeVector& p_e) const {
+  G4CMP_PROFILE_SCOPE("G4LatticeLogical::MapPtoK");
 #ifdef G4CMP_DEBUG
   if (verboseLevel>1)
     G4cout << "G4LatticeLogical::MapPtoK " << ivalley << " " << p_e << G4endl;
@@ -537,6 +588,7 @@ G4LatticeLogical::MapPtoK(G4int ivalley, const G4ThreeVector& p_e) const {
 
 G4ThreeVector
 G4LatticeLogical::MapKtoP(G4int ivalley, const G4ThreeVector& k) const {
+  G4CMP_PROFILE_SCOPE("G4LatticeLogical::MapKtoP");
 #ifdef G4CMP_DEBUG
   if (verboseLevel>1)
     G4cout << "G4LatticeLogical::MapKtoP " << ivalley << " " << k << G4endl;
@@ -561,6 +613,7 @@ G4LatticeLogical::MapKtoP(G4int ivalley, const G4ThreeVector& k) const {
 
 G4double  
 G4LatticeLogical::MapP_QtoEkin(G4int iv, const G4ThreeVector& p) const {
+  G4CMP_PROFILE_SCOPE("G4LatticeLogical::MapP_QtoEkin");
 #ifdef G4CMP_DEBUG
   if (verboseLevel>1)
     G4cout << "G4LatticeLogical::MapP_QtoEkin " << iv << " " << p << G4endl;
@@ -578,6 +631,7 @@ G4LatticeLogical::MapP_QtoEkin(G4int iv, const G4ThreeVector& p) const {
 
 G4ThreeVector
 G4LatticeLogical::MapEkintoP(G4int iv, const G4ThreeVector& pdir, const G4double Ekin) const {
+  G4CMP_PROFILE_SCOPE("G4LatticeLogical::MapEkintoP");
 #ifdef G4CMP_DEBUG
   if (verboseLevel>1)
     G4cout << "G4LatticeLogical::MapEkintoP " << iv << " " << pdir << " " << Ekin << G4endl;
@@ -602,6 +656,7 @@ G4LatticeLogical::MapEkintoP(G4int iv, const G4ThreeVector& pdir, const G4double
 
 G4double  
 G4LatticeLogical::MapPtoEkin(G4int iv, const G4ThreeVector& p) const {
+  G4CMP_PROFILE_SCOPE("G4LatticeLogical::MapPtoEkin");
 #ifdef G4CMP_DEBUG
   if (verboseLevel>1)
     G4cout << "G4LatticeLogical::MapPtoEkin " << iv << " " << p << G4endl;
@@ -632,6 +687,7 @@ G4LatticeLogical::MapPtoEkin(G4int iv, const G4ThreeVector& p) const {
 
 G4double
 G4LatticeLogical::MapV_elToEkin(G4int iv, const G4ThreeVector& v) const {
+  G4CMP_PROFILE_SCOPE("G4LatticeLogical::MapV_elToEkin");
 #ifdef G4CMP_DEBUG
   if (verboseLevel>1)
     G4cout << "G4LatticeLogical::MapV_elToEkin " << iv << " " << v << G4endl;
@@ -1100,3 +1156,205 @@ void G4LatticeLogical::DumpList(std::ostream& os,
 
   os << unit;
 }
+
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+
+// Binary "compiled" lattice, with parameters and tables in internal units
+
+namespace {
+  const char compiledMagic[8] = { 'G','4','C','M','P','L','A','T' };
+
+  template <class T> void writeValue(std::ostream& os, const T& value) {
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <class T> G4bool readValue(std::istream& is, T& value) {
+    return (G4bool)is.read(reinterpret_cast<char*>(&value), sizeof(T));
+  }
+
+  void writeVector(std::ostream& os, const G4ThreeVector& v) {
+    writeValue(os, v.x()); writeValue(os, v.y()); writeValue(os, v.z());
+  }
+
+  G4bool readVector(std::istream& is, G4ThreeVector& v) {
+    G4double x=0., y=0., z=0.;
+    G4bool good = readValue(is, x) && readValue(is, y) && readValue(is, z);
+    v.set(x, y, z);
+    return good;
+  }
+
+  void writeMatrix(std::ostream& os, const G4RotationMatrix& mat) {
+    const G4Rep3x3 rep = mat.rep3x3();
+    const G4double elem[9] = { rep.xx_, rep.xy_, rep.xz_, rep.yx_, rep.yy_,
+			       rep.yz_, rep.zx_, rep.zy_, rep.zz_ };
+    os.write(reinterpret_cast<const char*>(elem), sizeof(elem));
+  }
+
+  G4bool readMatrix(std::istream& is, G4RotationMatrix& mat) {
+    G4double e[9];
+    if (!is.read(reinterpret_cast<char*>(e), sizeof(e))) return false;
+    mat = G4RotationMatrix(G4Rep3x3(e[0],e[1],e[2],e[3],e[4],e[5],
+				    e[6],e[7],e[8]));
+    return true;
+  }
+
+  void writeList(std::ostream& os, const std::vector<G4double>& vlist) {
+    writeValue<uint32_t>(os, vlist.size());
+    os.write(reinterpret_cast<const char*>(vlist.data()),
+	     vlist.size()*sizeof(G4double));
+  }
+
+  G4bool readList(std::istream& is, std::vector<G4double>& vlist) {
+    uint32_t n = 0;
+    if (!readValue(is, n) || n > 1024) return false;
+    vlist.resize(n);
+    return (G4bool)is.read(reinterpret_cast<char*>(vlist.data()),
+			   n*sizeof(G4double));
+  }
+
+  void writeString(std::ostream& os, const G4String& str) {
+    writeValue<uint32_t>(os, str.size());
+    os.write(str.data(), str.size());
+  }
+
+  G4bool readString(std::istream& is, G4String& str) {
+    uint32_t n = 0;
+    if (!readValue(is, n) || n > 1024) return false;
+    std::vector<char> buf(n);
+    if (!is.read(buf.data(), n)) return false;
+    str.assign(buf.data(), n);
+    return true;
+  }
+}
+
+// Scalar parameters, in order written; add new parameters at end, and
+// change COMPILED_VERSION
+
+std::vector<G4double*> G4LatticeLogical::CompiledParameters() {
+  return { &fDensity, &fNImpurity, &fPermittivity, &fA, &fB, &fLDOS, &fSTDOS,
+	   &fFTDOS, &fTTFrac, &fBeta, &fGamma, &fLambda, &fMu, &fDebye,
+	   &fVSound, &fVTrans, &fL0_e, &fL0_h, &fHoleMass, &fElectronMass,
+	   &fElectronMDOS, &fBandGap, &fPairEnergy, &fFanoFactor, &fAlpha,
+	   &fAcDeform_e, &fAcDeform_h, &fIVQuadField, &fIVQuadRate,
+	   &fIVQuadExponent, &fIVLinExponent, &fIVLinRate0, &fIVLinRate1 };
+}
+
+G4bool G4LatticeLogical::WriteCompiled(std::ostream& os) const {
+  os.write(compiledMagic, sizeof(compiledMagic));
+  writeValue<uint32_t>(os, COMPILED_VERSION);	// Also detects byte order
+  writeValue<uint32_t>(os, G4PhononPolarization::NUM_MODES);
+  writeValue<uint32_t>(os, KVBINS);
+
+  writeString(os, fName);
+  writeValue<int32_t>(os, fCrystal.group);
+  for (const G4ThreeVector& axis: fCrystal.axis) writeVector(os, axis);
+  for (const G4ThreeVector& basis: fBasis) writeVector(os, basis);
+
+  writeValue<uint8_t>(os, fHasElasticity);
+  os.write(reinterpret_cast<const char*>(fElReduced), sizeof(fElReduced));
+
+  // Parameter list doesn't modify lattice, but is shared with reading
+  G4LatticeLogical* self = const_cast<G4LatticeLogical*>(this);
+  for (G4double* par: self->CompiledParameters()) writeValue(os, *par);
+
+  writeMatrix(os, fMassTensor);
+  writeMatrix(os, fMassInverse);
+  writeMatrix(os, fMassRatioSqrt);
+  writeMatrix(os, fMInvRatioSqrt);
+
+  writeValue<uint32_t>(os, fValley.size());
+  for (size_t iv=0; iv<fValley.size(); iv++) {
+    writeMatrix(os, fValley[iv]);
+    writeMatrix(os, fValleyInv[iv]);
+    writeVector(os, fValleyAxis[iv]);
+  }
+
+  writeList(os, fIVDeform);
+  writeList(os, fIVEnergy);
+  writeString(os, fIVModel);
+
+  // K-Vg table is only valid for the density used to fill it
+  writeValue(os, fKVMapDensity);
+  if (fKVMapDensity > 0.) {
+    std::vector<G4double> buf;
+    buf.reserve(3*KVBINS*KVBINS);
+    for (G4int mode=0; mode<G4PhononPolarization::NUM_MODES; mode++) {
+      buf.clear();
+      for (G4int i=0; i<KVBINS; i++) {
+	for (G4int j=0; j<KVBINS; j++) {
+	  const G4ThreeVector& vg = fKVMap[mode][i][j];
+	  buf.push_back(vg.x()); buf.push_back(vg.y()); buf.push_back(vg.z());
+	}
+      }
+      os.write(reinterpret_cast<const char*>(buf.data()),
+	       buf.size()*sizeof(G4double));
+    }
+  }
+
+  return os.good();
+}
+
+G4bool G4LatticeLogical::ReadCompiled(std::istream& is) {
+  char magic[sizeof(compiledMagic)];
+  uint32_t version=0, nModes=0, nBins=0;
+  if (!is.read(magic, sizeof(magic)) ||
+      memcmp(magic, compiledMagic, sizeof(magic)) != 0 ||
+      !readValue(is, version) || version != COMPILED_VERSION ||
+      !readValue(is, nModes) || nModes != G4PhononPolarization::NUM_MODES ||
+      !readValue(is, nBins) || nBins != KVBINS) return false;
+
+  int32_t group = 0;
+  uint8_t hasEl = 0;
+  G4bool good = (readString(is, fName) && readValue(is, group) &&
+		 readVector(is, fCrystal.axis[0]) &&
+		 readVector(is, fCrystal.axis[1]) &&
+		 readVector(is, fCrystal.axis[2]) &&
+		 readVector(is, fBasis[0]) && readVector(is, fBasis[1]) &&
+		 readVector(is, fBasis[2]) && readValue(is, hasEl) &&
+		 is.read(reinterpret_cast<char*>(fElReduced),
+			 sizeof(fElReduced)));
+  fCrystal.group = G4CMPCrystalGroup::Bravais(group);
+  fHasElasticity = hasEl;
+
+  for (G4double* par: CompiledParameters()) good = good && readValue(is, *par);
+
+  good = (good && readMatrix(is, fMassTensor) &&
+	  readMatrix(is, fMassInverse) && readMatrix(is, fMassRatioSqrt) &&
+	  readMatrix(is, fMInvRatioSqrt));
+
+  uint32_t nValley = 0;
+  good = good && readValue(is, nValley) && nValley <= 1024;
+  ClearValleys();
+  for (uint32_t iv=0; good && iv<nValley; iv++) {
+    fValley.emplace_back();
+    fValleyInv.emplace_back();
+    fValleyAxis.emplace_back();
+    good = (readMatrix(is, fValley.back()) &&
+	    readMatrix(is, fValleyInv.back()) &&
+	    readVector(is, fValleyAxis.back()));
+  }
+
+  G4String ivModel;
+  good = (good && readList(is, fIVDeform) && readList(is, fIVEnergy) &&
+	  readString(is, ivModel) && readValue(is, fKVMapDensity));
+  if (!ivModel.empty()) fIVModel = ivModel;
+
+  if (good && fKVMapDensity > 0.) {
+    std::vector<G4double> buf(3*KVBINS*KVBINS);
+    for (G4int mode=0; good && mode<G4PhononPolarization::NUM_MODES; mode++) {
+      good = (G4bool)is.read(reinterpret_cast<char*>(buf.data()),
+			     buf.size()*sizeof(G4double));
+
+      const G4double* vg = buf.data();
+      for (G4int i=0; i<KVBINS; i++) {
+	for (G4int j=0; j<KVBINS; j++, vg+=3) {
+	  fKVMap[mode][i][j].set(vg[0], vg[1], vg[2]);
+	}
+      }
+    }
+  }
+
+  if (!good) fKVMapDensity = 0.;	// Don't trust partial table
+  return good;
+}
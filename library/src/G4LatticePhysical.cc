@@ -27,6 +27,8 @@
 // 20211021  Wrap verbose output in #ifdef G4CMP_DEBUG for performace
 // 20220921  G4CMP-319 -- Add utilities for thermal (Maxwellian) distributions
 // 20250507  G4CMP-480 -- Swap rotation matrix for local<-->lattice transforms.
+// 20261019  Use precomputed valley transforms in local frame for electron
+//		mappings, without thread-local buffer; add batch mappings.
 
 #include "G4LatticePhysical.hh"
 #include "G4CMPConfigManager.hh"
@@ -49,7 +51,9 @@ namespace {
 
 G4LatticePhysical::G4LatticePhysical()
   : verboseLevel(0), fLattice(0), hMiller(0), kMiller(0), lMiller(0),
-    fRot(0.), fTemperature(-1.) {;}
+    fRot(0.), fTemperature(-1.) {
+  FillValleyFrames();
+}
 
 // Set lattice orientation (relative to G4VSolid) with Miller indices
 
@@ -86,6 +90,8 @@ void G4LatticePhysical::SetMillerOrientation(G4int h, G4int k, G4int l,
 
   if (verboseLevel>1) G4cout << " fOrient = " << fOrient << G4endl;
 
+  FillValleyFrames();
+
   // FIXME:  Is this equivalent to (phi,theta,rot) Euler angles???
 }
 
@@ -112,6 +118,55 @@ G4LatticePhysical::RotateToSolid(G4ThreeVector& dir) const {
   return dir.transform(fOrient);
 }
 
+void G4LatticePhysical::RotateToLattice(std::vector<G4ThreeVector>& dirs) const {
+  for (G4ThreeVector& dir: dirs) dir.transform(fInverse);
+}
+
+void G4LatticePhysical::RotateToSolid(std::vector<G4ThreeVector>& dirs) const {
+  for (G4ThreeVector& dir: dirs) dir.transform(fOrient);
+}
+
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+
+// Combine lattice orientation with valley rotations and mass tensors, so
+// that electron mappings need one matrix multiplication in local frame
+
+void G4LatticePhysical::FillValleyFrames() {
+  fValleyFrames.clear();
+
+  G4int nValley = fLattice ? fLattice->NumberOfValleys() : 0;
+  fValleyFrames.resize(nValley+1);	// Last entry for invalid index
+
+  for (G4int iv=0; iv<=nValley; iv++) {
+    ValleyFrame& frame = fValleyFrames[iv];
+
+    // Logical lattice uses identity valley rotation for invalid index
+    frame.toValley = (iv<nValley ? fLattice->GetValley(iv) : G4RotationMatrix())
+      * fInverse;
+    frame.fromValley = fOrient
+      * (iv<nValley ? fLattice->GetValleyInv(iv) : G4RotationMatrix());
+
+    if (!fLattice) continue;		// Mass tensors not yet available
+
+    frame.mass = frame.fromValley * fLattice->GetMassTensor() * frame.toValley;
+    frame.mInv = frame.fromValley * fLattice->GetMInvTensor() * frame.toValley;
+    frame.toHV = fLattice->GetSqrtInvTensor() * frame.toValley;
+    frame.fromHV = frame.fromValley * fLattice->GetSqrtTensor();
+  }
+
+#ifdef G4CMP_DEBUG
+  if (verboseLevel>1) {
+    G4cout << "G4LatticePhysical::FillValleyFrames " << nValley
+	   << " valleys" << G4endl;
+    for (G4int iv=0; iv<nValley; iv++) {
+      G4cout << " valley " << iv << " mInv " << fValleyFrames[iv].mInv
+	     << G4endl;
+    }
+  }
+#endif
+}
+
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
 
@@ -123,12 +178,12 @@ G4double G4LatticePhysical::MapKtoV(G4int mode, const G4ThreeVector& k) const {
   if (verboseLevel>1) G4cout << "G4LatticePhysical::MapKtoV " << k << G4endl;
 #endif
 
-  RotateToLattice(tempvec()=k);
+  G4ThreeVector klat = fInverse*k;
 #ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " in lattice frame " << tempvec() << G4endl;
+  if (verboseLevel>1) G4cout << " in lattice frame " << klat << G4endl;
 #endif
 
-  return fLattice->MapKtoV(mode, tempvec());
+  return fLattice->MapKtoV(mode, klat);
 }
 
 ///////////////////////////////
@@ -139,14 +194,14 @@ G4ThreeVector G4LatticePhysical::MapKtoVDir(G4int mode, const G4ThreeVector& k)
   if (verboseLevel>1) G4cout << "G4LatticePhysical::MapKtoVDir " << k << G4endl;
 #endif
 
-  RotateToLattice(tempvec()=k);
+  G4ThreeVector klat = fInverse*k;
 #ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " in lattice frame " << tempvec() << G4endl;
+  if (verboseLevel>1) G4cout << " in lattice frame " << klat << G4endl;
 #endif
 
-  G4ThreeVector VG = fLattice->MapKtoVDir(mode, tempvec());
+  G4ThreeVector VG = fLattice->MapKtoVDir(mode, klat);
 #ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " VDir (lattice) " << tempvec() << G4endl;
+  if (verboseLevel>1) G4cout << " VDir (lattice) " << VG << G4endl;
 #endif
 
   return RotateToSolid(VG);
@@ -154,6 +209,9 @@ G4ThreeVector G4LatticePhysical::MapKtoVDir(G4int mode, const G4ThreeVector& k)
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
 
+// Electron energy-momentum relations use mass tensor in local frame,
+// <p|M|p> = <p|R D^-1 M D R^-1|p>, rather than rotating p to the valley
+
 G4ThreeVector
 G4LatticePhysical::MapEkintoP(G4int iv, const G4ThreeVector& pdir, const G4double Ekin) const {
 #ifdef G4CMP_DEBUG
@@ -161,17 +219,16 @@ G4LatticePhysical::MapEkintoP(G4int iv, const G4ThreeVector& pdir, const G4doubl
     G4cout << "G4LatticePhysical::MapEkintoP " << iv << " " << pdir << " " << Ekin << G4endl;
 #endif
 
-  RotateToLattice(tempvec()=pdir);
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " in lattice frame " << tempvec() << G4endl;
-#endif
+  const G4double mass = GetElectronMass();
+  G4double bandP = pdir.dot(GetValleyMassTensor(iv)*pdir);
+  G4double PMag = sqrt(mass*(Ekin*Ekin+2.*Ekin*mass*c_squared)/bandP);
 
-  G4ThreeVector p = fLattice->MapEkintoP(iv, tempvec(), Ekin);
 #ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " P (lattice) " << tempvec() << G4endl;
+  if (verboseLevel>1)
+    G4cout << " <pdir|M|pdir> " << bandP << " PMag " << PMag << G4endl;
 #endif
 
-  return RotateToSolid(p);
+  return pdir*PMag;
 }
 
 G4double G4LatticePhysical::MapPtoEkin(G4int iv, const G4ThreeVector& p) const {
@@ -180,16 +237,17 @@ G4double G4LatticePhysical::MapPtoEkin(G4int iv, const G4ThreeVector& p) const {
     G4cout << "G4LatticePhysical::MapPtoEkin " << iv << " " << p << G4endl;
 #endif
 
-  RotateToLattice(tempvec()=p);
+  const G4double mc2 = GetElectronMass()*c_squared;
+  G4double bandP = p.dot(GetValleyMassTensor(iv)*p);
+
 #ifdef G4CMP_DEBUG
   if (verboseLevel>1) {
-    G4cout << " in lattice frame " << tempvec() << G4endl
-	   << " returning Ekin " << fLattice->MapPtoEkin(iv, tempvec())
-	   << G4endl;
+    G4cout << " <P|M|P> " << bandP << " returning Ekin "
+	   << sqrt(bandP/GetElectronMass() + mc2*mc2) - mc2 << G4endl;
   }
 #endif
 
-  return fLattice->MapPtoEkin(iv, tempvec());
+  return sqrt(bandP/GetElectronMass() + mc2*mc2) - mc2;
 }
 
 G4double G4LatticePhysical::MapV_elToEkin(G4int iv, const G4ThreeVector& v) const {
@@ -198,16 +256,7 @@ G4double G4LatticePhysical::MapV_elToEkin(G4int iv, const G4ThreeVector& v) cons
     G4cout << "G4LatticePhysical::MapV_elToEkin " << iv << " " << v << G4endl;
 #endif
 
-  RotateToLattice(tempvec()=v);
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>1) {
-    G4cout << " in lattice frame " << tempvec() << G4endl
-	   << " returning Ekin " << fLattice->MapV_elToEkin(iv, tempvec())
-	   << G4endl;
-  }
-#endif
-
-  return fLattice->MapV_elToEkin(iv, tempvec());
+  return MapPtoEkin(iv, MapV_elToP(iv, v));
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
@@ -222,17 +271,7 @@ G4LatticePhysical::MapPtoV_el(G4int ivalley, const G4ThreeVector& p_e) const {
 	   << G4endl;
 #endif
 
-  RotateToLattice(tempvec()=p_e);
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " in lattice frame " << tempvec() << G4endl;
-#endif
-
-  tempvec() = fLattice->MapPtoV_el(ivalley, tempvec());
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " V_el (lattice) " << tempvec() << G4endl;
-#endif
-
-  return RotateToSolid(tempvec());
+  return p_e*c_light/(MapPtoEkin(ivalley,p_e) + GetElectronMass()*c_squared);
 }
 
 G4ThreeVector 
@@ -243,17 +282,16 @@ G4LatticePhysical::MapV_elToP(G4int ivalley, const G4ThreeVector& v_e) const {
 	   << G4endl;
 #endif
 
-  RotateToLattice(tempvec()=v_e);
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " in lattice frame " << tempvec() << G4endl;
-#endif
+  // Same expression as G4LatticeLogical::MapV_elToP()
+  G4double bandV = v_e.dot(GetValleyMassTensor(ivalley)*v_e);
+  G4double gamma = 1/sqrt(1-bandV/GetElectronMass()*c_squared);
 
-  tempvec() = fLattice->MapV_elToP(ivalley, tempvec());
 #ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " p (lattice) " << tempvec() << G4endl;
+  if (verboseLevel>1)
+    G4cout << " <v|M|v> " << bandV << " gamma " << gamma << G4endl;
 #endif
 
-  return RotateToSolid(tempvec());
+  return gamma*GetElectronMass()*c_light*v_e;
 }
 
 G4ThreeVector 
@@ -264,17 +302,7 @@ G4LatticePhysical::MapPToP_Q(G4int ivalley, const G4ThreeVector& P) const {
 	   << G4endl;
 #endif
 
-  RotateToLattice(tempvec()=P);
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " in lattice frame " << tempvec() << G4endl;
-#endif
-
-  tempvec() = fLattice->MapPToP_Q(ivalley, tempvec());
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " p_q (lattice) " << tempvec() << G4endl;
-#endif
-
-  return RotateToSolid(tempvec());
+  return GetValleyMassTensor(ivalley)*P / GetElectronMass();
 }
 
 G4ThreeVector 
@@ -285,17 +313,7 @@ G4LatticePhysical::MapP_QToP(G4int ivalley, const G4ThreeVector& P_Q) const {
 	   << G4endl;
 #endif
 
-  RotateToLattice(tempvec()=P_Q);
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " in lattice frame " << tempvec() << G4endl;
-#endif
-
-  tempvec() = fLattice->MapP_QToP(ivalley, tempvec());
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " p (lattice) " << tempvec() << G4endl;
-#endif
-
-  return RotateToSolid(tempvec());
+  return GetValleyMInvTensor(ivalley)*P_Q * GetElectronMass();
 }
 
 G4ThreeVector
@@ -306,17 +324,7 @@ G4LatticePhysical::MapV_elToK(G4int ivalley, const G4ThreeVector& v_e) const {
      << G4endl;
 #endif
 
-  RotateToLattice(tempvec()=v_e);
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " in lattice frame " << tempvec() << G4endl;
-#endif
-
-  tempvec() = fLattice->MapV_elToK(ivalley, tempvec());
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " K (lattice) " << tempvec() << G4endl;
-#endif
-
-  return RotateToSolid(tempvec());
+  return MapPtoK(ivalley, MapV_elToP(ivalley, v_e));
 }
 
 G4ThreeVector 
@@ -326,18 +334,8 @@ G4LatticePhysical::MapPtoK(G4int ivalley, const G4ThreeVector& p_e) const {
     G4cout << "G4LatticePhysical::MapPtoK " << ivalley << " " << p_e
      << G4endl;
 #endif
-  
-  RotateToLattice(tempvec()=p_e);
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " in lattice frame " << tempvec() << G4endl;
-#endif
-  
-  tempvec() = fLattice->MapPtoK(ivalley, tempvec());
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " k (lattice) " << tempvec() << G4endl;
-#endif
 
-  return RotateToSolid(tempvec());
+  return GetValleyMassTensor(ivalley)*p_e / (GetElectronMass()*hbarc);
 }
 
 G4ThreeVector 
@@ -347,18 +345,8 @@ G4LatticePhysical::MapKtoP(G4int ivalley, const G4ThreeVector& k) const {
     G4cout << "G4LatticePhysical::MapKtoP " << ivalley << " " << k
      << G4endl;
 #endif
-    
-  RotateToLattice(tempvec()=k);
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " in lattice frame " << tempvec() << G4endl;
-#endif
-    
-  tempvec() = fLattice->MapKtoP(ivalley, tempvec());
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " p (lattice) " << tempvec() << G4endl;
-#endif
 
-  return RotateToSolid(tempvec());
+  return GetValleyMInvTensor(ivalley)*k * (GetElectronMass()*hbarc);
 }
 
 G4double 
@@ -370,12 +358,8 @@ G4LatticePhysical::GetElectronEffectiveMass(G4int iv,
 	   << " " << p << G4endl;
 #endif
 
-  RotateToLattice(tempvec()=p);
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " in lattice frame " << tempvec() << G4endl;
-#endif
-
-  return fLattice->GetElectronEffectiveMass(iv, tempvec());
+  G4double Ekin = MapPtoEkin(iv, p);
+  return (p.mag2()-Ekin*Ekin)/(2.*Ekin*c_squared);	// Relativistic
 }
 
 G4ThreeVector
@@ -385,14 +369,9 @@ G4LatticePhysical::RotateToValley(G4int iv, const G4ThreeVector& v) const {
     G4cout << "G4LatticePhysical::RotateToValley " << iv
 	   << " " << v << G4endl;
 #endif
-  
-    RotateToLattice(tempvec()=v);
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " in lattice frame " << tempvec() << G4endl;
-#endif
-    
-    return fLattice->RotateToValley(iv, tempvec());
-  }
+
+  return GetValleyFrame(iv).toValley*v;
+}
 
 G4ThreeVector
 G4LatticePhysical::RotateFromValley(G4int iv, const G4ThreeVector& v) const {
@@ -402,8 +381,7 @@ G4LatticePhysical::RotateFromValley(G4int iv, const G4ThreeVector& v) const {
 	   << " " << v << G4endl;
 #endif
 
-  tempvec() = fLattice->RotateFromValley(iv, v);
-  return RotateToSolid(tempvec());
+  return GetValleyFrame(iv).fromValley*v;
 }
 
 G4ThreeVector G4LatticePhysical::
@@ -414,13 +392,7 @@ EllipsoidalToSphericalTranformation(G4int iv, const G4ThreeVector& v) const {
 	   << " " << v << G4endl;
 #endif
 
-  RotateToLattice(tempvec()=v);
-
-#ifdef G4CMP_DEBUG
-  if (verboseLevel>1) G4cout << " in lattice frame " << tempvec() << G4endl;
-#endif
-
-  return fLattice->EllipsoidalToSphericalTranformation(iv, tempvec());
+  return GetValleyToHV(iv)*v;
 }
 
 // Compute vector in ellipsoidal frame from the spherical frame
@@ -433,8 +405,76 @@ SphericalToEllipsoidalTranformation(G4int iv, const G4ThreeVector& v) const {
     << " " << v << G4endl;
 #endif
 
-  tempvec() = fLattice->SphericalToEllipsoidalTranformation(iv, v);
-  return RotateToSolid(tempvec());
+  return GetValleyFromHV(iv)*v;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+
+// Batch mappings, with valley transforms looked up once
+
+void G4LatticePhysical::MapPtoV_el(G4int iv,
+				   const std::vector<G4ThreeVector>& p_e,
+				   std::vector<G4ThreeVector>& v_el) const {
+  const G4RotationMatrix& mass = GetValleyMassTensor(iv);
+  const G4double m = GetElectronMass();
+  const G4double mc2 = m*c_squared;
+
+  v_el.resize(p_e.size());
+  for (size_t i=0; i<p_e.size(); i++) {
+    G4double Etot = sqrt(p_e[i].dot(mass*p_e[i])/m + mc2*mc2);
+    v_el[i] = p_e[i]*(c_light/Etot);
+  }
+}
+
+void G4LatticePhysical::MapPtoK(G4int iv, const std::vector<G4ThreeVector>& p_e,
+				std::vector<G4ThreeVector>& k) const {
+  const G4RotationMatrix& mass = GetValleyMassTensor(iv);
+  const G4double scale = 1./(GetElectronMass()*hbarc);
+
+  k.resize(p_e.size());
+  for (size_t i=0; i<p_e.size(); i++) k[i] = mass*p_e[i] * scale;
+}
+
+void G4LatticePhysical::MapKtoP(G4int iv, const std::vector<G4ThreeVector>& k,
+				std::vector<G4ThreeVector>& p_e) const {
+  const G4RotationMatrix& mInv = GetValleyMInvTensor(iv);
+  const G4double scale = GetElectronMass()*hbarc;
+
+  p_e.resize(k.size());
+  for (size_t i=0; i<k.size(); i++) p_e[i] = mInv*k[i] * scale;
+}
+
+void G4LatticePhysical::MapPtoEkin(G4int iv,
+				   const std::vector<G4ThreeVector>& p_e,
+				   std::vector<G4double>& Ekin) const {
+  const G4RotationMatrix& mass = GetValleyMassTensor(iv);
+  const G4double m = GetElectronMass();
+  const G4double mc2 = m*c_squared;
+
+  Ekin.resize(p_e.size());
+  for (size_t i=0; i<p_e.size(); i++) {
+    Ekin[i] = sqrt(p_e[i].dot(mass*p_e[i])/m + mc2*mc2) - mc2;
+  }
+}
+
+void G4LatticePhysical::
+EllipsoidalToSphericalTranformation(G4int iv,
+				    const std::vector<G4ThreeVector>& v,
+				    std::vector<G4ThreeVector>& vHV) const {
+  const G4RotationMatrix& toHV = GetValleyToHV(iv);
+
+  vHV.resize(v.size());
+  for (size_t i=0; i<v.size(); i++) vHV[i] = toHV*v[i];
+}
+
+void G4LatticePhysical::
+SphericalToEllipsoidalTranformation(G4int iv,
+				    const std::vector<G4ThreeVector>& vHV,
+				    std::vector<G4ThreeVector>& v) const {
+  const G4RotationMatrix& fromHV = GetValleyFromHV(iv);
+
+  v.resize(vHV.size());
+  for (size_t i=0; i<vHV.size(); i++) v[i] = fromHV*vHV[i];
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
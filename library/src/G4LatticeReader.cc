@@ -35,6 +35,8 @@
 // 20231017  E. Michaud -- Add 'valleyDir' to set rotation matrix with valley's
 //		 direction instead of euler angles
 // 20240131  J. Inman -- Multiple path selection on G4LATTICEDATA variable
+// 20261019  Use binary "compiled" lattice if newer than config file; add
+//		CompileLattice() to write one.
 
 #include "G4LatticeReader.hh"
 #include "G4CMPConfigManager.hh"
@@ -50,6 +52,7 @@
 #include <limits>
 #include <regex>
 #include <stdlib.h>
+#include <sys/stat.h>
 
 
 // Constructor and destructor
@@ -57,7 +60,7 @@
 G4LatticeReader::G4LatticeReader(G4int vb)
   : verboseLevel(vb?vb:G4CMPConfigManager::GetVerboseLevel()),
     psLatfile(0), pLattice(0), fToken(""), fValue(0.), f3Vec(0.,0.,0.),
-    fDataDir(G4CMPConfigManager::GetLatticeDir()),
+    fDataDir(G4CMPConfigManager::GetLatticeDir()), fHasIVModel(false),
     mElectron(electron_mass_c2/c_squared) {
   G4CMPUnitsTable::Init();  // Ensures thread-by-thread initialization
 }
@@ -80,7 +83,24 @@ G4LatticeLogical* G4LatticeReader::MakeLattice(const G4String& filename) {
     return 0;
   }
 
+  // Precomputed lattice skips parsing and filling tables
+  G4String binfile = CompiledName(fFilePath);
+  if (UseCompiled(fFilePath, binfile)) {
+    pLattice = ReadCompiled(binfile);
+    if (pLattice) {
+      CloseFile();
+      return pLattice;
+    }
+  }
+
+  return ParseFile(filename);
+}
+
+// Fill new lattice from text file opened by OpenFile()
+
+G4LatticeLogical* G4LatticeReader::ParseFile(const G4String& filename) {
   pLattice = new G4LatticeLogical;	// Create lattice to be filled
+  fHasIVModel = false;
 
   G4bool goodLattice = true;
   while (!psLatfile->eof()) {
@@ -111,6 +131,7 @@ G4bool G4LatticeReader::OpenFile(const G4String& filename) {
     G4cout << "G4LatticeReader::OpenFile " << filename << G4endl;
 
   G4String filepath = filename;
+  fFilePath = filename;
   psLatfile = new std::ifstream(filepath);
   if (!psLatfile->good()) { 		// Local file not found
     G4Tokenizer nextpath(fDataDir);
@@ -120,6 +141,7 @@ G4bool G4LatticeReader::OpenFile(const G4String& filename) {
       psLatfile->open(filepath);      // Try data directory
       if (psLatfile->good()) {
         if (verboseLevel>1) G4cout << " Found file " << filepath << G4endl;
+        fFilePath = filepath;
         return true;
       }
       psLatfile->close();
@@ -140,6 +162,95 @@ void G4LatticeReader::CloseFile() {
 }
 
 
+// Binary lattice, written by CompileLattice(), is name of text file
+// with ".txt" replaced by ".bin"
+
+G4String G4LatticeReader::CompiledName(const G4String& filepath) {
+  size_t ext = filepath.rfind(".txt");
+  if (ext != std::string::npos && ext+4 == filepath.size())
+    return filepath.substr(0,ext) + ".bin";
+
+  return filepath + ".bin";
+}
+
+G4bool G4LatticeReader::UseCompiled(const G4String& textfile,
+				    const G4String& binfile) const {
+  struct stat textInfo, binInfo;
+  return (stat(binfile.c_str(), &binInfo) == 0 &&
+	  stat(textfile.c_str(), &textInfo) == 0 &&
+	  binInfo.st_mtime >= textInfo.st_mtime);
+}
+
+G4LatticeLogical* G4LatticeReader::ReadCompiled(const G4String& binfile) {
+  if (verboseLevel)
+    G4cout << "G4LatticeReader::ReadCompiled " << binfile << G4endl;
+
+  std::ifstream input(binfile, std::ios::binary);
+  G4LatticeLogical* lattice = new G4LatticeLogical;
+  if (!input.good() || !lattice->ReadCompiled(input)) {
+    G4ExceptionDescription msg;
+    msg << binfile << " is not a version "
+	<< G4LatticeLogical::COMPILED_VERSION << " compiled lattice;"
+	<< " using text file";
+    G4Exception("G4LatticeReader::ReadCompiled", "Lattice004",
+		JustWarning, msg);
+    delete lattice;
+    return 0;
+  }
+
+  if (verboseLevel>1)
+    G4cout << "G4LatticeReader produced\n" << *lattice << G4endl;
+
+  return lattice;
+}
+
+// Parse text file and write lattice with tables in binary format
+
+G4bool G4LatticeReader::CompileLattice(const G4String& filename,
+				       G4double density,
+				       const G4String& outfile) {
+  if (verboseLevel)
+    G4cout << "G4LatticeReader::CompileLattice " << filename << G4endl;
+
+  if (!OpenFile(filename)) {
+    G4ExceptionDescription msg;
+    msg << "Unable to open " << filename;
+    G4Exception("G4LatticeReader::CompileLattice", "Lattice001",
+		JustWarning, msg);
+    CloseFile();
+    return false;
+  }
+
+  G4LatticeLogical* lattice = ParseFile(filename);
+  if (!lattice) return false;
+
+  // K-Vg table depends on density, which usually comes from G4Material
+  if (density > 0.) {
+    lattice->SetDensity(density);
+    lattice->Initialize();
+  }
+
+  if (!fHasIVModel) lattice->SetIVModel("");	// Use default when read
+
+  G4String binfile = outfile.empty() ? CompiledName(fFilePath) : outfile;
+  std::ofstream output(binfile, std::ios::binary|std::ios::trunc);
+  G4bool good = output.good() && lattice->WriteCompiled(output);
+  output.close();
+  delete lattice;
+
+  if (!good) {
+    G4ExceptionDescription msg;
+    msg << "Unable to write compiled lattice " << binfile;
+    G4Exception("G4LatticeReader::CompileLattice", "Lattice005",
+		JustWarning, msg);
+  } else if (verboseLevel) {
+    G4cout << " Wrote compiled lattice " << binfile << G4endl;
+  }
+
+  return good;
+}
+
+
 // Read next token from file, use it to store next data into lattice
 
 G4bool G4LatticeReader::ProcessToken() {
@@ -236,8 +347,10 @@ G4bool G4LatticeReader::ProcessString(const G4String& name) {
     G4cout << " ProcessString " << name << " " << arg << G4endl;
 
   G4bool good = true;
-  if (name == "ivmodel") pLattice->SetIVModel(arg);
-  else {
+  if (name == "ivmodel") {
+    pLattice->SetIVModel(arg);
+    fHasIVModel = true;
+  } else {
     G4cerr << "G4LatticeReader: Unrecognized token " << name << G4endl;
     good = false;
   }
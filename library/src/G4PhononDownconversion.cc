@@ -30,10 +30,14 @@
 // 20201109  Move debugging output creation to PostStepDoIt to allows settting
 //		process verbosity via macro commands.
 // 20220712  M. Kelsey -- Pass process pointer to G4CMPAnharmonicDecay
+// 20261019  Add G4CMPProfiler timing of PostStepDoIt().
+// 20261019  Use G4CMPPhononCascade above configured cascade energy.
 
 #include "G4PhononDownconversion.hh"
 #include "G4CMPAnharmonicDecay.hh"
 #include "G4CMPDownconversionRate.hh"
+#include "G4CMPPhononCascade.hh"
+#include "G4CMPProfiler.hh"
 #include "G4PhononLong.hh"
 #include "G4Step.hh"
 #include "G4Track.hh"
@@ -46,12 +50,14 @@
 
 G4PhononDownconversion::G4PhononDownconversion(const G4String& aName)
   : G4VPhononProcess(aName, fPhononDownconversion),
-    anharmonicDecay(new G4CMPAnharmonicDecay(this)) {
+    anharmonicDecay(new G4CMPAnharmonicDecay(this)),
+    phononCascade(new G4CMPPhononCascade(this)) {
   UseRateModel(new G4CMPDownconversionRate);
 }
 
 G4PhononDownconversion::~G4PhononDownconversion() {
   delete anharmonicDecay;
+  delete phononCascade;
 }
 
 
@@ -61,6 +67,9 @@ G4PhononDownconversion::~G4PhononDownconversion() {
 void G4PhononDownconversion::LoadDataForTrack(const G4Track* track) {
   G4CMPProcessUtils::LoadDataForTrack(track);
   anharmonicDecay->LoadDataForTrack(track);
+
+  if (G4CMPPhononCascade::GetThreshold() > 0.)
+    phononCascade->LoadDataForTrack(track);
 }
 
 
@@ -70,6 +79,7 @@ void G4PhononDownconversion::LoadDataForTrack(const G4Track* track) {
 void G4PhononDownconversion::SetVerboseLevel(G4int vb) {
   verboseLevel = vb;
   anharmonicDecay->SetVerboseLevel(vb);
+  phononCascade->SetVerboseLevel(vb);
 }
 
 
@@ -77,6 +87,7 @@ void G4PhononDownconversion::SetVerboseLevel(G4int vb) {
 
 G4VParticleChange* G4PhononDownconversion::PostStepDoIt(const G4Track& aTrack,
 							const G4Step& aStep) {
+  G4CMP_PROFILE_TIMER(profileDoIt);
   aParticleChange.Initialize(aTrack);
 
   G4StepPoint* postStepPoint = aStep.GetPostStepPoint();
@@ -101,7 +112,14 @@ G4VParticleChange* G4PhononDownconversion::PostStepDoIt(const G4Track& aTrack,
 	   << G4endl;
   }
 
-  anharmonicDecay->DoDecay(aTrack, aStep, aParticleChange);
+  // High-energy phonons are followed in bulk until boundary or threshold
+  if (G4CMPPhononCascade::GetThreshold() > 0. &&
+      phononCascade->IsApplicable(aTrack)) {
+    phononCascade->DoCascade(aTrack, aParticleChange);
+  } else {
+    anharmonicDecay->DoDecay(aTrack, aStep, aParticleChange);
+  }
+
   return &aParticleChange;
 }
 
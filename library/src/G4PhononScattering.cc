@@ -15,10 +15,12 @@
 // 20170805  Move GetMeanFreePath() to scattering-rate model
 // 20170819  Overwrite track's particle definition instead of killing
 // 20250129  Call FillParticleChange() to update phonon track information.
+// 20261019  Add G4CMPProfiler timing of PostStepDoIt().
 
 #include "G4PhononScattering.hh"
 #include "G4CMPPhononScatteringRate.hh"
 #include "G4CMPPhononTrackInfo.hh"
+#include "G4CMPProfiler.hh"
 #include "G4CMPSecondaryUtils.hh"
 #include "G4CMPTrackUtils.hh"
 #include "G4CMPUtils.hh"
@@ -46,6 +48,7 @@ G4PhononScattering::~G4PhononScattering() {;}
 
 G4VParticleChange* G4PhononScattering::PostStepDoIt( const G4Track& aTrack,
 						     const G4Step& aStep) {
+  G4CMP_PROFILE_TIMER(profileDoIt);
   // Initialize particle change
   aParticleChange.Initialize(aTrack);
   
@@ -0,0 +1,81 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: benchChargeCloud <Npairs> <Lattice> [N] [seed] [csvfile]
+//
+// Time N calls to G4CMPChargeCloud::Generate() for a cloud of Npairs
+// points, in the bulk of a cylindrical crystal and near a corner, where
+// points must be tested against the solid.  Arguments are the same as
+// testChargeCloud.
+//
+// Geant4 material will be set as "G4_<Lattice>".
+//
+// 20261019  New benchmark for charge cloud generation
+
+#include "globals.hh"
+#include "g4cmpBenchmark.hh"
+#include "G4CMPChargeCloud.hh"
+#include "G4LatticeLogical.hh"
+#include "G4LatticeManager.hh"
+#include "G4NistManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "G4Tubs.hh"
+#include <stdlib.h>
+#include <vector>
+
+
+// Main benchmark is here
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    G4cerr << "Usage: " << argv[0] << " <Npairs> <Lattice> [N] [seed] [csvfile]"
+	   << G4endl;
+    ::exit(1);
+  }
+
+  G4int npoints = atoi(argv[1]);
+  G4String lname = argv[2];
+  G4String mname = "G4_"+lname;
+
+  G4CMPBench::Options opt = G4CMPBench::ParseOptions(argc, argv, 3, 1000);
+
+  G4Material* mat = G4NistManager::Instance()->FindOrBuildMaterial(mname);
+  G4LatticeLogical* lat = G4LatticeManager::Instance()->LoadLattice(mat,lname);
+
+  // MUST USE 'new', SO THAT G4SolidStore CAN DELETE
+  G4Tubs* crystal = new G4Tubs("GeCrystal", 0., 5.*cm, 1.*cm, 0., 360.*deg);
+
+  G4CMPChargeCloud cloud(lat, crystal);
+  G4double rcloud = cloud.ComputeRadius(npoints);
+
+  G4cout << "G4CMPChargeCloud " << npoints << " e/h radius "
+	 << rcloud/nm << " nm" << G4endl;
+
+  const G4ThreeVector bulk(0.,0.,0.);
+  const G4ThreeVector corner(0., 5.*cm-rcloud/2., 1.*cm-rcloud/2.);
+
+  // Sum of positions is a stable checksum for a given seed
+  auto generate = [&](const G4ThreeVector& center) {
+    const std::vector<G4ThreeVector>& points = cloud.Generate(npoints, center);
+    G4double sum = 0.;
+    for (const auto& p: points) sum += (p-center).mag();
+    return sum/nm;
+  };
+
+  std::vector<G4CMPBench::Result> results;
+
+  results.push_back(G4CMPBench::Run("ChargeCloud::Generate bulk",
+				    opt.nCalls, [&](G4long) {
+      return generate(bulk);
+    }));
+
+  results.push_back(G4CMPBench::Run("ChargeCloud::Generate corner",
+				    opt.nCalls, [&](G4long) {
+      return generate(corner);
+    }));
+
+  G4CMPBench::Report("benchChargeCloud", opt, results);
+}
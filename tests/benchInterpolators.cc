@@ -0,0 +1,182 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: benchInterpolators [N] [seed] [csvfile]
+//
+// Time N lookups of G4CMPTriLinearInterp and G4CMPBiLinearInterp on
+// regular synthetic meshes (cubes split into six tetrahedra, squares
+// split into two triangles), with explicit triangulation so that QHull
+// is not required.  Lookups are done both at uncorrelated random points,
+// and along a random walk of short steps as a track would see.
+//
+// 20261019  New benchmark for mesh interpolators
+
+#include "globals.hh"
+#include "g4cmpBenchmark.hh"
+#include "G4CMPBiLinearInterp.hh"
+#include "G4CMPTriLinearInterp.hh"
+#include "G4RandomDirection.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "Randomize.hh"
+#include <vector>
+
+namespace {
+  const G4int nGrid = 40;		// Mesh points along each axis
+  const G4double side = 1.*cm;		// Size of mesh cube or square
+  const G4int nPoints = 100000;		// Number of distinct query points
+
+  // Smooth potential to fill mesh
+  G4double potential(G4double x, G4double y, G4double z=0.) {
+    return (x*y/side + 0.5*z - 0.2*x)/side * volt;
+  }
+}
+
+
+// Regular 3D mesh, using Kuhn decomposition of each cube into six tetrahedra
+
+void fill3Dmesh(std::vector<point3d>& xyz, std::vector<G4double>& v,
+		std::vector<tetra3d>& tetra) {
+  G4double step = side/(nGrid-1);
+
+  for (G4int k=0; k<nGrid; k++) {
+    for (G4int j=0; j<nGrid; j++) {
+      for (G4int i=0; i<nGrid; i++) {
+	xyz.push_back(point3d{{i*step, j*step, k*step}});
+	v.push_back(potential(i*step, j*step, k*step));
+      }
+    }
+  }
+
+  // Corner offsets for each of the six axis orderings (x,y,z permutations)
+  static const G4int perm[6][3] = { {0,1,2}, {0,2,1}, {1,0,2},
+				    {1,2,0}, {2,0,1}, {2,1,0} };
+
+  for (G4int k=0; k<nGrid-1; k++) {
+    for (G4int j=0; j<nGrid-1; j++) {
+      for (G4int i=0; i<nGrid-1; i++) {
+	for (const auto& p: perm) {
+	  G4int ijk[3] = { i, j, k };
+	  tetra3d tet;
+	  tet[0] = ijk[0] + nGrid*(ijk[1] + nGrid*ijk[2]);
+	  for (G4int c=0; c<3; c++) {
+	    ijk[p[c]]++;
+	    tet[c+1] = ijk[0] + nGrid*(ijk[1] + nGrid*ijk[2]);
+	  }
+	  tetra.push_back(tet);
+	}
+      }
+    }
+  }
+}
+
+
+// Regular 2D mesh, with each square split into two triangles
+
+void fill2Dmesh(std::vector<point2d>& xy, std::vector<G4double>& v,
+		std::vector<tetra2d>& tri) {
+  G4double step = side/(nGrid-1);
+
+  for (G4int j=0; j<nGrid; j++) {
+    for (G4int i=0; i<nGrid; i++) {
+      xy.push_back(point2d{{i*step, j*step}});
+      v.push_back(potential(i*step, j*step));
+    }
+  }
+
+  for (G4int j=0; j<nGrid-1; j++) {
+    for (G4int i=0; i<nGrid-1; i++) {
+      G4int i00 = i + nGrid*j, i10 = i00+1, i01 = i00+nGrid, i11 = i01+1;
+      tri.push_back(tetra2d{{i00, i10, i11}});
+      tri.push_back(tetra2d{{i00, i11, i01}});
+    }
+  }
+}
+
+
+// Query points, kept away from the hull to avoid boundary messages
+
+void fillRandomPoints(std::vector<G4ThreeVector>& pts) {
+  pts.resize(nPoints);
+  for (auto& p: pts) {
+    p.set(G4UniformRand(), G4UniformRand(), G4UniformRand());
+    p = side*(0.01*G4ThreeVector(1.,1.,1.) + 0.98*p);
+  }
+}
+
+void fillWalkPoints(std::vector<G4ThreeVector>& pts) {
+  const G4double stepLen = 0.2*side/nGrid;	// Several steps per tetrahedron
+  const G4double lo = 0.01*side, hi = 0.99*side;
+
+  pts.resize(nPoints);
+  G4ThreeVector pos(0.5*side, 0.5*side, 0.5*side);
+  for (auto& p: pts) {
+    G4ThreeVector next = pos + stepLen*G4RandomDirection();
+    if (next.x()<lo || next.x()>hi || next.y()<lo || next.y()>hi ||
+	next.z()<lo || next.z()>hi) next = pos;		// Stay inside mesh
+    p = pos = next;
+  }
+}
+
+
+// Main benchmark is here
+
+int main(int argc, char* argv[]) {
+  G4CMPBench::Options opt = G4CMPBench::ParseOptions(argc, argv, 1, 1000000);
+
+  std::vector<point3d> xyz;
+  std::vector<G4double> v3;
+  std::vector<tetra3d> tetra;
+  fill3Dmesh(xyz, v3, tetra);
+
+  std::vector<point2d> xy;
+  std::vector<G4double> v2;
+  std::vector<tetra2d> tri;
+  fill2Dmesh(xy, v2, tri);
+
+  G4cout << "Building meshes with " << xyz.size() << " points, "
+	 << tetra.size() << " tetrahedra, " << tri.size() << " triangles"
+	 << G4endl;
+
+  G4CMPTriLinearInterp tli(xyz, v3, tetra);
+  G4CMPBiLinearInterp bli(xy, v2, tri);
+
+  std::vector<G4ThreeVector> randPts, walkPts;
+  fillRandomPoints(randPts);
+  fillWalkPoints(walkPts);
+
+  // Interpolators take C arrays; copy out to avoid timing the conversion
+  std::vector<point3d> randPos(nPoints), walkPos(nPoints);
+  for (G4int i=0; i<nPoints; i++) {
+    randPos[i] = point3d{{randPts[i].x(), randPts[i].y(), randPts[i].z()}};
+    walkPos[i] = point3d{{walkPts[i].x(), walkPts[i].y(), walkPts[i].z()}};
+  }
+
+  std::vector<G4CMPBench::Result> results;
+
+  results.push_back(G4CMPBench::Run("TriLinear::GetValue random", opt.nCalls,
+    [&](G4long i) { return tli.GetValue(randPos[i%nPoints].data())/volt; }));
+
+  results.push_back(G4CMPBench::Run("TriLinear::GetValue walk", opt.nCalls,
+    [&](G4long i) { return tli.GetValue(walkPos[i%nPoints].data())/volt; }));
+
+  results.push_back(G4CMPBench::Run("TriLinear::GetGrad walk", opt.nCalls,
+    [&](G4long i) {
+      return tli.GetGrad(walkPos[i%nPoints].data()).x()/(volt/cm);
+    }));
+
+  results.push_back(G4CMPBench::Run("BiLinear::GetValue random", opt.nCalls,
+    [&](G4long i) { return bli.GetValue(randPos[i%nPoints].data())/volt; }));
+
+  results.push_back(G4CMPBench::Run("BiLinear::GetValue walk", opt.nCalls,
+    [&](G4long i) { return bli.GetValue(walkPos[i%nPoints].data())/volt; }));
+
+  results.push_back(G4CMPBench::Run("BiLinear::GetGrad walk", opt.nCalls,
+    [&](G4long i) {
+      return bli.GetGrad(walkPos[i%nPoints].data()).x()/(volt/cm);
+    }));
+
+  G4CMPBench::Report("benchInterpolators", opt, results);
+}
@@ -0,0 +1,71 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: benchKaplanQP [N] [seed] [csvfile]
+//
+// Time N calls to G4CMPKaplanQP::AbsorbPhonon(), for a 600 nm aluminum
+// film with the same parameters as examples/phonon.  Phonon energies are
+// drawn uniformly in log(E) from just above 2*gap to 10 meV, covering
+// both pair-breaking cascades and near-gap reflections.
+//
+// 20261019  New benchmark for Kaplan quasiparticle absorption
+
+#include "globals.hh"
+#include "g4cmpBenchmark.hh"
+#include "G4CMPKaplanQP.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+#include <cmath>
+#include <vector>
+
+namespace {
+  const G4int nPoints = 100000;		// Number of distinct energies
+}
+
+
+// Main benchmark is here
+
+int main(int argc, char* argv[]) {
+  G4CMPBench::Options opt = G4CMPBench::ParseOptions(argc, argv, 1, 100000);
+
+  // Aluminum film parameters, see examples/phonon/PhononDetectorConstruction
+  const G4double gap = 173.715e-6*eV;
+
+  G4CMPKaplanQP kaplan(0);
+  kaplan.SetFilmThickness(600.*nm);
+  kaplan.SetGapEnergy(gap);
+  kaplan.SetLowQPLimit(3.);
+  kaplan.SetPhononLifetime(242.*ps);
+  kaplan.SetPhononLifetimeSlope(0.29);
+  kaplan.SetVSound(3.26*km/s);
+  kaplan.SetSubgapAbsorption(0.1);
+  kaplan.SetTemperature(0.);
+
+  const G4double logEmin = std::log(2.01*gap), logEmax = std::log(10.*meV);
+
+  std::vector<G4double> energies(nPoints);
+  for (auto& E: energies) {
+    E = std::exp(logEmin + (logEmax-logEmin)*G4UniformRand());
+  }
+
+  std::vector<G4double> reflected;	// Reused buffer, as in process
+  G4long nAbsorb = 0, nReflected = 0;
+
+  std::vector<G4CMPBench::Result> results;
+
+  results.push_back(G4CMPBench::Run("KaplanQP::AbsorbPhonon", opt.nCalls,
+    [&](G4long i) {
+      reflected.clear();
+      G4double Eabs = kaplan.AbsorbPhonon(energies[i%nPoints], reflected);
+      nAbsorb++;
+      nReflected += reflected.size();
+      return Eabs/eV;
+    }));
+
+  G4cout << " average " << (G4double)nReflected/nAbsorb
+	 << " reflected phonons per call" << G4endl;
+
+  G4CMPBench::Report("benchKaplanQP", opt, results);
+}
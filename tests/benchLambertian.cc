@@ -0,0 +1,105 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: benchLambertian <Lattice> [N] [seed] [csvfile]
+//
+// Time N diffuse phonon reflections, as done by G4CMP::GetLambertianVector()
+// for a phonon on the top face of a 1 cm crystal cube.
+//
+// G4CMP::GetLambertianVector() normally gets its coordinate transforms from
+// the current track's touchable, which does not exist outside of tracking.
+// The crystal touchable is located here with a G4Navigator, and passed to
+// the library function directly.  The LambertReflection() call alone is
+// also reported.
+//
+// Geant4 material will be set as "G4_<Lattice>".
+//
+// 20261019  New benchmark for Lambertian phonon reflection
+// 20261019  Call library GetLambertianVector() with navigator touchable
+
+#include "globals.hh"
+#include "g4cmpBenchmark.hh"
+#include "G4Box.hh"
+#include "G4CMPUtils.hh"
+#include "G4LatticeManager.hh"
+#include "G4LatticePhysical.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Navigator.hh"
+#include "G4NistManager.hh"
+#include "G4PVPlacement.hh"
+#include "G4PhononPolarization.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "G4TouchableHistory.hh"
+#include "Randomize.hh"
+#include <stdlib.h>
+#include <vector>
+
+namespace {
+  const G4int nPoints = 100000;		// Number of distinct surface points
+
+  struct SurfInput {
+    G4int mode;
+    G4ThreeVector pos;
+  };
+}
+
+
+// Main benchmark is here
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    G4cerr << "Usage: " << argv[0] << " <Lattice> [N] [seed] [csvfile]"
+	   << G4endl;
+    ::exit(1);
+  }
+
+  G4String lname = argv[1];
+  G4String mname = "G4_"+lname;
+
+  G4CMPBench::Options opt = G4CMPBench::ParseOptions(argc, argv, 2, 1000000);
+
+  // MUST USE 'new', SO THAT G4SolidStore CAN DELETE
+  const G4double halfSize = 0.5*cm;
+  G4Material* mat = G4NistManager::Instance()->FindOrBuildMaterial(mname);
+  G4Box* crystal = new G4Box("Crystal", halfSize, halfSize, halfSize);
+  G4LogicalVolume* lv = new G4LogicalVolume(crystal, mat, crystal->GetName());
+  G4PVPlacement* pv = new G4PVPlacement(0, G4ThreeVector(), lv, lv->GetName(),
+					0, false, 1);
+
+  G4LatticePhysical* lattice =
+    G4LatticeManager::Instance()->LoadLattice(pv,lname);
+
+  // Touchable for crystal, to replace the one from current track
+  G4Navigator nav;
+  nav.SetWorldVolume(pv);
+  nav.LocateGlobalPointAndSetup(G4ThreeVector(), 0, false, true);
+  G4TouchableHistory* touch = nav.CreateTouchableHistory();
+
+  // Phonons hit top face (+Z), away from edges
+  const G4ThreeVector surfNorm(0., 0., 1.);
+  std::vector<SurfInput> inputs(nPoints);
+  for (auto& in: inputs) {
+    in.mode = (G4int)(G4PhononPolarization::NUM_MODES*G4UniformRand());
+    in.pos.set(0.9*halfSize*(2.*G4UniformRand()-1.),
+	       0.9*halfSize*(2.*G4UniformRand()-1.), halfSize);
+  }
+
+  std::vector<G4CMPBench::Result> results;
+
+  results.push_back(G4CMPBench::Run("G4CMP::LambertReflection", opt.nCalls,
+    [&](G4long) { return G4CMP::LambertReflection(surfNorm).z(); }));
+
+  results.push_back(G4CMPBench::Run("G4CMP::GetLambertianVector",
+				    opt.nCalls, [&](G4long i) {
+      const SurfInput& in = inputs[i%nPoints];
+      return G4CMP::GetLambertianVector(touch, lattice, surfNorm, in.mode,
+					in.pos).z();
+    }));
+
+  G4CMPBench::Report("benchLambertian", opt, results);
+
+  delete touch;
+}
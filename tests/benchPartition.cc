@@ -0,0 +1,101 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: benchPartition <Ehit> <Esample> <Lattice> [N] [seed] [csvfile]
+//
+// Time N calls to G4CMPEnergyPartition::DoPartition() for a fixed energy
+// deposit, both ionizing and non-ionizing, and the subsequent conversion
+// to primary particles.  Arguments are the same as testPartition.
+//
+// Specify total hit energy (eV), downsampling threshold (eV),
+// and lattice directory.  Geant4 material will be set as "G4_<Lattice>".
+//
+// 20261019  New benchmark for energy partitioning
+
+#include "globals.hh"
+#include "g4cmpBenchmark.hh"
+#include "G4CMPConfigManager.hh"
+#include "G4CMPEnergyPartition.hh"
+#include "G4Delete.hh"
+#include "G4LatticeManager.hh"
+#include "G4LatticePhysical.hh"
+#include "G4LogicalVolume.hh"
+#include "G4NistManager.hh"
+#include "G4PVPlacement.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "G4Tubs.hh"
+#include <algorithm>
+#include <stdlib.h>
+#include <vector>
+
+
+// Main benchmark is here
+
+int main(int argc, char* argv[]) {
+  if (argc < 4) {
+    G4cerr << "Usage: " << argv[0] << " <Ehit> <Esamp> <Lattice>"
+	   << " [N] [seed] [csvfile]" << G4endl
+	   << "\tEnergies should be in eV" << G4endl;
+    ::exit(1);
+  }
+
+  G4double Ehit = strtod(argv[1],NULL) * eV;
+  G4double Esamp = strtod(argv[2],NULL) * eV;
+  G4String lname = argv[3];
+  G4String mname = "G4_"+lname;
+
+  G4CMPBench::Options opt = G4CMPBench::ParseOptions(argc, argv, 4, 1000);
+
+  // MUST USE 'new', SO THAT G4SolidStore CAN DELETE
+  G4Material* mat = G4NistManager::Instance()->FindOrBuildMaterial(mname);
+  G4Tubs* crystal = new G4Tubs("GeCrystal", 0., 5.*cm, 1.*cm, 0., 360.*deg);
+  G4LogicalVolume* lv = new G4LogicalVolume(crystal, mat, crystal->GetName());
+  G4PVPlacement* pv = new G4PVPlacement(0, G4ThreeVector(), lv, lv->GetName(),
+					0, false, 1);
+
+  G4LatticeManager::Instance()->LoadLattice(pv,lname);
+
+  G4CMPConfigManager* g4cmp = G4CMPConfigManager::Instance();
+  g4cmp->SetSamplingEnergy(Esamp);
+  g4cmp->SetLukeSampling(-1.);			// Let partitioner do scaling
+
+  G4CMPEnergyPartition partition(pv);
+  partition.SetBiasVoltage(50.*volt);		// For Luke sampling
+
+  std::vector<G4PrimaryParticle*> prim;
+
+  // Count outputs and clean up after each partitioning
+  auto convert = [&]() {
+    partition.GetPrimaries(prim);
+    G4double nPrim = prim.size();
+    std::for_each(prim.begin(), prim.end(), Delete<G4PrimaryParticle>());
+    prim.clear();
+    return nPrim;
+  };
+
+  std::vector<G4CMPBench::Result> results;
+
+  results.push_back(G4CMPBench::Run("EnergyPartition::DoPartition ion",
+				    opt.nCalls, [&](G4long) {
+      partition.DoPartition(Ehit, 0.);
+      return convert();
+    }));
+
+  results.push_back(G4CMPBench::Run("EnergyPartition::DoPartition NIEL",
+				    opt.nCalls, [&](G4long) {
+      partition.DoPartition(0., Ehit);
+      return convert();
+    }));
+
+  results.push_back(G4CMPBench::Run("EnergyPartition::DoPartition mixed",
+				    opt.nCalls, [&](G4long) {
+      partition.DoPartition(0.7*Ehit, 0.3*Ehit);
+      return convert();
+    }));
+
+  G4CMPBench::Report("benchPartition", opt, results);
+}
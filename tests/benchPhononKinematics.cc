@@ -0,0 +1,107 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: benchPhononKinematics <Lattice> [N] [seed] [csvfile]
+//
+// Time N phonon wavevector to group velocity mappings, using random
+// wavevector directions and phonon modes.  Compares G4CMPPhononKinTable
+// queries against G4LatticeLogical::MapKtoVg(), with both the lookup
+// table and the eigensolver (G4CMPPhononKinematics).
+//
+// Geant4 material will be set as "G4_<Lattice>".
+//
+// 20261019  New benchmark for phonon kinematics lookups
+
+#include "globals.hh"
+#include "g4cmpBenchmark.hh"
+#include "G4CMPConfigManager.hh"
+#include "G4CMPPhononKinTable.hh"
+#include "G4CMPPhononKinematics.hh"
+#include "G4LatticeLogical.hh"
+#include "G4LatticeManager.hh"
+#include "G4NistManager.hh"
+#include "G4PhononPolarization.hh"
+#include "G4RandomDirection.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "Randomize.hh"
+#include <stdlib.h>
+#include <vector>
+
+namespace {
+  const G4int nPoints = 100000;		// Number of distinct wavevectors
+
+  struct KInput {
+    G4int mode;
+    G4ThreeVector k;
+  };
+}
+
+
+// Main benchmark is here
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    G4cerr << "Usage: " << argv[0] << " <Lattice> [N] [seed] [csvfile]"
+	   << G4endl;
+    ::exit(1);
+  }
+
+  G4String lname = argv[1];
+  G4String mname = "G4_"+lname;
+
+  G4CMPBench::Options opt = G4CMPBench::ParseOptions(argc, argv, 2, 1000000);
+
+  G4Material* mat = G4NistManager::Instance()->FindOrBuildMaterial(mname);
+  G4LatticeLogical* lat = G4LatticeManager::Instance()->LoadLattice(mat,lname);
+
+  // Private kinematics and table, so that filling can be done up front
+  G4CMPPhononKinematics solver(lat);
+  G4CMPPhononKinTable table(&solver);
+  table.initialize();
+
+  std::vector<KInput> inputs(nPoints);
+  for (auto& in: inputs) {
+    in.mode = (G4int)(G4PhononPolarization::NUM_MODES*G4UniformRand());
+    in.k = G4RandomDirection();
+  }
+
+  std::vector<G4CMPBench::Result> results;
+
+  results.push_back(G4CMPBench::Run("KinTable::interpGroupVelocity_N",
+				    opt.nCalls, [&](G4long i) {
+    const KInput& in = inputs[i%nPoints];
+    return table.interpGroupVelocity_N(in.mode, in.k).x()/(m/s);
+  }));
+
+  results.push_back(G4CMPBench::Run("KinTable::interpGroupVelocity",
+				    opt.nCalls, [&](G4long i) {
+    const KInput& in = inputs[i%nPoints];
+    return table.interpGroupVelocity(in.mode, in.k)/(m/s);
+  }));
+
+  results.push_back(G4CMPBench::Run("KinTable::interpPerpSlowness",
+				    opt.nCalls, [&](G4long i) {
+    const KInput& in = inputs[i%nPoints];
+    return table.interpPerpSlowness(in.mode, in.k)*(m/s);
+  }));
+
+  G4CMPConfigManager::UseKVSolver(false);
+  results.push_back(G4CMPBench::Run("LatticeLogical::MapKtoVg table",
+				    opt.nCalls, [&](G4long i) {
+    const KInput& in = inputs[i%nPoints];
+    return lat->MapKtoVg(in.mode, in.k).x()/(m/s);
+  }));
+
+  // Eigensolver is much slower; use fewer calls to keep total time similar
+  G4CMPConfigManager::UseKVSolver(true);
+  results.push_back(G4CMPBench::Run("LatticeLogical::MapKtoVg solver",
+				    opt.nCalls/10+1, [&](G4long i) {
+    const KInput& in = inputs[i%nPoints];
+    return lat->MapKtoVg(in.mode, in.k).x()/(m/s);
+  }));
+
+  G4CMPBench::Report("benchPhononKinematics", opt, results);
+}
@@ -0,0 +1,131 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// g4cmpBenchmark.hh	Common timing and reporting for the standalone
+//			micro-benchmarks (bench*.cc) in this directory.
+//
+// Each benchmark runs a kernel a fixed number of times on synthetic inputs
+// generated from a fixed random seed, and reports calls per second.  The
+// kernel returns a value which is summed into a "checksum"; the same seed
+// and inputs should always produce the same checksum.
+//
+// Results are written to G4cout as a table, and are appended to a CSV
+// file if one is specified, with columns
+//
+//	benchmark,kernel,calls,wall_s,cpu_s,calls_per_s,ns_per_call,seed,checksum
+//
+// 20261019  New helper for fixed-seed micro-benchmarks
+
+#ifndef g4cmpBenchmark_hh
+#define g4cmpBenchmark_hh 1
+
+#include "globals.hh"
+#include "G4CMPProfiler.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <stdlib.h>
+#include <vector>
+
+namespace G4CMPBench {
+  // Default seed, so that results are comparable between runs
+  const long defaultSeed = 20261019;
+
+  // Command line parameters common to all benchmarks
+  struct Options {
+    Options() : nCalls(100000), seed(defaultSeed) {;}
+    G4long nCalls;
+    long seed;
+    G4String csvFile;
+  };
+
+  // Accumulated timing for one kernel
+  struct Result {
+    G4String kernel;
+    G4long calls;
+    G4double wall, cpu;		// In Geant4 time units
+    G4double checksum;
+  };
+
+  // Parse "[N] [seed] [csvfile]" starting from argv[first]
+  inline Options ParseOptions(int argc, char* argv[], int first,
+			      G4long defaultCalls) {
+    Options opt;
+    opt.nCalls = (argc>first) ? atol(argv[first]) : defaultCalls;
+    opt.seed   = (argc>first+1) ? atol(argv[first+1]) : defaultSeed;
+    if (argc>first+2) opt.csvFile = argv[first+2];
+
+    if (opt.nCalls <= 0) opt.nCalls = defaultCalls;
+
+    G4Random::setTheSeed(opt.seed);
+    return opt;
+  }
+
+  // Call kernel(i) for i in [0,calls), after a short untimed warm-up
+  template <class Kernel>
+  Result Run(const G4String& kernel, G4long calls, Kernel func) {
+    Result res{kernel, calls, 0., 0., 0.};
+
+    G4long nWarm = std::min<G4long>(calls/10+1, 1000);
+    for (G4long i=0; i<nWarm; i++) func(i);
+
+    G4double wall0 = G4CMPProfiler::GetWallTime();
+    G4double cpu0 = G4CMPProfiler::GetCPUTime();
+
+    for (G4long i=0; i<calls; i++) res.checksum += func(i);
+
+    res.wall = G4CMPProfiler::GetWallTime() - wall0;
+    res.cpu = G4CMPProfiler::GetCPUTime() - cpu0;
+
+    return res;
+  }
+
+  // Print table to G4cout, and append to CSV file if requested
+  inline void Report(const G4String& bench, const Options& opt,
+		     const std::vector<Result>& results) {
+    G4cout << bench << " (seed " << opt.seed << ")\n"
+	   << std::setw(36) << std::left << " Kernel" << std::right
+	   << std::setw(12) << "Calls" << std::setw(12) << "Wall [s]"
+	   << std::setw(14) << "Calls/s" << std::setw(12) << "ns/call"
+	   << std::setw(16) << "Checksum" << G4endl;
+
+    std::ofstream csv;
+    if (!opt.csvFile.empty()) {
+      std::ifstream exists(opt.csvFile);
+      G4bool needHeader = !exists.good();
+      exists.close();
+
+      csv.open(opt.csvFile, std::ios::app);
+      if (!csv.good()) {
+	G4cerr << bench << ": unable to open " << opt.csvFile << G4endl;
+      } else if (needHeader) {
+	csv << "benchmark,kernel,calls,wall_s,cpu_s,calls_per_s,ns_per_call"
+	    << ",seed,checksum" << std::endl;
+      }
+    }
+
+    for (const Result& r: results) {
+      G4double rate = (r.wall > 0.) ? r.calls/(r.wall/s) : 0.;
+      G4double perCall = r.wall/r.calls/ns;
+
+      G4cout << " " << std::setw(35) << std::left << r.kernel << std::right
+	     << std::setw(12) << r.calls << std::setw(12) << r.wall/s
+	     << std::setw(14) << rate << std::setw(12) << perCall
+	     << std::setw(16) << std::setprecision(10) << r.checksum
+	     << std::setprecision(6) << G4endl;
+
+      if (csv.is_open() && csv.good()) {
+	csv << bench << "," << r.kernel << "," << r.calls << ","
+	    << r.wall/s << "," << r.cpu/s << "," << rate << "," << perCall
+	    << "," << opt.seed << "," << std::setprecision(17) << r.checksum
+	    << std::setprecision(6) << std::endl;
+      }
+    }
+  }
+}
+
+#endif	/* g4cmpBenchmark_hh */
@@ -0,0 +1,271 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: testAnharmonicTable <Lattice> [N] [seed] [verbose]
+//
+// Verify the tabulated anharmonic decay energies (G4CMPAnharmonicTable)
+// for the given lattice against the rejection sampling which they replace
+// in G4CMPAnharmonicDecay, for both L->T+T and L->L'+T.
+//
+// The rejection densities, including their cutoffs, are integrated here
+// on a much finer grid than the table uses.  The tabulated CDF, found by
+// inverting SampleTT() and SampleLT() at closely spaced probabilities,
+// must agree with that integral to within the table's tolerance (1e-4).
+//
+// N energies (default 1000000) are also drawn with ShootTT() and ShootLT()
+// and with rejection sampling.  The samples must pass a two-sample
+// Kolmogorov-Smirnov test at the 0.1% level.
+//
+// Geant4 material will be set as "G4_<Lattice>".
+//
+// Returns number of errors.
+//
+// 20261019  New test for tabulated anharmonic decay sampling
+
+#include "globals.hh"
+#include "G4Box.hh"
+#include "G4CMPAnharmonicTable.hh"
+#include "G4LatticeManager.hh"
+#include "G4LatticePhysical.hh"
+#include "G4LogicalVolume.hh"
+#include "G4NistManager.hh"
+#include "G4PVPlacement.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <functional>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+
+namespace {
+  G4int nErrors = 0;
+  G4int verbose = 0;
+
+  // Dimensionless lattice constants, as used by G4CMPAnharmonicDecay
+  G4double vLvT = 1.;
+  G4double anhBeta = 0., anhGamma = 0., anhLambda = 0., anhMu = 0.;
+
+  const G4int nGrid = 1<<21;		// Integration steps for reference
+  const G4int nProb = 1000000;		// Probabilities for tabulated CDF
+}
+
+
+// Acceptance probability of rejection sampling in G4CMPAnharmonicDecay
+
+G4double acceptTT(G4double x) {
+  G4double p = G4CMPAnharmonicTable::TTDecayProb(vLvT, x*vLvT, anhBeta,
+						 anhGamma, anhLambda, anhMu);
+  return std::min(std::max(p/1.5, 0.), 1.);
+}
+
+G4double acceptLT(G4double x) {
+  G4double range = (G4CMPAnharmonicTable::LTUpperBound(vLvT) -
+		    G4CMPAnharmonicTable::LTLowerBound(vLvT));
+  G4double p = G4CMPAnharmonicTable::LTDecayProb(vLvT, x);
+  return std::min(std::max(p*range/2.8, 0.), 1.);
+}
+
+
+// Rejection sampling, as in G4CMPAnharmonicDecay without the table
+
+G4double shootRejection(const std::function<G4double(G4double)>& accept,
+			G4double xmin, G4double xmax) {
+  G4double x = 0.;
+  do {
+    x = xmin + G4UniformRand()*(xmax-xmin);
+  } while (G4UniformRand() >= accept(x));
+
+  return x;
+}
+
+
+// Normalized CDF of density at nGrid+1 points, using midpoint rule
+
+std::vector<G4double>
+integrate(const std::function<G4double(G4double)>& density,
+	  G4double xmin, G4double xmax) {
+  const G4double dx = (xmax-xmin)/nGrid;
+
+  std::vector<G4double> cdf(nGrid+1, 0.);
+  for (G4int i=1; i<=nGrid; i++) {
+    cdf[i] = cdf[i-1] + density(xmin+(i-0.5)*dx)*dx;
+  }
+
+  for (G4double& c: cdf) c /= cdf[nGrid];
+  return cdf;
+}
+
+// Interpolate reference CDF at x
+
+G4double evaluate(const std::vector<G4double>& cdf, G4double xmin,
+		  G4double xmax, G4double x) {
+  G4double t = (x-xmin)/(xmax-xmin) * nGrid;
+  if (t <= 0.) return 0.;
+  if (t >= nGrid) return 1.;
+
+  G4int i = G4int(t);
+  return cdf[i] + (t-i)*(cdf[i+1]-cdf[i]);
+}
+
+
+// Two-sample Kolmogorov-Smirnov distance
+
+G4double KolmogorovSmirnov(std::vector<G4double> a, std::vector<G4double> b) {
+  std::sort(a.begin(), a.end());
+  std::sort(b.begin(), b.end());
+
+  G4double D = 0.;
+  size_t i=0, j=0;
+  while (i < a.size() && j < b.size()) {
+    G4double x = std::min(a[i], b[j]);
+    while (i < a.size() && a[i] <= x) i++;
+    while (j < b.size() && b[j] <= x) j++;
+    D = std::max(D, fabs(G4double(i)/a.size() - G4double(j)/b.size()));
+  }
+
+  return D;
+}
+
+
+// Compare one tabulated distribution with rejection sampling
+
+void compare(const G4String& name,
+	     const std::function<G4double(G4double)>& sample,
+	     const std::function<G4double(G4double)>& accept,
+	     G4double xmin, G4double xmax, G4double tableError, G4int N) {
+  G4cout << "\n" << name << " decay, energy fraction " << xmin << " to "
+	 << xmax << G4endl;
+
+  const G4double tolerance = G4CMPAnharmonicTable::GetTolerance();
+
+  G4cout << " table CDF error from fill " << tableError << G4endl;
+  if (tableError > tolerance) {
+    G4cerr << " " << name << " TABLE FILL EXCEEDS TOLERANCE " << tolerance
+	   << G4endl;
+    nErrors++;
+  }
+
+  // Tabulated CDF is u at x = sample(u); compare with reference integral
+  std::vector<G4double> cdf = integrate(accept, xmin, xmax);
+
+  G4double maxDiff = 0., xMaxDiff = xmin;
+  for (G4int k=0; k<=nProb; k++) {
+    G4double u = G4double(k)/nProb;
+    G4double x = sample(u);
+    G4double diff = fabs(evaluate(cdf, xmin, xmax, x) - u);
+    if (diff > maxDiff) {
+      maxDiff = diff;
+      xMaxDiff = x;
+    }
+  }
+
+  G4cout << " CDF distance from reference " << maxDiff << " at x = "
+	 << xMaxDiff << " (tolerance " << tolerance << ")" << G4endl;
+
+  if (maxDiff > tolerance) {
+    G4cerr << " " << name << " TABULATED CDF DIFFERS FROM REFERENCE"
+	   << G4endl;
+    nErrors++;
+  }
+
+  // Sampled energies from table and from rejection sampling
+  std::vector<G4double> table(N), reject(N);
+  for (G4int i=0; i<N; i++) {
+    table[i] = sample(G4UniformRand());
+    reject[i] = shootRejection(accept, xmin, xmax);
+  }
+
+  G4double D = KolmogorovSmirnov(table, reject);
+  G4double Dcrit = 1.95*sqrt(2./N);			// alpha = 0.001
+
+  G4cout << " sampled KS distance " << D << " (critical " << Dcrit << ")"
+	 << G4endl;
+
+  if (D > Dcrit) {
+    G4cerr << " " << name << " SAMPLED DISTRIBUTION DIFFERS FROM REJECTION"
+	   << G4endl;
+    nErrors++;
+  }
+
+  if (verbose) {
+    G4cout << " x      table CDF  reference CDF" << G4endl;
+    for (G4int k=1; k<10; k++) {
+      G4double x = sample(k/10.);
+      G4cout << " " << x << " " << k/10. << " "
+	     << evaluate(cdf, xmin, xmax, x) << G4endl;
+    }
+  }
+}
+
+
+// Main test is here
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    G4cerr << "Usage: " << argv[0] << " <Lattice> [N] [seed] [verbose]"
+	   << G4endl;
+    ::exit(1);
+  }
+
+  G4String lname = argv[1];
+  G4String mname = "G4_"+lname;
+
+  G4int N = (argc>2) ? atoi(argv[2]) : 1000000;
+  G4long seed = (argc>3) ? atol(argv[3]) : 20261019;
+  verbose = (argc>4) ? atoi(argv[4]) : 0;
+
+  G4Random::setTheSeed(seed);
+
+  // MUST USE 'new', SO THAT G4SolidStore CAN DELETE
+  G4Material* mat = G4NistManager::Instance()->FindOrBuildMaterial(mname);
+  G4Box* crystal = new G4Box("Crystal", 1.*cm, 1.*cm, 1.*cm);
+  G4LogicalVolume* lv = new G4LogicalVolume(crystal, mat, crystal->GetName());
+  G4PVPlacement* pv = new G4PVPlacement(0, G4ThreeVector(), lv, lv->GetName(),
+					0, false, 1);
+
+  G4LatticePhysical* lattice =
+    G4LatticeManager::Instance()->LoadLattice(pv,lname);
+  if (!lattice) {
+    G4cerr << " Unable to load " << lname << " lattice" << G4endl;
+    ::exit(1);
+  }
+
+  const G4CMPAnharmonicTable* anhTable = lattice->GetAnharmonicTable();
+  if (!anhTable) {
+    G4cerr << " " << lname << " lattice has no anharmonic decay table"
+	   << G4endl;
+    ::exit(1);
+  }
+
+  vLvT   = lattice->GetSoundSpeed() / lattice->GetTransverseSoundSpeed();
+  anhBeta   = lattice->GetBeta() / (1e11*pascal);
+  anhGamma  = lattice->GetGamma() / (1e11*pascal);
+  anhLambda = lattice->GetLambda() / (1e11*pascal);
+  anhMu     = lattice->GetMu() / (1e11*pascal);
+
+  G4cout << lname << " vL/vT " << vLvT << ", beta " << anhBeta << " gamma "
+	 << anhGamma << " lambda " << anhLambda << " mu " << anhMu << G4endl;
+
+  if (fabs(anhTable->GetVLVT() - vLvT) > 1e-9*vLvT) {
+    G4cerr << " TABLE vL/vT " << anhTable->GetVLVT() << " DIFFERS FROM "
+	   << "LATTICE" << G4endl;
+    nErrors++;
+  }
+
+  compare("L->T+T",
+	  [anhTable](G4double u) { return anhTable->SampleTT(u); }, acceptTT,
+	  G4CMPAnharmonicTable::TTLowerBound(vLvT),
+	  G4CMPAnharmonicTable::TTUpperBound(vLvT), anhTable->GetTTError(), N);
+
+  compare("L->L'+T",
+	  [anhTable](G4double u) { return anhTable->SampleLT(u); }, acceptLT,
+	  G4CMPAnharmonicTable::LTLowerBound(vLvT),
+	  G4CMPAnharmonicTable::LTUpperBound(vLvT), anhTable->GetLTError(), N);
+
+  G4cout << "\n" << nErrors << " errors found" << G4endl;
+  ::exit(nErrors);
+}
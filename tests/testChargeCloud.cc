@@ -9,6 +9,8 @@
 // Geant4 material will be set as "G4_<Lattice>".
 //
 // NOTE: 10 keV energy deposit should produce ~5000 e/h pairs
+//
+// 20261019  Bin indices are now 64-bit, 21 bits per axis
 
 #include "globals.hh"
 #include "G4CMPChargeCloud.hh"
@@ -44,11 +46,11 @@ void testCloud(G4int n, const G4ThreeVector& pos) {
   // Find boundaries of good sphere for validation
   G4ThreeVector min(1.*km,1.*km,1.*km);
   G4ThreeVector max(-1.*km,-1.*km,-1*km);
-  G4int maxbin = -1;
+  G4long maxbin = -1;
   G4double rsum=0., r2sum=0.;
 
   for (size_t i=0; i<points.size(); i++) {
-    G4int ibin = cloud->GetPositionBin(i);
+    G4long ibin = cloud->GetPositionBin(i);
     if (ibin > maxbin) maxbin = ibin;
 
     G4double ri = (points[i]-pos).mag();
@@ -67,7 +69,7 @@ void testCloud(G4int n, const G4ThreeVector& pos) {
   G4double rrms = sqrt(r2sum/points.size() - ravg*ravg);
   G4cout << " at " << pos << " points span " << min/mm << " to "
 	 << max/mm << " mm\n Ravg " << ravg/nm << " rms " << rrms/nm << " nm"
-	 << "\n Maximum bin (zzzyyyxxx) " << maxbin << G4endl;
+	 << "\n Maximum bin (21 bits each z,y,x) " << maxbin << G4endl;
 
   G4double rcloud = cloud->GetRadius();		// Radius used to generate
 
@@ -0,0 +1,179 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: testChargeCloudDist <N> <Lattice> [verbose]
+//
+// Verify that G4CMPChargeCloud::Generate() reproduces the reference
+// distribution, in which every point is drawn with GeneratePoint() and then
+// folded into the volume with AdjustToVolume().  Generate() only checks
+// points which might reach the surface, so with the same random seed the
+// two must agree point-for-point.  In the bulk, the radial distribution is
+// also compared to its analytic CDF with a Kolmogorov-Smirnov test, and
+// each point must lie in the bin returned by GetBinCenter().
+//
+// Geant4 material will be set as "G4_<Lattice>".  Returns number of errors.
+//
+// 20261019  New test for charge cloud generation with safety distance
+
+#include "globals.hh"
+#include "G4CMPChargeCloud.hh"
+#include "G4LatticeLogical.hh"
+#include "G4LatticeManager.hh"
+#include "G4NistManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "G4Tubs.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+// Global variables for use in tests
+
+namespace {
+  G4CMPChargeCloud* cloud = 0;
+  G4double binSpacing = 0.;	// Must match G4CMPChargeCloud
+  G4int nErrors = 0;		// Increment counter at failed checks
+  G4int verbose = 0;
+}
+
+
+// Compare generated cloud to reference algorithm with same seed
+
+void testReference(G4int n, const G4ThreeVector& pos) {
+  G4Random::setTheSeed(20261019);
+  std::vector<G4ThreeVector> points = cloud->Generate(n, pos);
+
+  G4Random::setTheSeed(20261019);
+  G4double rcloud = cloud->GetRadius();
+
+  G4int nDiffer = 0;
+  for (G4int i=0; i<n; i++) {
+    G4ThreeVector ref = cloud->GeneratePoint(rcloud)+pos;
+    cloud->AdjustToVolume(ref);
+
+    if ((points[i]-ref).mag() > 1e-9*nm) {
+      if (verbose) G4cerr << " point " << i << " " << points[i]
+			  << " reference " << ref << G4endl;
+      nDiffer++;
+    }
+  }
+
+  G4cout << " at " << pos << " " << cloud->GetNumberChecked() << " of " << n
+	 << " points checked against volume" << G4endl;
+
+  if (nDiffer) {
+    G4cerr << " " << nDiffer << " POINTS DIFFER FROM REFERENCE" << G4endl;
+    nErrors++;
+  }
+}
+
+
+// Compare radial distribution in bulk to analytic CDF, check binning
+
+void testDistribution(G4int n, const G4ThreeVector& pos) {
+  const std::vector<G4ThreeVector>& points = cloud->Generate(n, pos);
+  G4double rcloud = cloud->GetRadius();
+
+  std::vector<G4double> radii;
+  radii.reserve(n);
+  G4ThreeVector dirSum;
+  G4int nBadBin = 0;
+
+  for (G4int i=0; i<n; i++) {
+    G4ThreeVector dr = points[i]-pos;
+    radii.push_back(dr.mag());
+    if (dr.mag() > 0.) dirSum += dr.unit();
+
+    G4ThreeVector dbin = points[i] - cloud->GetBinCenter(cloud->GetPositionBin(i));
+    if (std::max({fabs(dbin.x()), fabs(dbin.y()), fabs(dbin.z())})
+	> 0.5*binSpacing*(1.+1e-9)) nBadBin++;
+  }
+
+  // Generated as r = R(1-sqrt(1-u^2)), so CDF(r) = sqrt(1-(1-r/R)^2)
+  std::sort(radii.begin(), radii.end());
+  G4double ksD = 0.;
+  for (G4int i=0; i<n; i++) {
+    G4double x = 1. - radii[i]/rcloud;
+    G4double cdf = sqrt(std::max(0., 1.-x*x));
+    ksD = std::max({ksD, fabs(cdf-G4double(i)/n), fabs(cdf-G4double(i+1)/n)});
+  }
+
+  G4double ksLimit = 1.63/sqrt(n);		// 1% significance
+  G4double dirMean = dirSum.mag()/n;
+
+  G4cout << " radial KS distance " << ksD << " (limit " << ksLimit << ")"
+	 << "\n mean direction " << dirMean << " (limit " << 4./sqrt(n) << ")"
+	 << G4endl;
+
+  if (ksD > ksLimit) {
+    G4cerr << " RADIAL DISTRIBUTION DOES NOT MATCH" << G4endl;
+    nErrors++;
+  }
+
+  if (dirMean > 4./sqrt(n)) {
+    G4cerr << " DIRECTIONS NOT ISOTROPIC" << G4endl;
+    nErrors++;
+  }
+
+  if (nBadBin) {
+    G4cerr << " " << nBadBin << " POINTS OUTSIDE THEIR BIN" << G4endl;
+    nErrors++;
+  }
+}
+
+
+// Main test is here
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    G4cerr << "Usage: " << argv[0] << " <N> <Lattice> [verbose]" << G4endl;
+    ::exit(1);
+  }
+
+  G4int npoints = atoi(argv[1]);
+  G4String lname = argv[2];
+  G4String mname = "G4_"+lname;
+
+  verbose = (argc>3) ? atoi(argv[3]) : 0;
+
+  G4Material* mat = G4NistManager::Instance()->FindOrBuildMaterial(mname);
+  G4LatticeLogical* lat = G4LatticeManager::Instance()->LoadLattice(mat,lname);
+
+  // MUST USE 'new', SO THAT G4SolidStore CAN DELETE
+  G4Tubs* crystal = new G4Tubs("GeCrystal", 0., 5.*cm, 1.*cm, 0., 360.*deg);
+
+  cloud = new G4CMPChargeCloud(lat, crystal);
+  cloud->SetVerboseLevel(verbose);
+
+  binSpacing = 4.*cbrt(lat->GetBasis(0).mag() * lat->GetBasis(1).mag() *
+		       lat->GetBasis(2).mag());
+
+  G4double rcloud = cloud->ComputeRadius(npoints);
+  G4cout << "G4CMPChargeCloud " << npoints << " e/h radius "
+	 << rcloud/nm << " nm" << G4endl;
+
+  // Bulk, near top face, and near corner (top face and side)
+  testReference(npoints, G4ThreeVector(0.,0.,0.));
+  testReference(npoints, G4ThreeVector(0., 0., 1.*cm-rcloud/2.));
+  testReference(npoints, G4ThreeVector(0., 5.*cm-rcloud/2., 1.*cm-rcloud/2.));
+
+  testDistribution(npoints, G4ThreeVector(0.,0.,0.));
+
+  // Cloud radius scales with charges per unit cell
+  cloud->SetLatticeFill(G4CMPChargeCloud::FCC);
+  G4double ratio = cloud->ComputeRadius(npoints)/rcloud;
+  G4cout << " FCC/diamond radius ratio " << ratio << G4endl;
+  if (fabs(ratio-cbrt(2.)) > 1e-9 && rcloud > binSpacing/4.) {
+    G4cerr << " WRONG RADIUS SCALING FOR LATTICE FILL" << G4endl;
+    nErrors++;
+  }
+
+  G4cout << "\n" << nErrors << " errors found" << G4endl;
+
+  delete cloud;		// Clean up memory at end
+  ::exit(nErrors);
+}
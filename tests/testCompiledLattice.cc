@@ -0,0 +1,360 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: testCompiledLattice <Lattice> [N] [seed] [verbose]
+//
+// Verify binary "compiled" lattices (G4LatticeLogical::WriteCompiled and
+// ReadCompiled) against the same lattice parsed from its config.txt.  The
+// text lattice is initialized with the density of the Geant4 material,
+// then written to a buffer and read back into a new lattice.  Every
+// parameter must be identical, as must the derived tables (full
+// elasticity tensor, the K-Vg lookup table sampled at N random
+// wavevectors for each mode, and the anharmonic decay quantiles).
+//
+// The lattice is also compiled by G4LatticeReader::CompileLattice() to a
+// file, both with the material density and without (so the K-Vg table
+// must be filled when it is read and initialized), and compared the same
+// way.  A truncated compiled lattice must be rejected.
+//
+// Geant4 material will be set as "G4_<Lattice>".
+//
+// Returns number of errors.
+//
+// 20261019  New test for compiled lattice round trip
+
+#include "globals.hh"
+#include "G4CMPAnharmonicTable.hh"
+#include "G4CMPConfigManager.hh"
+#include "G4LatticeLogical.hh"
+#include "G4LatticeReader.hh"
+#include "G4Material.hh"
+#include "G4NistManager.hh"
+#include "G4PhononPolarization.hh"
+#include "G4RandomDirection.hh"
+#include "G4RotationMatrix.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "Randomize.hh"
+#include <fstream>
+#include <math.h>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+
+namespace {
+  G4int nErrors = 0;
+  G4int verbose = 0;
+
+  // Wavevectors for sampling K-Vg table, same for every comparison
+  std::vector<G4ThreeVector> kSample;
+}
+
+
+// Give access to text parsing, bypassing any config.bin in data directory
+
+class TextLatticeReader : public G4LatticeReader {
+public:
+  TextLatticeReader(G4int vb=0) : G4LatticeReader(vb) {;}
+
+  G4LatticeLogical* Parse(const G4String& filepath) {
+    if (!OpenFile(filepath)) {
+      CloseFile();
+      return 0;
+    }
+    return ParseFile(filepath);
+  }
+};
+
+
+// Count differences between lattice values, reporting each by name
+
+class LatticeCompare {
+public:
+  LatticeCompare(const G4String& label) : name(label), nBad(0) {;}
+
+  void Check(const G4String& what, G4double a, G4double b, G4double tol=0.) {
+    if (fabs(a-b) > tol*fabs(b)) Report(what, a, b);
+  }
+
+  void Check(const G4String& what, const G4ThreeVector& a,
+	     const G4ThreeVector& b, G4double tol=0.) {
+    if ((a-b).mag() > tol*b.mag()) Report(what, a, b);
+  }
+
+  void Check(const G4String& what, const G4RotationMatrix& a,
+	     const G4RotationMatrix& b) {
+    if (a != b) Report(what, a, b);
+  }
+
+  void Check(const G4String& what, const G4String& a, const G4String& b) {
+    if (a != b) Report(what, a, b);
+  }
+
+  G4int Done() {
+    G4cout << " " << name << ": " << nBad << " differences" << G4endl;
+    if (nBad) {
+      G4cerr << " " << name << " DIFFERS FROM TEXT LATTICE" << G4endl;
+      nErrors++;
+    }
+    return nBad;
+  }
+
+protected:
+  template <class T>
+  void Report(const G4String& what, const T& a, const T& b) {
+    if (verbose) G4cerr << " " << name << " " << what << ": " << a
+			<< " expected " << b << G4endl;
+    nBad++;
+  }
+
+private:
+  G4String name;
+  G4int nBad;
+};
+
+
+// Compare every parameter and derived table of lattice with text version
+
+void compare(const G4String& name, const G4LatticeLogical* lat,
+	     const G4LatticeLogical* text) {
+  LatticeCompare cmp(name);
+
+  cmp.Check("name", lat->GetName(), text->GetName());
+
+  // Dump includes crystal group, which has no accessor
+  std::ostringstream latDump, textDump;
+  lat->Dump(latDump);
+  text->Dump(textDump);
+  cmp.Check("Dump()", G4String(latDump.str()), G4String(textDump.str()));
+
+  for (G4int i=0; i<3; i++) {
+    cmp.Check("basis "+std::to_string(i), lat->GetBasis(i), text->GetBasis(i));
+  }
+
+  cmp.Check("density", lat->GetDensity(), text->GetDensity());
+  cmp.Check("impurities", lat->GetImpurities(), text->GetImpurities());
+  cmp.Check("permittivity", lat->GetPermittivity(), text->GetPermittivity());
+
+  for (G4int p=1; p<=6; p++) {
+    for (G4int q=1; q<=6; q++) {
+      cmp.Check("C"+std::to_string(p)+std::to_string(q),
+		lat->GetCpq(p,q), text->GetCpq(p,q));
+    }
+  }
+
+  cmp.Check("beta", lat->GetBeta(), text->GetBeta());
+  cmp.Check("gamma", lat->GetGamma(), text->GetGamma());
+  cmp.Check("lambda", lat->GetLambda(), text->GetLambda());
+  cmp.Check("mu", lat->GetMu(), text->GetMu());
+  cmp.Check("scat", lat->GetScatteringConstant(), text->GetScatteringConstant());
+  cmp.Check("decay", lat->GetAnhDecConstant(), text->GetAnhDecConstant());
+  cmp.Check("decayTT", lat->GetAnhTTFrac(), text->GetAnhTTFrac());
+  cmp.Check("LDOS", lat->GetLDOS(), text->GetLDOS());
+  cmp.Check("STDOS", lat->GetSTDOS(), text->GetSTDOS());
+  cmp.Check("FTDOS", lat->GetFTDOS(), text->GetFTDOS());
+  cmp.Check("debye", lat->GetDebyeEnergy(), text->GetDebyeEnergy());
+
+  cmp.Check("bandgap", lat->GetBandGapEnergy(), text->GetBandGapEnergy());
+  cmp.Check("pairEnergy", lat->GetPairProductionEnergy(),
+	    text->GetPairProductionEnergy());
+  cmp.Check("fanoFactor", lat->GetFanoFactor(), text->GetFanoFactor());
+  cmp.Check("vsound", lat->GetSoundSpeed(), text->GetSoundSpeed());
+  cmp.Check("vtrans", lat->GetTransverseSoundSpeed(),
+	    text->GetTransverseSoundSpeed());
+  cmp.Check("l0_h", lat->GetHoleScatter(), text->GetHoleScatter());
+  cmp.Check("l0_e", lat->GetElectronScatter(), text->GetElectronScatter());
+  cmp.Check("hmass", lat->GetHoleMass(), text->GetHoleMass());
+  cmp.Check("emass", lat->GetElectronMass(), text->GetElectronMass());
+  cmp.Check("emassDOS", lat->GetElectronDOSMass(), text->GetElectronDOSMass());
+
+  cmp.Check("mass tensor", lat->GetMassTensor(), text->GetMassTensor());
+  cmp.Check("inverse mass", lat->GetMInvTensor(), text->GetMInvTensor());
+  cmp.Check("sqrt mass", lat->GetSqrtTensor(), text->GetSqrtTensor());
+  cmp.Check("sqrt inverse", lat->GetSqrtInvTensor(), text->GetSqrtInvTensor());
+
+  cmp.Check("valleys", lat->NumberOfValleys(), text->NumberOfValleys());
+  for (size_t iv=0; iv<lat->NumberOfValleys() &&
+	 iv<text->NumberOfValleys(); iv++) {
+    G4String valley = "valley "+std::to_string(iv);
+    cmp.Check(valley, lat->GetValley(iv), text->GetValley(iv));
+    cmp.Check(valley+" inverse", lat->GetValleyInv(iv), text->GetValleyInv(iv));
+    cmp.Check(valley+" axis", lat->GetValleyAxis(iv), text->GetValleyAxis(iv));
+  }
+
+  cmp.Check("alpha", lat->GetAlpha(), text->GetAlpha());
+  cmp.Check("acDeform_e", lat->GetElectronAcousticDeform(),
+	    text->GetElectronAcousticDeform());
+  cmp.Check("acDeform_h", lat->GetHoleAcousticDeform(),
+	    text->GetHoleAcousticDeform());
+
+  cmp.Check("ivDeform", lat->GetNIVDeform(), text->GetNIVDeform());
+  for (G4int i=0; i<lat->GetNIVDeform(); i++) {
+    cmp.Check("ivDeform "+std::to_string(i), lat->GetIVDeform(i),
+	      text->GetIVDeform(i));
+    cmp.Check("ivEnergy "+std::to_string(i), lat->GetIVEnergy(i),
+	      text->GetIVEnergy(i));
+  }
+
+  cmp.Check("ivModel", lat->GetIVModel(), text->GetIVModel());
+  cmp.Check("ivQuadField", lat->GetIVQuadField(), text->GetIVQuadField());
+  cmp.Check("ivQuadRate", lat->GetIVQuadRate(), text->GetIVQuadRate());
+  cmp.Check("ivQuadExponent", lat->GetIVQuadExponent(),
+	    text->GetIVQuadExponent());
+  cmp.Check("ivLinRate0", lat->GetIVLinRate0(), text->GetIVLinRate0());
+  cmp.Check("ivLinRate1", lat->GetIVLinRate1(), text->GetIVLinRate1());
+  cmp.Check("ivLinExponent", lat->GetIVLinExponent(), text->GetIVLinExponent());
+
+  // Derived tables, filled by Initialize() or read from compiled lattice
+  for (G4int i=0; i<3; i++) {
+    for (G4int j=0; j<3; j++) {
+      for (G4int k=0; k<3; k++) {
+	for (G4int l=0; l<3; l++) {
+	  cmp.Check("C"+std::to_string(i)+std::to_string(j)+std::to_string(k)
+		    +std::to_string(l), lat->GetCijkl(i,j,k,l),
+		    text->GetCijkl(i,j,k,l));
+	}
+      }
+    }
+  }
+
+  for (G4int mode=0; mode<G4PhononPolarization::NUM_MODES; mode++) {
+    G4String kvg = "K-Vg " + G4PhononPolarization::Label(mode);
+    for (const G4ThreeVector& k: kSample) {
+      cmp.Check(kvg, lat->MapKtoVg(mode, k), text->MapKtoVg(mode, k), 1e-12);
+    }
+  }
+
+  const G4CMPAnharmonicTable* anh = lat->GetAnharmonicTable();
+  const G4CMPAnharmonicTable* textAnh = text->GetAnharmonicTable();
+  if ((anh == 0) != (textAnh == 0)) {
+    cmp.Check("anharmonic table", G4String(anh ? "filled" : "missing"),
+	      G4String(textAnh ? "filled" : "missing"));
+  } else if (anh) {
+    cmp.Check("anharmonic vL/vT", anh->GetVLVT(), textAnh->GetVLVT());
+    for (G4double u=0.; u<1.; u+=1./64.) {
+      cmp.Check("anharmonic TT", anh->SampleTT(u), textAnh->SampleTT(u));
+      cmp.Check("anharmonic LT", anh->SampleLT(u), textAnh->SampleLT(u));
+    }
+  }
+
+  cmp.Done();
+}
+
+
+// Read compiled lattice from file, and set density if not already done
+
+G4LatticeLogical* readFile(const G4String& binfile, G4double density) {
+  std::ifstream input(binfile, std::ios::binary);
+  G4LatticeLogical* lattice = new G4LatticeLogical;
+  if (!input.good() || !lattice->ReadCompiled(input)) {
+    G4cerr << " UNABLE TO READ COMPILED LATTICE " << binfile << G4endl;
+    nErrors++;
+    delete lattice;
+    return 0;
+  }
+
+  if (lattice->GetDensity() <= 0.) lattice->SetDensity(density);
+  lattice->Initialize();
+  return lattice;
+}
+
+
+// Main test is here
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    G4cerr << "Usage: " << argv[0] << " <Lattice> [N] [seed] [verbose]"
+	   << G4endl;
+    ::exit(1);
+  }
+
+  G4String lname = argv[1];
+  G4String mname = "G4_"+lname;
+
+  G4int n = (argc>2) ? atoi(argv[2]) : 1000;
+  G4long seed = (argc>3) ? atol(argv[3]) : 20261019;
+  verbose = (argc>4) ? atoi(argv[4]) : 0;
+
+  G4Random::setTheSeed(seed);
+  G4CMPConfigManager::UseKVSolver(false);	// Use K-Vg lookup table
+
+  for (G4int i=0; i<n; i++) kSample.push_back(G4RandomDirection());
+
+  G4Material* mat = G4NistManager::Instance()->FindOrBuildMaterial(mname);
+  if (!mat) {
+    G4cerr << " Unable to build " << mname << G4endl;
+    ::exit(1);
+  }
+
+  const G4double density = mat->GetDensity();
+  const G4String config = lname+"/config.txt";
+
+  TextLatticeReader reader(verbose);
+  G4LatticeLogical* text = reader.Parse(config);
+  if (!text) {
+    G4cerr << " Unable to load " << lname << " lattice" << G4endl;
+    ::exit(1);
+  }
+
+  text->SetDensity(density);
+  text->Initialize(lname);
+
+  G4cout << lname << " lattice, density " << density/(g/cm3) << " g/cm3"
+	 << G4endl;
+
+  // Write to memory and read back directly
+  std::stringstream buffer;
+  if (!text->WriteCompiled(buffer)) {
+    G4cerr << " UNABLE TO WRITE COMPILED LATTICE" << G4endl;
+    ::exit(++nErrors);
+  }
+
+  G4LatticeLogical* compiled = new G4LatticeLogical;
+  if (!compiled->ReadCompiled(buffer)) {
+    G4cerr << " UNABLE TO READ COMPILED LATTICE" << G4endl;
+    nErrors++;
+  } else {
+    compiled->Initialize();
+    compare("WriteCompiled/ReadCompiled", compiled, text);
+  }
+  delete compiled;
+
+  // Incomplete lattice must not be accepted
+  const std::string image = buffer.str();
+  std::istringstream truncated(image.substr(0, image.size()/2));
+  G4LatticeLogical partial;
+  if (partial.ReadCompiled(truncated)) {
+    G4cerr << " TRUNCATED COMPILED LATTICE WAS READ" << G4endl;
+    nErrors++;
+  }
+
+  // Compile through reader, with and without K-Vg table
+  const G4String binfile = "testCompiledLattice.bin";
+  for (G4double compileDensity: { density, 0. }) {
+    G4String name = (compileDensity > 0. ? "CompileLattice with K-Vg"
+		     : "CompileLattice without K-Vg");
+
+    if (!reader.CompileLattice(config, compileDensity, binfile)) {
+      G4cerr << " " << name << " FAILED" << G4endl;
+      nErrors++;
+      continue;
+    }
+
+    G4LatticeLogical* fromFile = readFile(binfile, density);
+    if (fromFile) {
+      fromFile->SetName(lname);		// Name isn't set by reader
+      compare(name, fromFile, text);
+    }
+    delete fromFile;
+  }
+
+  remove(binfile.c_str());
+  delete text;
+
+  G4cout << "\n" << nErrors << " errors found" << G4endl;
+  ::exit(nErrors);
+}
@@ -0,0 +1,305 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: testHitImage [N] [seed] [verbose]
+//
+// Verify G4CMPHitImage with N random hits on a tilted face, with two
+// imaged modes, time and energy slices, and energy weighting.  Hits
+// include unimaged particle types and positions, times and energies
+// outside the binning.  Each bin is compared with a reference histogram
+// filled directly in this test.
+//
+// The hits are also split between two images, which must Merge() to the
+// same contents, while an image with different binning must not merge.
+// The image is written to a file and read back, and must have the same
+// configuration and contents.  A copy of the file with a duplicated mode
+// in the header must be rejected by Read(), leaving the image unchanged.
+//
+// Returns number of errors.
+//
+// 20261019  New test for in-memory hit images
+
+#include "globals.hh"
+#include "G4CMPHitImage.hh"
+#include "G4CMPHitWriter.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "Randomize.hh"
+#include <fstream>
+#include <iterator>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+
+namespace {
+  G4int nErrors = 0;
+  G4int verbose = 0;
+
+  // Face is tilted about X axis, offset from origin
+  const G4ThreeVector origin(1.*mm, -2.*mm, 3.*mm);
+  const G4ThreeVector uAxis(1., 0., 0.);
+  const G4ThreeVector vAxis(0., cos(30.*deg), sin(30.*deg));
+
+  const size_t nu = 20, nv = 10;
+  const G4double umin = -4.*mm, umax = 6.*mm;
+  const G4double vmin = -3.*mm, vmax = 2.*mm;
+
+  const std::vector<G4int> modes = { G4CMPHitWriter::kPhononTS,
+				     G4CMPHitWriter::kPhononL };
+  const std::vector<G4double> tEdges = { 0.*ns, 10.*ns, 100.*ns, 1.*us };
+  const std::vector<G4double> eEdges = { 0.*eV, 1.*meV, 10.*meV };
+
+  struct Hit {
+    G4int type;
+    G4ThreeVector pos;
+    G4double time, energy, weight;
+  };
+}
+
+
+// Configure image as above
+
+void configure(G4CMPHitImage& image) {
+  image.SetFace(origin, uAxis, vAxis);
+  image.SetBinning(nu, umin, umax, nv, vmin, vmax);
+  image.SetModes(modes);
+  image.SetTimeSlices(tEdges);
+  image.SetEnergySlices(eEdges);
+  image.SetWeighting(G4CMPHitImage::kEnergy);
+}
+
+
+// Random hits, including some outside of image in each dimension
+
+std::vector<Hit> makeHits(G4int n) {
+  std::vector<Hit> hits(n);
+  for (Hit& hit: hits) {
+    hit.type = 1 + G4int(G4UniformRand()*(G4CMPHitWriter::kNumParticleTypes-1));
+
+    G4double u = umin + (1.2*G4UniformRand()-0.1)*(umax-umin);
+    G4double v = vmin + (1.2*G4UniformRand()-0.1)*(vmax-vmin);
+    G4double w = (G4UniformRand()-0.5)*mm;		// Off face is allowed
+    hit.pos = origin + u*uAxis + v*vAxis + w*uAxis.cross(vAxis);
+
+    hit.time = 1.1*tEdges.back()*G4UniformRand();
+    hit.energy = 1.1*eEdges.back()*G4UniformRand();
+    hit.weight = 0.5 + G4UniformRand();
+  }
+
+  return hits;
+}
+
+
+// Reference histogram, in same layout as G4CMPHitImage contents
+
+std::vector<G4double> reference(const std::vector<Hit>& hits,
+				const G4CMPHitImage& image,
+				uint64_t& nEntries, uint64_t& nOutside) {
+  const size_t nt = tEdges.size()-1, ne = eEdges.size()-1;
+  std::vector<G4double> bins(modes.size()*nt*ne*nv*nu, 0.);
+
+  nEntries = nOutside = 0;
+  for (const Hit& hit: hits) {
+    size_t mode = 0;
+    while (mode < modes.size() && modes[mode] != hit.type) mode++;
+    if (mode == modes.size()) continue;
+
+    nEntries++;
+
+    size_t it = 0, ie = 0;
+    while (it < nt && hit.time >= tEdges[it+1]) it++;
+    while (ie < ne && hit.energy >= eEdges[ie+1]) ie++;
+
+    // Same arithmetic as G4CMPHitImage, with its normalized axes
+    G4ThreeVector local = hit.pos - origin;
+    G4double u = (local.dot(image.GetUAxis()) - umin) * (nu/(umax-umin));
+    G4double v = (local.dot(image.GetVAxis()) - vmin) * (nv/(vmax-vmin));
+
+    if (it == nt || ie == ne || !(u >= 0. && u < nu && v >= 0. && v < nv)) {
+      nOutside++;
+      continue;
+    }
+
+    size_t iu = size_t(u), iv = size_t(v);
+
+    bins[(((mode*nt + it)*ne + ie)*nv + iv)*nu + iu] +=
+      hit.weight * hit.energy/eV;
+  }
+
+  return bins;
+}
+
+
+// Compare image contents with reference
+
+G4bool compare(const G4String& name, const G4CMPHitImage& image,
+	       const std::vector<G4double>& bins, uint64_t nEntries,
+	       uint64_t nOutside) {
+  G4int nBad = 0;
+  const size_t nImage = nu*nv;
+  for (size_t mode=0; mode<modes.size(); mode++) {
+    for (size_t it=0; it<image.GetNTimeSlices(); it++) {
+      for (size_t ie=0; ie<image.GetNEnergySlices(); ie++) {
+	const G4double* img = image.GetImage(mode, it, ie);
+	const G4double* ref = &bins[((mode*image.GetNTimeSlices() + it)
+				     * image.GetNEnergySlices() + ie) * nImage];
+	for (size_t i=0; img && i<nImage; i++) {
+	  if (fabs(img[i]-ref[i]) > 1e-9*fabs(ref[i])) {
+	    if (verbose) G4cerr << " " << name << " mode " << mode << " slice "
+				<< it << " " << ie << " bin " << i << ": "
+				<< img[i] << " expected " << ref[i] << G4endl;
+	    nBad++;
+	  }
+	}
+	if (!img) nBad++;
+      }
+    }
+  }
+
+  if (image.GetEntries() != nEntries || image.GetOutside() != nOutside) {
+    if (verbose) G4cerr << " " << name << " entries " << image.GetEntries()
+			<< " outside " << image.GetOutside() << ", expected "
+			<< nEntries << " " << nOutside << G4endl;
+    nBad++;
+  }
+
+  G4cout << " " << name << ": " << nBad << " bins differ" << G4endl;
+  if (nBad) {
+    G4cerr << " " << name << " DIFFERS FROM REFERENCE" << G4endl;
+    nErrors++;
+  }
+
+  return (nBad == 0);
+}
+
+
+// Images must have same configuration after Read(); values in file are
+// in mm, ns and eV, so allow for rounding
+
+G4bool sameEdges(const std::vector<G4double>& a,
+		 const std::vector<G4double>& b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i=0; i<a.size(); i++) {
+    if (fabs(a[i]-b[i]) > 1e-12*fabs(b[i])) return false;
+  }
+  return true;
+}
+
+
+void compareConfig(const G4CMPHitImage& image, const G4CMPHitImage& ref) {
+  if (image.GetOrigin() != ref.GetOrigin() ||
+      image.GetUAxis() != ref.GetUAxis() ||
+      image.GetVAxis() != ref.GetVAxis() ||
+      image.GetNU() != ref.GetNU() || image.GetNV() != ref.GetNV() ||
+      image.GetUMin() != ref.GetUMin() || image.GetUMax() != ref.GetUMax() ||
+      image.GetVMin() != ref.GetVMin() || image.GetVMax() != ref.GetVMax() ||
+      image.GetModes() != ref.GetModes() ||
+      !sameEdges(image.GetTimeSlices(), ref.GetTimeSlices()) ||
+      !sameEdges(image.GetEnergySlices(), ref.GetEnergySlices()) ||
+      image.GetWeighting() != ref.GetWeighting()) {
+    G4cerr << " IMAGE CONFIGURATION CHANGED BY WRITE/READ" << G4endl;
+    nErrors++;
+  }
+}
+
+
+// Main test is here
+
+int main(int argc, char* argv[]) {
+  G4int n = (argc>1) ? atoi(argv[1]) : 100000;
+  G4long seed = (argc>2) ? atol(argv[2]) : 20261019;
+  verbose = (argc>3) ? atoi(argv[3]) : 0;
+
+  G4Random::setTheSeed(seed);
+
+  // Fill single image with all hits
+  G4CMPHitImage image;
+  configure(image);
+
+  std::vector<Hit> hits = makeHits(n);
+  uint64_t nEntries = 0, nOutside = 0;
+  std::vector<G4double> bins = reference(hits, image, nEntries, nOutside);
+
+  G4cout << "G4CMPHitImage " << n << " hits, " << nEntries << " imaged, "
+	 << nOutside << " outside" << G4endl;
+
+  for (const Hit& hit: hits) {
+    image.Fill(hit.type, hit.pos, hit.time, hit.energy, hit.weight);
+  }
+
+  compare("Fill", image, bins, nEntries, nOutside);
+
+  // Fill two images with alternate hits, and combine them
+  G4CMPHitImage even, odd;
+  configure(even);
+  configure(odd);
+  for (size_t i=0; i<hits.size(); i++) {
+    const Hit& hit = hits[i];
+    (i%2 ? odd : even).Fill(hit.type, hit.pos, hit.time, hit.energy,
+			     hit.weight);
+  }
+
+  if (!even.Merge(odd)) {
+    G4cerr << " IDENTICAL IMAGES NOT MERGED" << G4endl;
+    nErrors++;
+  }
+  compare("Merge", even, bins, nEntries, nOutside);
+
+  G4CMPHitImage other;
+  configure(other);
+  other.SetBinning(nu+1, umin, umax, nv, vmin, vmax);
+  if (other.Merge(image)) {
+    G4cerr << " IMAGES WITH DIFFERENT BINNING MERGED" << G4endl;
+    nErrors++;
+  }
+
+  // Write image, and read it back into default image
+  const G4String fileName = "testHitImage.img";
+  if (!image.Write(fileName)) {
+    G4cerr << " UNABLE TO WRITE " << fileName << G4endl;
+    ::exit(++nErrors);
+  }
+
+  G4CMPHitImage readBack;
+  if (!readBack.Read(fileName)) {
+    G4cerr << " UNABLE TO READ " << fileName << G4endl;
+    nErrors++;
+  } else {
+    compareConfig(readBack, image);
+    compare("Write/Read", readBack, bins, nEntries, nOutside);
+  }
+
+  // Duplicate mode in header must be rejected, without changing image
+  std::vector<char> data;
+  {
+    std::ifstream input(fileName, std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(input),
+		std::istreambuf_iterator<char>());
+  }
+
+  const size_t modeOffset = sizeof(G4CMPHitImage::kMagic) + 3*sizeof(uint32_t);
+  if (data.size() > modeOffset+1) data[modeOffset+1] = data[modeOffset];
+
+  const G4String badName = "testHitImage-bad.img";
+  {
+    std::ofstream output(badName, std::ios::binary|std::ios::trunc);
+    output.write(data.data(), data.size());
+  }
+
+  if (readBack.Read(badName)) {
+    G4cerr << " IMAGE WITH DUPLICATE MODE WAS READ" << G4endl;
+    nErrors++;
+  }
+  compareConfig(readBack, image);
+  compare("Rejected Read", readBack, bins, nEntries, nOutside);
+
+  remove(fileName.c_str());
+  remove(badName.c_str());
+
+  G4cout << "\n" << nErrors << " errors found" << G4endl;
+  ::exit(nErrors);
+}
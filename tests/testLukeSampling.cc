@@ -0,0 +1,167 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: testLukeSampling [N] [seed] [verbose]
+//
+// Verify that G4CMP::LukePhononWaveVector() reproduces the accept/reject
+// kinematics previously used in G4CMPLukeScattering, in which the polar
+// angle is drawn with G4CMPProcessUtils::MakePhononTheta() and the phonon
+// wavevector is rotated into place about the carrier direction.  With the
+// same random seed the two must agree point-for-point.  The polar angle
+// distribution is also compared to its analytic CDF with a Kolmogorov-
+// Smirnov test, for several Mach ratios (k/ks).
+//
+// Returns number of errors.
+//
+// 20261019  New test for direct Luke phonon sampling
+
+#include "globals.hh"
+#include "G4CMPProcessUtils.hh"
+#include "G4CMPUtils.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4RandomDirection.hh"
+#include "G4ThreeVector.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace {
+  G4CMPProcessUtils* utils = 0;		// For reference MakePhononTheta()
+  G4int nErrors = 0;
+  G4int verbose = 0;
+}
+
+
+// Reference kinematics, as formerly done in G4CMPLukeScattering
+
+G4ThreeVector referencePhonon(const G4ThreeVector& ktrk, G4double kSound) {
+  G4double kmag = ktrk.mag();
+  G4ThreeVector kdir = ktrk.unit();
+
+  G4double theta_phonon = utils->MakePhononTheta(kmag, kSound);
+  G4double phi_phonon   = G4UniformRand()*twopi;
+  G4double q = 2*(kmag*cos(theta_phonon)-kSound);
+
+  G4ThreeVector qvec = q*kdir;
+  qvec.rotate(kdir.orthogonal(), theta_phonon);
+  qvec.rotate(kdir, phi_phonon);
+
+  return qvec;
+}
+
+
+// Compare direct sampling to reference algorithm with same seed
+
+void testReference(G4int n, G4double mach) {
+  G4int nDiffer = 0;
+
+  for (G4int i=0; i<n; i++) {
+    G4ThreeVector ktrk = G4RandomDirection() * mach;	// Units of ks
+
+    G4long seed = 20261019 + i;
+    G4Random::setTheSeed(seed);
+    G4ThreeVector qnew = G4CMP::LukePhononWaveVector(ktrk, 1.);
+
+    G4Random::setTheSeed(seed);
+    G4ThreeVector qref = referencePhonon(ktrk, 1.);
+
+    if ((qnew-qref).mag() > 1e-6*mach) {
+      if (verbose) G4cerr << " k " << ktrk << " q " << qnew << " reference "
+			  << qref << G4endl;
+      nDiffer++;
+    }
+  }
+
+  G4cout << " k/ks " << mach << ": " << nDiffer << " of " << n
+	 << " differ from reference" << G4endl;
+
+  if (nDiffer) nErrors++;
+}
+
+
+// Compare polar angle to analytic CDF, check azimuth is uniform
+
+void testDistribution(G4int n, G4double mach) {
+  G4ThreeVector ktrk(0., 0., mach);		// Units of ks
+  G4double v = 1./mach;
+
+  std::vector<G4double> cosTh;
+  cosTh.reserve(n);
+  G4ThreeVector perpSum;
+  G4int nBadQ = 0;
+
+  for (G4int i=0; i<n; i++) {
+    G4ThreeVector qvec = G4CMP::LukePhononWaveVector(ktrk, 1.);
+    G4double c = qvec.cosTheta();
+    cosTh.push_back(c);
+    perpSum += qvec.perpPart().unit();
+
+    // Phonon magnitude from energy-momentum conservation
+    if (fabs(qvec.mag() - 2.*(mach*c-1.)) > 1e-9*mach) nBadQ++;
+  }
+
+  // cos(theta) = v + (1-v)*cbrt(1-u), so CDF(c) = ((c-v)/(1-v))^3
+  std::sort(cosTh.begin(), cosTh.end());
+  G4double ksD = 0.;
+  for (G4int i=0; i<n; i++) {
+    G4double w = (cosTh[i]-v)/(1.-v);
+    G4double cdf = std::min(1., std::max(0., w*w*w));
+    ksD = std::max({ksD, fabs(cdf-G4double(i)/n), fabs(cdf-G4double(i+1)/n)});
+  }
+
+  G4double ksLimit = 1.63/sqrt(n);		// 1% significance
+  G4double phiMean = perpSum.mag()/n;
+
+  G4cout << " k/ks " << mach << ": polar KS distance " << ksD
+	 << " (limit " << ksLimit << "), mean azimuth " << phiMean
+	 << " (limit " << 4./sqrt(n) << ")" << G4endl;
+
+  if (ksD > ksLimit) {
+    G4cerr << " POLAR ANGLE DISTRIBUTION DOES NOT MATCH" << G4endl;
+    nErrors++;
+  }
+
+  if (phiMean > 4./sqrt(n)) {
+    G4cerr << " AZIMUTH NOT UNIFORM" << G4endl;
+    nErrors++;
+  }
+
+  if (nBadQ) {
+    G4cerr << " " << nBadQ << " PHONONS WITH WRONG MAGNITUDE" << G4endl;
+    nErrors++;
+  }
+}
+
+
+// Main test is here
+
+int main(int argc, char* argv[]) {
+  G4int n = (argc>1) ? atoi(argv[1]) : 100000;
+  G4long seed = (argc>2) ? atol(argv[2]) : 20261019;
+  verbose = (argc>3) ? atoi(argv[3]) : 0;
+
+  utils = new G4CMPProcessUtils;
+
+  G4cout << "G4CMP::LukePhononWaveVector " << n << " samples" << G4endl;
+
+  const G4double machs[] = { 1.001, 1.1, 2., 10., 100. };
+  for (G4double mach: machs) testReference(n/10+1, mach);
+
+  G4Random::setTheSeed(seed);
+  for (G4double mach: machs) testDistribution(n, mach);
+
+  // Below sound speed, no phonon is emitted
+  if (G4CMP::LukePhononWaveVector(G4ThreeVector(0.,0.,0.5), 1.).mag() != 0.) {
+    G4cerr << " PHONON EMITTED BELOW SOUND SPEED" << G4endl;
+    nErrors++;
+  }
+
+  G4cout << "\n" << nErrors << " errors found" << G4endl;
+
+  delete utils;
+  ::exit(nErrors);
+}
@@ -0,0 +1,399 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: testMacroCarriers <Lattice> [N] [seed] [verbose]
+//
+// Verify macro-carrier charge transport (/g4cmp/macroCharges).
+//
+// G4CMPEnergyPartition must group the charge pairs from a 100 keV
+// ionization deposit into bundles of at most N pairs, with multiplicities
+// differing by no more than one, the same multiplicity for electrons and
+// holes, and weights proportional to multiplicity.  The summed weight must
+// equal the true number of pairs, with and without downsampling.
+//
+// G4CMPDriftTrappingProcess must remove one carrier from a bundle for each
+// trap, reducing multiplicity and weight, and kill the track only when its
+// last carrier is trapped.
+//
+// G4CMPElectrodeSensitivity must split a bundle's hit into the configured
+// number of pieces, which together have the same weight and energy
+// deposit, spread in the electrode plane with the bundle's diffusion width.
+//
+// G4CMPDriftTrackInfo must grow the diffusion width only from displacement
+// transverse to the drift field; N isotropic random steps must average to
+// the same width as without a field.
+//
+// Geant4 material will be set as "G4_<Lattice>".
+//
+// Returns number of errors.
+//
+// 20261019  New test for macro-carrier bundles
+
+#include "globals.hh"
+#include "G4Box.hh"
+#include "G4CMPConfigManager.hh"
+#include "G4CMPDriftElectron.hh"
+#include "G4CMPDriftTrackInfo.hh"
+#include "G4CMPDriftTrappingProcess.hh"
+#include "G4CMPElectrodeHit.hh"
+#include "G4CMPElectrodeSensitivity.hh"
+#include "G4CMPEnergyPartition.hh"
+#include "G4CMPPrimaryInfo.hh"
+#include "G4CMPTrackUtils.hh"
+#include "G4CMPUtils.hh"
+#include "G4DynamicParticle.hh"
+#include "G4LatticeManager.hh"
+#include "G4LatticePhysical.hh"
+#include "G4LogicalVolume.hh"
+#include "G4NistManager.hh"
+#include "G4PVPlacement.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4RandomDirection.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "G4Track.hh"
+#include "G4VParticleChange.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+
+namespace {
+  G4int nErrors = 0;
+  G4int verbose = 0;
+
+  G4LatticePhysical* lattice = 0;
+  G4CMPEnergyPartition* partition = 0;
+}
+
+
+// Partition ionization into bundles of up to nMacro pairs
+
+void testPartition(G4double energy, G4int nMacro, G4double eSample) {
+  G4CMPConfigManager::SetMacroCharges(nMacro);
+  G4CMPConfigManager::SetSamplingEnergy(eSample);
+
+  partition->DoPartition(energy, 0.);
+
+  std::vector<G4PrimaryParticle*> prim;
+  partition->GetPrimaries(prim);
+
+  std::vector<G4int> eMult, hMult;
+  G4double eWeight = 0., wPerCarrier = -1.;
+  G4bool badWeight = false;
+
+  for (G4PrimaryParticle* p: prim) {
+    if (!G4CMP::IsChargeCarrier(p->GetParticleDefinition())) continue;
+
+    const G4CMPPrimaryInfo* info =
+      dynamic_cast<const G4CMPPrimaryInfo*>(p->GetUserInformation());
+    G4int mult = info ? info->Multiplicity() : 1;
+
+    if (G4CMP::IsElectron(p->GetParticleDefinition())) {
+      eMult.push_back(mult);
+      eWeight += p->GetWeight();
+    } else {
+      hMult.push_back(mult);
+    }
+
+    // Every bundle has same weight per carrier (1/downsampling)
+    G4double wt = p->GetWeight()/mult;
+    if (wPerCarrier < 0.) wPerCarrier = wt;
+    badWeight |= (fabs(wt-wPerCarrier) > 1e-12*wPerCarrier);
+  }
+
+  for (G4PrimaryParticle* p: prim) delete p;
+
+  G4long nPairs = 0;
+  for (G4int mult: eMult) nPairs += mult;
+
+  G4int minMult = eMult.empty() ? 0 : *std::min_element(eMult.begin(), eMult.end());
+  G4int maxMult = eMult.empty() ? 0 : *std::max_element(eMult.begin(), eMult.end());
+
+  // Fano statistics are disabled, so true number of pairs is fixed
+  G4double nTrue = std::round(energy/lattice->GetPairProductionEnergy());
+
+  G4cout << " macroCharges " << nMacro << " sampling " << eSample/keV
+	 << " keV: " << nPairs << " pairs in " << eMult.size()
+	 << " bundles of " << minMult << " to " << maxMult
+	 << ", weight " << eWeight << " (true pairs " << nTrue << ")" << G4endl;
+
+  G4long nBundles = (nPairs + nMacro-1) / nMacro;
+
+  if (G4long(eMult.size()) != nBundles ||
+      partition->GetNumberOfCharges() != 2*eMult.size()) {
+    G4cerr << " " << eMult.size() << " BUNDLES FOR " << nPairs
+	   << " PAIRS, EXPECTED " << nBundles << G4endl;
+    nErrors++;
+  }
+
+  if (minMult < 1 || maxMult > nMacro || maxMult-minMult > 1) {
+    G4cerr << " BUNDLE MULTIPLICITIES NOT EVEN" << G4endl;
+    nErrors++;
+  }
+
+  if (eMult != hMult) {
+    G4cerr << " ELECTRON AND HOLE BUNDLES DIFFER" << G4endl;
+    nErrors++;
+  }
+
+  if (badWeight) {
+    G4cerr << " WEIGHTS NOT PROPORTIONAL TO MULTIPLICITY" << G4endl;
+    nErrors++;
+  }
+
+  if (fabs(eWeight-nTrue) > 1e-9*nTrue) {
+    G4cerr << " WEIGHTED PAIRS " << eWeight << " EXPECTED " << nTrue << G4endl;
+    nErrors++;
+  }
+}
+
+
+// Trap carriers one at a time until bundle is gone
+
+void testTrapping(G4int mult) {
+  const G4double weight0 = 2.5;
+
+  G4Track* track = new G4Track(new G4DynamicParticle(G4CMPDriftElectron::Definition(),
+						     G4RandomDirection(), 1.*eV),
+			       0., G4ThreeVector());
+  track->SetWeight(weight0);
+
+  G4CMPDriftTrackInfo* info = new G4CMPDriftTrackInfo(lattice, 0);
+  info->SetMultiplicity(mult);
+  G4CMP::AttachTrackInfo(*track, info);
+
+  G4CMPDriftTrappingProcess trapping;
+  G4Step step;
+
+  G4int nTraps = 0;
+  G4bool killed = false, bad = false;
+  while (!killed && nTraps <= mult) {
+    G4VParticleChange* change = trapping.PostStepDoIt(*track, step);
+    nTraps++;
+
+    killed = (change->GetTrackStatus() == fStopAndKill);
+    if (killed) break;
+
+    track->SetWeight(change->GetWeight());
+
+    // Remaining carriers keep their share of original weight
+    G4int left = mult - nTraps;
+    G4double expected = weight0*left/mult;
+    if (info->Multiplicity() != left ||
+	fabs(track->GetWeight()-expected) > 1e-12*weight0) {
+      if (verbose) G4cerr << "  after " << nTraps << " traps multiplicity "
+			  << info->Multiplicity() << " weight "
+			  << track->GetWeight() << ", expected " << left
+			  << " " << expected << G4endl;
+      bad = true;
+    }
+  }
+
+  G4cout << " trapping bundle of " << mult << ": killed after " << nTraps
+	 << " traps" << G4endl;
+
+  if (bad) {
+    G4cerr << " TRAPPING DID NOT REDUCE BUNDLE BY ONE CARRIER" << G4endl;
+    nErrors++;
+  }
+
+  if (!killed || nTraps != mult) {
+    G4cerr << " BUNDLE OF " << mult << " NOT KILLED BY LAST TRAP" << G4endl;
+    nErrors++;
+  }
+
+  delete track;
+}
+
+
+// Split electrode hit from bundle, compare sum with original
+
+void testSplitting(G4int mult, G4int nSplitConfig, G4double sigma) {
+  G4CMPConfigManager::SetMacroSplitHits(nSplitConfig);
+
+  G4int nsplit = G4CMPElectrodeSensitivity::NumberOfSplitHits(mult);
+  G4int expected = (nSplitConfig <= 0 || nSplitConfig > mult) ? mult
+    : nSplitConfig;
+
+  const G4double weight0 = 3.*mult, edep0 = 1.5*eV;
+  const G4ThreeVector center(1.*mm, 2.*mm, -3.*mm);
+  const G4ThreeVector norm = G4RandomDirection();
+
+  G4CMPElectrodeHit* hit = new G4CMPElectrodeHit;
+  hit->SetWeight(weight0);
+  hit->SetEnergyDeposit(edep0);
+  hit->SetFinalPosition(center);
+
+  std::vector<G4CMPElectrodeHit*> subhits;
+  G4CMPElectrodeSensitivity::SplitHit(hit, nsplit, sigma, norm, subhits);
+
+  G4double wsum = 0., esum = 0., var = 0.;
+  G4bool offPlane = false;
+  for (G4CMPElectrodeHit* sub: subhits) {
+    wsum += sub->GetWeight();
+    esum += sub->GetEnergyDeposit();
+
+    G4ThreeVector offset = sub->GetFinalPosition() - center;
+    offPlane |= (fabs(offset.dot(norm)) > 1e-9*mm);
+    var += offset.mag2()/2.;			// Two axes in plane
+  }
+  if (!subhits.empty()) var /= subhits.size();
+
+  G4cout << " splitting bundle of " << mult << " (macroSplitHits "
+	 << nSplitConfig << "): " << subhits.size() << " hits, weight "
+	 << wsum << " energy " << esum/eV << " eV, width " << sqrt(var)/um
+	 << " um" << G4endl;
+
+  if (nsplit != expected || G4int(subhits.size()) != expected ||
+      (!subhits.empty() && subhits[0] != hit)) {
+    G4cerr << " BUNDLE OF " << mult << " SPLIT INTO " << subhits.size()
+	   << " HITS, EXPECTED " << expected << G4endl;
+    nErrors++;
+  }
+
+  if (fabs(wsum-weight0) > 1e-12*weight0 || fabs(esum-edep0) > 1e-12*edep0) {
+    G4cerr << " SPLIT HITS DO NOT CONSERVE WEIGHT AND ENERGY" << G4endl;
+    nErrors++;
+  }
+
+  if (offPlane) {
+    G4cerr << " SPLIT HITS SPREAD OUT OF ELECTRODE PLANE" << G4endl;
+    nErrors++;
+  }
+
+  // Sample variance of 2n offsets has relative error 1/sqrt(n)
+  if (subhits.size() > 100 && fabs(var/(sigma*sigma)-1.) > 5./sqrt(subhits.size())) {
+    G4cerr << " SPLIT HITS HAVE WIDTH " << sqrt(var)/um << " um, EXPECTED "
+	   << sigma/um << " um" << G4endl;
+    nErrors++;
+  }
+
+  if (sigma == 0. && var > 0.) {
+    G4cerr << " SPLIT HITS MOVED WITHOUT DIFFUSION" << G4endl;
+    nErrors++;
+  }
+
+  for (G4CMPElectrodeHit* sub: subhits) delete sub;
+}
+
+
+// Diffusion width must come only from transverse displacement
+
+void testDiffusion(G4int n) {
+  const G4double l = 1.*um;
+  const G4ThreeVector field(0., 0., 1.*volt/cm);
+  const G4ThreeVector start(1.*mm, -1.*mm, 0.);
+
+  G4CMPDriftTrackInfo along(lattice, 0);
+  along.AddDiffusion(start, start+l*field.unit(), field);
+  along.AddDiffusion(start, start-l*field.unit(), -field);
+
+  G4CMPDriftTrackInfo across(lattice, 0);
+  across.AddDiffusion(start, start+G4ThreeVector(l,0.,0.), field);
+
+  G4CMPDriftTrackInfo noField(lattice, 0);
+  noField.AddDiffusion(start, start+G4ThreeVector(l,0.,0.), G4ThreeVector());
+
+  G4cout << " diffusion widths for " << l/um << " um step: along field "
+	 << along.DiffusionWidth()/um << " um, across "
+	 << across.DiffusionWidth()/um << " um, no field "
+	 << noField.DiffusionWidth()/um << " um" << G4endl;
+
+  if (along.DiffusionWidth() > 1e-12*l) {
+    G4cerr << " DRIFT ALONG FIELD ADDED TO DIFFUSION" << G4endl;
+    nErrors++;
+  }
+
+  if (fabs(across.DiffusionWidth() - l/sqrt(2.)) > 1e-12*l ||
+      fabs(noField.DiffusionWidth() - l/sqrt(3.)) > 1e-12*l) {
+    G4cerr << " WRONG DIFFUSION FOR SINGLE STEP" << G4endl;
+    nErrors++;
+  }
+
+  // Isotropic steps: l_perp^2/2 has mean l^2/3, variance l^4/45
+  G4CMPDriftTrackInfo walk(lattice, 0);
+  G4ThreeVector pos = start;
+  for (G4int i=0; i<n; i++) {
+    G4ThreeVector next = pos + l*G4RandomDirection();
+    walk.AddDiffusion(pos, next, field);
+    pos = next;
+  }
+
+  G4double width2 = walk.DiffusionWidth()*walk.DiffusionWidth();
+  G4double mean = n*l*l/3., sigma = l*l*sqrt(n/45.);
+
+  G4cout << " random walk of " << n << " steps: width "
+	 << walk.DiffusionWidth()/um << " um, expected " << sqrt(mean)/um
+	 << " um (" << fabs(width2-mean)/sigma << " sigma)" << G4endl;
+
+  if (fabs(width2-mean) > 5.*sigma) {
+    G4cerr << " RANDOM WALK DIFFUSION DIFFERS FROM ISOTROPIC" << G4endl;
+    nErrors++;
+  }
+}
+
+
+// Main test is here
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    G4cerr << "Usage: " << argv[0] << " <Lattice> [N] [seed] [verbose]"
+	   << G4endl;
+    ::exit(1);
+  }
+
+  G4String lname = argv[1];
+  G4String mname = "G4_"+lname;
+
+  G4int n = (argc>2) ? atoi(argv[2]) : 10000;
+  G4long seed = (argc>3) ? atol(argv[3]) : 20261019;
+  verbose = (argc>4) ? atoi(argv[4]) : 0;
+
+  G4Random::setTheSeed(seed);
+
+  // MUST USE 'new', SO THAT G4SolidStore CAN DELETE
+  G4Material* mat = G4NistManager::Instance()->FindOrBuildMaterial(mname);
+  G4Box* crystal = new G4Box("Crystal", 5.*cm, 5.*cm, 1.*cm);
+  G4LogicalVolume* lv = new G4LogicalVolume(crystal, mat, crystal->GetName());
+  G4PVPlacement* pv = new G4PVPlacement(0, G4ThreeVector(), lv, lv->GetName(),
+					0, false, 1);
+
+  lattice = G4LatticeManager::Instance()->LoadLattice(pv,lname);
+  if (!lattice) {
+    G4cerr << " Unable to load " << lname << " lattice" << G4endl;
+    ::exit(1);
+  }
+
+  G4CMPConfigManager::EnableFanoStatistics(false);
+  G4CMPConfigManager::SetLukeSampling(-1.);
+
+  partition = new G4CMPEnergyPartition(pv);
+  partition->SetVerboseLevel(verbose);
+
+  const G4double energy = 100.*keV;
+  for (G4int nMacro: { 1, 7, 100, 1000 }) {
+    testPartition(energy, nMacro, 0.);
+    testPartition(energy, nMacro, energy/10.);
+  }
+
+  for (G4int mult: { 1, 2, 17 }) testTrapping(mult);
+
+  for (G4int nSplit: { 0, 1, 5, 2*n }) {
+    testSplitting(n, nSplit, 10.*um);
+  }
+  testSplitting(17, 0, 0.);
+  testSplitting(1, 0, 10.*um);
+
+  testDiffusion(n);
+
+  delete partition;
+
+  G4cout << "\n" << nErrors << " errors found" << G4endl;
+  ::exit(nErrors);
+}
@@ -0,0 +1,308 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: testMeshExitTime [N] [seed] [verbose]
+//
+// Verify G4CMPTriLinearInterp::GetExitTime() on a regular mesh (cubes
+// split into six tetrahedra) with random potentials at the mesh points, so
+// that every tetrahedron has a distinct gradient.  For N random points,
+// velocities and accelerations, the trajectory must stay in the starting
+// tetrahedron (same gradient) at all times before the exit time, and be in
+// a different tetrahedron just after it.  Points on facets between cubes,
+// moving outward, must continue into the neighboring tetrahedron.
+//
+// G4CMPTimeStepper::MeshPathLength() is checked with a uniform field along
+// one axis (linear potential on the same mesh), for carriers at rest,
+// moving along the field, and moving against it (reversing inside the
+// tetrahedron).  The path length must match the analytic distance to the
+// tetrahedron facet, and the acceleration must be qE/m.
+//
+// Returns number of errors.
+//
+// 20261019  New test for exit time from mesh tetrahedra
+// 20261019  Add check of G4CMPTimeStepper::MeshPathLength() in uniform field
+
+#include "globals.hh"
+#include "G4CMPMeshElectricField.hh"
+#include "G4CMPTimeStepper.hh"
+#include "G4CMPTriLinearInterp.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4RandomDirection.hh"
+#include "G4RotationMatrix.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "Randomize.hh"
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace {
+  const G4int nGrid = 6;		// Mesh points along each axis
+  const G4double side = 1.*mm;		// Size of mesh cube
+  const G4double step = side/(nGrid-1);
+
+  G4CMPTriLinearInterp* mesh = 0;
+  G4int nErrors = 0;
+  G4int verbose = 0;
+}
+
+
+// Regular 3D mesh, using Kuhn decomposition of each cube into six tetrahedra
+
+void fill3Dmesh(std::vector<point3d>& xyz, std::vector<G4double>& v,
+		std::vector<tetra3d>& tetra) {
+  for (G4int k=0; k<nGrid; k++) {
+    for (G4int j=0; j<nGrid; j++) {
+      for (G4int i=0; i<nGrid; i++) {
+	xyz.push_back(point3d{{i*step, j*step, k*step}});
+	v.push_back(G4UniformRand()*volt);
+      }
+    }
+  }
+
+  static const G4int perm[6][3] = { {0,1,2}, {0,2,1}, {1,0,2},
+				    {1,2,0}, {2,0,1}, {2,1,0} };
+
+  for (G4int k=0; k<nGrid-1; k++) {
+    for (G4int j=0; j<nGrid-1; j++) {
+      for (G4int i=0; i<nGrid-1; i++) {
+	for (const auto& p: perm) {
+	  G4int ijk[3] = { i, j, k };
+	  tetra3d tet;
+	  tet[0] = ijk[0] + nGrid*(ijk[1] + nGrid*ijk[2]);
+	  for (G4int c=0; c<3; c++) {
+	    ijk[p[c]]++;
+	    tet[c+1] = ijk[0] + nGrid*(ijk[1] + nGrid*ijk[2]);
+	  }
+	  tetra.push_back(tet);
+	}
+      }
+    }
+  }
+}
+
+
+// Position along constant-acceleration trajectory
+
+G4ThreeVector trajectory(const G4ThreeVector& pos, const G4ThreeVector& vel,
+			 const G4ThreeVector& acc, G4double t) {
+  return pos + t*vel + 0.5*t*t*acc;
+}
+
+G4bool insideMesh(const G4ThreeVector& pos) {
+  return (pos.x() > 0. && pos.x() < side && pos.y() > 0. && pos.y() < side &&
+	  pos.z() > 0. && pos.z() < side);
+}
+
+G4ThreeVector gradAt(const G4ThreeVector& pos) {
+  G4double pt[3] = { pos.x(), pos.y(), pos.z() };
+  return mesh->GetGrad(pt, true);
+}
+
+
+// Check that trajectory leaves tetrahedron at computed time
+
+G4bool testTrajectory(const G4ThreeVector& pos, const G4ThreeVector& vel,
+		      const G4ThreeVector& acc, const G4ThreeVector& grad0) {
+  G4double pt[3] = { pos.x(), pos.y(), pos.z() };
+  G4double tExit = mesh->GetExitTime(pt, vel, acc, true);
+
+  if (tExit <= 0. || tExit >= DBL_MAX) {
+    if (verbose) G4cerr << " pos " << pos << " vel " << vel << " acc " << acc
+			<< " bad exit time " << tExit << G4endl;
+    return false;
+  }
+
+  const G4double tol = 1e-6;		// Stay well away from facets
+  const G4double gtol = 1e-9*grad0.mag();
+
+  // Trajectory must stay inside starting tetrahedron
+  const G4int nScan = 50;
+  for (G4int i=1; i<=nScan; i++) {
+    G4double t = tExit*(1.-tol)*i/nScan;
+    if ((gradAt(trajectory(pos, vel, acc, t)) - grad0).mag() > gtol) {
+      if (verbose) G4cerr << " pos " << pos << " left tetrahedron at "
+			  << t/tExit << " of exit time" << G4endl;
+      return false;
+    }
+  }
+
+  // Trajectory must have left just after exit, unless outside mesh
+  G4ThreeVector after = trajectory(pos, vel, acc, tExit*(1.+tol));
+  if (insideMesh(after) && (gradAt(after) - grad0).mag() <= gtol) {
+    if (verbose) G4cerr << " pos " << pos << " still in tetrahedron after "
+			<< " exit time " << tExit/ns << " ns" << G4endl;
+    return false;
+  }
+
+  return true;
+}
+
+
+// Random points in bulk, with random velocity and acceleration
+
+void testBulk(G4int n) {
+  G4int nBad = 0;
+  for (G4int i=0; i<n; i++) {
+    G4ThreeVector pos(G4UniformRand(), G4UniformRand(), G4UniformRand());
+    pos *= side;
+
+    G4ThreeVector vel = G4RandomDirection() * G4UniformRand() * 1e4*m/s;
+    G4ThreeVector acc = G4RandomDirection() * G4UniformRand() * 1e13*m/s/s;
+    if (i%4 == 0) acc.set(0.,0.,0.);		// Straight-line trajectories
+    if (i%4 == 1) vel.set(0.,0.,0.);		// Starting at rest
+
+    if (!testTrajectory(pos, vel, acc, gradAt(pos))) nBad++;
+  }
+
+  G4cout << " bulk: " << nBad << " of " << n << " trajectories failed"
+	 << G4endl;
+  if (nBad) nErrors++;
+}
+
+
+// Points on facet between cubes, moving down into lower cube
+
+void testFacets(G4int n) {
+  G4int nBad = 0;
+  for (G4int i=0; i<n; i++) {
+    G4ThreeVector pos(G4UniformRand()*side, G4UniformRand()*side,
+		      (1+G4int(G4UniformRand()*(nGrid-2)))*step);
+
+    G4ThreeVector vel = G4RandomDirection() * 1e4*m/s;
+    if (vel.z() > 0.) vel.setZ(-vel.z());
+    G4ThreeVector acc(0.,0.,0.);
+
+    // Reference gradient from just below facet along trajectory
+    G4ThreeVector grad0 = gradAt(pos + 1e-9*step*vel.unit());
+
+    if (!testTrajectory(pos, vel, acc, grad0)) nBad++;
+  }
+
+  G4cout << " facets: " << nBad << " of " << n << " trajectories failed"
+	 << G4endl;
+  if (nBad) nErrors++;
+}
+
+
+// Distance along axis (sign of dir) to leave tetrahedron containing pos.
+// Each cube is split into tetrahedra by ordering of coordinates within
+// cube, so the facets along the way are where the coordinate on the axis
+// reaches the next one, or the side of the cube
+
+G4double axisExitDistance(const G4ThreeVector& pos, G4int axis, G4int dir) {
+  G4double u[3];
+  for (G4int c=0; c<3; c++) u[c] = pos[c] - floor(pos[c]/step)*step;
+
+  G4double dist = (dir > 0) ? step-u[axis] : u[axis];
+  for (G4int c=0; c<3; c++) {
+    G4double d = dir*(u[c]-u[axis]);
+    if (c != axis && d > 0. && d < dist) dist = d;
+  }
+
+  return dist;
+}
+
+
+// Uniform field along each axis in turn: path length from time stepper
+
+void testUniformField(G4int n) {
+  std::vector<point3d> xyz;
+  std::vector<G4double> v;
+  std::vector<tetra3d> tetra;
+  fill3Dmesh(xyz, v, tetra);
+
+  const G4double Efield = 100.*volt/cm;
+  const G4double mass = electron_mass_c2/c_squared;
+  const G4RotationMatrix mInv(G4Rep3x3(1./mass, 0., 0., 0., 1./mass, 0.,
+				       0., 0., 1./mass));
+
+  G4int nBad = 0;
+  for (G4int axis=0; axis<3; axis++) {
+    for (size_t i=0; i<xyz.size(); i++) v[i] = -Efield*xyz[i][axis];
+
+    G4CMPMeshElectricField field(xyz, v, tetra);
+
+    for (G4int i=0; i<n/3; i++) {
+      G4ThreeVector pos(G4UniformRand(), G4UniformRand(), G4UniformRand());
+      pos *= side;
+      G4double pt[3] = { pos.x(), pos.y(), pos.z() };
+
+      G4double EB[6];
+      field.GetFieldValue(pt, EB);
+      G4ThreeVector E(EB[3], EB[4], EB[5]);
+
+      G4double charge = (G4UniformRand() < 0.5) ? eplus : -eplus;
+      G4ThreeVector acc = G4CMPTimeStepper::FieldAcceleration(charge, E, mInv);
+
+      G4ThreeVector accExpect(0.,0.,0.);
+      accExpect[axis] = charge*Efield/mass;
+      if ((acc-accExpect).mag() > 1e-9*accExpect.mag()) {
+	if (verbose) G4cerr << " field " << E << " acceleration " << acc
+			    << " expected " << accExpect << G4endl;
+	nBad++;
+	continue;
+      }
+
+      // At rest, moving with acceleration, or reversing in tetrahedron
+      G4int dir = (charge > 0.) ? 1 : -1;
+      G4double sFwd = axisExitDistance(pos, axis, dir);
+      G4double sExpect = sFwd;
+      G4ThreeVector vel(0.,0.,0.);
+
+      if (i%3 == 1) {
+	vel = acc.unit() * G4UniformRand() * 1e5*m/s;
+      } else if (i%3 == 2) {
+	G4double sBack = (0.1+0.8*G4UniformRand())
+	  * axisExitDistance(pos, axis, -dir);
+	vel = -acc.unit() * sqrt(2.*acc.mag()*sBack);
+	sExpect += 2.*sBack;
+      }
+
+      G4double s = G4CMPTimeStepper::MeshPathLength(&field, pt, vel, acc);
+      if (s < sExpect || s > sExpect*(1.+1e-5)) {
+	if (verbose) G4cerr << " pos " << pos << " vel " << vel << " acc "
+			    << acc << " path " << s/um << " um, expected "
+			    << sExpect/um << " um" << G4endl;
+	nBad++;
+      }
+    }
+  }
+
+  G4cout << " uniform field: " << nBad << " of " << 3*(n/3)
+	 << " path lengths failed" << G4endl;
+  if (nBad) nErrors++;
+}
+
+
+// Main test is here
+
+int main(int argc, char* argv[]) {
+  G4int n = (argc>1) ? atoi(argv[1]) : 10000;
+  G4long seed = (argc>2) ? atol(argv[2]) : 20261019;
+  verbose = (argc>3) ? atoi(argv[3]) : 0;
+
+  G4Random::setTheSeed(seed);
+
+  std::vector<point3d> xyz;
+  std::vector<G4double> v;
+  std::vector<tetra3d> tetra;
+  fill3Dmesh(xyz, v, tetra);
+
+  mesh = new G4CMPTriLinearInterp(xyz, v, tetra);
+  mesh->Initialize();
+
+  G4cout << "G4CMPTriLinearInterp " << tetra.size() << " tetrahedra, "
+	 << n << " trajectories" << G4endl;
+
+  testBulk(n);
+  testFacets(n/10+1);
+  testUniformField(n);
+
+  G4cout << "\n" << nErrors << " errors found" << G4endl;
+
+  delete mesh;
+  ::exit(nErrors);
+}
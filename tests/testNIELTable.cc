@@ -0,0 +1,166 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: testNIELTable [N] [seed] [verbose]
+//
+// Verify tabulated NIEL yields (G4CMPNIELTable) against the yield
+// functions used to fill them, for nuclear recoils in Ge and Si.  Each
+// function is compared at N random energies (log uniform over the table
+// range), and just above and below the energies where the functions switch
+// models.  The absolute difference must be within
+// G4CMPNIELTable::GetTolerance() everywhere.
+//
+// Returns number of errors.
+//
+// 20261019  New test for tabulated NIEL yield functions
+
+#include "globals.hh"
+#include "G4CMPConfigManager.hh"
+#include "G4CMPEmpiricalNIEL.hh"
+#include "G4CMPImpactTunlNIEL.hh"
+#include "G4CMPLewinSmithNIEL.hh"
+#include "G4CMPLindhardNIEL.hh"
+#include "G4CMPNIELTable.hh"
+#include "G4CMPSarkisNIEL.hh"
+#include "G4Material.hh"
+#include "G4NistManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4VNIELPartition.hh"
+#include "Randomize.hh"
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+
+namespace {
+  G4int nErrors = 0;
+  G4int verbose = 0;
+}
+
+
+// Compare table to yield function at list of points
+
+void compare(const G4String& name, const G4VNIELPartition* niel,
+	     const G4Material* mat, G4double Z, G4double A,
+	     const std::vector<G4double>& points) {
+  G4CMPNIELTable table(niel);
+  table.Fill(mat, Z, A);
+
+  G4double maxDiff = 0., eWorst = 0.;
+  for (G4double E: points) {
+    G4double Y = niel->PartitionNIEL(E, mat, Z, A);
+    G4double diff = fabs(table.PartitionNIEL(E, mat, Z, A) - Y);
+
+    if (diff > maxDiff) { maxDiff = diff; eWorst = E; }
+
+    if (verbose>1) {
+      G4cout << " " << name << " E " << E/keV << " keV yield " << Y
+	     << " table " << table.PartitionNIEL(E, mat, Z, A) << G4endl;
+    }
+  }
+
+  G4cout << " " << name << ": " << table.GetNPoints(mat, Z, A)
+	 << " points, fill error " << table.GetError(mat, Z, A)
+	 << ", max difference " << maxDiff << " at " << eWorst/keV << " keV"
+	 << G4endl;
+
+  if (maxDiff > G4CMPNIELTable::GetTolerance()) {
+    G4cerr << " " << name << " TABLE DIFFERS FROM YIELD FUNCTION" << G4endl;
+    nErrors++;
+  }
+}
+
+
+// Random points, log uniform over range, with extra points given
+
+std::vector<G4double> makePoints(G4int n, G4double elow, G4double ehigh,
+				 const std::vector<G4double>& extra) {
+  std::vector<G4double> points;
+  for (G4int i=0; i<n; i++) {
+    points.push_back(elow*pow(ehigh/elow, G4UniformRand()));
+  }
+
+  for (G4double E: extra) {
+    points.push_back(E*(1.-1e-6));
+    points.push_back(E);
+    points.push_back(E*(1.+1e-6));
+  }
+
+  return points;
+}
+
+
+// Test all yield functions for given material, with its own recoils
+
+void testMaterial(const G4String& name, G4int n) {
+  G4Material* mat = G4NistManager::Instance()->FindOrBuildMaterial(name);
+  if (!mat) {
+    G4cerr << " Unable to build " << name << G4endl;
+    nErrors++;
+    return;
+  }
+
+  G4double Z = mat->GetZ(), A = mat->GetA()/(g/mole);
+  G4cout << name << " recoils, Z " << Z << " A " << A << G4endl;
+
+  G4CMPLindhardNIEL lindhard;
+  G4CMPLewinSmithNIEL lewinSmith;
+  G4CMPNIELTable range(&lewinSmith);	// For default energy range
+
+  std::vector<G4double> points =
+    makePoints(n, range.GetLowEnergy(), range.GetHighEnergy(),
+	       { G4CMPConfigManager::GetEmpEhigh(), 3.*MeV });
+
+  compare("Lindhard", &lindhard, mat, Z, A, points);
+  compare("LewinSmith", &lewinSmith, mat, Z, A, points);
+
+  G4CMPImpactTunlNIEL impact;
+  compare("Impact", &impact, mat, Z, A, points);
+
+  G4CMPEmpiricalNIEL empirical;
+  compare("Empirical", &empirical, mat, Z, A, points);
+
+  G4CMPSarkisNIEL sarkis;
+  compare("Sarkis", &sarkis, mat, Z, A, points);
+
+  // Outside tabulated range, yield must come from function directly
+  G4double E = 10.*range.GetHighEnergy();
+  if (range.PartitionNIEL(E, mat, Z, A) != lewinSmith.PartitionNIEL(E, mat, Z, A)
+      || range.GetNPoints(mat, Z, A) != 0) {
+    G4cerr << " TABLE USED OUTSIDE OF RANGE" << G4endl;
+    nErrors++;
+  }
+}
+
+
+// Main test is here
+
+int main(int argc, char* argv[]) {
+  G4int n = (argc>1) ? atoi(argv[1]) : 100000;
+  G4long seed = (argc>2) ? atol(argv[2]) : 20261019;
+  verbose = (argc>3) ? atoi(argv[3]) : 0;
+
+  G4Random::setTheSeed(seed);
+  G4CMPConfigManager::SetVerboseLevel(verbose);
+
+  testMaterial("G4_Ge", n);
+  testMaterial("G4_Si", n);
+
+  // Configured function must be wrapped only when requested
+  G4CMPConfigManager::UseNIELTables(false);
+  if (dynamic_cast<const G4CMPNIELTable*>(G4CMPConfigManager::GetNIELPartition())) {
+    G4cerr << " NIEL TABLE USED WITHOUT G4CMP_NIEL_TABLES" << G4endl;
+    nErrors++;
+  }
+
+  G4CMPConfigManager::UseNIELTables(true);
+  if (!dynamic_cast<const G4CMPNIELTable*>(G4CMPConfigManager::GetNIELPartition())) {
+    G4cerr << " NIEL TABLE NOT USED WITH G4CMP_NIEL_TABLES" << G4endl;
+    nErrors++;
+  }
+
+  G4cout << "\n" << nErrors << " errors found" << G4endl;
+  ::exit(nErrors);
+}
@@ -0,0 +1,197 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: testPartitionTasks <Lattice> [keV] [seed] [verbose]
+//
+// Verify that G4CMPEnergyPartition gives identical particles however the
+// work is split into tasks (/g4cmp/partitionTaskSize) and however many
+// threads run them (/g4cmp/partitionThreads).
+//
+// A deposit of the given energy (default 100 keV), 10% non-ionizing, is
+// partitioned with the same seed for each configuration, with the charge
+// cloud enabled.  Every particle's type, direction, energy, weight and
+// multiplicity, and its precomputed position, group velocity, mass and
+// valley, must be the same as with task size 0 (serial).  A different
+// seed must give different particles.
+//
+// Geant4 material will be set as "G4_<Lattice>".
+//
+// Returns number of errors.
+//
+// 20261019  New test for task-split energy partitioning
+
+#include "globals.hh"
+#include "G4Box.hh"
+#include "G4CMPConfigManager.hh"
+#include "G4CMPEnergyPartition.hh"
+#include "G4LatticeManager.hh"
+#include "G4LatticePhysical.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Navigator.hh"
+#include "G4NistManager.hh"
+#include "G4PVPlacement.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "G4TouchableHistory.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <stdlib.h>
+#include <vector>
+
+
+namespace {
+  G4int nErrors = 0;
+  G4int verbose = 0;
+
+  G4TouchableHistory* touch = 0;
+  const G4ThreeVector center(1.*mm, -2.*mm, 0.5*mm);
+
+  struct Config {
+    G4int taskSize;
+    G4int nThreads;
+  };
+
+  // Task sizes smaller than, equal to and larger than the random streams
+  const std::vector<Config> configs = {
+    { 1, 0 }, { 1, 2 }, { 1000, 0 }, { 1000, 1 }, { 1000, 3 },
+    { 4096, 4 }, { 30000, 2 }, { 100000000, 0 }
+  };
+}
+
+
+// Expose particle list and kinematics for comparison
+
+class PartitionTasks : public G4CMPEnergyPartition {
+public:
+  explicit PartitionTasks(const G4VPhysicalVolume* pv)
+    : G4CMPEnergyPartition(pv) {;}
+
+  // Partition deposit with given seed, and fill track kinematics
+  void Run(G4long seed, G4double energy) {
+    G4Random::setTheSeed(seed);
+    DoPartition(0.9*energy, 0.1*energy);
+    FillKinematics(touch, center);
+  }
+
+  size_t Size() const { return particles.size(); }
+
+  // Count particles which differ in any way from reference
+  size_t Compare(const PartitionTasks& ref) const {
+    if (particles.size() != ref.particles.size() ||
+	kinematics.size() != ref.kinematics.size()) {
+      return std::max(particles.size(), ref.particles.size());
+    }
+
+    size_t nBad = 0;
+    for (size_t i=0; i<particles.size(); i++) {
+      const Data& p = particles[i];
+      const Data& r = ref.particles[i];
+      const Kinematics& k = kinematics[i];
+      const Kinematics& rk = ref.kinematics[i];
+
+      if (p.pd != r.pd || p.dir != r.dir || p.ekin != r.ekin ||
+	  p.wt != r.wt || p.mult != r.mult || k.pos != rk.pos ||
+	  k.vdir != rk.vdir || k.vel != rk.vel || k.mass != rk.mass ||
+	  k.valley != rk.valley) {
+	if (verbose>1) {
+	  G4cerr << "  particle " << i << " " << p.pd->GetParticleName()
+		 << " " << p.ekin/eV << " eV @ " << k.pos/mm
+		 << " mm differs from " << r.pd->GetParticleName()
+		 << " " << r.ekin/eV << " eV @ " << rk.pos/mm << " mm"
+		 << G4endl;
+	}
+	nBad++;
+      }
+    }
+
+    return nBad;
+  }
+};
+
+
+// Main test is here
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    G4cerr << "Usage: " << argv[0] << " <Lattice> [keV] [seed] [verbose]"
+	   << G4endl;
+    ::exit(1);
+  }
+
+  G4String lname = argv[1];
+  G4String mname = "G4_"+lname;
+
+  G4double energy = ((argc>2) ? strtod(argv[2],0) : 100.) * keV;
+  G4long seed = (argc>3) ? atol(argv[3]) : 20261019;
+  verbose = (argc>4) ? atoi(argv[4]) : 0;
+
+  // MUST USE 'new', SO THAT G4SolidStore CAN DELETE
+  const G4double halfSize = 1.*cm;
+  G4Material* mat = G4NistManager::Instance()->FindOrBuildMaterial(mname);
+  G4Box* crystal = new G4Box("Crystal", halfSize, halfSize, halfSize);
+  G4LogicalVolume* lv = new G4LogicalVolume(crystal, mat, crystal->GetName());
+  G4PVPlacement* pv = new G4PVPlacement(0, G4ThreeVector(), lv, lv->GetName(),
+					0, false, 1);
+
+  G4LatticePhysical* lattice =
+    G4LatticeManager::Instance()->LoadLattice(pv,lname);
+  if (!lattice) {
+    G4cerr << " Unable to load " << lname << " lattice" << G4endl;
+    ::exit(1);
+  }
+
+  // Touchable for crystal, in place of the one from current track
+  G4Navigator nav;
+  nav.SetWorldVolume(pv);
+  nav.LocateGlobalPointAndSetup(center, 0, false, true);
+  touch = nav.CreateTouchableHistory();
+
+  G4CMPConfigManager::CreateChargeCloud(true);
+
+  // Reference is generated serially
+  G4CMPConfigManager::SetPartitionTaskSize(0);
+
+  PartitionTasks reference(pv);
+  reference.Run(seed, energy);
+
+  G4cout << lname << " " << energy/keV << " keV partitioned into "
+	 << reference.Size() << " particles" << G4endl;
+
+  for (const Config& config: configs) {
+    G4CMPConfigManager::SetPartitionTaskSize(config.taskSize);
+    G4CMPConfigManager::SetPartitionThreads(config.nThreads);
+
+    PartitionTasks partition(pv);
+    partition.SetVerboseLevel(verbose);
+    partition.Run(seed, energy);
+
+    size_t nBad = partition.Compare(reference);
+    G4cout << " task size " << config.taskSize << ", " << config.nThreads
+	   << " threads: " << nBad << " particles differ" << G4endl;
+
+    if (nBad) {
+      G4cerr << " TASK SIZE " << config.taskSize << " WITH " << config.nThreads
+	     << " THREADS DIFFERS FROM SERIAL" << G4endl;
+      nErrors++;
+    }
+  }
+
+  // Comparison must be able to see a different random stream
+  G4CMPConfigManager::SetPartitionTaskSize(1000);
+  G4CMPConfigManager::SetPartitionThreads(0);
+
+  PartitionTasks other(pv);
+  other.Run(seed+1, energy);
+  if (other.Compare(reference) == 0) {
+    G4cerr << " DIFFERENT SEED GIVES SAME PARTICLES" << G4endl;
+    nErrors++;
+  }
+
+  delete touch;
+
+  G4cout << "\n" << nErrors << " errors found" << G4endl;
+  ::exit(nErrors);
+}
@@ -0,0 +1,299 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: testPhononCascade <Lattice> [N] [seed] [verbose]
+//
+// Verify the bulk phonon cascade (G4CMPPhononCascade) for N decays of
+// L-phonons at the lattice's Debye energy, with a cascade threshold of
+// 1/5 of that energy, at the center of a crystal large enough that no
+// phonon reaches the surface.
+//
+// Every cascade must conserve energy, end with all phonons below
+// threshold, and have one more phonon than decays.  The final phonons
+// are compared with a simple reference cascade, which decays and scatters
+// each phonon directly with the same rates and decay kinematics, ignoring
+// position.  The number of phonons and the fraction of L-phonons must
+// agree within 5 sigma, and the energy distributions must pass a
+// two-sample Kolmogorov-Smirnov test at the 0.1% level.
+//
+// Geant4 material will be set as "G4_<Lattice>".
+//
+// Returns number of errors.
+//
+// 20261019  New test for bulk phonon cascade
+
+#include "globals.hh"
+#include "G4Box.hh"
+#include "G4CMPAnharmonicDecay.hh"
+#include "G4CMPConfigManager.hh"
+#include "G4CMPDownconversionRate.hh"
+#include "G4CMPPhononCascade.hh"
+#include "G4CMPPhononScatteringRate.hh"
+#include "G4CMPUtils.hh"
+#include "G4LatticeManager.hh"
+#include "G4LatticePhysical.hh"
+#include "G4LogicalVolume.hh"
+#include "G4NistManager.hh"
+#include "G4PVPlacement.hh"
+#include "G4PhononPolarization.hh"
+#include "G4RandomDirection.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+
+namespace {
+  G4int nErrors = 0;
+  G4int verbose = 0;
+
+  // Final phonons from all cascades
+  struct Summary {
+    Summary() : nCascades(0), nPhonons(0), sumN2(0.), nLong(0) {;}
+
+    void Add(const std::vector<G4double>& E, G4int nL) {
+      nCascades++;
+      nPhonons += E.size();
+      sumN2 += E.size()*E.size();
+      nLong += nL;
+      energy.insert(energy.end(), E.begin(), E.end());
+    }
+
+    G4double MeanN() const { return G4double(nPhonons)/nCascades; }
+    G4double VarMeanN() const {
+      return (sumN2/nCascades - MeanN()*MeanN()) / nCascades;
+    }
+
+    G4double FracL() const { return G4double(nLong)/nPhonons; }
+    G4double VarFracL() const { return FracL()*(1.-FracL())/nPhonons; }
+
+    G4int nCascades;
+    G4long nPhonons;
+    G4double sumN2;
+    G4long nLong;
+    std::vector<G4double> energy;
+  };
+}
+
+
+// Reference cascade: decay or scatter each phonon until below threshold
+
+class ReferenceCascade {
+public:
+  ReferenceCascade(const G4LatticePhysical* lat, G4double thresh)
+    : lattice(lat), threshold(thresh), decay(0) {
+    decay.SetLattice(lat);
+    downRate.SetLattice(lat);
+    scatRate.SetLattice(lat);
+  }
+
+  void Cascade(G4double E0, const G4ThreeVector& k0,
+	       std::vector<G4double>& E, G4int& nL) {
+    E.clear();
+    nL = 0;
+    Decay(E0, k0, E, nL);
+  }
+
+protected:
+  void Decay(G4double E0, const G4ThreeVector& k0, std::vector<G4double>& E,
+	     G4int& nL) {
+    G4int dmode[2];
+    G4ThreeVector dk[2];
+    G4double dE[2];
+    decay.SampleDecay(E0, k0, dmode, dk, dE);
+
+    Follow(dmode[0], dE[0], dk[0], E, nL);
+    Follow(dmode[1], dE[1], dk[1], E, nL);
+  }
+
+  void Follow(G4int mode, G4double energy, const G4ThreeVector& k,
+	      std::vector<G4double>& E, G4int& nL) {
+    while (energy >= threshold) {
+      G4double rateDown = (mode == G4PhononPolarization::Long
+			   ? downRate.RateForEnergy(energy) : 0.);
+      G4double rate = rateDown + scatRate.RateForEnergy(energy);
+
+      if (G4UniformRand()*rate < rateDown) {
+	Decay(energy, k, E, nL);
+	return;
+      }
+
+      mode = G4CMP::ChoosePhononPolarization(lattice->GetLDOS(),
+					     lattice->GetSTDOS(),
+					     lattice->GetFTDOS());
+    }
+
+    E.push_back(energy);
+    if (mode == G4PhononPolarization::Long) nL++;
+  }
+
+private:
+  const G4LatticePhysical* lattice;
+  G4double threshold;
+  G4CMPAnharmonicDecay decay;
+  G4CMPDownconversionRate downRate;
+  G4CMPPhononScatteringRate scatRate;
+};
+
+
+// Two-sample Kolmogorov-Smirnov statistic
+
+G4double KolmogorovSmirnov(std::vector<G4double> a, std::vector<G4double> b) {
+  std::sort(a.begin(), a.end());
+  std::sort(b.begin(), b.end());
+
+  G4double D = 0.;
+  size_t i=0, j=0;
+  while (i < a.size() && j < b.size()) {
+    G4double x = std::min(a[i], b[j]);
+    while (i < a.size() && a[i] <= x) i++;
+    while (j < b.size() && b[j] <= x) j++;
+    D = std::max(D, fabs(G4double(i)/a.size() - G4double(j)/b.size()));
+  }
+
+  return D;
+}
+
+
+// Compare summary values between cascade and reference
+
+void compare(const G4String& name, G4double x, G4double varX,
+	     G4double ref, G4double varRef) {
+  G4double sigma = sqrt(varX + varRef);
+  G4cout << " " << name << " " << x << " reference " << ref
+	 << " (" << fabs(x-ref)/sigma << " sigma)" << G4endl;
+
+  if (fabs(x-ref) > 5.*sigma) {
+    G4cerr << " " << name << " DIFFERS FROM REFERENCE" << G4endl;
+    nErrors++;
+  }
+}
+
+
+// Main test is here
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    G4cerr << "Usage: " << argv[0] << " <Lattice> [N] [seed] [verbose]"
+	   << G4endl;
+    ::exit(1);
+  }
+
+  G4String lname = argv[1];
+  G4String mname = "G4_"+lname;
+
+  G4int n = (argc>2) ? atoi(argv[2]) : 1000;
+  G4long seed = (argc>3) ? atol(argv[3]) : 20261019;
+  verbose = (argc>4) ? atoi(argv[4]) : 0;
+
+  G4Random::setTheSeed(seed);
+
+  // MUST USE 'new', SO THAT G4SolidStore CAN DELETE
+  const G4double halfSize = 1.*km;
+  G4Material* mat = G4NistManager::Instance()->FindOrBuildMaterial(mname);
+  G4Box* crystal = new G4Box("Crystal", halfSize, halfSize, halfSize);
+  G4LogicalVolume* lv = new G4LogicalVolume(crystal, mat, crystal->GetName());
+  G4PVPlacement* pv = new G4PVPlacement(0, G4ThreeVector(), lv, lv->GetName(),
+					0, false, 1);
+
+  G4LatticePhysical* lattice =
+    G4LatticeManager::Instance()->LoadLattice(pv,lname);
+  if (!lattice) {
+    G4cerr << " Unable to load " << lname << " lattice" << G4endl;
+    ::exit(1);
+  }
+
+  const G4double E0 = lattice->GetDebyeEnergy();
+  const G4double threshold = E0/5.;
+  G4CMPConfigManager::SetPhononCascadeEnergy(threshold);
+
+  G4cout << lname << " cascade from " << E0/meV << " meV to "
+	 << threshold/meV << " meV" << G4endl;
+
+  G4CMPPhononCascade cascade(0);
+  cascade.LoadDataForVolume(lattice, crystal);
+  cascade.SetMaxInteractions(100000000);	// Always finish in bulk
+
+  ReferenceCascade reference(lattice, threshold);
+
+  Summary result, refResult;
+  std::vector<G4double> E;
+  G4int nL = 0;
+
+  for (G4int i=0; i<n; i++) {
+    G4ThreeVector k0 = G4RandomDirection();
+    G4double t0 = 1.*us;
+
+    cascade.Cascade(E0, t0, G4ThreeVector(), k0);
+
+    G4double Esum = 0.;
+    G4bool escaped = false, early = false;
+    E.clear();
+    nL = 0;
+    for (size_t j=0; j<cascade.GetNumberOfPhonons(); j++) {
+      E.push_back(cascade.GetPhononEnergy(j));
+      Esum += E.back();
+      if (cascade.GetPhononMode(j) == G4PhononPolarization::Long) nL++;
+
+      escaped |= (E.back() >= threshold ||
+		  crystal->Inside(cascade.GetPhononPosition(j)) != kInside);
+      early |= (cascade.GetPhononTime(j) < t0);
+    }
+    result.Add(E, nL);
+
+    if (verbose>1) {
+      G4cout << " cascade " << i << ": " << E.size() << " phonons, "
+	     << cascade.GetNumberOfDecays() << " decays, "
+	     << cascade.GetNumberOfScatters() << " scatters" << G4endl;
+    }
+
+    if (fabs(Esum-E0) > 1e-9*E0) {
+      G4cerr << " cascade " << i << " ENERGY NOT CONSERVED: " << Esum/meV
+	     << " meV" << G4endl;
+      nErrors++;
+    }
+
+    if (escaped) {
+      G4cerr << " cascade " << i << " PHONON LEFT ABOVE THRESHOLD" << G4endl;
+      nErrors++;
+    }
+
+    if (early) {
+      G4cerr << " cascade " << i << " PHONON BEFORE PARENT" << G4endl;
+      nErrors++;
+    }
+
+    if (G4int(E.size()) != cascade.GetNumberOfDecays()+1) {
+      G4cerr << " cascade " << i << " " << E.size() << " PHONONS FROM "
+	     << cascade.GetNumberOfDecays() << " DECAYS" << G4endl;
+      nErrors++;
+    }
+
+    reference.Cascade(E0, k0, E, nL);
+    refResult.Add(E, nL);
+  }
+
+  compare("phonons per cascade", result.MeanN(), result.VarMeanN(),
+	  refResult.MeanN(), refResult.VarMeanN());
+  compare("L-phonon fraction", result.FracL(), result.VarFracL(),
+	  refResult.FracL(), refResult.VarFracL());
+
+  G4double nA = result.energy.size(), nB = refResult.energy.size();
+  G4double D = KolmogorovSmirnov(result.energy, refResult.energy);
+  G4double Dcrit = 1.95*sqrt((nA+nB)/(nA*nB));		// alpha = 0.001
+
+  G4cout << " energy distribution KS distance " << D << " (critical "
+	 << Dcrit << ")" << G4endl;
+
+  if (D > Dcrit) {
+    G4cerr << " ENERGY DISTRIBUTION DIFFERS FROM REFERENCE" << G4endl;
+    nErrors++;
+  }
+
+  G4cout << "\n" << nErrors << " errors found" << G4endl;
+  ::exit(nErrors);
+}
@@ -0,0 +1,204 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: testRamoSignal [N] [seed] [verbose]
+//
+// Verify G4CMPRamoSignal with two weighting potentials on a regular mesh:
+// V1 rises linearly from 0 V at z=0 to 1 V at z=side, and V2 = 1-V1.  N
+// random charge tracks, each drifting in several steps, must induce total
+// charge -q*(V(final)-V(initial)) on each channel, with the two channels
+// summing to zero.  Each step's signal must be spread over the time bins
+// in proportion to its overlap with them.
+//
+// Returns number of errors.
+//
+// 20261019  New test for in-transport Shockley-Ramo signals
+
+#include "globals.hh"
+#include "G4CMPMeshElectricField.hh"
+#include "G4CMPRamoSignal.hh"
+#include "G4CMPTriLinearInterp.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace {
+  const G4int nGrid = 5;		// Mesh points along each axis
+  const G4double side = 1.*mm;		// Size of mesh cube
+  const G4double step = side/(nGrid-1);
+
+  const G4double binWidth = 10.*ns;
+  const size_t nBins = 100;
+  const G4double tolerance = 1e-9;	// Relative to unit charge
+
+  G4int nErrors = 0;
+  G4int verbose = 0;
+}
+
+
+// Regular 3D mesh, using Kuhn decomposition of each cube into six tetrahedra
+
+void fill3Dmesh(std::vector<point3d>& xyz, std::vector<G4double>& v1,
+		std::vector<G4double>& v2, std::vector<tetra3d>& tetra) {
+  for (G4int k=0; k<nGrid; k++) {
+    for (G4int j=0; j<nGrid; j++) {
+      for (G4int i=0; i<nGrid; i++) {
+	xyz.push_back(point3d{{i*step, j*step, k*step}});
+	v1.push_back(k*step/side * volt);
+	v2.push_back((1.-k*step/side) * volt);
+      }
+    }
+  }
+
+  static const G4int perm[6][3] = { {0,1,2}, {0,2,1}, {1,0,2},
+				    {1,2,0}, {2,0,1}, {2,1,0} };
+
+  for (G4int k=0; k<nGrid-1; k++) {
+    for (G4int j=0; j<nGrid-1; j++) {
+      for (G4int i=0; i<nGrid-1; i++) {
+	for (const auto& p: perm) {
+	  G4int ijk[3] = { i, j, k };
+	  tetra3d tet;
+	  tet[0] = ijk[0] + nGrid*(ijk[1] + nGrid*ijk[2]);
+	  for (G4int c=0; c<3; c++) {
+	    ijk[p[c]]++;
+	    tet[c+1] = ijk[0] + nGrid*(ijk[1] + nGrid*ijk[2]);
+	  }
+	  tetra.push_back(tet);
+	}
+      }
+    }
+  }
+}
+
+
+// Random point well inside mesh
+
+G4ThreeVector randomPoint() {
+  return G4ThreeVector(0.05+0.9*G4UniformRand(), 0.05+0.9*G4UniformRand(),
+		       0.05+0.9*G4UniformRand()) * side;
+}
+
+
+// Random tracks, each in several steps, must give Ramo total charge
+
+void testTracks(G4CMPRamoSignal& signal, G4int n) {
+  G4int nBad = 0;
+  for (G4int i=0; i<n; i++) {
+    signal.Clear();
+
+    G4double charge = (i%2) ? -1. : 1.;
+    G4ThreeVector start = randomPoint(), pos = start;
+    G4double time = G4UniformRand()*nBins*binWidth/4.;	// Ends within trace
+
+    G4int nSteps = 1 + G4int(10.*G4UniformRand());
+    for (G4int j=0; j<nSteps; j++) {
+      G4ThreeVector next = randomPoint();
+      G4double tnext = time + G4UniformRand()*5.*binWidth;
+      signal.AddStep(charge, pos, time, next, tnext);
+      pos = next;
+      time = tnext;
+    }
+
+    G4double expect = -charge*(pos.z()-start.z())/side;
+
+    std::vector<G4double> q1, q2;
+    signal.GetInducedCharge(0, q1);
+    signal.GetInducedCharge(1, q2);
+
+    G4double diff = std::max({ fabs(signal.GetTotalCharge(0)-expect),
+			       fabs(signal.GetTotalCharge(1)+expect),
+			       fabs(q1.back()-expect),
+			       fabs(q2.back()+expect) });
+    if (diff > tolerance) {
+      if (verbose) G4cerr << " track " << i << " expected " << expect
+			  << " got " << signal.GetTotalCharge(0) << " and "
+			  << q1.back() << G4endl;
+      nBad++;
+    }
+  }
+
+  G4cout << " tracks: " << nBad << " of " << n << " have wrong total"
+	 << G4endl;
+  if (nBad) nErrors++;
+}
+
+
+// Single step across several bins, starting before trace
+
+void testBinning(G4CMPRamoSignal& signal) {
+  signal.Clear();
+
+  // Step across half of mesh, from t=-1.5 to t=2.5 bins
+  G4ThreeVector start(side/2., side/2., side/4.);
+  G4ThreeVector end(side/2., side/2., 3.*side/4.);
+  signal.AddStep(1., start, -1.5*binWidth, end, 2.5*binWidth);
+
+  // Half charge over four bins; first bin collects signal before start
+  const G4double expect[4] = { -0.3125, -0.125, -0.0625, 0. };
+  const G4double* trace = signal.GetTrace(0);
+
+  G4double diff = 0.;
+  for (size_t i=0; i<4; i++) diff = std::max(diff, fabs(trace[i]-expect[i]));
+
+  if (verbose) {
+    G4cout << " binning: trace";
+    for (size_t i=0; i<4; i++) G4cout << " " << trace[i];
+    G4cout << G4endl;
+  }
+
+  if (diff > tolerance) {
+    G4cerr << " SIGNAL NOT SPREAD CORRECTLY OVER BINS" << G4endl;
+    nErrors++;
+  }
+
+  // Signal after end of trace is not in trace, but is in total
+  signal.Clear();
+  signal.AddStep(-1., start, (nBins-0.5)*binWidth, end, (nBins+0.5)*binWidth);
+
+  std::vector<G4double> q;
+  signal.GetInducedCharge(0, q);
+  if (fabs(q.back()-0.25) > tolerance ||
+      fabs(signal.GetTotalCharge(0)-0.5) > tolerance) {
+    G4cerr << " SIGNAL AFTER END OF TRACE NOT HANDLED" << G4endl;
+    nErrors++;
+  }
+}
+
+
+// Main test is here
+
+int main(int argc, char* argv[]) {
+  G4int n = (argc>1) ? atoi(argv[1]) : 10000;
+  G4long seed = (argc>2) ? atol(argv[2]) : 20261019;
+  verbose = (argc>3) ? atoi(argv[3]) : 0;
+
+  G4Random::setTheSeed(seed);
+
+  std::vector<point3d> xyz;
+  std::vector<G4double> v1, v2;
+  std::vector<tetra3d> tetra;
+  fill3Dmesh(xyz, v1, v2, tetra);
+
+  G4CMPMeshElectricField chan1(xyz, v1, tetra);
+  G4CMPMeshElectricField chan2(xyz, v2, tetra);
+
+  G4CMPRamoSignal signal(binWidth, nBins);
+  signal.AddChannel(&chan1);
+  signal.AddChannel(&chan2);
+
+  G4cout << "G4CMPRamoSignal " << signal.GetNumberOfChannels() << " channels, "
+	 << signal.GetNumberOfBins() << " bins, " << n << " tracks" << G4endl;
+
+  testTracks(signal, n);
+  testBinning(signal);
+
+  G4cout << "\n" << nErrors << " errors found" << G4endl;
+  ::exit(nErrors);
+}
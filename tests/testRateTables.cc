@@ -0,0 +1,192 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: testRateTables [N] [seed] [verbose]
+//
+// Verify tabulated intervalley scattering rates against the analytic
+// expressions used to fill them, for Ge and Si lattices.  The IVRate
+// model is compared at N random energies (log uniform from 1 ueV to 1 eV),
+// the Linear and Quadratic models at N random HV field magnitudes (log
+// uniform from 1 mV/cm to 100 kV/cm).  The relative difference must be
+// within G4CMPRateTable::GetTolerance() everywhere, including just above
+// and below the IV energy thresholds.
+//
+// Returns number of errors.
+//
+// 20261019  New test for tabulated IV scattering rates
+
+#include "globals.hh"
+#include "G4CMPConfigManager.hh"
+#include "G4CMPInterValleyRate.hh"
+#include "G4CMPIVRateLinear.hh"
+#include "G4CMPIVRateQuadratic.hh"
+#include "G4CMPRateTable.hh"
+#include "G4LatticeManager.hh"
+#include "G4LatticePhysical.hh"
+#include "G4LogicalVolume.hh"
+#include "G4NistManager.hh"
+#include "G4PVPlacement.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Tubs.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+
+namespace {
+  G4int nErrors = 0;
+  G4int verbose = 0;
+}
+
+
+// Construct lattice with a "fake" physical volume
+
+G4LatticePhysical* BuildLattice(const G4String& lname) {
+  G4String mname = "G4_"+lname;
+
+  // MUST USE 'new', SO THAT G4SolidStore CAN DELETE
+  G4Material* mat = G4NistManager::Instance()->FindOrBuildMaterial(mname);
+  G4Tubs* crystal = new G4Tubs(lname+"Crystal", 0., 5.*cm, 1.*cm, 0., 360.*deg);
+  G4LogicalVolume* lv = new G4LogicalVolume(crystal, mat, crystal->GetName());
+  G4PVPlacement* pv = new G4PVPlacement(0, G4ThreeVector(), lv, lv->GetName(),
+					0, false, 1);
+
+  return G4LatticeManager::Instance()->LoadLattice(pv,lname);
+}
+
+
+// Compare table to analytic rate at list of points
+
+template <class Rate>
+void compare(const G4String& name, const G4CMPRateTable* table, Rate rate,
+	     const std::vector<G4double>& points, G4double unit) {
+  if (!table) {
+    G4cerr << " " << name << ": NO RATE TABLE" << G4endl;
+    nErrors++;
+    return;
+  }
+
+  G4double maxDiff = 0., xWorst = 0.;
+  for (G4double x: points) {
+    G4double f = rate(x);
+    G4double diff = ((f != 0.) ? fabs(table->Value(x) - f)/fabs(f)
+		     : (table->Value(x) != 0.) ? 1. : 0.);	// Below threshold
+
+    if (diff > maxDiff) { maxDiff = diff; xWorst = x; }
+
+    if (verbose>1) {
+      G4cout << " " << name << " x " << x/unit << " rate " << f/hertz
+	     << " table " << table->Value(x)/hertz << " Hz" << G4endl;
+    }
+  }
+
+  G4cout << " " << name << ": " << table->GetNSegments() << " segments of "
+	 << table->GetNPoints() << " points, max difference " << maxDiff
+	 << " at " << xWorst/unit << G4endl;
+
+  if (maxDiff > G4CMPRateTable::GetTolerance()) {
+    G4cerr << " " << name << " TABLE DIFFERS FROM ANALYTIC RATE" << G4endl;
+    nErrors++;
+  }
+}
+
+
+// Random points, log uniform over range, with extra points given
+
+std::vector<G4double> makePoints(G4int n, G4double xlow, G4double xhigh,
+				 const std::vector<G4double>& extra) {
+  std::vector<G4double> points;
+  for (G4int i=0; i<n; i++) {
+    points.push_back(xlow*pow(xhigh/xlow, G4UniformRand()));
+  }
+
+  for (G4double x: extra) {
+    points.push_back(x*(1.-1e-6));
+    points.push_back(x);
+    points.push_back(x*(1.+1e-6));
+  }
+
+  return points;
+}
+
+
+// Test all three rate models for given lattice
+
+G4LatticePhysical* testLattice(const G4String& lname, G4int n) {
+  G4LatticePhysical* lat = BuildLattice(lname);
+  if (!lat) {
+    G4cerr << " Unable to load " << lname << " lattice" << G4endl;
+    nErrors++;
+    return 0;
+  }
+
+  G4cout << lname << " lattice" << G4endl;
+
+  G4CMPInterValleyRate ivRate;
+  ivRate.SetLattice(lat);
+  ivRate.LoadDataForLattice();
+
+  const std::vector<G4double>& Eiv = lat->GetIVEnergy();
+  compare("IVRate", ivRate.GetRateTable(),
+	  [&ivRate](G4double E) { return ivRate.EnergyRate(E); },
+	  makePoints(n, 1e-6*eV, 1.*eV, Eiv), eV);
+
+  std::vector<G4double> fieldPoints =
+    makePoints(n, 1e-3*volt/cm, 1e5*volt/cm, {lat->GetIVQuadField()});
+
+  G4CMPIVRateLinear linRate;
+  linRate.SetLattice(lat);
+  linRate.LoadDataForLattice();
+  compare("Linear", linRate.GetRateTable(),
+	  [&linRate](G4double f) { return linRate.FieldRate(f); },
+	  fieldPoints, volt/cm);
+
+  G4CMPIVRateQuadratic quadRate;
+  quadRate.SetLattice(lat);
+  quadRate.LoadDataForLattice();
+  compare("Quadratic", quadRate.GetRateTable(),
+	  [&quadRate](G4double f) { return quadRate.FieldRate(f); },
+	  fieldPoints, volt/cm);
+
+  // Outside tabulated range, rates must fall back to analytic values
+  const G4CMPRateTable* table = ivRate.GetRateTable();
+  if (table && table->InRange(10.*table->GetHighEdge())) {
+    G4cerr << " IVRate TABLE RANGE NOT BOUNDED" << G4endl;
+    nErrors++;
+  }
+
+  return lat;
+}
+
+
+// Main test is here
+
+int main(int argc, char* argv[]) {
+  G4int n = (argc>1) ? atoi(argv[1]) : 100000;
+  G4long seed = (argc>2) ? atol(argv[2]) : 20261019;
+  verbose = (argc>3) ? atoi(argv[3]) : 0;
+
+  G4Random::setTheSeed(seed);
+  G4CMPConfigManager::UseRateTables(true);
+  G4CMPConfigManager::SetVerboseLevel(verbose);
+
+  G4LatticePhysical* ge = testLattice("Ge", n);
+  testLattice("Si", n);
+
+  // Tables must not be used unless requested
+  G4CMPConfigManager::UseRateTables(false);
+  G4CMPInterValleyRate ivRate;
+  ivRate.SetLattice(ge);
+  ivRate.LoadDataForLattice();
+  if (ivRate.GetRateTable()) {
+    G4cerr << " RATE TABLE USED WITHOUT G4CMP_RATE_TABLES" << G4endl;
+    nErrors++;
+  }
+
+  G4cout << "\n" << nErrors << " errors found" << G4endl;
+  ::exit(nErrors);
+}
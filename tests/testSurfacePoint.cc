@@ -0,0 +1,185 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Compare exact closest surface points from G4CMPSolidUtils against the
+// numerical search (OptimizeSurfaceAdjustAngle), for each supported solid.
+//
+// Usage: testSurfacePoint [N] [verbose]
+//
+// N random points (default 1000) are thrown in a box 20% larger than each
+// solid's bounding box.  For each point, the exact surface point must be
+// on the surface, no farther than the numerical result, and its normal
+// must match G4VSolid::SurfaceNormal() away from edges.  Timing for both
+// methods is reported.  Returns the number of failed checks.
+//
+// 20261019  New test for exact surface points in G4CMPSolidUtils
+
+#include "globals.hh"
+#include "G4Box.hh"
+#include "G4CMPSolidUtils.hh"
+#include "G4ExtrudedSolid.hh"
+#include "G4Polycone.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "G4Tubs.hh"
+#include "G4TwoVector.hh"
+#include "G4VSolid.hh"
+#include "Randomize.hh"
+#include <chrono>
+#include <stdlib.h>
+#include <vector>
+
+namespace {
+  G4int nErrors = 0;		// Increment counter at failed checks
+  G4int verbose = 0;
+}
+
+
+// Elapsed time for function over all points, in ns per call
+
+template <class F>
+G4double timeSearch(const std::vector<G4ThreeVector>& points, F func) {
+  auto start = std::chrono::steady_clock::now();
+  for (const G4ThreeVector& pos: points) func(pos);
+  std::chrono::duration<G4double, std::nano> elapsed =
+    std::chrono::steady_clock::now() - start;
+  return elapsed.count() / points.size();
+}
+
+
+// Compare exact and numerical surface points for one solid
+
+void testSolid(const G4VSolid* solid, G4int n) {
+  G4cout << "\n" << solid->GetEntityType() << " " << solid->GetName()
+	 << G4endl;
+
+  G4CMPSolidUtils exact(solid, verbose, "Exact");
+  G4CMPSolidUtils search(solid, verbose, "Search");
+  search.SetUseAnalytic(false);
+
+  if (!exact.HasAnalyticSurface()) {
+    G4cerr << " NO EXACT SURFACE CALCULATION" << G4endl;
+    nErrors++;
+    return;
+  }
+
+  // Throw points around solid, including outside
+  G4ThreeVector bbMin, bbMax;
+  solid->BoundingLimits(bbMin, bbMax);
+  G4ThreeVector center = 0.5*(bbMax+bbMin), range = 0.6*(bbMax-bbMin);
+
+  std::vector<G4ThreeVector> points(n);
+  for (G4ThreeVector& pos: points) {
+    pos.set(center.x() + range.x()*(2.*G4UniformRand()-1.),
+	    center.y() + range.y()*(2.*G4UniformRand()-1.),
+	    center.z() + range.z()*(2.*G4UniformRand()-1.));
+  }
+
+  G4double tol = 1.*nm;		// Golden-section search is not exact
+  G4int nOffSurface=0, nFarther=0, nNormal=0, nMatched=0, nNoSearch=0;
+  G4double maxDiff = 0.;
+
+  for (const G4ThreeVector& pos: points) {
+    G4ThreeVector surfPoint, surfNorm;
+    G4bool atEdge = false;
+    exact.GetAnalyticSurfacePoint(pos, surfPoint, surfNorm, atEdge);
+
+    if (solid->Inside(surfPoint) != kSurface) {
+      if (verbose) G4cerr << " " << pos << " exact " << surfPoint
+			  << " not on surface" << G4endl;
+      nOffSurface++;
+    }
+
+    if (!atEdge && surfNorm*solid->SurfaceNormal(surfPoint) < 0.999) {
+      if (verbose) G4cerr << " " << pos << " exact normal " << surfNorm
+			  << " vs. " << solid->SurfaceNormal(surfPoint)
+			  << G4endl;
+      nNormal++;
+    }
+
+    G4ThreeVector searchPoint = search.GetClosestSurfacePoint(pos);
+    if (searchPoint.x() == kInfinity) {		// Search did not converge
+      nNoSearch++;
+      continue;
+    }
+
+    G4double dExact = (surfPoint-pos).mag();
+    G4double dSearch = (searchPoint-pos).mag();
+    if (dExact > dSearch + tol) {
+      if (verbose) G4cerr << " " << pos << " exact " << surfPoint
+			  << " farther than search " << searchPoint << G4endl;
+      nFarther++;
+    }
+
+    G4double diff = (surfPoint-searchPoint).mag();
+    if (diff < 1.*um) nMatched++;
+    if (diff > maxDiff) maxDiff = diff;
+  }
+
+  G4cout << " " << n << " points: " << nMatched << " match search, "
+	 << nNoSearch << " search failed, max difference "
+	 << maxDiff/um << " um" << G4endl;
+
+  if (nOffSurface) {
+    G4cerr << " " << nOffSurface << " EXACT POINTS NOT ON SURFACE" << G4endl;
+  }
+
+  if (nFarther) {
+    G4cerr << " " << nFarther << " EXACT POINTS FARTHER THAN SEARCH" << G4endl;
+  }
+
+  if (nNormal) {
+    G4cerr << " " << nNormal << " EXACT NORMALS WRONG" << G4endl;
+  }
+
+  nErrors += nOffSurface + nFarther + nNormal;
+
+  // Timing of both methods
+  G4double tExact = timeSearch(points, [&](const G4ThreeVector& pos) {
+      return exact.GetClosestSurfacePoint(pos); });
+  G4double tSearch = timeSearch(points, [&](const G4ThreeVector& pos) {
+      return search.GetClosestSurfacePoint(pos); });
+
+  G4cout << " exact " << tExact << " ns/call, search " << tSearch
+	 << " ns/call (x" << tSearch/tExact << ")" << G4endl;
+}
+
+
+int main(int argc, char* argv[]) {
+  G4int n = (argc > 1) ? atoi(argv[1]) : 1000;
+  verbose = (argc > 2) ? atoi(argv[2]) : 0;
+
+  G4Random::setTheSeed(20261019);
+
+  // Crystal shapes used for detectors
+  G4Box box("Box", 5.*mm, 10.*mm, 2.*mm);
+  testSolid(&box, n);
+
+  G4Tubs tubs("Tubs", 0., 38.1*mm, 12.7*mm, 0., 360.*deg);
+  testSolid(&tubs, n);
+
+  G4Tubs ring("Ring", 10.*mm, 38.1*mm, 12.7*mm, 0., 360.*deg);
+  testSolid(&ring, n);
+
+  // Cylinder with bevelled top edge
+  const G4double zPlane[] = { -12.7*mm, 10.*mm, 12.7*mm };
+  const G4double rInner[] = { 0., 0., 0. };
+  const G4double rOuter[] = { 38.1*mm, 38.1*mm, 35.4*mm };
+  G4Polycone pcon("Polycone", 0., 360.*deg, 3, zPlane, rInner, rOuter);
+  testSolid(&pcon, n);
+
+  // Cylinder with flats is approximated by a polygon
+  std::vector<G4TwoVector> polygon;
+  for (G4int i=0; i<12; i++) {
+    polygon.push_back(G4TwoVector(38.1*mm*std::cos(-i*30.*deg),
+				  38.1*mm*std::sin(-i*30.*deg)));
+  }
+  G4ExtrudedSolid xtru("Extruded", polygon, 12.7*mm, G4TwoVector(), 1.,
+		       G4TwoVector(), 1.);
+  testSolid(&xtru, n);
+
+  G4cout << "\n" << nErrors << " errors found" << G4endl;
+  return nErrors;
+}
@@ -0,0 +1,240 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: testValleyFrames [N] [seed] [verbose]
+//
+// Verify that G4LatticePhysical electron mappings, which use valley
+// transforms precomputed in the local (G4VSolid) frame, reproduce the
+// step-wise calculation: rotate into the lattice frame, call through to
+// G4LatticeLogical, and rotate back.  N random momenta are tested for each
+// valley of Ge and Si lattices with a non-trivial Miller orientation, and
+// the batch mappings are compared with the single-vector ones.
+//
+// Returns number of errors.
+//
+// 20261019  New test for precomputed valley transforms
+
+#include "globals.hh"
+#include "G4LatticeLogical.hh"
+#include "G4LatticeManager.hh"
+#include "G4LatticePhysical.hh"
+#include "G4NistManager.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4RandomDirection.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+
+namespace {
+  G4int nErrors = 0;
+  G4int verbose = 0;
+  const G4double tolerance = 1e-12;	// Relative difference
+}
+
+
+// Relative difference between vectors or scalars
+
+G4double relDiff(const G4ThreeVector& a, const G4ThreeVector& b) {
+  G4double scale = std::max(a.mag(), b.mag());
+  return (scale > 0.) ? (a-b).mag()/scale : 0.;
+}
+
+G4double relDiff(G4double a, G4double b) {
+  G4double scale = std::max(fabs(a), fabs(b));
+  return (scale > 0.) ? fabs(a-b)/scale : 0.;
+}
+
+
+// Record maximum difference for each mapping
+
+class DiffCounter {
+public:
+  DiffCounter(const G4String& theName) : name(theName), maxDiff(0.) {;}
+  ~DiffCounter() {
+    if (verbose) G4cout << "  " << name << " max difference " << maxDiff
+			<< G4endl;
+    if (maxDiff > tolerance) {
+      G4cerr << "  " << name << " DIFFERS FROM REFERENCE BY " << maxDiff
+	     << G4endl;
+      nErrors++;
+    }
+  }
+
+  template <class T> void operator()(const T& a, const T& b) {
+    maxDiff = std::max(maxDiff, relDiff(a, b));
+  }
+
+private:
+  G4String name;
+  G4double maxDiff;
+};
+
+
+// Reference mappings, rotating into lattice frame for logical lattice
+
+class Reference {
+public:
+  Reference(const G4LatticePhysical* lat)
+    : phys(lat), logic(lat->GetLattice()) {;}
+
+  G4ThreeVector toLattice(G4ThreeVector v) const {
+    return phys->RotateToLattice(v);
+  }
+  G4ThreeVector toSolid(G4ThreeVector v) const {
+    return phys->RotateToSolid(v);
+  }
+
+  G4ThreeVector MapPtoK(G4int iv, const G4ThreeVector& p) const {
+    return toSolid(logic->MapPtoK(iv, toLattice(p)));
+  }
+  G4ThreeVector MapKtoP(G4int iv, const G4ThreeVector& k) const {
+    return toSolid(logic->MapKtoP(iv, toLattice(k)));
+  }
+  G4ThreeVector MapPtoV_el(G4int iv, const G4ThreeVector& p) const {
+    return toSolid(logic->MapPtoV_el(iv, toLattice(p)));
+  }
+  G4double MapPtoEkin(G4int iv, const G4ThreeVector& p) const {
+    return logic->MapPtoEkin(iv, toLattice(p));
+  }
+  G4ThreeVector MapEkintoP(G4int iv, const G4ThreeVector& pdir,
+			   G4double E) const {
+    return toSolid(logic->MapEkintoP(iv, toLattice(pdir), E));
+  }
+  G4ThreeVector ToHV(G4int iv, const G4ThreeVector& v) const {
+    return logic->EllipsoidalToSphericalTranformation(iv, toLattice(v));
+  }
+  G4ThreeVector FromHV(G4int iv, const G4ThreeVector& v) const {
+    return toSolid(logic->SphericalToEllipsoidalTranformation(iv, v));
+  }
+  G4ThreeVector MInv(G4int iv, G4ThreeVector v) const {
+    phys->RotateToLattice(v);
+    v.transform(logic->GetValley(iv));
+    v *= logic->GetMInvTensor();
+    v.transform(logic->GetValleyInv(iv));
+    return phys->RotateToSolid(v);
+  }
+
+private:
+  const G4LatticePhysical* phys;
+  const G4LatticeLogical* logic;
+};
+
+
+// Compare all mappings for one valley
+
+void testValley(const G4LatticePhysical* lat, G4int iv, G4int n) {
+  Reference ref(lat);
+
+  std::vector<G4ThreeVector> pList;
+  for (G4int i=0; i<n; i++) {
+    G4double ekin = 1e-3*eV * pow(1e4, G4UniformRand());	// 1 meV to 10 eV
+    pList.push_back(lat->MapEkintoP(iv, G4RandomDirection(), ekin));
+  }
+
+  if (verbose) G4cout << " valley " << iv << G4endl;
+
+  {
+    DiffCounter pToK("MapPtoK"), kToP("MapKtoP"), pToV("MapPtoV_el"),
+      pToE("MapPtoEkin"), eToP("MapEkintoP"),
+      toHV("EllipsoidalToSpherical"), fromHV("SphericalToEllipsoidal"),
+      mInv("GetValleyMInvTensor");
+
+    for (const G4ThreeVector& p: pList) {
+      G4ThreeVector k = ref.MapPtoK(iv, p);
+      G4ThreeVector v = ref.MapPtoV_el(iv, p);
+      G4double ekin = ref.MapPtoEkin(iv, p);
+
+      pToK(lat->MapPtoK(iv, p), k);
+      kToP(lat->MapKtoP(iv, k), ref.MapKtoP(iv, k));
+      pToV(lat->MapPtoV_el(iv, p), v);
+      pToE(lat->MapPtoEkin(iv, p), ekin);
+      eToP(lat->MapEkintoP(iv, p.unit(), ekin),
+	   ref.MapEkintoP(iv, p.unit(), ekin));
+      toHV(lat->EllipsoidalToSphericalTranformation(iv, p), ref.ToHV(iv, p));
+      fromHV(lat->SphericalToEllipsoidalTranformation(iv, p),
+	     ref.FromHV(iv, p));
+      mInv(lat->GetValleyMInvTensor(iv)*p, ref.MInv(iv, p));
+    }
+  }
+
+  // Batch mappings must agree with single-vector versions
+  {
+    DiffCounter bPtoK("MapPtoK (batch)"), bKtoP("MapKtoP (batch)"),
+      bPtoV("MapPtoV_el (batch)"), bPtoE("MapPtoEkin (batch)"),
+      bToHV("EllipsoidalToSpherical (batch)"),
+      bFromHV("SphericalToEllipsoidal (batch)"), bRot("RotateToLattice (batch)");
+
+    std::vector<G4ThreeVector> out;
+    std::vector<G4double> energies;
+
+    lat->MapPtoK(iv, pList, out);
+    for (G4int i=0; i<n; i++) bPtoK(out[i], lat->MapPtoK(iv, pList[i]));
+
+    lat->MapKtoP(iv, pList, out);
+    for (G4int i=0; i<n; i++) bKtoP(out[i], lat->MapKtoP(iv, pList[i]));
+
+    lat->MapPtoV_el(iv, pList, out);
+    for (G4int i=0; i<n; i++) bPtoV(out[i], lat->MapPtoV_el(iv, pList[i]));
+
+    lat->MapPtoEkin(iv, pList, energies);
+    for (G4int i=0; i<n; i++) bPtoE(energies[i], lat->MapPtoEkin(iv, pList[i]));
+
+    lat->EllipsoidalToSphericalTranformation(iv, pList, out);
+    for (G4int i=0; i<n; i++) {
+      bToHV(out[i], lat->EllipsoidalToSphericalTranformation(iv, pList[i]));
+    }
+
+    lat->SphericalToEllipsoidalTranformation(iv, pList, out);
+    for (G4int i=0; i<n; i++) {
+      bFromHV(out[i], lat->SphericalToEllipsoidalTranformation(iv, pList[i]));
+    }
+
+    out = pList;
+    lat->RotateToLattice(out);
+    for (G4int i=0; i<n; i++) bRot(out[i], ref.toLattice(pList[i]));
+  }
+}
+
+
+// Test all valleys of lattice with given orientation
+
+void testLattice(const G4String& lname, G4int n) {
+  G4Material* mat = G4NistManager::Instance()->FindOrBuildMaterial("G4_"+lname);
+  G4LatticeLogical* logic = G4LatticeManager::Instance()->LoadLattice(mat, lname);
+  if (!logic) {
+    G4cerr << " Unable to load " << lname << " lattice" << G4endl;
+    nErrors++;
+    return;
+  }
+
+  G4LatticePhysical lat(logic, 1, 1, 0, 30.*deg);
+
+  G4cout << lname << " lattice, " << lat.NumberOfValleys() << " valleys"
+	 << G4endl;
+
+  for (size_t iv=0; iv<lat.NumberOfValleys(); iv++) testValley(&lat, iv, n);
+}
+
+
+// Main test is here
+
+int main(int argc, char* argv[]) {
+  G4int n = (argc>1) ? atoi(argv[1]) : 10000;
+  G4long seed = (argc>2) ? atol(argv[2]) : 20261019;
+  verbose = (argc>3) ? atoi(argv[3]) : 0;
+
+  G4Random::setTheSeed(seed);
+
+  testLattice("Ge", n);
+  testLattice("Si", n);
+
+  G4cout << "\n" << nErrors << " errors found" << G4endl;
+  ::exit(nErrors);
+}
@@ -0,0 +1,62 @@
+//
+//  g4cmpCompileLattice -- Write binary "compiled" lattice for G4CMP
+//
+//  Usage: g4cmpCompileLattice <lattice> [material] [output]
+//
+//  Reads <lattice>/config.txt (locally or from G4LATTICEDATA), and writes
+//  all parameters, along with the phonon K-Vg lookup table, to config.bin
+//  in the same directory, or to the output file given.  G4LatticeReader
+//  will use config.bin in place of config.txt if it is not older.
+//
+//  The K-Vg table depends on the material density, taken from the named
+//  Geant4 material (default "G4_<lattice>").  Use "none" to skip the table;
+//  it will be filled when the lattice is loaded, as for config.txt.  If the
+//  density used in the job is different, the table is also filled then.
+//
+//  20261019  New utility to precompute lattice configurations
+
+#include "G4LatticeReader.hh"
+#include "G4Material.hh"
+#include "G4NistManager.hh"
+#include "G4SystemOfUnits.hh"
+#include <iostream>
+#include <stdlib.h>
+using namespace std;
+
+
+int main(int argc, const char* argv[]) {
+  if (argc < 2) {
+    cerr << "Usage: " << argv[0] << " <lattice> [material] [output]" << endl;
+    ::exit(1);
+  }
+
+  G4String latDir = argv[1];
+  G4String matName = (argc > 2) ? argv[2] : "G4_"+latDir;
+  G4String outfile = (argc > 3) ? argv[3] : "";
+
+  G4double density = 0.;
+  if (matName != "none") {
+    G4Material* mat = G4NistManager::Instance()->FindOrBuildMaterial(matName);
+    if (!mat) {
+      cerr << argv[0] << ": unknown material " << matName
+	   << "; use \"none\" to skip K-Vg table" << endl;
+      ::exit(1);
+    }
+    density = mat->GetDensity();
+  }
+
+  G4LatticeReader reader(1);
+  if (!reader.CompileLattice(latDir+"/config.txt", density, outfile)) {
+    cerr << argv[0] << ": unable to compile " << latDir << endl;
+    ::exit(2);
+  }
+
+  if (density > 0.) {
+    cout << latDir << " compiled with K-Vg table for " << matName << " ("
+	 << density/(g/cm3) << " g/cm3)" << endl;
+  } else {
+    cout << latDir << " compiled without K-Vg table" << endl;
+  }
+
+  return 0;
+}
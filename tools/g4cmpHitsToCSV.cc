@@ -0,0 +1,183 @@
+//
+//  g4cmpHitsToCSV -- Convert binary hits file from G4CMPHitWriter to CSV
+//
+//  Usage: g4cmpHitsToCSV <hits.bin> [hits.csv]
+//
+//  Output goes to standard output if no CSV file is given.  Columns are
+//  "Run ID" followed by the columns named in the input file header, with
+//  the same names as the text output of the phonon example.
+//
+//  20261019  New utility for G4CMPHitWriter files
+
+#include "G4CMPHitWriter.hh"
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <stdlib.h>
+using namespace std;
+
+
+// Read one value of known type from file
+
+template <class T> bool readValue(istream& in, T& value) {
+  return (bool)in.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+bool readString(istream& in, string& value) {
+  uint16_t len = 0;
+  if (!readValue(in, len)) return false;
+
+  value.resize(len);
+  return len==0 || (bool)in.read(&value[0], len);
+}
+
+template <class T> bool readColumn(istream& in, vector<T>& column, size_t n) {
+  column.resize(n);
+  return n==0 || (bool)in.read(reinterpret_cast<char*>(column.data()),
+			       n*sizeof(T));
+}
+
+
+// Column definition and storage from file
+
+struct Column {
+  char type;
+  string name;
+  vector<int32_t> ivals;
+  vector<uint8_t> bvals;
+  vector<float>   fvals;
+  vector<double>  dvals;
+};
+
+
+int main(int argc, const char* argv[]) {
+  if (argc < 2) {
+    cerr << "Usage: " << argv[0] << " <hits.bin> [hits.csv]" << endl;
+    ::exit(1);
+  }
+
+  ifstream input(argv[1], ios::binary);
+  if (!input.good()) {
+    cerr << argv[0] << ": unable to open " << argv[1] << endl;
+    ::exit(1);
+  }
+
+  ofstream outfile;
+  if (argc > 2) {
+    outfile.open(argv[2], ios::trunc);
+    if (!outfile.good()) {
+      cerr << argv[0] << ": unable to open " << argv[2] << endl;
+      ::exit(1);
+    }
+  }
+  ostream& output = (argc > 2) ? outfile : cout;
+
+  // Validate file header
+  char magic[sizeof(G4CMPHitWriter::kMagic)];
+  uint32_t version=0, realSize=0;
+  input.read(magic, sizeof(magic));
+  readValue(input, version);
+  readValue(input, realSize);
+
+  if (!input.good() || memcmp(magic, G4CMPHitWriter::kMagic, sizeof(magic))) {
+    cerr << argv[1] << " is not a G4CMP hit file" << endl;
+    ::exit(2);
+  }
+
+  if (version != G4CMPHitWriter::kVersion || (realSize!=4 && realSize!=8)) {
+    cerr << argv[1] << " has unsupported version " << version
+	 << " or real size " << realSize << " (byte-swapped file?)" << endl;
+    ::exit(2);
+  }
+
+  // Particle names for enum column
+  uint32_t nParticles = 0;
+  readValue(input, nParticles);
+  vector<string> particles(nParticles);
+  for (auto& name: particles) readString(input, name);
+
+  // Column definitions
+  uint32_t nColumns = 0;
+  readValue(input, nColumns);
+  vector<Column> columns(nColumns);
+  for (auto& col: columns) {
+    uint8_t type = 0;
+    readValue(input, type);
+    col.type = type;
+    readString(input, col.name);
+  }
+
+  if (!input.good()) {
+    cerr << argv[1] << ": header is truncated" << endl;
+    ::exit(2);
+  }
+
+  output << "Run ID";
+  for (const auto& col: columns) output << ',' << col.name;
+  output << '\n';
+
+  output << setprecision(realSize==4 ? numeric_limits<float>::digits10
+			 : numeric_limits<double>::max_digits10);
+
+  // Blocks of hits, each with all columns
+  uint32_t marker = 0, nRows = 0;
+  int32_t runID = 0;
+  size_t nBlocks = 0, nHits = 0;
+
+  while (readValue(input, marker)) {
+    if (marker != G4CMPHitWriter::kBlockMarker ||
+	!readValue(input, runID) || !readValue(input, nRows)) {
+      cerr << argv[1] << ": bad block header after " << nBlocks << " blocks"
+	   << endl;
+      ::exit(3);
+    }
+
+    bool good = true;
+    for (auto& col: columns) {
+      switch (col.type) {
+      case 'i': good &= readColumn(input, col.ivals, nRows); break;
+      case 'b': good &= readColumn(input, col.bvals, nRows); break;
+      case 'r': good &= (realSize==4 ? readColumn(input, col.fvals, nRows)
+			 : readColumn(input, col.dvals, nRows)); break;
+      default:
+	cerr << argv[1] << ": unknown column type " << col.type << endl;
+	::exit(3);
+      }
+    }
+
+    if (!good) {
+      cerr << argv[1] << ": truncated block " << nBlocks << endl;
+      ::exit(3);
+    }
+
+    for (uint32_t i=0; i<nRows; i++) {
+      output << runID;
+      for (const auto& col: columns) {
+	output << ',';
+	switch (col.type) {
+	case 'i': output << col.ivals[i]; break;
+	case 'b': output << (col.bvals[i] < particles.size()
+			     ? particles[col.bvals[i]] : string("unknown"));
+	  break;
+	case 'r': if (realSize==4) output << col.fvals[i];
+	  else output << col.dvals[i];
+	  break;
+	}
+      }
+      output << '\n';
+    }
+
+    nBlocks++;
+    nHits += nRows;
+  }
+
+  cerr << argv[0] << ": converted " << nHits << " hits in " << nBlocks
+       << " blocks" << endl;
+
+  return 0;
+}
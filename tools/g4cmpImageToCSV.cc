@@ -0,0 +1,99 @@
+//
+//  g4cmpImageToCSV -- Convert hit image file from G4CMPHitImage to CSV
+//
+//  Usage: g4cmpImageToCSV <image.img> [image.csv]
+//
+//  Output goes to standard output if no CSV file is given.  Each line is
+//  one row (fixed v bin) of the image for one mode and slice:
+//
+//    Mode,Time slice,Energy slice,V [mm],<nu values>
+//
+//  Column headings give the bin centers in u [mm].  Slice ranges, the
+//  weighting, and the number of hits are printed to standard error.
+//
+//  20261019  New utility for G4CMPHitImage files
+
+#include "G4CMPHitImage.hh"
+#include "G4CMPHitWriter.hh"
+#include "G4SystemOfUnits.hh"
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdlib.h>
+using namespace std;
+
+
+// Report slice ranges with units
+
+void printSlices(const char* name, const vector<G4double>& edges,
+		 G4double unit, const char* unitName) {
+  if (edges.empty()) return;
+
+  cerr << name << " slices [" << unitName << "]:";
+  for (size_t i=0; i+1<edges.size(); i++) {
+    cerr << " " << i << " (" << edges[i]/unit << "-" << edges[i+1]/unit << ")";
+  }
+  cerr << endl;
+}
+
+
+int main(int argc, const char* argv[]) {
+  if (argc < 2) {
+    cerr << "Usage: " << argv[0] << " <image.img> [image.csv]" << endl;
+    ::exit(1);
+  }
+
+  G4CMPHitImage image;
+  if (!image.Read(argv[1])) {
+    cerr << argv[0] << ": unable to read " << argv[1] << endl;
+    ::exit(2);
+  }
+
+  ofstream outfile;
+  if (argc > 2) {
+    outfile.open(argv[2], ios::trunc);
+    if (!outfile.good()) {
+      cerr << argv[0] << ": unable to open " << argv[2] << endl;
+      ::exit(1);
+    }
+  }
+  ostream& output = (argc > 2) ? outfile : cout;
+
+  const size_t nu = image.GetNU(), nv = image.GetNV();
+  const G4double du = (image.GetUMax()-image.GetUMin())/nu;
+  const G4double dv = (image.GetVMax()-image.GetVMin())/nv;
+
+  cerr << argv[1] << ": " << nu << " x " << nv << " bins, "
+       << image.GetEntries() << " hits (" << image.GetOutside()
+       << " outside), filled with "
+       << (image.GetWeighting() == G4CMPHitImage::kEnergy ? "energy [eV]"
+	   : "weight") << endl;
+  printSlices("Time", image.GetTimeSlices(), ns, "ns");
+  printSlices("Energy", image.GetEnergySlices(), eV, "eV");
+
+  output << "Mode,Time slice,Energy slice,V [mm]";
+  for (size_t iu=0; iu<nu; iu++)
+    output << ',' << (image.GetUMin() + (iu+0.5)*du)/mm;
+  output << '\n';
+
+  output.precision(numeric_limits<double>::max_digits10);
+
+  for (size_t mode=0; mode<image.GetModes().size(); mode++) {
+    const char* name = G4CMPHitWriter::GetParticleName(image.GetModes()[mode]);
+
+    for (size_t it=0; it<image.GetNTimeSlices(); it++) {
+      for (size_t ie=0; ie<image.GetNEnergySlices(); ie++) {
+	const G4double* bins = image.GetImage(mode, it, ie);
+
+	for (size_t iv=0; iv<nv; iv++) {
+	  output << name << ',' << it << ',' << ie << ','
+		 << (image.GetVMin() + (iv+0.5)*dv)/mm;
+	  for (size_t iu=0; iu<nu; iu++) output << ',' << bins[iv*nu+iu];
+	  output << '\n';
+	}
+      }
+    }
+  }
+
+  return 0;
+}